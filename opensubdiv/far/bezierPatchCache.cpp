@@ -0,0 +1,286 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/bezierPatchCache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cstring>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    //
+    // Conversion matrices : the 16 Bezier points of a patch are expressed as
+    // linear combinations of the B-spline control vertices of the patch.
+    //
+    // The 4x4 grid of B-spline points is first completed (mirroring of the
+    // missing boundary & corner points, see Osd::evalBoundary() and
+    // Osd::evalCorner()), then converted with the tensor product of the
+    // cubic B-spline to Bezier change of basis.
+    //
+    struct ConversionMatrix {
+
+        void Initialize(PatchDescriptor::Type type);
+
+        int numCVs;
+
+        float weights[16][16]; // [bezier point][control vertex]
+    };
+
+    void
+    ConversionMatrix::Initialize(PatchDescriptor::Type type) {
+
+        // grid[16][16] : 4x4 B-spline grid as combination of the patch CVs
+        float grid[16][16];
+        memset(grid, 0, sizeof(grid));
+
+        switch (type) {
+
+            case PatchDescriptor::REGULAR : {
+                numCVs = 16;
+                for (int i=0; i<16; ++i) {
+                    grid[i][i] = 1.0f;
+                }
+            } break;
+
+            case PatchDescriptor::BOUNDARY : {
+                // M[i] = 2*v[i] - v[i+4]
+                numCVs = 12;
+                for (int i=0; i<4; ++i) {
+                    grid[i][i] = 2.0f;
+                    grid[i][i+4] = -1.0f;
+                }
+                for (int i=4; i<16; ++i) {
+                    grid[i][i-4] = 1.0f;
+                }
+            } break;
+
+            case PatchDescriptor::CORNER : {
+                numCVs = 9;
+                // first row : M0, M1, M2 & M3 = 2*M2 - M1
+                grid[0][0] =  2.0f; grid[0][3] = -1.0f;
+                grid[1][1] =  2.0f; grid[1][4] = -1.0f;
+                grid[2][2] =  2.0f; grid[2][5] = -1.0f;
+                grid[3][1] = -2.0f; grid[3][2] =  4.0f;
+                grid[3][4] =  1.0f; grid[3][5] = -2.0f;
+                for (int j=1; j<4; ++j) {
+                    for (int i=0; i<3; ++i) {
+                        grid[j*4+i][i+(j-1)*3] = 1.0f;
+                    }
+                }
+                // last column : M4, M5 & M6
+                grid[ 7][2] = 2.0f; grid[ 7][1] = -1.0f;
+                grid[11][5] = 2.0f; grid[11][4] = -1.0f;
+                grid[15][8] = 2.0f; grid[15][7] = -1.0f;
+            } break;
+
+            default:
+                assert(0);
+        }
+
+        // cubic B-spline to Bezier change of basis
+        static float const C[4][4] = { { 1.0f/6.0f, 4.0f/6.0f, 1.0f/6.0f, 0.0f      },
+                                       { 0.0f,      4.0f/6.0f, 2.0f/6.0f, 0.0f      },
+                                       { 0.0f,      2.0f/6.0f, 4.0f/6.0f, 0.0f      },
+                                       { 0.0f,      1.0f/6.0f, 4.0f/6.0f, 1.0f/6.0f } };
+
+        memset(weights, 0, sizeof(weights));
+        for (int a=0; a<4; ++a) {
+            for (int b=0; b<4; ++b) {
+                for (int r=0; r<4; ++r) {
+                    for (int c=0; c<4; ++c) {
+                        float w = C[a][r] * C[b][c];
+                        if (w==0.0f) {
+                            continue;
+                        }
+                        for (int n=0; n<numCVs; ++n) {
+                            weights[a*4+b][n] += w * grid[r*4+c][n];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // conversion matrices of the regular, boundary & corner patches
+    struct ConversionMatrices {
+
+        ConversionMatrices() {
+            matrices[0].Initialize(PatchDescriptor::REGULAR);
+            matrices[1].Initialize(PatchDescriptor::BOUNDARY);
+            matrices[2].Initialize(PatchDescriptor::CORNER);
+        }
+
+        // returns the conversion matrix of a type of patch (or NULL)
+        ConversionMatrix const * Get(PatchDescriptor::Type type) const {
+            switch (type) {
+                case PatchDescriptor::REGULAR  : return &matrices[0];
+                case PatchDescriptor::BOUNDARY : return &matrices[1];
+                case PatchDescriptor::CORNER   : return &matrices[2];
+                default:
+                    return 0;
+            }
+        }
+
+        ConversionMatrix matrices[3];
+    };
+
+    ConversionMatrices const g_conversionMatrices;
+}
+
+// Constructor
+BezierPatchCache::BezierPatchCache( PatchTables const & patchTables ) :
+    _patchTables(&patchTables), _numPatches(0), _length(0) {
+
+    _patchOffsets.resize(patchTables.GetNumPatchesTotal(), -1);
+
+    for (int parray=0, current=0; parray<patchTables.GetNumPatchArrays(); ++parray) {
+
+        PatchDescriptor desc = patchTables.GetPatchArrayDescriptor(parray);
+
+        int npatches = patchTables.GetNumPatches(parray);
+
+        if (g_conversionMatrices.Get(desc.GetType())) {
+            for (int j=0; j<npatches; ++j) {
+                _patchOffsets[current+j] = _numPatches++;
+            }
+        }
+        current += npatches;
+    }
+}
+
+void
+BezierPatchCache::Update( float const * src, int length, int stride ) {
+
+    _length = length;
+    _points.resize(_numPatches*16*_length);
+
+    for (int parray=0, current=0; parray<_patchTables->GetNumPatchArrays(); ++parray) {
+
+        int npatches = _patchTables->GetNumPatches(parray);
+
+        ConversionMatrix const * matrix = g_conversionMatrices.Get(
+            _patchTables->GetPatchArrayDescriptor(parray).GetType());
+
+        if (not matrix) {
+            current += npatches;
+            continue;
+        }
+
+        for (int j=0; j<npatches; ++j, ++current) {
+
+            Index buffer[PatchTables::MAX_PATCH_VERTICES];
+            ConstIndexArray cvs = _patchTables->GetPatchVertices(parray, j, buffer);
+            assert(cvs.size()==matrix->numCVs);
+
+            float * dst = &_points[_patchOffsets[current]*16*_length];
+
+            memset(dst, 0, 16*_length*sizeof(float));
+
+            for (int n=0; n<matrix->numCVs; ++n) {
+
+                float const * in = src + cvs[n]*stride;
+
+                for (int i=0; i<16; ++i) {
+                    float w = matrix->weights[i][n];
+                    if (w==0.0f) {
+                        continue;
+                    }
+                    float * out = dst + i*_length;
+                    for (int k=0; k<_length; ++k) {
+                        out[k] += w * in[k];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+BezierPatchCache::Evaluate( Handle const & handle, float s, float t,
+    float * Q, float * dQs, float * dQt ) const {
+
+    float const * cvs = GetPatchPoints(handle);
+    assert(cvs);
+
+    PatchParam::BitField bits = _patchTables->GetPatchParam(handle).bitField;
+
+    float wQ[16], wDs[16], wDt[16];
+    PatchTables::GetBasisWeights(PatchTables::BASIS_BEZIER, bits, s, t,
+        wQ, (dQs or dQt) ? wDs : 0, (dQs or dQt) ? wDt : 0);
+
+    memset(Q, 0, _length*sizeof(float));
+    if (dQs) {
+        memset(dQs, 0, _length*sizeof(float));
+    }
+    if (dQt) {
+        memset(dQt, 0, _length*sizeof(float));
+    }
+
+    for (int i=0; i<16; ++i) {
+
+        float const * in = cvs + i*_length;
+
+        for (int k=0; k<_length; ++k) {
+            Q[k] += wQ[i] * in[k];
+            if (dQs) {
+                dQs[k] += wDs[i] * in[k];
+            }
+            if (dQt) {
+                dQt[k] += wDt[i] * in[k];
+            }
+        }
+    }
+}
+
+void
+BezierPatchCache::GetPatchBounds( Handle const & handle,
+    float bmin[3], float bmax[3] ) const {
+
+    float const * cvs = GetPatchPoints(handle);
+    assert(cvs and _length>=3);
+
+    for (int k=0; k<3; ++k) {
+        bmin[k] =  FLT_MAX;
+        bmax[k] = -FLT_MAX;
+    }
+    for (int i=0; i<16; ++i) {
+        float const * p = cvs + i*_length;
+        for (int k=0; k<3; ++k) {
+            bmin[k] = std::min(bmin[k], p[k]);
+            bmax[k] = std::max(bmax[k], p[k]);
+        }
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,158 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef FAR_BEZIER_PATCH_CACHE_H
+#define FAR_BEZIER_PATCH_CACHE_H
+
+#include "../version.h"
+
+#include "../far/patchTables.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+/// \brief A cache of the bi-cubic Bezier form of the B-spline patches
+///
+/// Regular, boundary and corner patches are described in the PatchTables by
+/// 16, 12 and 9 B-spline control vertices respectively : every evaluation
+/// has to gather the control vertices, extrapolate the missing boundary
+/// points and apply the B-spline basis.
+///
+/// The BezierPatchCache converts each of these patches into 16 Bezier control
+/// points, stored contiguously per patch. The conversion is meant to be run
+/// once per frame, after the control vertices have been posed, so that
+/// repeated evaluations, bounds computations and tessellation of the patches
+/// can use the cheaper Bezier form.
+///
+/// The Bezier points of a patch are stored in the same order as the B-spline
+/// control points of a regular patch : evaluating them with
+/// PatchTables::GetBasisWeights(BASIS_BEZIER, ...) and the PatchParam of the
+/// patch returns the same limit values as the original B-spline patch.
+///
+/// Single-crease and Gregory patches are not converted.
+///
+/// Ex :
+/// \code
+/// Far::BezierPatchCache bezierCache(*patchTables);
+///
+/// // every frame
+/// bezierCache.Update(positions, 3, 3);
+///
+/// parallel_for( ... ) {
+///     if (bezierCache.HasPatch(handle)) {
+///         bezierCache.Evaluate(handle, s, t, P, dPds, dPdt);
+///     }
+/// }
+/// \endcode
+///
+class BezierPatchCache {
+public:
+
+    typedef PatchTables::PatchHandle Handle;
+
+    /// \brief Constructor
+    ///
+    /// @param patchTables  A valid set of PatchTables
+    ///
+    BezierPatchCache( PatchTables const & patchTables );
+
+    /// \brief Converts the patches to Bezier form for a new set of control
+    /// vertex data
+    ///
+    /// @param src     Control vertex data for all the vertices indexed by
+    ///                the patches
+    ///
+    /// @param length  Number of floats interpolated per vertex
+    ///
+    /// @param stride  Number of floats between 2 successive vertices
+    ///
+    void Update( float const * src, int length, int stride );
+
+    /// \brief Returns the PatchTables the cache was built from
+    PatchTables const & GetPatchTables() const { return *_patchTables; }
+
+    /// \brief Returns the number of patches converted to Bezier form
+    int GetNumPatches() const { return _numPatches; }
+
+    /// \brief Returns the number of floats per Bezier point (0 until the
+    /// first update)
+    int GetLength() const { return _length; }
+
+    /// \brief Returns true if the patch has a Bezier form in the cache
+    bool HasPatch( Handle const & handle ) const {
+        return _length>0 and _patchOffsets[handle.patchIndex]>=0;
+    }
+
+    /// \brief Returns the 16 Bezier points of a patch ('length' floats
+    /// each) or NULL if the patch is not cached
+    float const * GetPatchPoints( Handle const & handle ) const {
+        return HasPatch(handle) ?
+            &_points[_patchOffsets[handle.patchIndex]*16*_length] : 0;
+    }
+
+    /// \brief Evaluates a cached patch
+    ///
+    /// @param handle  A patch handle (see HasPatch())
+    ///
+    /// @param s       Patch coordinate (normalized to the sub-patch)
+    ///
+    /// @param t       Patch coordinate (normalized to the sub-patch)
+    ///
+    /// @param Q       Output limit value ('length' floats)
+    ///
+    /// @param dQs     Output derivative along s (optional)
+    ///
+    /// @param dQt     Output derivative along t (optional)
+    ///
+    void Evaluate( Handle const & handle, float s, float t,
+                   float * Q, float * dQs=0, float * dQt=0 ) const;
+
+    /// \brief Computes the bounds of the convex hull of the first 3 floats
+    /// of the Bezier points of a cached patch
+    void GetPatchBounds( Handle const & handle,
+                         float bmin[3], float bmax[3] ) const;
+
+private:
+
+    PatchTables const * _patchTables;
+
+    int _numPatches,
+        _length;
+
+    std::vector<Index> _patchOffsets; // per patch offset in the cache (-1 if not cached)
+    std::vector<float> _points;       // 16 Bezier points per cached patch
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif /* FAR_BEZIER_PATCH_CACHE_H */
@@ -25,9 +25,15 @@
 #include "../far/gregoryBasis.h"
 #include "../far/topologyRefiner.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
+#include <vector>
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -363,8 +369,10 @@ ProtoBasis::ProtoBasis(Vtr::Level const & level, Index faceIndex) {
                   idx_neighbor_m = (manifoldRing[2*im + 0]),
                   idx_diagonal_m = (manifoldRing[2*im + 1]);
 
-            bool boundaryNeighbor = (level.getVertexEdges(idx_neighbor).size() >
-                level.getVertexFaces(idx_neighbor).size());
+            // test the edge rather than the neighbor vertex : vertices on the
+            // fringe of a sparse level may have an incomplete neighborhood
+            bool boundaryNeighbor = level.getEdgeTag(
+                level.findEdge(faceVerts[vid], idx_neighbor))._boundary;
 
             if (boundaryNeighbor) {
                 if (currentNeighbor<2) {
@@ -401,15 +409,19 @@ ProtoBasis::ProtoBasis(Vtr::Level const & level, Index faceIndex) {
             boundaryEdgeNeighbors[1] = boundaryEdgeNeighbors[0];
         }
 
-        for (int i=0; i<ivalence; ++i) {
-            int im = (i+ivalence-1)%ivalence;
-            Point e = (f[i]+f[im])*0.5f;
-            e0[vid] += e * csf(ivalence-3, 2*i);
-            e1[vid] += e * csf(ivalence-3, 2*i+1);
-        }
+        // boundary corners (faces isolated short of the maximum level) have
+        // a valence of 2 : their tangents are set below
+        if (ivalence > 2) {
+            for (int i=0; i<ivalence; ++i) {
+                int im = (i+ivalence-1)%ivalence;
+                Point e = (f[i]+f[im])*0.5f;
+                e0[vid] += e * csf(ivalence-3, 2*i);
+                e1[vid] += e * csf(ivalence-3, 2*i+1);
+            }
 
-        e0[vid] *= ef[ivalence-3];
-        e1[vid] *= ef[ivalence-3];
+            e0[vid] *= ef[ivalence-3];
+            e1[vid] *= ef[ivalence-3];
+        }
 
         if (valence<0) {
 
@@ -582,7 +594,7 @@ GregoryBasisFactory::Create(TopologyRefiner const & refiner, Index faceIndex) {
 //
 GregoryBasisFactory::GregoryBasisFactory(TopologyRefiner const & refiner,
     StencilTables const & stencils, int numpatches, int maxvalence) :
-        _currentStencil(0), _refiner(refiner),
+        _currentStencil(0), _maxValence(maxvalence), _refiner(refiner),
             _stencils(stencils), _alloc(GetNumMaxElems(maxvalence)) {
 
     // Sanity check: the mesh must be adaptively refined
@@ -591,25 +603,23 @@ GregoryBasisFactory::GregoryBasisFactory(TopologyRefiner const & refiner,
     _alloc.Resize(numpatches * 20);
 
     // Gregory limit stencils have indices that are relative to the level
-    // (maxlevel) of subdivision. These indices need to be offset to match
+    // of subdivision of the patch. These indices need to be offset to match
     // the indices from the multi-level adaptive stencil tables.
     // In addition: stencil tables can be built with singular stencils
     // (single weight of 1.0f) as place-holders for coarse mesh vertices,
     // which also needs to be accounted for.
-    _stencilsOffset=-1;
-    {         int maxlevel = _refiner.GetMaxLevel(),
-            nverts = _refiner.GetNumVerticesTotal(),
+    _stencilsOffset=0;
+    {   int nverts = _refiner.GetNumVerticesTotal(),
             nstencils = _stencils.GetNumStencils();
         if (nstencils==nverts) {
 
             // the table contain stencils for the control vertices
-            _stencilsOffset = nverts - _refiner.GetNumVertices(maxlevel);
+            _stencilsOffset = 0;
 
         } else if (nstencils==(nverts-_refiner.GetNumVertices(0))) {
 
             // the table does not contain stencils for the control vertices
-            _stencilsOffset = nverts - _refiner.GetNumVertices(maxlevel)
-                - _refiner.GetNumVertices(0);
+            _stencilsOffset = - _refiner.GetNumVertices(0);
 
         } else {
             // these are not the stencils you are looking for...
@@ -618,48 +628,144 @@ GregoryBasisFactory::GregoryBasisFactory(TopologyRefiner const & refiner,
     }
 }
 static inline void
-factorizeBasisVertex(StencilTables const & stencils, Point const & p, ProtoStencil dst) {
+factorizeBasisVertex(StencilTables const & stencils, Index stencilsOffset,
+    Point const & p, ProtoStencil dst) {
     // Use the Allocator to factorize the Gregory patch influence CVs with the
     // supporting CVs from the stencil tables.
     dst.Clear();
     for (int j=0; j<p.GetSize(); ++j) {
-        dst.AddWithWeight(stencils,
-            p.GetIndices()[j], p.GetWeights()[j]);
+        Index index = p.GetIndices()[j] + stencilsOffset;
+        if (index>=0) {
+            dst.AddWithWeight(stencils, index, p.GetWeights()[j]);
+        } else {
+            // Control vertex not present in the stencil tables (patches of
+            // the base level, e.g. faces outside of a refined region)
+            dst.AddWithWeight(ProtoStencil(p.GetIndices()[j], 0), p.GetWeights()[j]);
+        }
     }
 }
 bool
-GregoryBasisFactory::AddPatchBasis(Index faceIndex) {
+GregoryBasisFactory::AddPatchBasis(Index faceIndex, int levelIndex) {
 
-    // Gregory patches only exist on the hight
-    Vtr::Level const & level = _refiner.getLevel(_refiner.GetMaxLevel());
+    // Gregory patches exist on the highest level (or the level at which the
+    // isolation of the face was limited)
+    Vtr::Level const & level = _refiner.getLevel(levelIndex);
 
     if (level.getMaxValence()>GetMaxValence()) {
         // The proto-basis closed-form table limits valence to 'MAX_VALENCE'
         return false;
     }
 
+    factorizePatchBasis(faceIndex, levelIndex, _alloc, _currentStencil);
+
+    _currentStencil += 20;
+    return true;
+}
+bool
+GregoryBasisFactory::AddPatchBases(int numPatches, Index const * faceIndices,
+    int const * levels, bool parallel) {
+
+    int numBlocks = 1;
+#ifdef OPENSUBDIV_HAS_OPENMP
+    if (parallel) {
+        numBlocks = std::max(1, std::min(4 * omp_get_max_threads(), numPatches / 64));
+    }
+#else
+    (void)parallel;
+#endif
+
+    if (numBlocks==1) {
+        bool result = true;
+        for (int i=0; i<numPatches; ++i) {
+            result &= AddPatchBasis(faceIndices[i], levels[i]);
+        }
+        return result;
+    }
+
+    int blockSize = (numPatches + numBlocks - 1) / numBlocks;
+
+    // Each block factorizes its bases into its own pool allocator : the shared
+    // pool (and its map of 'big' stencils) is only modified by the merge below
+    std::vector<StencilAllocator *> blockAllocs(numBlocks, (StencilAllocator *)0);
+    std::vector<int> blockNumPatches(numBlocks, 0);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (int block=0; block<numBlocks; ++block) {
+
+        int first = block * blockSize,
+            last = std::min(first + blockSize, numPatches);
+        if (first>=last) {
+            continue;
+        }
+
+        StencilAllocator * alloc = new StencilAllocator(GetNumMaxElems(_maxValence));
+        alloc->Resize((last-first) * 20);
+
+        int npatches = 0;
+        for (int i=first; i<last; ++i) {
+            if (_refiner.getLevel(levels[i]).getMaxValence()>GetMaxValence()) {
+                continue;
+            }
+            factorizePatchBasis(faceIndices[i], levels[i], *alloc, npatches * 20);
+            ++npatches;
+        }
+        blockAllocs[block] = alloc;
+        blockNumPatches[block] = npatches;
+    }
+
+    // Merge the block pools in the order of the batch
+    int numAdded = 0;
+    for (int block=0; block<numBlocks; ++block) {
+
+        StencilAllocator * alloc = blockAllocs[block];
+        if (not alloc) {
+            continue;
+        }
+
+        for (int i=0; i<blockNumPatches[block]*20; ++i, ++_currentStencil) {
+            int size = alloc->GetSize(i);
+            Index const * indices = alloc->GetIndices(i);
+            float const * weights = alloc->GetWeights(i);
+            for (int j=0; j<size; ++j) {
+                _alloc.PushBackVertex(_currentStencil, indices[j], weights[j]);
+            }
+        }
+        numAdded += blockNumPatches[block];
+        delete alloc;
+    }
+    return numAdded==numPatches;
+}
+void
+GregoryBasisFactory::factorizePatchBasis(Index faceIndex, int levelIndex,
+    StencilAllocator & alloc, Index firstStencil) const {
+
+    Vtr::Level const & level = _refiner.getLevel(levelIndex);
+
     // Gather the CVs that influence the Gregory patch and their relative
     // weights in a basis
     ProtoBasis basis(level, faceIndex);
 
-    // The basis vertex indices are currently local to maxlevel: need to offset
+    // The basis vertex indices are currently local to the level: need to offset
     // to match layout of adaptive StencilTables (see factory constructor above)
-    assert(_stencilsOffset>=0);
-    basis.OffsetIndices(_stencilsOffset);
+    Index levelOffset = 0;
+    for (int i=0; i<levelIndex; ++i) {
+        levelOffset += _refiner.GetNumVertices(i);
+    }
+    basis.OffsetIndices(levelOffset);
 
     // Factorize the basis CVs with the stencil tables: the basis is now
     // expressed as a linear combination of vertices from the coarse control
     // mesh with no data dependencies
     for (int i=0; i<4; ++i) {
-        int offset = _currentStencil + i * 5;
-        factorizeBasisVertex(_stencils, basis.P[i],  _alloc[offset]);
-        factorizeBasisVertex(_stencils, basis.Ep[i], _alloc[offset+1]);
-        factorizeBasisVertex(_stencils, basis.Em[i], _alloc[offset+2]);
-        factorizeBasisVertex(_stencils, basis.Fp[i], _alloc[offset+3]);
-        factorizeBasisVertex(_stencils, basis.Fm[i], _alloc[offset+4]);
+        int offset = firstStencil + i * 5;
+        factorizeBasisVertex(_stencils, _stencilsOffset, basis.P[i],  alloc[offset]);
+        factorizeBasisVertex(_stencils, _stencilsOffset, basis.Ep[i], alloc[offset+1]);
+        factorizeBasisVertex(_stencils, _stencilsOffset, basis.Em[i], alloc[offset+2]);
+        factorizeBasisVertex(_stencils, _stencilsOffset, basis.Fp[i], alloc[offset+3]);
+        factorizeBasisVertex(_stencils, _stencilsOffset, basis.Fm[i], alloc[offset+4]);
     }
-    _currentStencil += 20;
-    return true;
 }
 StencilTables const *
 GregoryBasisFactory::CreateStencilTables(int const permute[20]) {
@@ -113,19 +113,36 @@ public:
     GregoryBasisFactory(TopologyRefiner const & refiner,
         StencilTables const & stencils, int numpatches, int maxvalence);
 
-    // Creates a basis for the face and adds it to the stencil pool allocator
-    bool AddPatchBasis(Index faceIndex);
+    // Creates a basis for the face of the given level (the last level unless
+    // isolation was limited per face) and adds it to the stencil pool allocator
+    bool AddPatchBasis(Index faceIndex, int level);
+
+    // Creates the bases for a batch of faces (and their levels) and adds them
+    // to the stencil pool allocator in the order of the batch. If 'parallel'
+    // is set (and OpenMP is available), blocks of the batch are built
+    // concurrently in separate pools that are then merged in order, so the
+    // stencils are identical to those of successive AddPatchBasis() calls.
+    // Returns false if the basis of any face could not be added.
+    bool AddPatchBases(int numPatches, Index const * faceIndices,
+        int const * levels, bool parallel=false);
 
     // After all the patches have been collected, create the final table
     StencilTables const * CreateStencilTables(int const permute[20]=0);
 
 private:
 
-    int _currentStencil;
+    // Factorizes the basis of a face into 20 consecutive stencils of 'alloc'
+    void factorizePatchBasis(Index faceIndex, int level,
+        StencilAllocator & alloc, Index firstStencil) const;
+
+private:
+
+    int _currentStencil,
+        _maxValence;
 
     TopologyRefiner const & _refiner; // XXXX these should be smart pointers !
 
-    Index _stencilsOffset;
+    Index _stencilsOffset;  // offset of the vertices of level 0 in the stencils
 
     StencilTables const & _stencils;
     StencilAllocator _alloc;
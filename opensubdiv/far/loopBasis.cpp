@@ -0,0 +1,685 @@
+//
+//   Copyright 2013 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/loopBasis.h"
+#include "../far/stencilTables.h"
+#include "../far/topologyRefiner.h"
+#include "../vtr/level.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+//
+//  A point of the basis as a linear combination of the vertices of a level
+//
+class LoopPoint {
+
+public:
+
+    int GetSize() const { return (int)_indices.size(); }
+
+    Index const * GetIndices() const { return _indices.empty() ? 0 : &_indices[0]; }
+
+    float const * GetWeights() const { return _weights.empty() ? 0 : &_weights[0]; }
+
+    void Clear() {
+        _indices.clear();
+        _weights.clear();
+    }
+
+    void AddWithWeight(Index index, float weight) {
+        for (int i=0; i<GetSize(); ++i) {
+            if (_indices[i]==index) {
+                _weights[i] += weight;
+                return;
+            }
+        }
+        _indices.push_back(index);
+        _weights.push_back(weight);
+    }
+
+    void AddWithWeight(LoopPoint const & p, float weight) {
+        for (int i=0; i<p.GetSize(); ++i) {
+            AddWithWeight(p._indices[i], p._weights[i] * weight);
+        }
+    }
+
+private:
+
+    std::vector<Index> _indices;
+    std::vector<float> _weights;
+};
+
+//
+//  The limit position of a corner of a face and the limit tangents along the
+//  edges of the face leading to the next and previous corners
+//
+struct LoopCorner {
+    LoopPoint P,
+              Tnext,
+              Tprev;
+};
+
+inline Index
+otherVertex(Vtr::Level const & level, Index edge, Index vert) {
+    ConstIndexArray eVerts = level.getEdgeVertices(edge);
+    return (eVerts[0] == vert) ? eVerts[1] : eVerts[0];
+}
+
+inline bool
+isSharpEdge(Vtr::Level const & level, Index edge) {
+    Vtr::Level::ETag eTag = level.getEdgeTag(edge);
+    return eTag._boundary or eTag._infSharp;
+}
+
+//
+//  Tangent of an interior smooth vertex along its edge k (with the scale of the
+//  parameterization of the regular patches):
+//
+//      T(k) = 2/n * Sum( cos(2*PI*(i-k)/n) * N(i) )
+//
+void
+addSmoothTangent(Vtr::Level const & level, Index vert, int k, LoopPoint & T) {
+
+    ConstIndexArray vEdges = level.getVertexEdges(vert);
+
+    int n = vEdges.size();
+    for (int i=0; i<n; ++i) {
+        double theta = 2.0 * M_PI * (double)(i - k) / (double)n;
+        T.AddWithWeight(otherVertex(level, vEdges[i], vert),
+            (float)(2.0 * std::cos(theta) / (double)n));
+    }
+}
+
+//
+//  Tangent of a crease vertex along the edge k of a sector bounded by the sharp
+//  edges 'first' and 'last' (the m edges of the sector being ordered CCW):
+//
+//      Tb   = (N(0) - N(m-1)) / 2
+//      Tp   = Sum( sin(t(j)) * (N(j) - V - cos(t(j)) * Tb) ) / Sum( sin(t(j))^2 )
+//                  - (N(0) + N(m-1) - 2*V) / (2*sqrt(3))
+//      T(k) = cos(t(k)) * Tb + sin(t(k)) * Tp
+//
+//  with t(j) = PI * j / (m-1) -- the tangents match those of the regular
+//  boundary patches.
+//
+void
+addCreaseTangent(Vtr::Level const & level, Index vert, int first, int m, int k,
+    LoopPoint & T) {
+
+    ConstIndexArray vEdges = level.getVertexEdges(vert);
+
+    int n = vEdges.size();
+
+    Index N0 = otherVertex(level, vEdges[first], vert),
+          Nm = otherVertex(level, vEdges[(first + m - 1) % n], vert);
+
+    double step = M_PI / (double)(m - 1),
+           cosk = std::cos(step * k),
+           sink = std::sin(step * k);
+
+    //  Tb:
+    T.AddWithWeight(N0,  (float)(0.5 * cosk));
+    T.AddWithWeight(Nm, (float)(-0.5 * cosk));
+
+    if (m < 3 or sink == 0.0) {
+        return;
+    }
+
+    //  Tp:
+    double den = 0.0;
+    for (int j=1; j<(m-1); ++j) {
+        den += std::sin(step * j) * std::sin(step * j);
+    }
+    for (int j=1; j<(m-1); ++j) {
+        double sinj = std::sin(step * j),
+               cosj = std::cos(step * j),
+               w = sink * sinj / den;
+
+        T.AddWithWeight(otherVertex(level, vEdges[(first + j) % n], vert), (float)w);
+        T.AddWithWeight(vert, (float)(-w));
+        T.AddWithWeight(N0, (float)(-w * 0.5 * cosj));
+        T.AddWithWeight(Nm, (float)( w * 0.5 * cosj));
+    }
+
+    double w = sink / (2.0 * std::sqrt(3.0));
+    T.AddWithWeight(N0, (float)(-w));
+    T.AddWithWeight(Nm, (float)(-w));
+    T.AddWithWeight(vert, (float)(2.0 * w));
+}
+
+//
+//  Identifies the sector of the sharp edges of a crease vertex that contains the
+//  given face (a face i being between the edges i and i+1 of the vertex).
+//  Returns false if the vertex does not have 2 sharp edges.
+//
+bool
+getCreaseSector(Vtr::Level const & level, Index vert, int faceInVFaces,
+    int * first, int * m) {
+
+    ConstIndexArray vEdges = level.getVertexEdges(vert);
+
+    int n = vEdges.size(),
+        sharp[2],
+        nsharp = 0;
+    for (int i=0; i<n; ++i) {
+        if (isSharpEdge(level, vEdges[i])) {
+            if (nsharp == 2) return false;
+            sharp[nsharp++] = i;
+        }
+    }
+    if (nsharp != 2) return false;
+
+    //  Start from the sharp edge reaching the face before the other:
+    int d0 = (faceInVFaces - sharp[0] + n) % n,
+        d1 = (sharp[1] - sharp[0] + n) % n;
+
+    *first = (d0 < d1) ? sharp[0] : sharp[1];
+    *m = ((d0 < d1) ? d1 : (n - d1)) + 1;
+    return true;
+}
+
+//
+//  Computes the limit position and tangents of the corner k of a face
+//
+void
+computeCorner(Vtr::Level const & level, Index face, int k, LoopCorner & corner) {
+
+    ConstIndexArray fVerts = level.getFaceVertices(face),
+                    fEdges = level.getFaceEdges(face);
+
+    Index vert = fVerts[k];
+
+    ConstIndexArray vEdges = level.getVertexEdges(vert),
+                    vFaces = level.getVertexFaces(vert);
+
+    int n = vEdges.size(),
+        eNext = vEdges.FindIndex(fEdges[k]),
+        ePrev = vEdges.FindIndex(fEdges[(k+2)%3]);
+    assert(eNext >= 0 and ePrev >= 0);
+
+    corner.P.Clear();
+    corner.Tnext.Clear();
+    corner.Tprev.Clear();
+
+    Vtr::Level::VTag vTag = level.getVertexTag(vert);
+
+    int rule = vTag._rule;
+
+    int first = 0,
+        m = 0;
+    if ((rule == Sdc::Crease::RULE_CREASE or vTag._boundary) and
+        rule != Sdc::Crease::RULE_CORNER and
+        not getCreaseSector(level, vert, vFaces.FindIndex(face), &first, &m)) {
+        rule = Sdc::Crease::RULE_CORNER;
+    }
+
+    if (rule == Sdc::Crease::RULE_CORNER or vTag._nonManifold) {
+
+        corner.P.AddWithWeight(vert, 1.0f);
+
+        corner.Tnext.AddWithWeight(otherVertex(level, vEdges[eNext], vert), 1.0f);
+        corner.Tnext.AddWithWeight(vert, -1.0f);
+        corner.Tprev.AddWithWeight(otherVertex(level, vEdges[ePrev], vert), 1.0f);
+        corner.Tprev.AddWithWeight(vert, -1.0f);
+
+    } else if (m > 0) {
+
+        //  Crease vertex: the limit lies on the B-spline of the sharp edges
+        corner.P.AddWithWeight(vert, 4.0f / 6.0f);
+        corner.P.AddWithWeight(otherVertex(level, vEdges[first], vert), 1.0f / 6.0f);
+        corner.P.AddWithWeight(otherVertex(level, vEdges[(first + m - 1) % n], vert), 1.0f / 6.0f);
+
+        addCreaseTangent(level, vert, first, m, (eNext - first + n) % n, corner.Tnext);
+        addCreaseTangent(level, vert, first, m, (ePrev - first + n) % n, corner.Tprev);
+
+    } else {
+
+        //  Smooth vertex (see Sdc::Scheme<SCHEME_LOOP>::assignInteriorLimitMask())
+        float eWeight = 1.0f / 12.0f,
+              vWeight = 0.5f;
+        if (n != 6) {
+            float invValence = 1.0f / n;
+
+            float beta = 0.25f * cosf((float)M_PI * 2.0f * invValence) + 0.375f;
+            beta = (0.625f - (beta * beta)) * invValence;
+
+            eWeight = 1.0f / (n + 3.0f / (8.0f * beta));
+            vWeight = (float)(1.0f - (eWeight * n));
+        }
+        for (int i=0; i<n; ++i) {
+            corner.P.AddWithWeight(otherVertex(level, vEdges[i], vert), eWeight);
+        }
+        corner.P.AddWithWeight(vert, vWeight);
+
+        addSmoothTangent(level, vert, eNext, corner.Tnext);
+        addSmoothTangent(level, vert, ePrev, corner.Tprev);
+    }
+}
+
+//
+//  Edges of a face whose vertices are both regular have the limit curves of the
+//  edges of regular patches -- gather the vertices of the 1-rings of the edge in
+//  the positions of a regular patch oriented from the edge (see
+//  Vtr::Level::gatherTriRegularPatchVertices()) and fold the vertices missing on
+//  a boundary into the others.
+//
+//  Each row gives the weights of the patch vertices for a control point of the
+//  quartic Bezier curve of edge 0 of a regular patch (scaled by 24):
+//
+static float const edgeBezierWeights[5][12] = {
+    { 12,  2,  2,  2,  2,  0,  0,  0,  0,  0,  2,  2 },
+    { 12,  4,  3,  1,  3,  0,  0,  0,  0,  0,  1,  0 },
+    {  8,  8,  4,  0,  4,  0,  0,  0,  0,  0,  0,  0 },
+    {  4, 12,  3,  0,  3,  1,  0,  1,  0,  0,  0,  0 },
+    {  2, 12,  2,  0,  2,  2,  2,  2,  0,  0,  0,  0 } };
+
+inline bool
+isRegularEdgeVertex(Vtr::Level const & level, Index vert) {
+
+    Vtr::Level::VTag vTag = level.getVertexTag(vert);
+    if (vTag._nonManifold or vTag._xordinary or vTag._semiSharp) {
+        return false;
+    }
+    int n = level.getVertexEdges(vert).size();
+    if (vTag._boundary) {
+        return (n == 4) and (vTag._rule == Sdc::Crease::RULE_CREASE);
+    }
+    return (n == 6) and (vTag._rule == Sdc::Crease::RULE_SMOOTH);
+}
+
+bool
+computeRegularEdge(Vtr::Level const & level, Index face, int k, LoopPoint edge[3]) {
+
+    ConstIndexArray fVerts = level.getFaceVertices(face),
+                    fEdges = level.getFaceEdges(face);
+
+    //  Patch position of the vertex at the end of each of the 6 CCW lattice directions
+    //  from the first two vertices of the patch:
+    static int const latticePoints[2][6] = { {  1,  2, 10, 11,  3,  4 },
+                                             {  6,  7,  2,  0,  4,  5 } };
+
+    Index points[12];
+    for (int i=0; i<12; ++i) {
+        points[i] = Vtr::INDEX_INVALID;
+    }
+    for (int i=0; i<3; ++i) {
+        points[i] = fVerts[(k+i)%3];
+    }
+    for (int i=0; i<2; ++i) {
+        Index vert = points[i];
+        if (not isRegularEdgeVertex(level, vert)) {
+            return false;
+        }
+
+        ConstIndexArray vEdges = level.getVertexEdges(vert);
+
+        int eInVEdges = vEdges.FindIndex(fEdges[(k+i)%3]);
+        assert(eInVEdges >= 0);
+
+        for (int j=0; j<vEdges.size(); ++j) {
+            int direction = (2*i + 6 + j - eInVEdges) % 6;
+            points[latticePoints[i][direction]] = otherVertex(level, vEdges[j], vert);
+        }
+    }
+
+    //  Identify the boundary configuration of each vertex -- a boundary vertex
+    //  either has no boundary edge in the triangles adjacent to the edge or has
+    //  one in the face -- and the rules creating the missing vertices:
+    //
+    static int const phantomRules[4][2][4] = {
+        { { 11, 10, 0, 2 }, {  3, 0, 4, 1 } },    // vertex 0, no boundary edge
+        { { 10,  2, 0, 1 }, { 11, 0, 3, 4 } },    // vertex 0, boundary edge 2
+        { {  5,  4, 1, 0 }, {  6, 1, 7, 2 } },    // vertex 1, no boundary edge
+        { {  6,  5, 1, 4 }, {  7, 1, 2, 0 } } };  // vertex 1, boundary edge 1
+
+    bool missing[12];
+    for (int i=0; i<12; ++i) {
+        missing[i] = (points[i] == Vtr::INDEX_INVALID);
+    }
+
+    int rules[2],
+        nrules = 0;
+    if (missing[3] and missing[11]) {
+        rules[nrules++] = 0;
+    } else if (missing[10] and missing[11]) {
+        rules[nrules++] = 1;
+    }
+    if (missing[5] and missing[6]) {
+        rules[nrules++] = 2;
+    } else if (missing[6] and missing[7]) {
+        rules[nrules++] = 3;
+    }
+
+    //  Two boundary vertices are only supported at the corner of the adjacent
+    //  triangle, where the configurations of both vertices are consistent
+    if (nrules == 2 and (rules[0] != 0 or rules[1] != 2)) {
+        return false;
+    }
+    for (int i=0; i<nrules; ++i) {
+        missing[phantomRules[rules[i]][0][0]] = false;
+        missing[phantomRules[rules[i]][1][0]] = false;
+    }
+    for (int i=0; i<12; ++i) {
+        if (missing[i] and i != 8 and i != 9) {
+            return false;
+        }
+    }
+
+    for (int q=1; q<4; ++q) {
+
+        float weights[12];
+        for (int i=0; i<12; ++i) {
+            weights[i] = edgeBezierWeights[q][i] / 24.0f;
+        }
+        for (int i=0; i<nrules; ++i) {
+            for (int j=0; j<2; ++j) {
+                int const * rule = phantomRules[rules[i]][j];
+                float w = weights[rule[0]];
+                weights[rule[1]] += w;
+                weights[rule[2]] += w;
+                weights[rule[3]] -= w;
+                weights[rule[0]] = 0.0f;
+            }
+        }
+
+        LoopPoint & p = edge[q-1];
+        p.Clear();
+        for (int i=0; i<12; ++i) {
+            if (weights[i] != 0.0f) {
+                p.AddWithWeight(points[i], weights[i]);
+            }
+        }
+    }
+    return true;
+}
+
+//
+//  Sharp edges between crease (or corner) vertices have the limit curve of the
+//  uniform cubic B-spline of the crease -- elevated to a quartic Bezier curve
+//
+Index
+getCreaseNeighbor(Vtr::Level const & level, Index vert, Index edge) {
+
+    if (level.getVertexTag(vert)._rule != Sdc::Crease::RULE_CREASE) {
+        return Vtr::INDEX_INVALID;
+    }
+    ConstIndexArray vEdges = level.getVertexEdges(vert);
+    for (int i=0; i<vEdges.size(); ++i) {
+        if (vEdges[i] != edge and isSharpEdge(level, vEdges[i])) {
+            return otherVertex(level, vEdges[i], vert);
+        }
+    }
+    return Vtr::INDEX_INVALID;
+}
+
+bool
+computeCreaseEdge(Vtr::Level const & level, Index face, int k, LoopPoint edge[3]) {
+
+    ConstIndexArray fVerts = level.getFaceVertices(face),
+                    fEdges = level.getFaceEdges(face);
+
+    Index e  = fEdges[k],
+          v0 = fVerts[k],
+          v1 = fVerts[(k+1)%3];
+
+    if (not isSharpEdge(level, e)) {
+        return false;
+    }
+
+    int rule0 = level.getVertexTag(v0)._rule,
+        rule1 = level.getVertexTag(v1)._rule;
+    if ((rule0 != Sdc::Crease::RULE_CREASE and rule0 != Sdc::Crease::RULE_CORNER) or
+        (rule1 != Sdc::Crease::RULE_CREASE and rule1 != Sdc::Crease::RULE_CORNER)) {
+        return false;
+    }
+
+    //  B-spline points (P, V0, V1, Q) -- end points of corners are extrapolated
+    Index p = getCreaseNeighbor(level, v0, e),
+          q = getCreaseNeighbor(level, v1, e);
+
+    LoopPoint P, Q;
+    if (p == Vtr::INDEX_INVALID) {
+        P.AddWithWeight(v0, 2.0f);
+        P.AddWithWeight(v1, -1.0f);
+    } else {
+        P.AddWithWeight(p, 1.0f);
+    }
+    if (q == Vtr::INDEX_INVALID) {
+        Q.AddWithWeight(v1, 2.0f);
+        Q.AddWithWeight(v0, -1.0f);
+    } else {
+        Q.AddWithWeight(q, 1.0f);
+    }
+
+    //  Cubic Bezier points:
+    //      c0 = (P + 4*V0 + V1)/6, c1 = (2*V0 + V1)/3, c2 = (V0 + 2*V1)/3,
+    //      c3 = (V0 + 4*V1 + Q)/6
+    //  elevated to quartic:
+    //      b1 = (c0 + 3*c1)/4, b2 = (c1 + c2)/2, b3 = (3*c2 + c3)/4
+    edge[0].Clear();
+    edge[0].AddWithWeight(P, 1.0f / 24.0f);
+    edge[0].AddWithWeight(v0, 16.0f / 24.0f);
+    edge[0].AddWithWeight(v1, 7.0f / 24.0f);
+
+    edge[1].Clear();
+    edge[1].AddWithWeight(v0, 0.5f);
+    edge[1].AddWithWeight(v1, 0.5f);
+
+    edge[2].Clear();
+    edge[2].AddWithWeight(Q, 1.0f / 24.0f);
+    edge[2].AddWithWeight(v1, 16.0f / 24.0f);
+    edge[2].AddWithWeight(v0, 7.0f / 24.0f);
+    return true;
+}
+
+//
+//  Other edges interpolate the limit positions and tangents of their corners with
+//  a cubic curve -- elevated to a quartic Bezier curve:
+//
+//      b1 = P0 + T0/4,  b2 = (P0 + P1)/2 + (T0 + T1)/6,  b3 = P1 + T1/4
+//
+//  with T0 and T1 the tangents of the corners toward each other.
+//
+void
+computeHermiteEdge(LoopCorner const & c0, LoopCorner const & c1, LoopPoint edge[3]) {
+
+    edge[0].Clear();
+    edge[0].AddWithWeight(c0.P, 1.0f);
+    edge[0].AddWithWeight(c0.Tnext, 0.25f);
+
+    edge[1].Clear();
+    edge[1].AddWithWeight(c0.P, 0.5f);
+    edge[1].AddWithWeight(c1.P, 0.5f);
+    edge[1].AddWithWeight(c0.Tnext, 1.0f / 6.0f);
+    edge[1].AddWithWeight(c1.Tprev, 1.0f / 6.0f);
+
+    edge[2].Clear();
+    edge[2].AddWithWeight(c1.P, 1.0f);
+    edge[2].AddWithWeight(c1.Tprev, 0.25f);
+}
+
+} // end namespace
+
+//
+// LoopBasisFactory
+//
+LoopBasisFactory::LoopBasisFactory(TopologyRefiner const & refiner,
+    StencilTables const * stencils, int numpatches) :
+        _refiner(refiner), _stencils(stencils), _stencilsOffset(0) {
+
+    // Sanity check: the mesh must be adaptively refined
+    assert(not _refiner.IsUniform());
+
+    _tables = new StencilTables;
+
+    if (_stencils) {
+        // As for Gregory patches, the stencil tables may not contain the
+        // stencils of the control vertices (see GregoryBasisFactory)
+        int nverts = _refiner.GetNumVerticesTotal(),
+            nstencils = _stencils->GetNumStencils();
+        if (nstencils==(nverts-_refiner.GetNumVertices(0))) {
+            _stencilsOffset = - _refiner.GetNumVertices(0);
+        } else {
+            assert(nstencils==nverts);
+        }
+        _tables->_numControlVertices = _refiner.GetNumVertices(0);
+    } else {
+        _tables->_numControlVertices = _refiner.GetNumVerticesTotal();
+    }
+
+    _tables->_sizes.reserve(numpatches * 15);
+
+    _vertexWeights.resize(_tables->_numControlVertices, 0.0f);
+}
+
+LoopBasisFactory::~LoopBasisFactory() {
+    delete _tables;
+}
+
+void
+LoopBasisFactory::AddPatchBasis(Index faceIndex, int levelIndex) {
+
+    Vtr::Level const & level = _refiner.getLevel(levelIndex);
+
+    assert(level.getFaceVertices(faceIndex).size()==3);
+
+    LoopCorner corners[3];
+    for (int i=0; i<3; ++i) {
+        computeCorner(level, faceIndex, i, corners[i]);
+    }
+
+    //  Bezier points -- the 3 interior points of each edge are ordered from the
+    //  first corner of the edge:
+    static int const edgePoints[3][5] = { {  0,  1,  2,  3,  4 },
+                                          {  4,  8, 11, 13, 14 },
+                                          { 14, 12,  9,  5,  0 } };
+    LoopPoint points[15];
+
+    for (int i=0; i<3; ++i) {
+        points[edgePoints[i][0]] = corners[i].P;
+
+        LoopPoint edge[3];
+        if (not computeCreaseEdge(level, faceIndex, i, edge) and
+            not computeRegularEdge(level, faceIndex, i, edge)) {
+            computeHermiteEdge(corners[i], corners[(i+1)%3], edge);
+        }
+        for (int j=0; j<3; ++j) {
+            points[edgePoints[i][j+1]] = edge[j];
+        }
+    }
+
+    //  Interior points complete the parallelograms of the points of each corner
+    static int const interiorPoints[3][4] = { {  6,  1,  5,  0 },
+                                              {  7,  3,  8,  4 },
+                                              { 10, 12, 13, 14 } };
+    for (int i=0; i<3; ++i) {
+        int const * ip = interiorPoints[i];
+        points[ip[0]].AddWithWeight(points[ip[1]],  1.0f);
+        points[ip[0]].AddWithWeight(points[ip[2]],  1.0f);
+        points[ip[0]].AddWithWeight(points[ip[3]], -1.0f);
+    }
+
+    //  The points are local to the level: offset their vertices to match the
+    //  layout of the vertices of all levels
+    Index levelOffset = 0;
+    for (int i=0; i<levelIndex; ++i) {
+        levelOffset += _refiner.GetNumVertices(i);
+    }
+    for (int i=0; i<15; ++i) {
+        addStencil(points[i].GetSize(),
+            points[i].GetIndices(), points[i].GetWeights(), levelOffset);
+    }
+}
+
+inline void
+LoopBasisFactory::accumulate(Index index, float weight) {
+
+    if (_vertexWeights[index] == 0.0f) {
+        _vertexIndices.push_back(index);
+    }
+    _vertexWeights[index] += weight;
+}
+
+void
+LoopBasisFactory::addStencil(int size, Index const * indices,
+    float const * weights, Index levelOffset) {
+
+    for (int i=0; i<size; ++i) {
+        Index index = indices[i] + levelOffset;
+
+        if (_stencils and (index + _stencilsOffset) >= 0) {
+            // Factorize with the stencils of the refined vertices
+            Stencil stencil = _stencils->GetStencil(index + _stencilsOffset);
+            for (int j=0; j<stencil.GetSize(); ++j) {
+                accumulate(stencil.GetVertexIndices()[j],
+                    weights[i] * stencil.GetWeights()[j]);
+            }
+        } else {
+            accumulate(index, weights[i]);
+        }
+    }
+
+    int nverts = 0;
+    for (int i=0; i<(int)_vertexIndices.size(); ++i) {
+        Index index = _vertexIndices[i];
+        if (_vertexWeights[index] != 0.0f) {
+            _tables->_indices.push_back(index);
+            _tables->_weights.push_back(_vertexWeights[index]);
+            ++nverts;
+        }
+        _vertexWeights[index] = 0.0f;
+    }
+    _vertexIndices.clear();
+
+    assert(nverts < 256);
+    _tables->_sizes.push_back((unsigned char)nverts);
+}
+
+StencilTables const *
+LoopBasisFactory::CreateStencilTables() {
+
+    if (_tables->_sizes.empty()) {
+        return 0;
+    }
+
+    StencilTables * result = _tables;
+    _tables = 0;
+
+    result->generateOffsets();
+
+    return result;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,107 @@
+//
+//   Copyright 2013 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef FAR_LOOP_BASIS_H
+#define FAR_LOOP_BASIS_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class StencilTables;
+class TopologyRefiner;
+
+/// \brief A specialized factory for the stencils of Loop end-cap patches
+///
+/// Triangles of a Loop mesh whose neighborhood is not regular at the level of
+/// their patch are approximated by quartic Bezier triangles.  The corners of
+/// the end-caps interpolate the limit surface; their edges match the limit
+/// curves of regular edges and of creases, and otherwise interpolate the limit
+/// tangents of their corners, so that adjacent end-caps meet with C0
+/// continuity.
+///
+/// The 15 control points of each end-cap are ordered by rows from the edge of
+/// the first and second corners of the triangle (see
+/// PatchTables::GetLoopBezierWeights()).
+///
+class LoopBasisFactory {
+
+public:
+
+    // This factory accumulates the stencils of the 15 control points of Loop
+    // end-caps into StencilTables
+    //
+    // Note: the TopologyRefiner and StencilTables are held for the lifespan
+    //       of the factory - neither can be deleted or modified while this
+    //       factory is active.
+    //
+    // The stencils are factorized with the adaptive stencils when given, and
+    // are otherwise expressed in terms of the vertices of all the levels of
+    // the refiner.
+    //
+    LoopBasisFactory(TopologyRefiner const & refiner,
+        StencilTables const * stencils, int numpatches);
+
+    ~LoopBasisFactory();
+
+    // Creates the basis of the face of the given level and adds its stencils
+    void AddPatchBasis(Index faceIndex, int level);
+
+    // After all the patches have been collected, create the final table
+    StencilTables const * CreateStencilTables();
+
+private:
+
+    void addStencil(int size, Index const * indices, float const * weights,
+        Index levelOffset);
+
+    void accumulate(Index index, float weight);
+
+private:
+
+    TopologyRefiner const & _refiner;
+
+    StencilTables const * _stencils;
+
+    Index _stencilsOffset;  // offset of the vertices of level 0 in the stencils
+
+    StencilTables * _tables;
+
+    std::vector<float> _vertexWeights;  // accumulated weights of a stencil
+    std::vector<Index> _vertexIndices;  // vertices with accumulated weights
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
+
+#endif /* FAR_LOOP_BASIS_H */
@@ -0,0 +1,424 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/patchBVH.h"
+#include "../far/bezierPatchCache.h"
+#include "../far/stencilTables.h"
+
+#include <cfloat>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+void
+PatchBVH::Bounds::Clear() {
+    for (int k=0; k<3; ++k) {
+        min[k] =  FLT_MAX;
+        max[k] = -FLT_MAX;
+    }
+}
+
+void
+PatchBVH::Bounds::Extend( float const * p ) {
+    for (int k=0; k<3; ++k) {
+        min[k] = std::min(min[k], p[k]);
+        max[k] = std::max(max[k], p[k]);
+    }
+}
+
+void
+PatchBVH::Bounds::Extend( Bounds const & b ) {
+    for (int k=0; k<3; ++k) {
+        min[k] = std::min(min[k], b.min[k]);
+        max[k] = std::max(max[k], b.max[k]);
+    }
+}
+
+namespace {
+
+    // extends the bounds with the position of a vertex mirrored across
+    // another vertex (boundary & corner patches)
+    template <class BOUNDS> inline void
+    extendMirrored( BOUNDS & bounds, float const * positions, int stride,
+        Index v, Index w ) {
+
+        float const * pv = positions + v * stride,
+                    * pw = positions + w * stride;
+        float p[3] = { 2.0f*pv[0] - pw[0],
+                       2.0f*pv[1] - pw[1],
+                       2.0f*pv[2] - pw[2] };
+        bounds.Extend(p);
+    }
+
+    // extends the bounds with the points obtained by applying a series of
+    // consecutive stencils to the positions (end-cap patches)
+    template <class BOUNDS> inline void
+    extendStencils( BOUNDS & bounds, float const * positions, int stride,
+        StencilTables const & stencils, Index offset, int numStencils ) {
+
+        for (int i=0; i<numStencils; ++i) {
+
+            Stencil s = stencils.GetStencil(offset+i);
+
+            Index const * indices = s.GetVertexIndices();
+            float const * weights = s.GetWeights();
+
+            float p[3] = { 0.0f, 0.0f, 0.0f };
+            for (int j=0; j<s.GetSize(); ++j) {
+                float const * src = positions + indices[j]*stride;
+                p[0] += weights[j] * src[0];
+                p[1] += weights[j] * src[1];
+                p[2] += weights[j] * src[2];
+            }
+            bounds.Extend(p);
+        }
+    }
+
+    // sort functor for the median split
+    struct CompareCentroids {
+
+        CompareCentroids( std::vector<float> const & centroids, int axis ) :
+            _centroids(centroids), _axis(axis) { }
+
+        bool operator() ( PatchTables::PatchHandle const & a,
+                          PatchTables::PatchHandle const & b ) const {
+            return _centroids[a.patchIndex*3+_axis] < _centroids[b.patchIndex*3+_axis];
+        }
+
+        std::vector<float> const & _centroids;
+        int _axis;
+    };
+}
+
+// Computes the bounds of the convex hull of the control points of a patch
+void
+PatchBVH::computePatchBounds( Handle const & handle,
+    float const * positions, int stride,
+    BezierPatchCache const * bezierPatches, Bounds & bounds ) const {
+
+    typedef PatchDescriptor Desc;
+
+    if (bezierPatches and bezierPatches->HasPatch(handle)) {
+        bezierPatches->GetPatchBounds(handle, bounds.min, bounds.max);
+        return;
+    }
+
+    bounds.Clear();
+
+    Index buffer[PatchTables::MAX_PATCH_VERTICES];
+    ConstIndexArray cvs = _patchTables->GetPatchVertices(handle, buffer);
+
+    switch (_patchTables->GetPatchDescriptor(handle).GetType()) {
+
+        case Desc::BOUNDARY : {
+            // mirrored row : M[i] = 2*v[i] - v[i+4]
+            for (int i=0; i<4; ++i) {
+                extendMirrored(bounds, positions, stride, cvs[i], cvs[i+4]);
+            }
+        } break;
+
+        case Desc::CORNER : {
+            // mirrored row & column (see evalCorner), including the corner
+            // M3 = 2*M2 - M1
+            extendMirrored(bounds, positions, stride, cvs[0], cvs[3]);
+            extendMirrored(bounds, positions, stride, cvs[1], cvs[4]);
+            extendMirrored(bounds, positions, stride, cvs[2], cvs[5]);
+            extendMirrored(bounds, positions, stride, cvs[2], cvs[1]);
+            extendMirrored(bounds, positions, stride, cvs[5], cvs[4]);
+            extendMirrored(bounds, positions, stride, cvs[8], cvs[7]);
+
+            float const * v1 = positions + cvs[1]*stride,
+                        * v2 = positions + cvs[2]*stride,
+                        * v4 = positions + cvs[4]*stride,
+                        * v5 = positions + cvs[5]*stride;
+            float m3[3];
+            for (int k=0; k<3; ++k) {
+                m3[k] = -2.0f*v1[k] + 4.0f*v2[k] + v4[k] - 2.0f*v5[k];
+            }
+            bounds.Extend(m3);
+        } break;
+
+        case Desc::GREGORY_BASIS : {
+            // apply the end-cap stencils to obtain the 20 basis points
+            StencilTables const * stencils = _patchTables->GetEndCapStencilTables();
+            assert(stencils);
+
+            extendStencils(bounds, positions, stride, *stencils,
+                _patchTables->GetEndCapStencilIndex(handle),
+                    Desc::GetGregoryBasisPatchSize());
+            return;
+        }
+
+        case Desc::LOOP : {
+            // the control vertices missing on the boundaries of the patch are
+            // replaced by the combinations of the others they are folded into
+            // (real control vertices fold into themselves)
+            PatchParam::BitField bits = _patchTables->GetPatchParam(handle).bitField;
+            for (int i=0; i<12; ++i) {
+
+                float weights[12] = { 0.0f };
+                weights[i] = 1.0f;
+                PatchTables::FoldLoopBoundaryWeights(bits, weights);
+
+                float p[3] = { 0.0f, 0.0f, 0.0f };
+                for (int j=0; j<12; ++j) {
+                    if (weights[j]!=0.0f) {
+                        float const * src = positions + cvs[j]*stride;
+                        p[0] += weights[j] * src[0];
+                        p[1] += weights[j] * src[1];
+                        p[2] += weights[j] * src[2];
+                    }
+                }
+                bounds.Extend(p);
+            }
+            return;
+        }
+
+        case Desc::LOOP_BASIS : {
+            // apply the end-cap stencils to obtain the 15 Bezier points
+            StencilTables const * stencils = _patchTables->GetEndCapStencilTables();
+            assert(stencils);
+
+            extendStencils(bounds, positions, stride, *stencils,
+                _patchTables->GetEndCapStencilIndex(handle),
+                    Desc::GetLoopBasisPatchSize());
+            return;
+        }
+
+        case Desc::GREGORY          :
+        case Desc::GREGORY_BOUNDARY : {
+            // the patch lies within the convex hull of its 20 Gregory control
+            // points, which are gathered from the 1-rings of its corners
+            float points[20*3];
+            PatchTables::ComputeGregoryPoints(
+                _patchTables->GetPatchDescriptor(handle).GetType(), cvs.begin(),
+                    &_patchTables->GetVertexValenceTable()[0],
+                        _patchTables->GetPatchQuadOffsets(handle).begin(),
+                            _patchTables->GetMaxValence(),
+                                positions, stride, 3, points);
+            for (int i=0; i<20; ++i) {
+                bounds.Extend(points + i*3);
+            }
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    for (int i=0; i<cvs.size(); ++i) {
+        bounds.Extend(positions + cvs[i]*stride);
+    }
+}
+
+// Recursively splits the patches [first, first+count) at the median of
+// the largest axis of their centroids
+int
+PatchBVH::buildNode( std::vector<Bounds> const & patchBounds,
+    std::vector<float> const & centroids, int first, int count ) {
+
+    int nodeIndex = (int)_nodes.size();
+    _nodes.push_back(Node());
+
+    if (count <= _maxLeafSize) {
+
+        Node & node = _nodes[nodeIndex];
+        node.index = first;
+        node.count = count;
+        node.bounds.Clear();
+        for (int i=0; i<count; ++i) {
+            node.bounds.Extend(patchBounds[_handles[first+i].patchIndex]);
+        }
+        return nodeIndex;
+    }
+
+    // find the largest axis of the centroid bounds
+    Bounds cbounds;
+    cbounds.Clear();
+    for (int i=0; i<count; ++i) {
+        cbounds.Extend(&centroids[_handles[first+i].patchIndex*3]);
+    }
+
+    int axis = 0;
+    for (int k=1; k<3; ++k) {
+        if ((cbounds.max[k]-cbounds.min[k]) > (cbounds.max[axis]-cbounds.min[axis])) {
+            axis = k;
+        }
+    }
+
+    // partition the patches around the median
+    int half = count/2;
+    std::nth_element(_handles.begin()+first, _handles.begin()+first+half,
+        _handles.begin()+first+count, CompareCentroids(centroids, axis));
+
+    buildNode(patchBounds, centroids, first, half);
+    int second = buildNode(patchBounds, centroids, first+half, count-half);
+
+    Node & node = _nodes[nodeIndex];
+    node.index = second;
+    node.count = 0;
+    node.bounds = _nodes[nodeIndex+1].bounds;
+    node.bounds.Extend(_nodes[second].bounds);
+
+    return nodeIndex;
+}
+
+// Constructor
+PatchBVH::PatchBVH( PatchTables const & patchTables,
+    float const * positions, int stride, int maxLeafSize,
+    BezierPatchCache const * bezierPatches ) :
+        _patchTables(&patchTables), _maxLeafSize(std::max(1, maxLeafSize)) {
+
+    int narrays = patchTables.GetNumPatchArrays(),
+        npatches = patchTables.GetNumPatchesTotal();
+
+    if (not narrays or not npatches)
+        return;
+
+    // populate subpatch handles vector
+    _handles.resize(npatches);
+
+    for (int parray=0, current=0; parray<narrays; ++parray) {
+
+        int ringsize = patchTables.GetPatchArrayDescriptor(parray).GetNumControlVertices();
+
+        for (Index j=0; j < patchTables.GetNumPatches(parray); ++j) {
+
+            Handle & h = _handles[current];
+
+            h.arrayIndex = parray;
+            h.patchIndex = current;
+            h.vertIndex  = j * ringsize;
+
+            ++current;
+        }
+    }
+
+    // gather the bounds & centroids of all the patches
+    std::vector<Bounds> patchBounds(npatches);
+    std::vector<float> centroids(npatches*3);
+    for (int i=0; i<npatches; ++i) {
+        computePatchBounds(_handles[i], positions, stride, bezierPatches,
+            patchBounds[i]);
+        for (int k=0; k<3; ++k) {
+            centroids[i*3+k] = 0.5f * (patchBounds[i].min[k] + patchBounds[i].max[k]);
+        }
+    }
+
+    // build the hierarchy : handles are re-ordered so that each leaf
+    // references a contiguous range of patches
+    _nodes.reserve(2*(npatches/_maxLeafSize+1));
+
+    buildNode(patchBounds, centroids, 0, npatches);
+}
+
+void
+PatchBVH::Refit( float const * positions, int stride,
+    BezierPatchCache const * bezierPatches ) {
+
+    // children are always stored after their parent : walk the nodes
+    // backwards so that the bounds are propagated from the leaves up
+    for (int i=(int)_nodes.size()-1; i>=0; --i) {
+
+        Node & node = _nodes[i];
+
+        if (node.IsLeaf()) {
+            node.bounds.Clear();
+            for (int j=0; j<node.count; ++j) {
+                Bounds patchBounds;
+                computePatchBounds(_handles[node.index+j], positions, stride,
+                    bezierPatches, patchBounds);
+                node.bounds.Extend(patchBounds);
+            }
+        } else {
+            node.bounds = _nodes[i+1].bounds;
+            node.bounds.Extend(_nodes[node.index].bounds);
+        }
+    }
+}
+
+void
+PatchBVH::GetBounds( float bmin[3], float bmax[3] ) const {
+
+    Bounds bounds;
+    if (_nodes.empty()) {
+        bounds.Clear();
+    } else {
+        bounds = _nodes[0].bounds;
+    }
+    for (int k=0; k<3; ++k) {
+        bmin[k] = bounds.min[k];
+        bmax[k] = bounds.max[k];
+    }
+}
+
+// Slab test
+float
+PatchBVH::intersect( Bounds const & bounds, float const origin[3],
+    float const invdir[3], float tmin, float tmax ) {
+
+    for (int k=0; k<3; ++k) {
+
+        float t0 = (bounds.min[k] - origin[k]) * invdir[k],
+              t1 = (bounds.max[k] - origin[k]) * invdir[k];
+
+        // 0 * inf : the ray is parallel to the slab & lies on its plane
+        if (t0!=t0) t0 = -FLT_MAX;
+        if (t1!=t1) t1 =  FLT_MAX;
+
+        if (t0>t1) {
+            std::swap(t0, t1);
+        }
+        tmin = std::max(tmin, t0);
+        tmax = std::min(tmax, t1);
+        if (tmin>tmax) {
+            return -1.0f;
+        }
+    }
+    return std::max(tmin, 0.0f);
+}
+
+float
+PatchBVH::distanceSq( Bounds const & bounds, float const point[3] ) {
+
+    float dist = 0.0f;
+    for (int k=0; k<3; ++k) {
+        float d = 0.0f;
+        if (point[k] < bounds.min[k]) {
+            d = bounds.min[k] - point[k];
+        } else if (point[k] > bounds.max[k]) {
+            d = point[k] - bounds.max[k];
+        }
+        dist += d*d;
+    }
+    return dist;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
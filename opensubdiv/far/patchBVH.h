@@ -0,0 +1,330 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef FAR_PATCH_BVH_H
+#define FAR_PATCH_BVH_H
+
+#include "../version.h"
+
+#include "../far/patchTables.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class BezierPatchCache;
+
+/// \brief A bounding volume hierarchy over the limit patches of a PatchTables
+///
+/// Each limit patch is contained within the convex hull of its control
+/// points. The PatchBVH stores an axis-aligned box around that hull for every
+/// patch in the tables and organizes the boxes into a binary tree, which can
+/// be used to quickly cull the patches that a ray or a proximity query needs
+/// to consider before the limit surface is evaluated.
+///
+/// Note : the 20 control points of the legacy GREGORY and GREGORY_BOUNDARY
+///        patches are gathered from the 1-rings of their corner vertices
+///        (see PatchTables::ComputeGregoryPoints()).
+///
+/// The topology of the tree only depends on the initial positions of the
+/// control vertices : when the mesh is deformed, Refit() updates the bounds
+/// of the existing nodes without rebuilding the hierarchy.
+///
+class PatchBVH {
+public:
+
+    typedef PatchTables::PatchHandle Handle;
+
+    /// \brief Constructor
+    ///
+    /// @param patchTables  A valid set of PatchTables
+    ///
+    /// @param positions    Control vertex data : the first 3 floats of each
+    ///                     vertex are interpreted as its position. The buffer
+    ///                     must contain all the vertices indexed by the
+    ///                     patches (including refined vertices for adaptive
+    ///                     tables)
+    ///
+    /// @param stride       Number of floats between 2 successive vertices
+    ///
+    /// @param maxLeafSize  Maximum number of patches stored in a leaf node
+    ///
+    /// @param bezierPatches  Optional Bezier form of the patches, updated
+    ///                     with the same positions : the hull of the Bezier
+    ///                     points is tighter than the hull of the B-spline
+    ///                     control vertices
+    ///
+    PatchBVH( PatchTables const & patchTables,
+              float const * positions, int stride, int maxLeafSize=4,
+              BezierPatchCache const * bezierPatches=0 );
+
+    /// \brief Updates the bounds of the hierarchy for a new set of control
+    /// vertex positions. The patches and the structure of the tree are
+    /// unchanged, so the quality of the hierarchy degrades gracefully with
+    /// the amount of deformation.
+    ///
+    /// @param positions  Control vertex data (see constructor)
+    ///
+    /// @param stride     Number of floats between 2 successive vertices
+    ///
+    /// @param bezierPatches  Optional Bezier form of the patches (see
+    ///                   constructor)
+    ///
+    void Refit( float const * positions, int stride,
+                BezierPatchCache const * bezierPatches=0 );
+
+    /// \brief Returns the PatchTables the hierarchy was built from
+    PatchTables const & GetPatchTables() const { return *_patchTables; }
+
+    /// \brief Returns the number of patches in the hierarchy
+    int GetNumPatches() const { return (int)_handles.size(); }
+
+    /// \brief Returns the number of nodes in the hierarchy
+    int GetNumNodes() const { return (int)_nodes.size(); }
+
+    /// \brief Returns the bounds of the whole hierarchy
+    void GetBounds( float bmin[3], float bmax[3] ) const;
+
+    /// \brief Visits the patches whose bounds are intersected by a ray, in
+    /// approximate front-to-back order.
+    ///
+    /// The visitor is called as 'float visitor(Handle const & handle, float tmax)'
+    /// and returns the new maximum ray parameter : returning the parameter of
+    /// a hit found on the patch allows the traversal to cull every node that
+    /// lies behind it.
+    ///
+    /// @param origin     Origin of the ray
+    ///
+    /// @param direction  Direction of the ray (does not need to be normalized)
+    ///
+    /// @param tmin       Minimum ray parameter
+    ///
+    /// @param tmax       Maximum ray parameter
+    ///
+    /// @param visitor    Functor called for every candidate patch
+    ///
+    template <class VISITOR>
+    void TraverseRay( float const origin[3], float const direction[3],
+                      float tmin, float tmax, VISITOR & visitor ) const;
+
+    /// \brief Visits the patches whose bounds are within a given distance of
+    /// a point, nearest bounds first.
+    ///
+    /// The visitor is called as 'float visitor(Handle const & handle, float maxDist)'
+    /// and returns the new maximum distance : returning the distance to the
+    /// closest point found so far culls every node that is further away.
+    ///
+    /// @param point    Location of the query
+    ///
+    /// @param maxDist  Maximum distance to the point
+    ///
+    /// @param visitor  Functor called for every candidate patch
+    ///
+    template <class VISITOR>
+    void TraversePoint( float const point[3], float maxDist,
+                        VISITOR & visitor ) const;
+
+private:
+
+    // Axis-aligned box
+    struct Bounds {
+
+        void Clear();
+
+        void Extend( float const * p );
+
+        void Extend( Bounds const & b );
+
+        float min[3],
+              max[3];
+    };
+
+    // Nodes are stored in depth-first order : the first child of an interior
+    // node immediately follows its parent, which guarantees that children are
+    // always stored after their parent.
+    struct Node {
+
+        bool IsLeaf() const { return count>0; }
+
+        Bounds bounds;
+
+        int index, // index of the first patch (leaf) or of the second child
+            count; // number of patches in a leaf (0 for interior nodes)
+    };
+
+    void computePatchBounds( Handle const & handle,
+        float const * positions, int stride,
+        BezierPatchCache const * bezierPatches, Bounds & bounds ) const;
+
+    int buildNode( std::vector<Bounds> const & patchBounds,
+        std::vector<float> const & centroids, int first, int count );
+
+    // returns the entry parameter of the ray into the box, or -1 on a miss
+    static float intersect( Bounds const & bounds, float const origin[3],
+        float const invdir[3], float tmin, float tmax );
+
+    // returns the squared distance between a point and a box
+    static float distanceSq( Bounds const & bounds, float const point[3] );
+
+private:
+
+    PatchTables const * _patchTables;
+
+    int _maxLeafSize;
+
+    std::vector<Handle> _handles; // patch handles sorted by leaf
+    std::vector<Node>   _nodes;   // depth-first hierarchy
+};
+
+template <class VISITOR> void
+PatchBVH::TraverseRay( float const origin[3], float const direction[3],
+    float tmin, float tmax, VISITOR & visitor ) const {
+
+    if (_nodes.empty()) {
+        return;
+    }
+
+    float invdir[3];
+    for (int k=0; k<3; ++k) {
+        // infinite values are handled properly by the slab test
+        invdir[k] = 1.0f / direction[k];
+    }
+
+    if (intersect(_nodes[0].bounds, origin, invdir, tmin, tmax) < 0.0f) {
+        return;
+    }
+
+    // stack of nodes & their entry parameters
+    std::pair<int, float> stack[64];
+    int depth = 0;
+    stack[depth++] = std::make_pair(0, tmin);
+
+    while (depth>0) {
+
+        std::pair<int, float> const entry = stack[--depth];
+        if (entry.second > tmax) {
+            continue;
+        }
+
+        Node const & node = _nodes[entry.first];
+
+        if (node.IsLeaf()) {
+            for (int i=0; i<node.count; ++i) {
+                tmax = std::min(tmax, visitor(_handles[node.index+i], tmax));
+            }
+        } else {
+
+            int child0 = entry.first+1,
+                child1 = node.index;
+
+            float t0 = intersect(_nodes[child0].bounds, origin, invdir, tmin, tmax),
+                  t1 = intersect(_nodes[child1].bounds, origin, invdir, tmin, tmax);
+
+            if (t1>=0.0f and t0>=0.0f and t1<t0) {
+                std::swap(child0, child1);
+                std::swap(t0, t1);
+            }
+
+            // push the furthest child first so that the nearest is visited
+            // first
+            assert(depth+2 <= 64);
+            if (t1>=0.0f) {
+                stack[depth++] = std::make_pair(child1, t1);
+            }
+            if (t0>=0.0f) {
+                stack[depth++] = std::make_pair(child0, t0);
+            }
+        }
+    }
+}
+
+template <class VISITOR> void
+PatchBVH::TraversePoint( float const point[3], float maxDist,
+    VISITOR & visitor ) const {
+
+    if (_nodes.empty()) {
+        return;
+    }
+
+    float maxDistSq = maxDist * maxDist;
+
+    // stack of nodes & their squared distances
+    std::pair<int, float> stack[64];
+    int depth = 0;
+    stack[depth++] = std::make_pair(0, distanceSq(_nodes[0].bounds, point));
+
+    while (depth>0) {
+
+        std::pair<int, float> const entry = stack[--depth];
+        if (entry.second > maxDistSq) {
+            continue;
+        }
+
+        Node const & node = _nodes[entry.first];
+
+        if (node.IsLeaf()) {
+            for (int i=0; i<node.count; ++i) {
+                float dist = visitor(_handles[node.index+i], maxDist);
+                if (dist < maxDist) {
+                    maxDist = dist;
+                    maxDistSq = dist * dist;
+                }
+            }
+        } else {
+
+            int child0 = entry.first+1,
+                child1 = node.index;
+
+            float d0 = distanceSq(_nodes[child0].bounds, point),
+                  d1 = distanceSq(_nodes[child1].bounds, point);
+
+            if (d1<d0) {
+                std::swap(child0, child1);
+                std::swap(d0, d1);
+            }
+
+            assert(depth+2 <= 64);
+            if (d1<=maxDistSq) {
+                stack[depth++] = std::make_pair(child1, d1);
+            }
+            if (d0<=maxDistSq) {
+                stack[depth++] = std::make_pair(child0, d0);
+            }
+        }
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif /* FAR_PATCH_BVH_H */
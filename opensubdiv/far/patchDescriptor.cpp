@@ -84,9 +84,11 @@ getAdaptiveLoopDescriptors() {
     static PatchDescriptorVector _descriptors;
 
     if (_descriptors.empty()) {
-        _descriptors.reserve(1);
+        _descriptors.reserve(2);
         _descriptors.push_back(
             PatchDescriptor(PatchDescriptor::LOOP, PatchDescriptor::NON_TRANSITION, 0) );
+        _descriptors.push_back(
+            PatchDescriptor(PatchDescriptor::LOOP_BASIS, PatchDescriptor::NON_TRANSITION, 0) );
     }
     return _descriptors;
 }
@@ -48,6 +48,10 @@ namespace Far {
 ///   These bicubic patches are also further distinguished by a transition
 ///   pattern as well as a rotational orientation.
 ///
+/// * Adaptively subdivided Loop meshes contain quartic box-spline triangles of
+///   type LOOP (boundaries are identified by their PatchParam) and quartic
+///   Bezier triangles of type LOOP_BASIS around extraordinary vertices.
+///
 /// Bitfield layout :
 ///
 ///  Field      | Bits | Content
@@ -69,7 +73,7 @@ public:
         QUADS,             ///< bilinear quads-only patches
         TRIANGLES,         ///< bilinear triangles-only mesh
 
-        LOOP,              ///< Loop patch
+        LOOP,              ///< Loop patch (quartic box-spline triangle)
 
         REGULAR,           ///< feature-adaptive bicubic patches
         SINGLE_CREASE,
@@ -77,7 +81,8 @@ public:
         CORNER,
         GREGORY,
         GREGORY_BOUNDARY,
-        GREGORY_BASIS
+        GREGORY_BASIS,
+        LOOP_BASIS         ///< Loop end-cap (quartic Bezier triangle)
     };
 
     enum TransitionPattern {
@@ -151,6 +156,12 @@ public:
     /// \brief Number of control vertices of Gregory patch basis (20)
     static short GetGregoryBasisPatchSize() { return 20; }
 
+    /// \brief Number of control vertices of Loop Patches in table.
+    static short GetLoopPatchSize() { return 12; }
+
+    /// \brief Number of control vertices of Loop patch basis (15)
+    static short GetLoopBasisPatchSize() { return 15; }
+
 
     /// \brief Returns a vector of all the legal patch descriptors for the
     ///        given adaptive subdivision scheme
@@ -184,6 +195,8 @@ PatchDescriptor::GetNumControlVertices( Type type ) {
         case GREGORY_BASIS     : return GetGregoryBasisPatchSize();
         case BOUNDARY          : return GetBoundaryPatchSize();
         case CORNER            : return GetCornerPatchSize();
+        case LOOP              : return GetLoopPatchSize();
+        case LOOP_BASIS        : return GetLoopBasisPatchSize();
         case TRIANGLES         : return 3;
         case LINES             : return 2;
         case POINTS            : return 1;
@@ -203,6 +216,8 @@ PatchDescriptor::GetNumFVarControlVertices( Type type ) {
         case GREGORY_BASIS     :
         case BOUNDARY          :
         case CORNER            : return 4;
+        case LOOP              :
+        case LOOP_BASIS        :
         case TRIANGLES         : return 3;
         case LINES             : return 2;
         case POINTS            : return 1;
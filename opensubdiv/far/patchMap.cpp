@@ -30,7 +30,7 @@ namespace OPENSUBDIV_VERSION {
 namespace Far {
 
 // Constructor
-PatchMap::PatchMap( PatchTables const & patchTables ) {
+PatchMap::PatchMap( PatchTables const & patchTables ) : _triangles(false) {
     initialize( patchTables );
 }
 
@@ -77,9 +77,14 @@ PatchMap::initialize( PatchTables const & patchTables ) {
 
     for (int parray=0, current=0; parray<narrays; ++parray) {
 
-        ConstPatchParamArray params = patchTables.GetPatchParams(parray);
+        PatchDescriptor desc = patchTables.GetPatchArrayDescriptor(parray);
 
-        int ringsize = patchTables.GetPatchArrayDescriptor(parray).GetNumControlVertices();
+        int ringsize = desc.GetNumControlVertices();
+
+        if (desc.GetType()==PatchDescriptor::LOOP or
+            desc.GetType()==PatchDescriptor::LOOP_BASIS) {
+            _triangles = true;
+        }
 
         for (Index j=0; j < patchTables.GetNumPatches(parray); ++j) {
 
@@ -89,7 +94,7 @@ PatchMap::initialize( PatchTables const & patchTables ) {
             h.patchIndex = current;
             h.vertIndex  = j * ringsize;
 
-            nfaces = std::max(nfaces, (int)params[j].faceIndex);
+            nfaces = std::max(nfaces, (int)patchTables.GetPatchParam(parray, j).faceIndex);
 
             ++current;
         }
@@ -107,15 +112,15 @@ PatchMap::initialize( PatchTables const & patchTables ) {
     // populate the quadtree from the FarPatchArrays sub-patches
     for (Index parray=0, handleIndex=0; parray<narrays; ++parray) {
 
-        ConstPatchParamArray params = patchTables.GetPatchParams(parray);
-
         for (int i=0; i < patchTables.GetNumPatches(parray); ++i, ++handleIndex) {
 
-            PatchParam::BitField bits = params[i].bitField;
+            PatchParam param = patchTables.GetPatchParam(parray, i);
+
+            PatchParam::BitField bits = param.bitField;
 
             unsigned char depth = bits.GetDepth();
 
-            QuadNode * node = &quadtree[ params[i].faceIndex ];
+            QuadNode * node = &quadtree[ param.faceIndex ];
 
             if (depth==(bits.NonQuadRoot() ? 1 : 0)) {
                 // special case : regular BSpline face w/ no sub-patches
@@ -128,11 +133,21 @@ PatchMap::initialize( PatchTables const & patchTables ) {
                 pdepth = bits.NonQuadRoot() ? depth-2 : depth-1,
                 half = 1 << pdepth;
 
+            if (_triangles) {
+                // locate triangles from their centroid, in thirds of their cell
+                // (the cell of an inverted triangle being its upper half)
+                int ofs = (bits.GetRotation()==2) ? 2 : 1;
+                u = 3*u + ofs;
+                v = 3*v + ofs;
+                half = 3 << pdepth;
+            }
+
             for (unsigned char j=0; j<depth; ++j) {
 
                 int delta = half >> 1;
 
-                int quadrant = resolveQuadrant(half, u, v);
+                int quadrant = _triangles ? resolveTriangle(half, u, v) :
+                                            resolveQuadrant(half, u, v);
                 assert(quadrant>=0);
 
                 half = delta;
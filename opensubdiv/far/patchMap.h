@@ -46,6 +46,10 @@ namespace Far {
 /// parametric location, can efficiently return a handle to the sub-patch that
 /// contains this location.
 ///
+/// The coarse faces of Loop patches are triangles, whose (u,v) domain is split
+/// into the 4 triangles of their refinement -- the corner triangles of the
+/// 3 vertices and the inverted center triangle.
+///
 class PatchMap {
 public:
 
@@ -115,6 +119,32 @@ private:
     //
     template <class T> static int resolveQuadrant(T & median, T & u, T & v);
 
+    // given a median, transforms the (u,v) to the child triangle they point to,
+    // and return the index of the child triangle.
+    //
+    // Triangles indexing (3 is inverted : its (u,v) origin is the opposite
+    // corner of the square, and its axes are reversed):
+    //
+    //   (0,0) o-------o-------o (1,0)
+    //         |      /|      /
+    //         |  0  / |  1  /
+    //         |    /  |    /
+    //         |   /   |   /
+    //         |  /  3 |  /
+    //         | /     | /
+    //         o-------o
+    //         |      /
+    //         |  2  /
+    //         |    /
+    //         |   /
+    //         |  /
+    //         | /
+    //   (0,1) o
+    //
+    template <class T> static int resolveTriangle(T & median, T & u, T & v);
+
+    bool                  _triangles; // true if the patches are triangles (Loop)
+
     std::vector<Handle>   _handles;  // all the patches in the PatchTable
     std::vector<QuadNode> _quadtree; // quadtree nodes
 };
@@ -144,6 +174,28 @@ PatchMap::resolveQuadrant(T & median, T & u, T & v) {
     return quadrant;
 }
 
+// given a median, transforms the (u,v) to the child triangle they point to,
+// and return the index of the child triangle.
+template <class T> int
+PatchMap::resolveTriangle(T & median, T & u, T & v) {
+    int triangle = -1;
+
+    if (u>=median) {
+        triangle = 1;
+        u-=median;
+    } else if (v>=median) {
+        triangle = 2;
+        v-=median;
+    } else if ((u+v)<median) {
+        triangle = 0;
+    } else {
+        triangle = 3;
+        u = median-u;
+        v = median-v;
+    }
+    return triangle;
+}
+
 /// Returns a handle to the sub-patch of the face at the given (u,v).
 inline PatchMap::Handle const *
 PatchMap::FindPatch( int faceid, float u, float v ) const {
@@ -162,7 +214,8 @@ PatchMap::FindPatch( int faceid, float u, float v ) const {
 
         float delta = half * 0.5f;
 
-        int quadrant = resolveQuadrant( half, u, v );
+        int quadrant = _triangles ? resolveTriangle( half, u, v ) :
+                                    resolveQuadrant( half, u, v );
         assert(quadrant>=0);
 
         // is the quadrant a hole ?
@@ -53,7 +53,12 @@ namespace Far {
 ///  rotation   | 2    | patch rotations necessary to match CCW face-winding
 ///  v          | 10   | log2 value of u parameter at first patch corner
 ///  u          | 10   | log2 value of v parameter at first patch corner
-///  reserved1  | 5    | padding
+///  boundary   | 4    | boundary edges (or vertex) of a Loop patch
+///  reserved1  | 1    | padding
+///
+/// Loop patches are triangles : their (u,v) identify the cell of the triangular
+/// sub-patch in the ptex face and the rotation is 2 for the sub-patches whose
+/// orientation is inverted with respect to the ptex face.
 ///
 /// Note : the bitfield is not expanded in the struct due to differences in how
 ///        GPU & CPU compilers pack bit-fields and endian-ness.
@@ -89,6 +94,27 @@ struct PatchParam {
         /// \brief True if the parent coarse face is a non-quad
         bool NonQuadRoot() const { return (field >> 4) & 0x1; }
 
+        /// \brief Sets the boundary of a Loop patch
+        ///
+        /// @param mask        mask of the boundary edges of the patch (edge i
+        ///                    from vertex i), or of its boundary vertices
+        ///
+        /// @param vertexMask  true if the mask refers to vertices (a boundary
+        ///                    vertex without boundary edges)
+        ///
+        void SetBoundary( unsigned char mask, bool vertexMask ) {
+            field = (field & ~(0xfu << 27)) |
+                    ((unsigned int)(mask & 0x7) << 27) |
+                    ((vertexMask ? 1u:0u) << 30);
+        }
+
+        /// \brief Returns the mask of the boundary edges of a Loop patch (or of
+        /// its boundary vertices, see IsBoundaryVertexMask())
+        unsigned char GetBoundary() const { return (unsigned char)((field >> 27) & 0x7); }
+
+        /// \brief True if the boundary mask of a Loop patch refers to vertices
+        bool IsBoundaryVertexMask() const { return (field >> 30) & 0x1; }
+
         /// \brief Returns the fratcion of normalized parametric space covered by the
         /// sub-patch.
         float GetParamFraction() const;
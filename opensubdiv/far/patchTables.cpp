@@ -25,6 +25,9 @@
 #include "../far/patchTables.h"
 #include "../far/stencilTables.h"
 
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
 
 namespace OpenSubdiv {
@@ -50,14 +53,15 @@ getBezierWeights(float t, float point[4], float deriv[3]) {
     point[2] = 3.0f * t2 * w0;
     point[3] = t * t2;
 
-    // The weights for the three uniform quadratic basis functions are:
-    // (1-t)^2
-    // 2 * t * (1-t)
-    // t^2
+    // The derivative weights are the three quadratic Bernstein polynomials
+    // scaled by the degree of the curve:
+    // 3 * (1-t)^2
+    // 3 * 2 * t * (1-t)
+    // 3 * t^2
     if (deriv) {
-        deriv[0] = w2;
-        deriv[1] = 2.0f * t * w0;
-        deriv[2] = t2;
+        deriv[0] = 3.0f * w2;
+        deriv[1] = 6.0f * t * w0;
+        deriv[2] = 3.0f * t2;
     }
 }
 
@@ -91,55 +95,263 @@ getBSplineWeights(float t, float point[4], float deriv[3]) {
     }
 }
 
-void
-getBoxSplineWeights(float v, float w, float B[12]) {
+//
+//  The 12 quartic box-spline basis functions of a regular Loop patch, as polynomials
+//  of the (s,t) coordinates of the triangle (scaled by their common factor of 12).
+//  The control vertices follow the ordering of Vtr::Level::gatherTriRegularPatchVertices()
+//  and the monomials are ordered by degree:
+//
+//      1, s, t, s^2, st, t^2, s^3, s^2t, st^2, t^3, s^4, s^3t, s^2t^2, st^3, t^4
+//
+static short const loopBoxSplineCoefficients[12][15] = {
+    {  6,  0,  0,-12,-12,-12,  8, 12, 12,  8, -1, -2,  0, -2, -1 },
+    {  1,  4,  2,  6,  6,  0, -4, -6,-12, -4, -1, -2,  0,  4,  2 },
+    {  1,  2,  4,  0,  6,  6, -4,-12, -6, -4,  2,  4,  0, -2, -1 },
+    {  1, -2, -4,  0,  6,  6,  2,  0, -6, -4, -1, -2,  0,  2,  1 },
+    {  1,  2, -2,  0, -6,  0, -4,  0,  6,  2,  2,  4,  0, -2, -1 },
+    {  0,  0,  0,  0,  0,  0,  2,  0,  0,  0, -1, -2,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  2,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  2,  6,  6,  2, -1, -2,  0, -2, -1 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  2,  1 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  2,  0,  0,  0, -2, -1 },
+    {  1, -2,  2,  0, -6,  0,  2,  6,  0, -4, -1, -2,  0,  4,  2 },
+    {  1, -4, -2,  6,  6,  0, -4, -6,  0,  2,  1,  2,  0, -2, -1 } };
+
+static void
+getLoopBoxSplineWeights(float s, float t, float point[12], float deriv1[12], float deriv2[12]) {
+
+    float s2 = s*s, s3 = s*s2,
+          t2 = t*t, t3 = t*t2;
+
+    float const m[15] = { 1.0f, s, t, s2, s*t, t2, s3, s2*t, s*t2, t3,
+                          s*s3, s3*t, s2*t2, s*t3, t*t3 };
+
+    float const ds[15] = { 0.0f, 1.0f, 0.0f, 2.0f*s, t, 0.0f, 3.0f*s2, 2.0f*s*t, t2, 0.0f,
+                           4.0f*s3, 3.0f*s2*t, 2.0f*s*t2, t3, 0.0f };
+
+    float const dt[15] = { 0.0f, 0.0f, 1.0f, 0.0f, s, 2.0f*t, 0.0f, s2, 2.0f*s*t, 3.0f*t2,
+                           0.0f, s3, 2.0f*s2*t, 3.0f*s*t2, 4.0f*t3 };
+
+    for (int i=0; i<12; ++i) {
+        short const * c = loopBoxSplineCoefficients[i];
+
+        float w=0.0f, d1=0.0f, d2=0.0f;
+        for (int j=0; j<15; ++j) {
+            w  += c[j] * m[j];
+            d1 += c[j] * ds[j];
+            d2 += c[j] * dt[j];
+        }
+        if (point) point[i] = w / 12.0f;
+        if (deriv1 and deriv2) {
+            deriv1[i] = d1 / 12.0f;
+            deriv2[i] = d2 / 12.0f;
+        }
+    }
+}
+
+//
+//  The control vertices of a Loop patch missing on its boundaries are defined from the
+//  others so that the box-spline reproduces the boundary rules of the Loop scheme.  The
+//  rules are expressed for the canonical boundaries (edge 0, vertex 0 and the corner at
+//  vertex 0), which are rotated to the other edges and vertices of the triangle:
+//
+namespace {
+    struct LoopPhantomRule {
+        int   phantom;
+        int   points[3];
+        float weights[3];
+    };
+
+    LoopPhantomRule const loopEdgeRules[3] = {
+        { 3, { 11,  0, 10 }, { 1.0f, 1.0f, -1.0f } },
+        { 4, {  0,  1,  2 }, { 1.0f, 1.0f, -1.0f } },
+        { 5, {  1,  6,  7 }, { 1.0f, 1.0f, -1.0f } } };
+
+    LoopPhantomRule const loopVertexRules[2] = {
+        { 11, { 10,  0,  2 }, { 1.0f, 1.0f, -1.0f } },
+        {  3, {  0,  4,  1 }, { 1.0f, 1.0f, -1.0f } } };
+
+    LoopPhantomRule const loopCornerRules[6] = {
+        {  4, {  0,  1,  2 }, { 1.0f, 1.0f, -1.0f } },
+        {  5, {  1,  6,  7 }, { 1.0f, 1.0f, -1.0f } },
+        { 10, {  0,  2,  1 }, { 1.0f, 1.0f, -1.0f } },
+        {  9, {  2,  8,  7 }, { 1.0f, 1.0f, -1.0f } },
+        {  3, {  0,  2,  0 }, { 2.0f,-1.0f,  0.0f } },
+        { 11, {  0,  1,  0 }, { 2.0f,-1.0f,  0.0f } } };
+
+    // Control vertex of the patch rotated from vertex i to vertex i+1
+    int const loopRotation[12] = { 1, 2, 0, 6, 7, 8, 9, 10, 11, 3, 4, 5 };
+
+    inline int
+    rotateLoopPoint(int point, int rotation) {
+        for (int i=0; i<rotation; ++i) {
+            point = loopRotation[point];
+        }
+        return point;
+    }
 
-    float u = 1.0f - v - w;
+    inline void
+    foldLoopPhantomWeights(LoopPhantomRule const * rules, int nrules, int rotation,
+        float * weights) {
 
+        if (not weights) {
+            return;
+        }
+        for (int i=0; i<nrules; ++i) {
+            int phantom = rotateLoopPoint(rules[i].phantom, rotation);
+            for (int j=0; j<3; ++j) {
+                weights[rotateLoopPoint(rules[i].points[j], rotation)] +=
+                    rules[i].weights[j] * weights[phantom];
+            }
+            weights[phantom] = 0.0f;
+        }
+    }
+
+    inline void
+    foldLoopBoundaryWeights(PatchParam::BitField bits,
+        float * point, float * deriv1, float * deriv2) {
+
+        int mask = bits.GetBoundary();
+        if (mask==0) {
+            return;
+        }
+
+        LoopPhantomRule const * rules = 0;
+        int nrules = 0, rotation = 0;
+        if (bits.IsBoundaryVertexMask()) {
+            rules = loopVertexRules, nrules = 2;
+            rotation = (mask==1) ? 0 : ((mask==2) ? 1 : 2);
+        } else {
+            switch (mask) {
+                case 1 : rules = loopEdgeRules, nrules = 3, rotation = 0; break;
+                case 2 : rules = loopEdgeRules, nrules = 3, rotation = 1; break;
+                case 4 : rules = loopEdgeRules, nrules = 3, rotation = 2; break;
+                case 5 : rules = loopCornerRules, nrules = 6, rotation = 0; break;
+                case 3 : rules = loopCornerRules, nrules = 6, rotation = 1; break;
+                case 6 : rules = loopCornerRules, nrules = 6, rotation = 2; break;
+                default:
+                    assert(0);
+            }
+        }
+        foldLoopPhantomWeights(rules, nrules, rotation, point);
+        foldLoopPhantomWeights(rules, nrules, rotation, deriv1);
+        foldLoopPhantomWeights(rules, nrules, rotation, deriv2);
+    }
+
+    //
+    //  Triangular patches are rotated by 2 when their orientation is inverted with respect
+    //  to the ptex face : derivatives are flipped back, and scaled up based on the level of
+    //  subdivision
     //
-    //  The 12 basis functions of the quartic box spline (unscaled by their common
-    //  factor of 1/12 until later, and formatted to make it easy to spot any
-    //  typing errors):
+    inline void
+    adjustTriangleDerivatives(PatchParam::BitField bits, int n,
+        float * deriv1, float * deriv2) {
+
+        float scale = float(1 << bits.GetDepth());
+        if (bits.GetRotation()==2) {
+            scale = -scale;
+        } else {
+            assert(bits.GetRotation()==0);
+        }
+        for (int k=0; k<n; ++k) {
+            deriv1[k] *= scale;
+            deriv2[k] *= scale;
+        }
+    }
+}
+
+static void
+getLoopBezierWeights(float s, float t, float point[15], float deriv1[15], float deriv2[15]) {
+
     //
-    //      15 terms for the 3 points above the triangle corners
-    //       9 terms for the 3 points on faces opposite the triangle edges
-    //       2 terms for the 6 points on faces opposite the triangle corners
+    //  The 15 quartic Bernstein polynomials B(i,j,k) = 4!/(i!j!k!) w^i s^j t^k, with
+    //  w = 1-s-t, are ordered by rows of increasing k and of increasing j within
+    //  each row
     //
-    //  Powers of each variable for notational convenience:
-    float u2 = u*u;
-    float u3 = u*u2;
-    float u4 = u*u3;
-    float v2 = v*v;
-    float v3 = v*v2;
-    float v4 = v*v3;
-    float w2 = w*w;
-    float w3 = w*w2;
-    float w4 = w*w3;
-
-    //  And now the basis functions:
-    B[ 0] = u4 + 2.0f*u3*v;
-    B[ 1] = u4 + 2.0f*u3*w;
-    B[ 8] = w4 + 2.0f*w3*u;
-    B[11] = w4 + 2.0f*w3*v;
-    B[ 9] = v4 + 2.0f*v3*w;
-    B[ 5] = v4 + 2.0f*v3*u;
-
-    B[ 2] = u4 + 2.0f*u3*w + 6.0f*u3*v + 6.0f*u2*v*w + 12.0f*u2*v2 +
-            v4 + 2.0f*v3*w + 6.0f*v3*u + 6.0f*v2*u*w;
-    B[ 4] = w4 + 2.0f*w3*v + 6.0f*w3*u + 6.0f*w2*u*v + 12.0f*w2*u2 +
-            u4 + 2.0f*u3*v + 6.0f*u3*w + 6.0f*u2*v*w;
-    B[10] = v4 + 2.0f*v3*u + 6.0f*v3*w + 6.0f*v2*w*u + 12.0f*v2*w2 +
-            w4 + 2.0f*w3*u + 6.0f*w3*v + 6.0f*w3*u*v;
-
-    B[ 3] = v4 + 6*v3*w + 8*v3*u + 36*v2*w*u + 24*v2*u2 + 24*v*u3 +
-            w4 + 6*w3*v + 8*w3*u + 36*w2*v*u + 24*w2*u2 + 24*w*u3 + 6*u4 + 60*u2*v*w + 12*v2*w2;
-    B[ 6] = w4 + 6*w3*u + 8*w3*v + 36*w2*u*v + 24*w2*v2 + 24*w*v3 +
-            u4 + 6*u3*w + 8*u3*v + 36*u2*v*w + 24*u2*v2 + 24*u*v3 + 6*v4 + 60*v2*w*u + 12*w2*u2;
-    B[ 7] = u4 + 6*u3*v + 8*u3*w + 36*u2*v*w + 24*u2*w2 + 24*u*w3 +
-            v4 + 6*v3*u + 8*v3*w + 36*v2*u*w + 24*v2*w2 + 24*v*w3 + 6*w4 + 60*w2*u*v + 12*u2*v2;
-
-    for (int i = 0; i < 12; ++i) {
-        B[i] *= 1.0f / 12.0f;
+    float w = 1.0f - s - t;
+
+    float wp[5], sp[5], tp[5];
+    wp[0] = sp[0] = tp[0] = 1.0f;
+    for (int i=1; i<5; ++i) {
+        wp[i] = wp[i-1] * w;
+        sp[i] = sp[i-1] * s;
+        tp[i] = tp[i-1] * t;
+    }
+
+    static float const quarticCoefs[5][5] = { { 1.0f,  4.0f,  6.0f, 4.0f, 1.0f },
+                                              { 4.0f, 12.0f, 12.0f, 4.0f, 0.0f },
+                                              { 6.0f, 12.0f,  6.0f, 0.0f, 0.0f },
+                                              { 4.0f,  4.0f,  0.0f, 0.0f, 0.0f },
+                                              { 1.0f,  0.0f,  0.0f, 0.0f, 0.0f } };
+    if (point) {
+        for (int k=0, idx=0; k<=4; ++k) {
+            for (int j=0; j<=4-k; ++j, ++idx) {
+                point[idx] = quarticCoefs[k][j] * wp[4-j-k] * sp[j] * tp[k];
+            }
+        }
+    }
+
+    if (deriv1 and deriv2) {
+        //  The derivatives are the differences of consecutive points weighted by the
+        //  cubic Bernstein polynomials (scaled by the degree):
+        static float const cubicCoefs[4][4] = { { 1.0f, 3.0f, 3.0f, 1.0f },
+                                                { 3.0f, 6.0f, 3.0f, 0.0f },
+                                                { 3.0f, 3.0f, 0.0f, 0.0f },
+                                                { 1.0f, 0.0f, 0.0f, 0.0f } };
+
+        memset(deriv1, 0, 15*sizeof(float));
+        memset(deriv2, 0, 15*sizeof(float));
+        for (int k=0; k<=3; ++k) {
+            for (int j=0; j<=3-k; ++j) {
+                float b = 4.0f * cubicCoefs[k][j] * wp[3-j-k] * sp[j] * tp[k];
+
+                int idx  = 5*k - (k*(k-1))/2 + j,   // (i+1, j, k)
+                    idxS = idx + 1,                 // (i, j+1, k)
+                    idxT = idx + 5 - k;             // (i, j, k+1)
+
+                deriv1[idxS] += b;
+                deriv1[idx]  -= b;
+                deriv2[idxT] += b;
+                deriv2[idx]  -= b;
+            }
+        }
+    }
+}
+
+void
+PatchTables::GetLoopBasisWeights(PatchParam::BitField bits,
+    float s, float t, float point[12], float deriv1[12], float deriv2[12]) {
+
+    float rs=s, rt=t;
+    bits.Rotate(rs, rt);
+
+    getLoopBoxSplineWeights(rs, rt, point, deriv1, deriv2);
+
+    if (deriv1 and deriv2) {
+        foldLoopBoundaryWeights(bits, point, deriv1, deriv2);
+        adjustTriangleDerivatives(bits, 12, deriv1, deriv2);
+    } else {
+        foldLoopBoundaryWeights(bits, point, 0, 0);
+    }
+}
+
+void
+PatchTables::FoldLoopBoundaryWeights(PatchParam::BitField bits, float weights[12]) {
+
+    foldLoopBoundaryWeights(bits, weights, 0, 0);
+}
+
+void
+PatchTables::GetLoopBezierWeights(PatchParam::BitField bits,
+    float s, float t, float point[15], float deriv1[15], float deriv2[15]) {
+
+    float rs=s, rt=t;
+    bits.Rotate(rs, rt);
+
+    getLoopBezierWeights(rs, rt, point, deriv1, deriv2);
+
+    if (deriv1 and deriv2) {
+        adjustTriangleDerivatives(bits, 15, deriv1, deriv2);
     }
 }
 
@@ -230,8 +442,580 @@ PatchTables::GetBasisWeights(TensorBasis basis, PatchParam::BitField bits,
     }
 }
 
+void
+PatchTables::GetBilinearWeights(PatchParam::BitField bits,
+    float s, float t, float point[4], float deriv1[4], float deriv2[4]) {
+
+    // the corners of the patch are ordered relative to the rotated (s,t)
+    float rs=s, rt=t;
+    bits.Rotate(rs, rt);
+
+    float os = 1.0f - rs,
+          ot = 1.0f - rt;
+
+    if (point) {
+        point[0] = os*ot;
+        point[1] = rs*ot;
+        point[2] = rs*rt;
+        point[3] = os*rt;
+    }
+
+    if (deriv1 and deriv2) {
+
+        float ds[4] = { -ot,  ot, rt, -rt },
+              dt[4] = { -os, -rs, rs,  os };
+
+        // derivatives with respect to the un-rotated (s,t), scaled up based
+        // on level of subdivision
+        float scale = float(1 << bits.GetDepth());
+        for (int k=0; k<4; ++k) {
+            switch (bits.GetRotation()) {
+                case 0 : deriv1[k] =  ds[k]; deriv2[k] =  dt[k]; break;
+                case 1 : deriv1[k] = -dt[k]; deriv2[k] =  ds[k]; break;
+                case 2 : deriv1[k] = -ds[k]; deriv2[k] = -dt[k]; break;
+                case 3 : deriv1[k] =  dt[k]; deriv2[k] = -ds[k]; break;
+                default:
+                    assert(0);
+            }
+            deriv1[k] *= scale;
+            deriv2[k] *= scale;
+        }
+    }
+}
+
+void
+PatchTables::GetLinearWeights(PatchParam::BitField bits,
+    float s, float t, float point[3], float deriv1[3], float deriv2[3]) {
+
+    // the corners of the patch are ordered relative to the rotated (s,t)
+    float rs=s, rt=t;
+    bits.Rotate(rs, rt);
+
+    if (point) {
+        point[0] = 1.0f - rs - rt;
+        point[1] = rs;
+        point[2] = rt;
+    }
+
+    if (deriv1 and deriv2) {
+        deriv1[0] = -1.0f; deriv1[1] = 1.0f; deriv1[2] = 0.0f;
+        deriv2[0] = -1.0f; deriv2[1] = 0.0f; deriv2[2] = 1.0f;
+        adjustTriangleDerivatives(bits, 3, deriv1, deriv2);
+    }
+}
+
+//
+//  Control points of the Gregory patches (GREGORY and GREGORY_BOUNDARY), gathered from
+//  the 1-rings of the corner vertices in the vertex valence table:
+//
+static float const ef[27] = {
+    0.812816f, 0.500000f, 0.363644f, 0.287514f,
+    0.238688f, 0.204544f, 0.179229f, 0.159657f,
+    0.144042f, 0.131276f, 0.120632f, 0.111614f,
+    0.103872f, 0.09715f, 0.0912559f, 0.0860444f,
+    0.0814022f, 0.0772401f, 0.0734867f, 0.0700842f,
+    0.0669851f, 0.0641504f, 0.0615475f, 0.0591488f,
+    0.0569311f, 0.0548745f, 0.0529621f
+};
+
+static inline float
+csf(Index n, Index j) {
+    if (j%2 == 0) {
+        return cosf((2.0f * float(M_PI) * float(float(j-0)/2.0f))/(float(n)+3.0f));
+    } else {
+        return sinf((2.0f * float(M_PI) * float(float(j-1)/2.0f))/(float(n)+3.0f));
+    }
+}
+
+static void
+computeGregoryPoints(Index const * vertexIndices,
+                     Index const * vertexValenceBuffer,
+                     unsigned int const * quadOffsetBuffer,
+                     int maxValence,
+                     float const * inOffset, int stride, int length,
+                     float * points) {
+
+    int valences[4];
+
+    float  *r  = (float*)alloca((maxValence+2)*4*length*sizeof(float)), *rp,
+           *e0 = r + maxValence*4*length,
+           *e1 = e0 + 4*length;
+    memset(r, 0, (maxValence+2)*4*length*sizeof(float));
+
+    float *f=(float*)alloca(maxValence*length*sizeof(float)),
+          *pos=(float*)alloca(length*sizeof(float)),
+          *opos=(float*)alloca(length*4*sizeof(float));
+    memset(opos, 0, length*4*sizeof(float));
+
+    for (int vid=0; vid < 4; ++vid) {
+
+        int vertexID = vertexIndices[vid];
+
+        const int *valenceTable = vertexValenceBuffer + vertexID * (2*maxValence+1);
+        int valence = abs(*valenceTable);
+        assert(valence<=maxValence);
+        valences[vid] = valence;
+
+        memcpy(pos, inOffset + vertexID*stride, length*sizeof(float));
+
+        rp=r+vid*maxValence*length;
+
+        int vofs = vid*length;
+
+        for (int i=0; i<valence; ++i) {
+            Index im = (i+valence-1)%valence,
+                       ip = (i+1)%valence;
+
+            int idx_neighbor   = valenceTable[2*i  + 0 + 1];
+            int idx_diagonal   = valenceTable[2*i  + 1 + 1];
+            int idx_neighbor_p = valenceTable[2*ip + 0 + 1];
+            int idx_neighbor_m = valenceTable[2*im + 0 + 1];
+            int idx_diagonal_m = valenceTable[2*im + 1 + 1];
+
+            float const * neighbor   = inOffset + idx_neighbor   * stride;
+            float const * diagonal   = inOffset + idx_diagonal   * stride;
+            float const * neighbor_p = inOffset + idx_neighbor_p * stride;
+            float const * neighbor_m = inOffset + idx_neighbor_m * stride;
+            float const * diagonal_m = inOffset + idx_diagonal_m * stride;
+
+            float  *fp = f+i*length;
+
+            for (int k=0; k<length; ++k) {
+                fp[k] = (pos[k]*float(valence) + (neighbor_p[k]+neighbor[k])*2.0f + diagonal[k])/(float(valence)+5.0f);
+
+                opos[vofs+k] += fp[k];
+                rp[i*length+k] =(neighbor_p[k]-neighbor_m[k])/3.0f + (diagonal[k]-diagonal_m[k])/6.0f;
+            }
+
+        }
+
+        for (int k=0; k<length; ++k) {
+            opos[vofs+k] /= valence;
+        }
+
+        for (int i=0; i<valence; ++i) {
+            int im = (i+valence-1)%valence;
+            for (int k=0; k<length; ++k) {
+                float e = 0.5f*(f[i*length+k]+f[im*length+k]);
+                e0[vofs+k] += csf(valence-3, 2*i) * e;
+                e1[vofs+k] += csf(valence-3, 2*i+1) * e;
+            }
+        }
+
+        for (int k=0; k<length; ++k) {
+            e0[vofs+k] *= ef[valence-3];
+            e1[vofs+k] *= ef[valence-3];
+        }
+    }
+
+    // Control Vertices based on :
+    // "Approximating Subdivision Surfaces with Gregory Patches for Hardware Tessellation"
+    // Loop, Schaefer, Ni, Castafio (ACM ToG Siggraph Asia 2009)
+    //
+    //  P3         e3-      e2+         E2
+    //     O--------O--------O--------O
+    //     |        |        |        |
+    //     |        |        |        |
+    //     |        | f3-    | f2+    |
+    //     |        O        O        |
+    // e3+ O------O            O------O e2-
+    //     |     f3+          f2-     |
+    //     |                          |
+    //     |                          |
+    //     |      f0-         f1+     |
+    // e0- O------O            O------O e1+
+    //     |        O        O        |
+    //     |        | f0+    | f1-    |
+    //     |        |        |        |
+    //     |        |        |        |
+    //     O--------O--------O--------O
+    //  P0         e0+      e1-         E1
+    //
+
+    float *Ep=(float*)alloca(length*4*sizeof(float)),
+          *Em=(float*)alloca(length*4*sizeof(float)),
+          *Fp=(float*)alloca(length*4*sizeof(float)),
+          *Fm=(float*)alloca(length*4*sizeof(float));
+
+    for (int vid=0; vid<4; ++vid) {
+
+        int ip = (vid+1)%4;
+        int im = (vid+3)%4;
+        int n = valences[vid];
+        unsigned int const *quadOffsets = quadOffsetBuffer;
+
+        int start = quadOffsets[vid] & 0x00ff;
+        int prev = (quadOffsets[vid] & 0xff00) / 256;
+
+        for (int k=0, ofs=vid*length; k<length; ++k, ++ofs) {
+
+            Ep[ofs] = opos[ofs] + e0[ofs] * csf(n-3, 2*start) + e1[ofs]*csf(n-3, 2*start +1);
+            Em[ofs] = opos[ofs] + e0[ofs] * csf(n-3, 2*prev ) + e1[ofs]*csf(n-3, 2*prev + 1);
+        }
+
+        Index np = valences[ip],
+                   nm = valences[im];
+
+        Index prev_p = (quadOffsets[ip] & 0xff00) / 256,
+                   start_m = quadOffsets[im] & 0x00ff;
+
+        float *Em_ip=(float*)alloca(length*sizeof(float)),
+              *Ep_im=(float*)alloca(length*sizeof(float));
+
+        for (int k=0, ipofs=ip*length, imofs=im*length; k<length; ++k, ++ipofs, ++imofs) {
+            Em_ip[k] = opos[ipofs] + e0[ipofs]*csf(np-3, 2*prev_p)  + e1[ipofs]*csf(np-3, 2*prev_p+1);
+            Ep_im[k] = opos[imofs] + e0[imofs]*csf(nm-3, 2*start_m) + e1[imofs]*csf(nm-3, 2*start_m+1);
+        }
+
+        float s1 = 3.0f - 2.0f*csf(n-3,2)-csf(np-3,2),
+              s2 = 2.0f*csf(n-3,2),
+              s3 = 3.0f -2.0f*cosf(2.0f*float(M_PI)/float(n)) - cosf(2.0f*float(M_PI)/float(nm));
+
+        rp = r + vid*maxValence*length;
+        for (int k=0, ofs=vid*length; k<length; ++k, ++ofs) {
+            Fp[ofs] = (csf(np-3,2)*opos[ofs] + s1*Ep[ofs] + s2*Em_ip[k] + rp[start*length+k])/3.0f;
+            Fm[ofs] = (csf(nm-3,2)*opos[ofs] + s3*Em[ofs] + s2*Ep_im[k] - rp[prev*length+k])/3.0f;
+        }
+    }
+    for (int vid=0, ofs=0; vid<4; ++vid, ofs+=length) {
+        memcpy(points + (vid*5+0)*length, opos + ofs, length*sizeof(float));
+        memcpy(points + (vid*5+1)*length,   Ep + ofs, length*sizeof(float));
+        memcpy(points + (vid*5+2)*length,   Em + ofs, length*sizeof(float));
+        memcpy(points + (vid*5+3)*length,   Fp + ofs, length*sizeof(float));
+        memcpy(points + (vid*5+4)*length,   Fm + ofs, length*sizeof(float));
+    }
+}
+
+static void
+computeGregoryBoundaryPoints(Index const * vertexIndices,
+                             Index const * vertexValenceBuffer,
+                             unsigned int const * quadOffsetBuffer,
+                             int maxValence,
+                             float const * inOffset, int stride, int length,
+                             float * points) {
+
+    int valences[4], zerothNeighbors[4];
+
+    float  *r  = (float*)alloca((maxValence+2)*4*length*sizeof(float)), *rp,
+           *e0 = r + maxValence*4*length,
+           *e1 = e0 + 4*length;
+    memset(r, 0, (maxValence+2)*4*length*sizeof(float));
+
+    float *f=(float*)alloca(maxValence*length*sizeof(float)),
+          *org=(float*)alloca(length*4*sizeof(float)),
+          *opos=(float*)alloca(length*4*sizeof(float));
+
+    memset(opos, 0, length*4*sizeof(float));
+
+    for (int vid=0; vid < 4; ++vid) {
+
+        int vertexID = vertexIndices[vid];
+
+        const int *valenceTable = vertexValenceBuffer + vertexID * (2*maxValence+1);
+        int valence = *valenceTable,
+            ivalence = abs(valence);
+
+        assert(ivalence<=maxValence);
+        valences[vid] = valence;
+
+        int vofs = vid * length;
+
+        float *pos=org + vofs;
+        memcpy(pos, inOffset + vertexID*stride, length*sizeof(float));
+
+        int boundaryEdgeNeighbors[2];
+        Index currNeighbor = 0,
+                   ibefore=0,
+                   zerothNeighbor=0;
+
+        rp=r+vid*maxValence*length;
+
+        for (int i=0; i<ivalence; ++i) {
+            Index im = (i+ivalence-1)%ivalence,
+                       ip = (i+1)%ivalence;
+
+            int idx_neighbor   = valenceTable[2*i  + 0 + 1];
+            int idx_diagonal   = valenceTable[2*i  + 1 + 1];
+            int idx_neighbor_p = valenceTable[2*ip + 0 + 1];
+            int idx_neighbor_m = valenceTable[2*im + 0 + 1];
+            int idx_diagonal_m = valenceTable[2*im + 1 + 1];
+
+            int valenceNeighbor = vertexValenceBuffer[idx_neighbor * (2*maxValence+1)];
+            if (valenceNeighbor < 0) {
+
+                if (currNeighbor<2) {
+                    boundaryEdgeNeighbors[currNeighbor] = idx_neighbor;
+                }
+                currNeighbor++;
+
+                if (currNeighbor == 1)    {
+                    ibefore = i;
+                    zerothNeighbor = i;
+                } else {
+                    if (i-ibefore == 1) {
+                        int tmp = boundaryEdgeNeighbors[0];
+                        boundaryEdgeNeighbors[0] = boundaryEdgeNeighbors[1];
+                        boundaryEdgeNeighbors[1] = tmp;
+                        zerothNeighbor = i;
+                    }
+                }
+            }
+
+            float const * neighbor   = inOffset + idx_neighbor   * stride;
+            float const * diagonal   = inOffset + idx_diagonal   * stride;
+            float const * neighbor_p = inOffset + idx_neighbor_p * stride;
+            float const * neighbor_m = inOffset + idx_neighbor_m * stride;
+            float const * diagonal_m = inOffset + idx_diagonal_m * stride;
+
+            float *fp = f+i*length;
+
+            for (int k=0; k<length; ++k) {
+                fp[k] = (pos[k]*float(ivalence) + (neighbor_p[k]+neighbor[k])*2.0f + diagonal[k])/(float(ivalence)+5.0f);
+
+                opos[vofs+k] += fp[k];
+                rp[i*length+k] =(neighbor_p[k]-neighbor_m[k])/3.0f + (diagonal[k]-diagonal_m[k])/6.0f;
+            }
+        }
+
+        for (int k=0; k<length; ++k) {
+            opos[vofs+k] /= ivalence;
+        }
+
+        zerothNeighbors[vid] = zerothNeighbor;
+
+        if (currNeighbor == 1) {
+            boundaryEdgeNeighbors[1] = boundaryEdgeNeighbors[0];
+        }
+
+        for (int i=0; i<ivalence; ++i) {
+            Index im = (i+ivalence-1)%ivalence;
+            for (int k=0; k<length; ++k) {
+                float e = 0.5f*(f[i*length+k]+f[im*length+k]);
+                e0[vofs+k] += csf(ivalence-3, 2*i  ) * e;
+                e1[vofs+k] += csf(ivalence-3, 2*i+1) * e;
+            }
+        }
+
+        for (int k=0; k<length; ++k) {
+            e0[vofs+k] *= ef[ivalence-3];
+            e1[vofs+k] *= ef[ivalence-3];
+        }
+
+        if (valence<0) {
+            if (ivalence>2) {
+                for (int k=0; k<length; ++k) {
+                    opos[vofs+k] = (inOffset[boundaryEdgeNeighbors[0]*stride+k] +
+                                    inOffset[boundaryEdgeNeighbors[1]*stride+k] + 4.0f*pos[k])/6.0f;
+                }
+            } else {
+                memcpy(opos+vofs, pos, length*sizeof(float));
+            }
+
+            float k = float(float(ivalence) - 1.0f);    //k is the number of faces
+            float c = cosf(float(M_PI)/k);
+            float s = sinf(float(M_PI)/k);
+            float gamma = -(4.0f*s)/(3.0f*k+c);
+            float alpha_0k = -((1.0f+2.0f*c)*sqrtf(1.0f+c))/((3.0f*k+c)*sqrtf(1.0f-c));
+            float beta_0 = s/(3.0f*k + c);
+
+            int idx_diagonal = valenceTable[2*zerothNeighbor + 1 + 1];
+            assert(idx_diagonal>0);
+            float const * diagonal = inOffset + idx_diagonal * stride;
+
+            for (int j=0; j<length; ++j) {
+                e0[vofs+j] = (inOffset[boundaryEdgeNeighbors[0]*stride+j] -
+                              inOffset[boundaryEdgeNeighbors[1]*stride+j])/6.0f;
+
+                e1[vofs+j] = gamma * pos[j] + beta_0 * diagonal[j] +
+                            (inOffset[boundaryEdgeNeighbors[0]*stride+j] +
+                             inOffset[boundaryEdgeNeighbors[1]*stride+j]) * alpha_0k;
+
+            }
+
+            for (int x=1; x<ivalence-1; ++x) {
+                Index curri = ((x + zerothNeighbor)%ivalence);
+                float alpha = (4.0f*sinf((float(M_PI) * float(x))/k))/(3.0f*k+c);
+                float beta = (sinf((float(M_PI) * float(x))/k) + sinf((float(M_PI) * float(x+1))/k))/(3.0f*k+c);
+
+                int idx_neighbor = valenceTable[2*curri + 0 + 1];
+                    idx_diagonal = valenceTable[2*curri + 1 + 1];
+                assert( idx_neighbor>0 and idx_diagonal>0 );
+
+                float const * neighbor = inOffset + idx_neighbor * stride;
+                              diagonal = inOffset + idx_diagonal * stride;
+
+                for (int j=0; j<length; ++j) {
+                    e1[vofs+j] += alpha*neighbor[j] + beta*diagonal[j];
+                }
+            }
+
+            for (int j=0; j<length; ++j) {
+                e1[vofs+j] /= 3.0f;
+            }
+        }
+    }
+
+    // tess control
+
+    // Control Vertices based on :
+    // "Approximating Subdivision Surfaces with Gregory Patches for Hardware Tessellation"
+    // Loop, Schaefer, Ni, Castafio (ACM ToG Siggraph Asia 2009)
+    //
+    //  P3         e3-      e2+         E2
+    //     O--------O--------O--------O
+    //     |        |        |        |
+    //     |        |        |        |
+    //     |        | f3-    | f2+    |
+    //     |        O        O        |
+    // e3+ O------O            O------O e2-
+    //     |     f3+          f2-     |
+    //     |                          |
+    //     |                          |
+    //     |      f0-         f1+     |
+    // e0- O------O            O------O e1+
+    //     |        O        O        |
+    //     |        | f0+    | f1-    |
+    //     |        |        |        |
+    //     |        |        |        |
+    //     O--------O--------O--------O
+    //  P0         e0+      e1-         E1
+    //
+
+    float *Ep=(float*)alloca(length*4*sizeof(float)),
+          *Em=(float*)alloca(length*4*sizeof(float)),
+          *Fp=(float*)alloca(length*4*sizeof(float)),
+          *Fm=(float*)alloca(length*4*sizeof(float));
+
+    for (int vid=0; vid<4; ++vid) {
+
+        Index ip = (vid+1)%4,
+                   im = (vid+3)%4,
+                   n = abs(valences[vid]),
+                   ivalence = n;
+
+        unsigned int const *quadOffsets = quadOffsetBuffer;
+
+        int vofs = vid * length;
+
+        Index   start =  quadOffsets[vid] & 0x00ff,
+                      prev = (quadOffsets[vid] & 0xff00) / 256,
+                        np = abs(valences[ip]),
+                        nm = abs(valences[im]),
+                   start_m =  quadOffsets[im] & 0x00ff,
+                    prev_p = (quadOffsets[ip] & 0xff00) / 256;
+
+        float *Em_ip=(float*)alloca(length*sizeof(float)),
+              *Ep_im=(float*)alloca(length*sizeof(float));
+
+        if (valences[ip]<-2) {
+            Index j = (np + prev_p - zerothNeighbors[ip]) % np;
+            for (int k=0, ipofs=ip*length; k<length; ++k, ++ipofs) {
+                Em_ip[k] = opos[ipofs] + cosf((float(M_PI)*j)/float(np-1))*e0[ipofs] + sinf((float(M_PI)*j)/float(np-1))*e1[ipofs];
+            }
+        } else {
+            for (int k=0, ipofs=ip*length; k<length; ++k, ++ipofs) {
+                Em_ip[k] = opos[ipofs] + e0[ipofs]*csf(np-3,2*prev_p)  + e1[ipofs]*csf(np-3,2*prev_p+1);
+            }
+        }
+
+        if (valences[im]<-2) {
+            Index j = (nm + start_m - zerothNeighbors[im]) % nm;
+            for (int k=0, imofs=im*length; k<length; ++k, ++imofs) {
+                Ep_im[k] = opos[imofs] + cosf((float(M_PI)*j)/float(nm-1))*e0[imofs] + sinf((float(M_PI)*j)/float(nm-1))*e1[imofs];
+            }
+        } else {
+            for (int k=0, imofs=im*length; k<length; ++k, ++imofs) {
+                Ep_im[k] = opos[imofs] + e0[imofs]*csf(nm-3,2*start_m) + e1[imofs]*csf(nm-3,2*start_m+1);
+            }
+        }
+
+        if (valences[vid] < 0) {
+            n = (n-1)*2;
+        }
+        if (valences[im] < 0) {
+            nm = (nm-1)*2;
+        }
+        if (valences[ip] < 0) {
+            np = (np-1)*2;
+        }
+
+        rp=r+vid*maxValence*length;
+
+        if (valences[vid] > 2) {
+           float s1 = 3.0f - 2.0f*csf(n-3,2)-csf(np-3,2),
+                 s2 = 2.0f*csf(n-3,2),
+                 s3 = 3.0f -2.0f*cosf(2.0f*float(M_PI)/float(n)) - cosf(2.0f*float(M_PI)/float(nm));
+
+            for (int k=0, ofs=vofs; k<length; ++k, ++ofs) {
+                Ep[ofs] = opos[ofs] + e0[ofs] * csf(n-3, 2*start) + e1[ofs]*csf(n-3, 2*start +1);
+                Em[ofs] = opos[ofs] + e0[ofs] * csf(n-3, 2*prev ) + e1[ofs]*csf(n-3, 2*prev + 1);
+                Fp[ofs] = (csf(np-3,2)*opos[ofs] + s1*Ep[ofs] + s2*Em_ip[k] + rp[start*length+k])/3.0f;
+                Fm[ofs] = (csf(nm-3,2)*opos[ofs] + s3*Em[ofs] + s2*Ep_im[k] - rp[prev*length+k])/3.0f;
+            }
+        } else if (valences[vid] < -2) {
+            Index jp = (ivalence + start - zerothNeighbors[vid]) % ivalence,
+                       jm = (ivalence + prev  - zerothNeighbors[vid]) % ivalence;
+
+            float s1 = 3-2*csf(n-3,2)-csf(np-3,2),
+                  s2 = 2*csf(n-3,2),
+                  s3 = 3.0f-2.0f*cosf(2.0f*float(M_PI)/n)-cosf(2.0f*float(M_PI)/nm);
+
+            for (int k=0, ofs=vofs; k<length; ++k, ++ofs) {
+                Ep[ofs] = opos[ofs] + cosf((float(M_PI)*jp)/float(ivalence-1))*e0[ofs] + sinf((float(M_PI)*jp)/float(ivalence-1))*e1[ofs];
+                Em[ofs] = opos[ofs] + cosf((float(M_PI)*jm)/float(ivalence-1))*e0[ofs] + sinf((float(M_PI)*jm)/float(ivalence-1))*e1[ofs];
+                Fp[ofs] = (csf(np-3,2)*opos[ofs] + s1*Ep[ofs] + s2*Em_ip[k] + rp[start*length+k])/3.0f;
+                Fm[ofs] = (csf(nm-3,2)*opos[ofs] + s3*Em[ofs] + s2*Ep_im[k] - rp[prev*length+k])/3.0f;
+            }
+
+            if (valences[im]<0) {
+                s1=3-2*csf(n-3,2)-csf(np-3,2);
+                for (int k=0, ofs=vofs; k<length; ++k, ++ofs) {
+                    Fp[ofs] = Fm[ofs] = (csf(np-3,2)*opos[ofs] + s1*Ep[ofs] + s2*Em_ip[k] + rp[start*length+k])/3.0f;
+                }
+            } else if (valences[ip]<0) {
+                s1 = 3.0f-2.0f*cosf(2.0f*float(M_PI)/n)-cosf(2.0f*float(M_PI)/nm);
+                for (int k=0, ofs=vofs; k<length; ++k, ++ofs) {
+                    Fm[ofs] = Fp[ofs] = (csf(nm-3,2)*opos[ofs] + s1*Em[ofs] + s2*Ep_im[k] - rp[prev*length+k])/3.0f;
+                }
+            }
+        } else if (valences[vid]==-2) {
+            for (int k=0, ofs=vofs, ipofs=ip*length, imofs=im*length; k<length; ++k, ++ofs, ++ipofs, ++imofs) {
+                Ep[ofs] = (2.0f * org[ofs] + org[ipofs])/3.0f;
+                Em[ofs] = (2.0f * org[ofs] + org[imofs])/3.0f;
+                Fp[ofs] = Fm[ofs] = (4.0f * org[ofs] + org[((vid+2)%n)*stride+k] + 2.0f * org[ipofs] + 2.0f * org[imofs])/9.0f;
+            }
+        }
+    }
+    for (int vid=0, ofs=0; vid<4; ++vid, ofs+=length) {
+        memcpy(points + (vid*5+0)*length, opos + ofs, length*sizeof(float));
+        memcpy(points + (vid*5+1)*length,   Ep + ofs, length*sizeof(float));
+        memcpy(points + (vid*5+2)*length,   Em + ofs, length*sizeof(float));
+        memcpy(points + (vid*5+3)*length,   Fp + ofs, length*sizeof(float));
+        memcpy(points + (vid*5+4)*length,   Fm + ofs, length*sizeof(float));
+    }
+}
+
+void
+PatchTables::ComputeGregoryPoints(PatchDescriptor::Type type,
+    Index const * cvs, Index const * vertexValenceTable,
+    unsigned int const * quadOffsets, int maxValence,
+    float const * values, int stride, int length, float * points) {
+
+    if (type==PatchDescriptor::GREGORY) {
+        computeGregoryPoints(cvs, vertexValenceTable, quadOffsets, maxValence,
+            values, stride, length, points);
+    } else if (type==PatchDescriptor::GREGORY_BOUNDARY) {
+        computeGregoryBoundaryPoints(cvs, vertexValenceTable, quadOffsets, maxValence,
+            values, stride, length, points);
+    } else {
+        assert(0);
+    }
+}
+
+
 PatchTables::PatchTables(int maxvalence) :
-    _maxValence(maxvalence), _endcapStencilTables(0), _fvarPatchTables(0) { }
+    _maxValence(maxvalence), _endcapStencilTables(0), _fvarPatchTables(0),
+    _isCompact(false), _compactUVBits(0) { }
 
 // Copy constructor
 // XXXX manuelk we need to eliminate this constructor (C++11 smart pointers)
@@ -247,7 +1031,12 @@ PatchTables::PatchTables(PatchTables const & src) :
     _quadOffsetsTable(src._quadOffsetsTable),
     _vertexValenceTable(src._vertexValenceTable),
     _sharpnessIndices(src._sharpnessIndices),
-    _sharpnessValues(src._sharpnessValues) {
+    _sharpnessValues(src._sharpnessValues),
+    _isCompact(src._isCompact),
+    _compactUVBits(src._compactUVBits),
+    _compactBlocks(src._compactBlocks),
+    _compactVerts(src._compactVerts),
+    _compactParams(src._compactParams) {
 
     _endcapStencilTables = src._endcapStencilTables ?
         new StencilTables(*src._endcapStencilTables) : 0;
@@ -280,6 +1069,21 @@ struct PatchTables::PatchArray {
           quadOffsetIndex; // index of the first quad offset entry
 };
 
+//
+// Compact storage blocks : consecutive patches of a patch array whose control
+// vertices and ptex faces are stored relative to common bases
+//
+
+struct PatchTables::CompactBlock {
+
+    CompactBlock(Index p, Index v, Index f) :
+        firstPatch(p), vertBase(v), faceBase(f) { }
+
+    Index firstPatch, // index of the first patch of the block
+          vertBase,   // lowest control vertex index of the block
+          faceBase;   // lowest ptex face index of the block
+};
+
 inline PatchTables::PatchArray &
 PatchTables::getPatchArray(Index arrayIndex) {
     assert(arrayIndex<(Index)GetNumPatchArrays());
@@ -305,6 +1109,10 @@ getPatchSize(PatchDescriptor desc) {
     if (desc.GetType() == PatchDescriptor::GREGORY_BASIS) {
         size = 4;
     }
+    // Loop basis patches point to the 3 corners of the triangle
+    if (desc.GetType() == PatchDescriptor::LOOP_BASIS) {
+        size = 3;
+    }
     return size;
 }
 
@@ -368,42 +1176,76 @@ PatchTables::getPatchArrayVertices(int arrayIndex) {
 }
 ConstIndexArray
 PatchTables::GetPatchArrayVertices(int arrayIndex) const {
+    assert(not _isCompact);
     PatchArray const & pa = getPatchArray(arrayIndex);
     int size = getPatchSize(pa.desc);
     assert(pa.vertIndex<(Index)_patchVerts.size());
     return ConstIndexArray(&_patchVerts[pa.vertIndex], pa.numPatches * size);
 }
 
+inline Index
+getPatchVertIndex(PatchDescriptor desc, Index vertIndex) {
+    // XXXX manuelk we do not store the topology for Gregory Basis
+    // patch types yet - so point to the 4 corners of the 0-ring
+    return (desc.GetType() == PatchDescriptor::GREGORY_BASIS or
+            desc.GetType() == PatchDescriptor::LOOP_BASIS) ?
+        vertIndex / 5 : vertIndex;
+}
+
 ConstIndexArray
 PatchTables::GetPatchVertices(PatchHandle const & handle) const {
+    assert(not _isCompact);
     PatchArray const & pa = getPatchArray(handle.arrayIndex);
 
-    Index vert = pa.vertIndex;
-    // XXXX manuelk we do not store the topology for Gregory Basis
-    // patch types yet - so point to the 4 corners of the 0-ring
-    vert += (pa.desc.GetType() == PatchDescriptor::GREGORY_BASIS) ?
-        handle.vertIndex / 5 : handle.vertIndex;
+    Index vert = pa.vertIndex + getPatchVertIndex(pa.desc, handle.vertIndex);
     assert(vert<(Index)_patchVerts.size());
     return ConstIndexArray(&_patchVerts[vert], getPatchSize(pa.desc));
 }
 ConstIndexArray
+PatchTables::GetPatchVertices(PatchHandle const & handle, Index * cvs) const {
+    if (not _isCompact) {
+        return GetPatchVertices(handle);
+    }
+    PatchArray const & pa = getPatchArray(handle.arrayIndex);
+
+    Index vert = pa.vertIndex + getPatchVertIndex(pa.desc, handle.vertIndex);
+    return decodePatchVertices(handle.patchIndex, vert, getPatchSize(pa.desc), cvs);
+}
+ConstIndexArray
 PatchTables::GetPatchVertices(int arrayIndex, int patchIndex) const {
+    assert(not _isCompact);
     PatchArray const & pa = getPatchArray(arrayIndex);
     int size = getPatchSize(pa.desc);
     assert((pa.vertIndex + patchIndex*size)<(Index)_patchVerts.size());
     return ConstIndexArray(&_patchVerts[pa.vertIndex + patchIndex*size], size);
 }
+ConstIndexArray
+PatchTables::GetPatchVertices(int arrayIndex, int patchIndex, Index * cvs) const {
+    if (not _isCompact) {
+        return GetPatchVertices(arrayIndex, patchIndex);
+    }
+    PatchArray const & pa = getPatchArray(arrayIndex);
+    int size = getPatchSize(pa.desc);
+    return decodePatchVertices(pa.patchIndex + patchIndex,
+        pa.vertIndex + patchIndex*size, size, cvs);
+}
 
 PatchParam
 PatchTables::GetPatchParam(PatchHandle const & handle) const {
-    assert(handle.patchIndex < (Index)_paramTable.size());
-    return _paramTable[handle.patchIndex];
+    if (not _isCompact) {
+        assert(handle.patchIndex < (Index)_paramTable.size());
+        return _paramTable[handle.patchIndex];
+    }
+    return decodePatchParam(handle.patchIndex);
 }
 PatchParam
 PatchTables::GetPatchParam(int arrayIndex, int patchIndex) const {
     PatchArray const & pa = getPatchArray(arrayIndex);
-    assert((pa.patchIndex + patchIndex) < (int)_paramTable.size());
-    return _paramTable[pa.patchIndex + patchIndex];
+    if (not _isCompact) {
+        assert((pa.patchIndex + patchIndex) < (int)_paramTable.size());
+        return _paramTable[pa.patchIndex + patchIndex];
+    }
+    return decodePatchParam(pa.patchIndex + patchIndex);
 }
 PatchParamArray
 PatchTables::getPatchParams(int arrayIndex) {
@@ -412,14 +1254,36 @@ PatchTables::getPatchParams(int arrayIndex) {
 }
 ConstPatchParamArray const
 PatchTables::GetPatchParams(int arrayIndex) const {
+    assert(not _isCompact);
     PatchArray const & pa = getPatchArray(arrayIndex);
     return ConstPatchParamArray(&_paramTable[pa.patchIndex], pa.numPatches);
 }
 
+Index
+PatchTables::getSharpnessIndex(Index arrayIndex, Index patchIndex) const {
+    if (not _isCompact) {
+        assert(patchIndex < (int)_sharpnessIndices.size());
+        return _sharpnessIndices[patchIndex];
+    }
+    // the compact storage only retains the indices of the single-crease
+    // patches, in the order of their arrays
+    PatchArray const & pa = getPatchArray(arrayIndex);
+    if (pa.desc.GetType() != PatchDescriptor::SINGLE_CREASE) {
+        return Vtr::INDEX_INVALID;
+    }
+    Index ofs = patchIndex - pa.patchIndex;
+    for (Index i=0; i<arrayIndex; ++i) {
+        if (_patchArrays[i].desc.GetType() == PatchDescriptor::SINGLE_CREASE) {
+            ofs += _patchArrays[i].numPatches;
+        }
+    }
+    assert(ofs < (int)_sharpnessIndices.size());
+    return _sharpnessIndices[ofs];
+}
+
 float
 PatchTables::GetSingleCreasePatchSharpnessValue(PatchHandle const & handle) const {
-    assert((handle.patchIndex) < (int)_sharpnessIndices.size());
-    Index index = _sharpnessIndices[handle.patchIndex];
+    Index index = getSharpnessIndex(handle.arrayIndex, handle.patchIndex);
     if (index == Vtr::INDEX_INVALID) {
         return 0.0f;
     }
@@ -429,8 +1293,7 @@ PatchTables::GetSingleCreasePatchSharpnessValue(PatchHandle const & handle) cons
 float
 PatchTables::GetSingleCreasePatchSharpnessValue(int arrayIndex, int patchIndex) const {
     PatchArray const & pa = getPatchArray(arrayIndex);
-    assert((pa.patchIndex + patchIndex) < (int)_sharpnessIndices.size());
-    Index index = _sharpnessIndices[pa.patchIndex + patchIndex];
+    Index index = getSharpnessIndex(arrayIndex, pa.patchIndex + patchIndex);
     if (index == Vtr::INDEX_INVALID) {
         return 0.0f;
     }
@@ -453,6 +1316,37 @@ PatchTables::getFVarVerts(int arrayIndex, int channel) {
     return IndexArray(&verts[ofs],pa.numPatches * pa.desc.GetNumFVarControlVertices());
 }
 
+PatchDescriptor::Type
+PatchTables::GetFVarPatchType(PatchHandle const & handle, int channel) const {
+    assert(_fvarPatchTables and (channel<(int)_fvarPatchTables->_channels.size()));
+    FVarPatchTables::Channel const & fvarChannel = _fvarPatchTables->_channels[channel];
+    if (fvarChannel.patchTypes.empty()) {
+        // bilinear face-varying patches only
+        PatchDescriptor::Type type = GetPatchDescriptor(handle).GetType();
+        return (type==PatchDescriptor::TRIANGLES or type==PatchDescriptor::LOOP or
+                type==PatchDescriptor::LOOP_BASIS) ?
+            PatchDescriptor::TRIANGLES : PatchDescriptor::QUADS;
+    }
+    assert(handle.patchIndex < (Index)fvarChannel.patchTypes.size());
+    return (PatchDescriptor::Type)fvarChannel.patchTypes[handle.patchIndex];
+}
+
+ConstIndexArray
+PatchTables::GetFVarPatchValues(PatchHandle const & handle, int channel) const {
+    FVarPatchTables::Channel const & fvarChannel = _fvarPatchTables->_channels[channel];
+    PatchDescriptor::Type type = GetFVarPatchType(handle, channel);
+    if (type>=PatchDescriptor::REGULAR and type<=PatchDescriptor::CORNER) {
+        PatchArray const & pa = getPatchArray(handle.arrayIndex);
+        Index ofs = pa.vertIndex + handle.vertIndex;
+        assert(ofs<(Index)fvarChannel.patchValueIndices.size());
+        return ConstIndexArray(&fvarChannel.patchValueIndices[ofs],
+            PatchDescriptor::GetNumControlVertices(type));
+    }
+    int ncvs = PatchDescriptor::GetNumFVarControlVertices(type);
+    assert((handle.patchIndex+1)*ncvs <= (Index)fvarChannel.patchVertIndices.size());
+    return ConstIndexArray(&fvarChannel.patchVertIndices[handle.patchIndex*ncvs], ncvs);
+}
+
 bool
 PatchTables::IsFeatureAdaptive() const {
 
@@ -463,8 +1357,8 @@ PatchTables::IsFeatureAdaptive() const {
     // otherwise, we have to check each patch array
     for (int i=0; i<GetNumPatchArrays(); ++i) {
         PatchDescriptor const & desc = _patchArrays[i].desc;
-        if (desc.GetType()>=PatchDescriptor::REGULAR and
-            desc.GetType()<=PatchDescriptor::GREGORY_BASIS) {
+        if (desc.GetType()>=PatchDescriptor::LOOP and
+            desc.GetType()<=PatchDescriptor::LOOP_BASIS) {
             return true;
         }
     }
@@ -474,7 +1368,7 @@ PatchTables::IsFeatureAdaptive() const {
 int
 PatchTables::GetNumPatchesTotal() const {
     // there is one PatchParam record for each patch in the mesh
-    return (int)_paramTable.size();
+    return _isCompact ? (int)_compactParams.size() : (int)_paramTable.size();
 }
 
 // Returns the first array of patches matching the descriptor
@@ -487,6 +1381,200 @@ PatchTables::findPatchArray(PatchDescriptor desc) {
     return Vtr::INDEX_INVALID;
 }
 
+//
+// Compact storage
+//
+
+PatchTables::CompactBlock const &
+PatchTables::findCompactBlock(Index patchIndex) const {
+
+    // binary search for the last block starting at or before the patch
+    int first = 0,
+        last = (int)_compactBlocks.size();
+    while (last - first > 1) {
+        int mid = (first + last) / 2;
+        if (_compactBlocks[mid].firstPatch <= patchIndex) {
+            first = mid;
+        } else {
+            last = mid;
+        }
+    }
+    assert(first < (int)_compactBlocks.size());
+    return _compactBlocks[first];
+}
+
+PatchParam
+PatchTables::decodePatchParam(Index patchIndex) const {
+
+    assert(patchIndex < (Index)_compactParams.size());
+
+    // see compact() for the layout of the packed PatchParams
+    unsigned int packed = _compactParams[patchIndex],
+                 uvMask = (1u << _compactUVBits) - 1;
+
+    PatchParam param;
+    param.faceIndex = findCompactBlock(patchIndex).faceBase +
+        (Index)(packed >> (11 + 2*_compactUVBits));
+    param.bitField.field = (packed & 0x7f) |
+                           (((packed >> 7) & 0xf) << 27) |
+                           (((packed >> 11) & uvMask) << 7) |
+                           (((packed >> (11 + _compactUVBits)) & uvMask) << 17);
+    return param;
+}
+
+ConstIndexArray
+PatchTables::decodePatchVertices(Index patchIndex,
+    Index vertIndex, int size, Index * cvs) const {
+
+    assert(size<=MAX_PATCH_VERTICES and
+        (vertIndex+size)<=(Index)_compactVerts.size());
+
+    Index base = findCompactBlock(patchIndex).vertBase;
+    for (int i=0; i<size; ++i) {
+        cvs[i] = base + _compactVerts[vertIndex+i];
+    }
+    return ConstIndexArray(cvs, size);
+}
+
+//
+// Re-encodes the tables with the compact storage : the patches of each array
+// are split into blocks whose control vertex indices span less than 2^16, so
+// that they can be stored as 16 bits offsets to the lowest index of their
+// block. The PatchParams are packed into 32 bits :
+//
+//  Field      | Bits | Content
+//  -----------|:----:|------------------------------------------------------
+//  level      | 4    | PatchParam bits 0-3
+//  nonquad    | 1    | PatchParam bit 4
+//  rotation   | 2    | PatchParam bits 5-6
+//  boundary   | 4    | PatchParam bits 27-30
+//  v          | B    | B bits required by the deepest (u,v) of the tables
+//  u          | B    |
+//  face       | F    | ptex face index offset to the lowest of the block,
+//             |      | with F = 21 - 2*B
+//
+// The blocks are also split so that their ptex face indices span less than
+// 2^F. Tables with patches that cannot be encoded are left unchanged.
+//
+void
+PatchTables::compact() {
+
+    assert(not _isCompact);
+
+    int npatches = (int)_paramTable.size();
+
+    int uvBits = 0;
+    for (int i=0; i<npatches; ++i) {
+        PatchParam::BitField const & bits = _paramTable[i].bitField;
+        assert((bits.field >> 31)==0);
+        while (((bits.GetU() | bits.GetV()) >> uvBits)!=0) {
+            ++uvBits;
+        }
+    }
+    int faceBits = 21 - 2*uvBits;
+    assert(faceBits>0);
+
+    std::vector<CompactBlock> blocks;
+    Index vmin=0, vmax=0, fmin=0, fmax=0;
+    for (int array=0; array<(int)_patchArrays.size(); ++array) {
+
+        PatchArray const & pa = _patchArrays[array];
+
+        int size = getPatchSize(pa.desc);
+
+        for (int patch=0; patch<pa.numPatches; ++patch) {
+
+            Index const * cvs = &_patchVerts[pa.vertIndex + patch*size];
+
+            Index pvmin = *std::min_element(cvs, cvs+size),
+                  pvmax = *std::max_element(cvs, cvs+size),
+                  face = _paramTable[pa.patchIndex + patch].faceIndex;
+
+            if (pvmax-pvmin > 0xffff) {
+                return;
+            }
+
+            if (patch==0 or
+                (std::max(vmax, pvmax) - std::min(vmin, pvmin)) > 0xffff or
+                ((std::max(fmax, face) - std::min(fmin, face)) >> faceBits)!=0) {
+
+                // start a new block
+                if (not blocks.empty()) {
+                    blocks.back().vertBase = vmin;
+                    blocks.back().faceBase = fmin;
+                }
+                blocks.push_back(CompactBlock(pa.patchIndex + patch, 0, 0));
+                vmin = pvmin; vmax = pvmax;
+                fmin = fmax = face;
+            } else {
+                vmin = std::min(vmin, pvmin); vmax = std::max(vmax, pvmax);
+                fmin = std::min(fmin, face);  fmax = std::max(fmax, face);
+            }
+        }
+    }
+    if (not blocks.empty()) {
+        blocks.back().vertBase = vmin;
+        blocks.back().faceBase = fmin;
+    }
+
+    _compactVerts.resize(_patchVerts.size());
+    _compactParams.resize(npatches);
+
+    for (int array=0, block=0; array<(int)_patchArrays.size(); ++array) {
+
+        PatchArray const & pa = _patchArrays[array];
+
+        int size = getPatchSize(pa.desc);
+
+        for (int patch=0; patch<pa.numPatches; ++patch) {
+
+            Index patchIndex = pa.patchIndex + patch,
+                  vertIndex = pa.vertIndex + patch*size;
+
+            if (block+1<(int)blocks.size() and
+                blocks[block+1].firstPatch==patchIndex) {
+                ++block;
+            }
+            CompactBlock const & b = blocks[block];
+
+            for (int i=0; i<size; ++i) {
+                _compactVerts[vertIndex+i] =
+                    (unsigned short)(_patchVerts[vertIndex+i] - b.vertBase);
+            }
+
+            PatchParam const & param = _paramTable[patchIndex];
+            unsigned int field = param.bitField.field;
+            _compactParams[patchIndex] = (field & 0x7f) |
+                (((field >> 27) & 0xf) << 7) |
+                (param.bitField.GetV() << 11) |
+                (param.bitField.GetU() << (11 + uvBits)) |
+                ((unsigned int)(param.faceIndex - b.faceBase) << (11 + 2*uvBits));
+        }
+    }
+
+    // only retain the sharpness indices of the single-crease patches
+    if (not _sharpnessIndices.empty()) {
+        std::vector<Index> sharpnessIndices;
+        for (int array=0; array<(int)_patchArrays.size(); ++array) {
+            PatchArray const & pa = _patchArrays[array];
+            if (pa.desc.GetType()==PatchDescriptor::SINGLE_CREASE) {
+                sharpnessIndices.insert(sharpnessIndices.end(),
+                    _sharpnessIndices.begin() + pa.patchIndex,
+                    _sharpnessIndices.begin() + pa.patchIndex + pa.numPatches);
+            }
+        }
+        _sharpnessIndices.swap(sharpnessIndices);
+    }
+
+    _compactBlocks.swap(blocks);
+    _compactUVBits = uvBits;
+    _isCompact = true;
+
+    // release the wide tables
+    std::vector<Index>().swap(_patchVerts);
+    PatchParamTable().swap(_paramTable);
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
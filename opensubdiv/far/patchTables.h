@@ -78,9 +78,13 @@ public:
     /// \brief True if the patches are of feature adaptive types
     bool IsFeatureAdaptive() const;
 
+    /// \brief True if the tables use the compact storage (see
+    ///        PatchTablesFactory::Options::compactStorage)
+    bool IsCompact() const { return _isCompact; }
+
     /// \brief Returns the total number of control vertex indices in the tables
     int GetNumControlVerticesTotal() const {
-        return (int)_patchVerts.size();
+        return _isCompact ? (int)_compactVerts.size() : (int)_patchVerts.size();
     }
 
     /// \brief Returns the total number of patches stored in the tables
@@ -99,17 +103,29 @@ public:
     /// \warning These direct accessors are left for convenience, but they are
     ///          likely going to be deprecated in future releases
     ///
+    /// \note The control vertices, PatchParam and sharpness index tables are
+    ///       not available with the compact storage (see IsCompact())
+    ///
 
     typedef std::vector<Index> PatchVertsTable;
 
     /// \brief Get the table of patch control vertices
-    PatchVertsTable const & GetPatchControlVerticesTable() const { return _patchVerts; }
+    PatchVertsTable const & GetPatchControlVerticesTable() const {
+        assert(not _isCompact);
+        return _patchVerts;
+    }
 
     /// \brief Returns the PatchParamTable (PatchParams order matches patch array sorting)
-    PatchParamTable const & GetPatchParamTable() const { return _paramTable; }
+    PatchParamTable const & GetPatchParamTable() const {
+        assert(not _isCompact);
+        return _paramTable;
+    }
 
     /// \brief Returns a sharpness index table for each patch (if exists)
-    std::vector<Index> const &GetSharpnessIndexTable() const { return _sharpnessIndices; }
+    std::vector<Index> const &GetSharpnessIndexTable() const {
+        assert(not _isCompact);
+        return _sharpnessIndices;
+    }
 
     /// \brief Returns sharpness values table
     std::vector<float> const &GetSharpnessValues() const { return _sharpnessValues; }
@@ -129,19 +145,35 @@ public:
     ///
     /// \brief Accessors for individual patches
     ///
+    /// The accessors taking a 'cvs' buffer decode the control vertex indices
+    /// of the compact storage into it (the buffer must hold
+    /// MAX_PATCH_VERTICES indices), and otherwise return the indices of the
+    /// tables without copying them.
+    ///
+
+    /// \brief Maximum number of control vertex indices of a patch
+    enum { MAX_PATCH_VERTICES = 16 };
 
     /// \brief Returns the PatchDescriptor for the patches in array 'array'
     PatchDescriptor GetPatchDescriptor(PatchHandle const & handle) const;
 
     /// \brief Returns the control vertex indices for the patch identified by 'handle'
+    /// (not available with the compact storage)
     ConstIndexArray GetPatchVertices(PatchHandle const & handle) const;
 
+    /// \brief Returns the control vertex indices for the patch identified by 'handle'
+    ConstIndexArray GetPatchVertices(PatchHandle const & handle, Index * cvs) const;
+
     /// \brief Returns a PatchParam for the patch identified by 'handle'
     PatchParam GetPatchParam(PatchHandle const & handle) const;
 
     /// \brief Returns the control vertex indices for the patch 'patch' in array 'array'
+    /// (not available with the compact storage)
     ConstIndexArray GetPatchVertices(int array, int patch) const;
 
+    /// \brief Returns the control vertex indices for the patch 'patch' in array 'array'
+    ConstIndexArray GetPatchVertices(int array, int patch, Index * cvs) const;
+
     /// \brief Returns the PatchParam for the patch 'patch' in array 'array'
     PatchParam GetPatchParam(int array, int patch) const;
     //@}
@@ -168,9 +200,11 @@ public:
     PatchDescriptor GetPatchArrayDescriptor(int array) const;
 
     /// \brief Returns the control vertex indices for the patches in array 'array'
+    /// (not available with the compact storage)
     ConstIndexArray GetPatchArrayVertices(int array) const;
 
     /// \brief Returns the PatchParams for the patches in array 'array'
+    /// (not available with the compact storage)
     ConstPatchParamArray const GetPatchParams(int array) const;
     //@}
 
@@ -231,8 +265,15 @@ public:
     /// FVarPatchTables contain the topology for face-varying primvar data
     /// channels. The patch ordering matches that of PatchTables PatchArrays.
     ///
-    /// \note bi-cubic face-varying limit interpolation is not implemented yet :
-    ///       this code will change soon
+    /// Every patch carries the 4 face-varying values of its corners (bilinear
+    /// interpolation). Feature adaptive tables also carry bi-cubic
+    /// face-varying patches for the regular, boundary and corner patches whose
+    /// face-varying topology matches the vertex topology (see
+    /// GetFVarPatchType() and GetFVarPatchValues()) : smooth face-varying
+    /// boundary interpolation rules are then honored at the limit. Use
+    /// TopologyRefiner::AdaptiveOptions::considerFVarChannels to isolate the
+    /// face-varying discontinuities, so that the remaining bilinear patches
+    /// are confined to the highest level of isolation.
     ///
     class FVarPatchTables {
 
@@ -258,7 +299,11 @@ public:
         struct Channel {
             friend class PatchTablesFactory;
 
-            std::vector<Index> patchVertIndices; // face-varying vertex indices
+            std::vector<Index> patchVertIndices;  // face-varying vertex indices
+
+            std::vector<unsigned char> patchTypes; // face-varying patch types (one per patch)
+            std::vector<Index> patchValueIndices;  // bi-cubic face-varying value indices
+                                                   // (same layout as the patch vertices)
         };
 
     private:
@@ -268,6 +313,32 @@ public:
 
     /// \brief Returns the face-varying patches
     FVarPatchTables const * GetFVarPatchTables() const { return _fvarPatchTables; }
+
+    /// \brief Returns the type of the face-varying patch identified by 'handle'
+    ///
+    /// REGULAR, BOUNDARY and CORNER face-varying patches are interpolated
+    /// with the bi-cubic B-spline basis, other patches bilinearly (QUADS or
+    /// TRIANGLES)
+    ///
+    /// @param handle   A patch handle
+    ///
+    /// @param channel  The face-varying primvar channel index
+    ///
+    PatchDescriptor::Type GetFVarPatchType(PatchHandle const & handle, int channel=0) const;
+
+    /// \brief Returns the face-varying value indices of the patch identified
+    /// by 'handle'
+    ///
+    /// The values index the face-varying data of all the refinement levels
+    /// (see TopologyRefiner::InterpolateFaceVarying()). Bi-cubic patches
+    /// return as many values as the vertex patch, in the same order, bilinear
+    /// patches return their corner values.
+    ///
+    /// @param handle   A patch handle
+    ///
+    /// @param channel  The face-varying primvar channel index
+    ///
+    ConstIndexArray GetFVarPatchValues(PatchHandle const & handle, int channel=0) const;
     //@}
 
 public:
@@ -393,6 +464,48 @@ public:
         float s, float t, float const * Q, float const *Qd1, float const *Qd2,
             T const & src, U & dst);
 
+    /// \brief Interpolate the (s,t) parametric location of a Loop (quartic
+    ///        box-spline) patch
+    ///
+    /// @param cvs     Array of 12 control vertex indices
+    ///
+    /// @param Q       Array of 12 box-spline weights for the control vertices
+    ///                (see GetLoopBasisWeights())
+    ///
+    /// @param Qd1     Array of 12 's' tangent weights for the control vertices
+    ///
+    /// @param Qd2     Array of 12 't' tangent weights for the control vertices
+    ///
+    /// @param src     Source primvar buffer (control vertices data)
+    ///
+    /// @param dst     Destination primvar buffer (limit surface data)
+    ///
+    template <class T, class U> static void
+    InterpolateLoopPatch(Index const * cvs,
+        float const * Q, float const *Qd1, float const *Qd2, T const & src, U & dst);
+
+    /// \brief Interpolate the (s,t) parametric location of a Loop end-cap
+    ///        (quartic Bezier triangle) patch
+    ///
+    /// @param basisStencils  Stencil tables driving the 15 CV basis of the patches
+    ///
+    /// @param stencilIndex   Index of the first CV stencil in the basis stencils tables
+    ///
+    /// @param Q              Array of 15 Bezier weights for the basis CVs
+    ///                       (see GetLoopBezierWeights())
+    ///
+    /// @param Qd1            Array of 15 's' tangent weights for the basis CVs
+    ///
+    /// @param Qd2            Array of 15 't' tangent weights for the basis CVs
+    ///
+    /// @param src            Source primvar buffer (control vertices data)
+    ///
+    /// @param dst            Destination primvar buffer (limit surface data)
+    ///
+    template <class T, class U> static void
+    InterpolateLoopBasisPatch(StencilTables const * basisStencils, int stencilIndex,
+        float const * Q, float const *Qd1, float const *Qd2, T const & src, U & dst);
+
     /// \brief Interpolate the (s,t) parametric location of a *bicubic* patch
     ///
     /// \note This method can only be used on feature adaptive PatchTables (ie.
@@ -412,6 +525,29 @@ public:
     template <class T, class U> void Limit(PatchHandle const & handle,
         float s, float t, T const & src, U & dst) const;
 
+    /// \brief Interpolate the (s,t) parametric location of a face-varying
+    ///        patch
+    ///
+    /// Bi-cubic face-varying patches are interpolated at the limit, other
+    /// face-varying patches bilinearly.
+    ///
+    /// @param handle   A patch handle indentifying the sub-patch containing the
+    ///                 (s,t) location
+    ///
+    /// @param s        Patch coordinate (in coarse face normalized space)
+    ///
+    /// @param t        Patch coordinate (in coarse face normalized space)
+    ///
+    /// @param src      Source primvar buffer (face-varying values of all the
+    ///                 levels)
+    ///
+    /// @param dst      Destination primvar buffer (limit surface data)
+    ///
+    /// @param channel  The face-varying primvar channel index
+    ///
+    template <class T, class U> void LimitFaceVarying(PatchHandle const & handle,
+        float s, float t, T const & src, U & dst, int channel=0) const;
+
     enum TensorBasis {
         BASIS_BEZIER,    ///< Bi-cubic bezier patch basis
         BASIS_BSPLINE    ///< Bi-cubic bspline patch basis
@@ -422,9 +558,74 @@ public:
     static void GetBasisWeights(TensorBasis basis, PatchParam::BitField bits,
         float s, float t, float point[16], float deriv1[16], float deriv2[16]);
 
+    /// \brief Returns bilinear weights for a given (s,t) location on a quad
+    /// patch : the weights apply to the corners of the patch after rotation,
+    /// in the order of the face-varying patch values
+    static void GetBilinearWeights(PatchParam::BitField bits,
+        float s, float t, float point[4], float deriv1[4], float deriv2[4]);
+
+    /// \brief Returns linear weights for a given (s,t) location on a triangle
+    /// patch : the weights apply to the corners of the triangle, in the order
+    /// of the face-varying patch values
+    static void GetLinearWeights(PatchParam::BitField bits,
+        float s, float t, float point[3], float deriv1[3], float deriv2[3]);
+
+    /// \brief Returns the quartic box-spline weights for a given (s,t) location
+    /// on a Loop patch
+    ///
+    /// The weights of the control vertices missing on the boundaries of the
+    /// patch (see PatchParam::BitField::GetBoundary()) are folded into the
+    /// weights of the other control vertices, and are 0.
+    ///
+    static void GetLoopBasisWeights(PatchParam::BitField bits,
+        float s, float t, float point[12], float deriv1[12], float deriv2[12]);
+
+    /// \brief Folds the weights of the control vertices of a Loop patch that
+    /// are missing on its boundaries into the weights of the other control
+    /// vertices
+    static void FoldLoopBoundaryWeights(PatchParam::BitField bits, float weights[12]);
+
+    /// \brief Computes the 20 control points of a GREGORY or GREGORY_BOUNDARY
+    /// patch from the 1-rings of its corner vertices
+    ///
+    /// The points are written consecutively ('length' values each) in the
+    /// order P, Ep, Em, Fp, Fm of each of the 4 corners of the patch. The
+    /// interior points of the patch are convex blends of the Fp and Fm pairs,
+    /// so the surface lies within the convex hull of these points.
+    ///
+    /// @param type               GREGORY or GREGORY_BOUNDARY
+    ///
+    /// @param cvs                The 4 vertices of the patch
+    ///
+    /// @param vertexValenceTable See GetVertexValenceTable()
+    ///
+    /// @param quadOffsets        See GetPatchQuadOffsets()
+    ///
+    /// @param maxValence         See GetMaxValence()
+    ///
+    /// @param values             Vertex data (first element of vertex 0)
+    ///
+    /// @param stride             Number of floats between consecutive vertices
+    ///
+    /// @param length             Number of floats of each vertex
+    ///
+    /// @param points             Destination buffer of 20 * 'length' floats
+    ///
+    static void ComputeGregoryPoints(PatchDescriptor::Type type,
+        Index const * cvs, Index const * vertexValenceTable,
+        unsigned int const * quadOffsets, int maxValence,
+        float const * values, int stride, int length, float * points);
+
+    /// \brief Returns the quartic Bezier weights for a given (s,t) location on
+    /// a Loop end-cap patch (15 control points ordered by rows from the edge
+    /// of the first and second corners of the triangle)
+    static void GetLoopBezierWeights(PatchParam::BitField bits,
+        float s, float t, float point[15], float deriv1[15], float deriv2[15]);
+
 protected:
 
     friend class PatchTablesFactory;
+    friend class TopologyPartition;
 
     // Factory constructor
     PatchTables(int maxvalence);
@@ -444,6 +645,8 @@ protected:
 
     IndexArray getFVarVerts(int arrayIndex, int channel);
 
+    void compact();
+
 private:
 
     //
@@ -455,6 +658,21 @@ private:
     PatchArray & getPatchArray(Index arrayIndex);
     PatchArray const & getPatchArray(Index arrayIndex) const;
 
+    Index getSharpnessIndex(Index arrayIndex, Index patchIndex) const;
+
+    //
+    // Compact storage
+    //
+
+    struct CompactBlock;
+
+    CompactBlock const & findCompactBlock(Index patchIndex) const;
+
+    ConstIndexArray decodePatchVertices(Index patchIndex,
+        Index vertIndex, int size, Index * cvs) const;
+
+    PatchParam decodePatchParam(Index patchIndex) const;
+
 private:
 
     typedef std::vector<PatchArray> PatchArrayVector;
@@ -497,6 +715,18 @@ private:
 
     std::vector<Index>   _sharpnessIndices; // Indices of single-crease sharpness (one per patch)
     std::vector<float>   _sharpnessValues;  // Sharpness values.
+
+    //
+    // Compact storage (replaces the patch vertices and PatchParam tables, and
+    // keeps the sharpness indices of the single-crease patches only)
+    //
+
+    bool _isCompact;
+    int  _compactUVBits; // number of bits of the packed (u,v) patch coordinates
+
+    std::vector<CompactBlock>   _compactBlocks; // Runs of patches sharing vertex & face bases
+    std::vector<unsigned short> _compactVerts;  // Control vertices relative to their block
+    std::vector<unsigned int>   _compactParams; // Packed PatchParams (one per patch)
 };
 
 template <class T, class U>
@@ -710,6 +940,37 @@ PatchTables::InterpolateGregoryPatch(StencilTables const * basisStencils,
     }
 }
 
+template <class T, class U>
+inline void
+PatchTables::InterpolateLoopPatch(Index const * cvs,
+    float const * Q, float const *Qd1, float const *Qd2,
+        T const & src, U & dst) {
+
+    // the control vertices missing on boundaries have weights of 0 (their
+    // indices are those of a corner of the patch)
+    for (int k=0; k<12; ++k) {
+        dst.AddWithWeight(src[cvs[k]], Q[k], Qd1[k], Qd2[k]);
+    }
+}
+
+template <class T, class U>
+inline void
+PatchTables::InterpolateLoopBasisPatch(StencilTables const * basisStencils,
+    int stencilIndex, float const * Q, float const *Qd1, float const *Qd2,
+        T const & src, U & dst) {
+
+    for (int i=0; i<15; ++i) {
+        Stencil stencil = basisStencils->GetStencil(stencilIndex + i);
+        Index const * srcIndices = stencil.GetVertexIndices();
+        float const * srcWeights = stencil.GetWeights();
+        for (int j=0; j<stencil.GetSize(); ++j) {
+            dst.AddWithWeight( src[srcIndices[j]],
+                Q[i]*srcWeights[j], Qd1[i]*srcWeights[j],
+                     Qd2[i]*srcWeights[j]);
+        }
+    }
+}
+
 // Interpolates the limit position of a parametric location on a bilinear patch
 template <class T, class U>
 inline void
@@ -718,13 +979,12 @@ PatchTables::Interpolate(PatchHandle const & handle, float s, float t,
 
     assert(not IsFeatureAdaptive());
 
-    ConstIndexArray cvs = GetPatchVertices(handle);
+    Index buffer[MAX_PATCH_VERTICES];
+    ConstIndexArray cvs = GetPatchVertices(handle, buffer);
 
-    PatchParam::BitField const & bits =
-        _paramTable[handle.patchIndex].bitField;
+    PatchParam::BitField bits = GetPatchParam(handle).bitField;
     bits.Normalize(s,t);
 
-
     dst.Clear();
 
     InterpolateBilinear(cvs.begin(), s, t, src, dst);
@@ -738,7 +998,7 @@ PatchTables::Limit(PatchHandle const & handle, float s, float t,
 
     assert(IsFeatureAdaptive());
 
-    PatchParam::BitField const & bits = _paramTable[handle.patchIndex].bitField;
+    PatchParam::BitField bits = GetPatchParam(handle).bitField;
     bits.Normalize(s,t);
 
     PatchDescriptor::Type ptype =
@@ -748,11 +1008,13 @@ PatchTables::Limit(PatchHandle const & handle, float s, float t,
 
     float Q[16], Qd1[16], Qd2[16];
 
+    Index buffer[MAX_PATCH_VERTICES];
+
     if (ptype>=PatchDescriptor::REGULAR and ptype<=PatchDescriptor::CORNER) {
 
         GetBasisWeights(BASIS_BSPLINE, bits, s, t, Q, Qd1, Qd2);
 
-        ConstIndexArray cvs = GetPatchVertices(handle);
+        ConstIndexArray cvs = GetPatchVertices(handle, buffer);
 
         switch (ptype) {
             case PatchDescriptor::REGULAR:
@@ -784,11 +1046,74 @@ PatchTables::Limit(PatchHandle const & handle, float s, float t,
         InterpolateGregoryPatch(_endcapStencilTables, handle.vertIndex,
             s, t, Q, Qd1, Qd2, src, dst);
 
+    } else if (ptype==PatchDescriptor::LOOP) {
+
+        GetLoopBasisWeights(bits, s, t, Q, Qd1, Qd2);
+
+        InterpolateLoopPatch(GetPatchVertices(handle, buffer).begin(),
+            Q, Qd1, Qd2, src, dst);
+
+    } else if (ptype==PatchDescriptor::LOOP_BASIS) {
+
+        assert(_endcapStencilTables);
+
+        GetLoopBezierWeights(bits, s, t, Q, Qd1, Qd2);
+
+        InterpolateLoopBasisPatch(_endcapStencilTables, handle.vertIndex,
+            Q, Qd1, Qd2, src, dst);
+
     } else {
         assert(0);
     }
 }
 
+// Interpolates the limit face-varying value of a parametric location on a patch
+template <class T, class U>
+inline void
+PatchTables::LimitFaceVarying(PatchHandle const & handle, float s, float t,
+    T const & src, U & dst, int channel) const {
+
+    PatchParam::BitField bits = GetPatchParam(handle).bitField;
+    bits.Normalize(s,t);
+
+    PatchDescriptor::Type ptype = GetFVarPatchType(handle, channel);
+
+    ConstIndexArray values = GetFVarPatchValues(handle, channel);
+
+    dst.Clear();
+
+    float Q[16], Qd1[16], Qd2[16];
+
+    switch (ptype) {
+        case PatchDescriptor::REGULAR:
+            GetBasisWeights(BASIS_BSPLINE, bits, s, t, Q, Qd1, Qd2);
+            InterpolateRegularPatch(values.begin(), Q, Qd1, Qd2, src, dst);
+            break;
+        case PatchDescriptor::BOUNDARY:
+            GetBasisWeights(BASIS_BSPLINE, bits, s, t, Q, Qd1, Qd2);
+            InterpolateBoundaryPatch(values.begin(), Q, Qd1, Qd2, src, dst);
+            break;
+        case PatchDescriptor::CORNER:
+            GetBasisWeights(BASIS_BSPLINE, bits, s, t, Q, Qd1, Qd2);
+            InterpolateCornerPatch(values.begin(), Q, Qd1, Qd2, src, dst);
+            break;
+        case PatchDescriptor::QUADS:
+            GetBilinearWeights(bits, s, t, Q, Qd1, Qd2);
+            for (int k=0; k<4; ++k) {
+                dst.AddWithWeight(src[values[k]], Q[k], Qd1[k], Qd2[k]);
+            }
+            break;
+        case PatchDescriptor::TRIANGLES:
+            GetLinearWeights(bits, s, t, Q, Qd1, Qd2);
+            for (int k=0; k<3; ++k) {
+                dst.AddWithWeight(src[values[k]], Q[k], Qd1[k], Qd2[k]);
+            }
+            break;
+        default:
+            assert(0);
+    }
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
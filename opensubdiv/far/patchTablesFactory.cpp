@@ -23,6 +23,7 @@
 //
 #include "../far/patchTablesFactory.h"
 #include "../far/gregoryBasis.h"
+#include "../far/loopBasis.h"
 #include "../far/patchTables.h"
 #include "../far/topologyRefiner.h"
 #include "../vtr/level.h"
@@ -32,6 +33,10 @@
 #include <cassert>
 #include <cstring>
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
+
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -53,7 +58,9 @@ struct PatchTypes {
          C[NUM_TRANSITIONS][NUM_ROTATIONS],    // corner patch (4 rotations)
          G,                                    // gregory patch
          GB,                                   // gregory boundary patch
-         GP;                                   // gregory basis patch
+         GP,                                   // gregory basis patch
+         L,                                    // loop patch
+         LB;                                   // loop basis patch
 
     PatchTypes() { std::memset(this, 0, sizeof(PatchTypes<TYPE>)); }
 
@@ -67,6 +74,8 @@ struct PatchTypes {
             case PatchDescriptor::GREGORY          : return G;
             case PatchDescriptor::GREGORY_BOUNDARY : return GB;
             case PatchDescriptor::GREGORY_BASIS    : return GP;
+            case PatchDescriptor::LOOP             : return L;
+            case PatchDescriptor::LOOP_BASIS       : return LB;
             default : assert(0);
         }
         // can't be reached (suppress compiler warning)
@@ -91,9 +100,20 @@ struct PatchTypes {
         if (G) ++result;
         if (GB) ++result;
         if (GP) ++result;
+        if (L) ++result;
+        if (LB) ++result;
         return result;
     }
 
+    // Adds the values of 'other' (counters)
+    void add(PatchTypes<TYPE> const & other) {
+        TYPE * dst = &R[0];
+        TYPE const * src = &other.R[0];
+        for (int i=0; i<(int)(sizeof(PatchTypes<TYPE>)/sizeof(TYPE)); ++i) {
+            dst[i] += src[i];
+        }
+    }
+
     // Returns true if there's any single-crease patch
     bool hasSingleCreasedPatches() const {
         for (int i=0; i<6; ++i) {
@@ -384,6 +404,72 @@ namespace {
             std::memcpy(result, indices, count * sizeof(Far::Index));
         }
     }
+
+    //
+    //  Returns the value of the type of patch identified for a face (see
+    //  identifyAdaptivePatches()):
+    //
+    template <class TYPE> TYPE &
+    getPatchTypeValue(PatchTypes<TYPE> & types, PatchFaceTag const & patchTag, bool hasGregoryBasis) {
+
+        if (patchTag._isRegular) {
+            int transIndex = patchTag._transitionType;
+            int transRot   = patchTag._transitionRot;
+
+            if (!patchTag._isSingleCrease && patchTag._boundaryCount == 0) {
+                return types.R[transIndex];
+            } else if (patchTag._isSingleCrease && patchTag._boundaryCount == 0) {
+                return types.S[transIndex][transRot];
+            } else if (patchTag._boundaryCount == 1) {
+                return types.B[transIndex][transRot];
+            } else {
+                return types.C[transIndex][transRot];
+            }
+        }
+        // if end-cap patches use a stencils-driven basis, we don't need
+        // to track regular / boundary cases
+        if (hasGregoryBasis) {
+            return types.GP;
+        }
+        return (patchTag._boundaryCount == 0) ? types.G : types.GB;
+    }
+
+    //
+    //  Counts the patches of the faces of a level, divided into blocks of faces that can be
+    //  processed concurrently (a single block unless 'parallel'):
+    //
+    void
+    countLevelPatches(PatchFaceTag const * levelPatchTags, int numFaces,
+                      bool hasGregoryBasis, bool parallel,
+                      std::vector<PatchTypes<int> > & blockCounts) {
+
+        int numBlocks = 1;
+#ifdef OPENSUBDIV_HAS_OPENMP
+        if (parallel) {
+            numBlocks = std::max(1, std::min(4 * omp_get_max_threads(), numFaces / 1024));
+        }
+#else
+        (void)parallel;
+#endif
+        int blockSize = (numFaces + numBlocks - 1) / numBlocks;
+
+        blockCounts.assign(numBlocks, PatchTypes<int>());
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (parallel)
+#endif
+        for (int block = 0; block < numBlocks; ++block) {
+            int faceBegin = block * blockSize,
+                faceEnd   = std::min(faceBegin + blockSize, numFaces);
+
+            PatchTypes<int> & counts = blockCounts[block];
+            for (int face = faceBegin; face < faceEnd; ++face) {
+                if (levelPatchTags[face]._hasPatch) {
+                    ++getPatchTypeValue(counts, levelPatchTags[face], hasGregoryBasis);
+                }
+            }
+        }
+    }
 } // namespace anon
 
 //
@@ -452,6 +538,16 @@ PatchTablesFactory::allocateFVarTables( TopologyRefiner const & refiner,
 
         for (int channel=0; channel<refiner.GetNumFVarChannels(); ++channel) {
             fvarTables->_channels[channel].patchVertIndices.resize(nverts);
+
+            // bi-cubic face-varying patches (linear channels remain bilinear,
+            // and the channels of Loop triangles linear)
+            if (not refiner.isFVarChannelLinear(channel) and
+                refiner.GetSchemeType() != Sdc::SCHEME_LOOP) {
+                fvarTables->_channels[channel].patchTypes.resize(
+                    tables.GetNumPatchesTotal(), PatchDescriptor::QUADS);
+                fvarTables->_channels[channel].patchValueIndices.resize(
+                    tables.GetNumControlVerticesTotal(), Vtr::INDEX_INVALID);
+            }
         }
     }
 
@@ -469,6 +565,10 @@ PatchTablesFactory::computePatchParam(TopologyRefiner const & refiner,
 
     if (coord == NULL) return NULL;
 
+    if (refiner.GetSchemeType() == Sdc::SCHEME_LOOP) {
+        return computeTriPatchParam(refiner, depth, faceIndex, coord);
+    }
+
     // Move up the hierarchy accumulating u,v indices to the coarse level:
     int childIndexInParent = 0,
         u = 0,
@@ -520,6 +620,58 @@ PatchTablesFactory::computePatchParam(TopologyRefiner const & refiner,
     return ++coord;
 }
 
+//
+//  Populates the PatchParam of a triangle of a Loop mesh:  each triangle is split
+//  into 3 corner children -- with the orientation of their parent -- and an inverted
+//  center child.  The (u,v) of the sub-patch identify the corner of the cell of the
+//  ptex face that is the origin of an upright sub-patch, or the opposite corner of
+//  an inverted sub-patch (rotation 2).
+//
+PatchParam *
+PatchTablesFactory::computeTriPatchParam(TopologyRefiner const & refiner,
+                                         int depth, Vtr::Index faceIndex,
+                                         PatchParam *coord) {
+
+    assert(depth < 16);
+
+    // Move up the hierarchy gathering the index of the child faces:
+    unsigned char childIndices[16];
+    for (int i = depth; i > 0; --i) {
+        Vtr::Refinement const& refinement = refiner.getRefinement(i-1);
+
+        childIndices[i-1] = (unsigned char)refinement.getChildFaceInParentFace(faceIndex);
+        faceIndex = refinement.getChildFaceParentFace(faceIndex);
+    }
+
+    // ... and move back down locating the origin of each child in its parent:
+    int u = 0,
+        v = 0;
+    bool inverted = false;
+    for (int i = 0; i < depth; ++i) {
+        int ofs = inverted ? -1 : 1;
+        u <<= 1;
+        v <<= 1;
+        switch (childIndices[i]) {
+            case 0 :                               break;
+            case 1 : { u+=ofs;                   } break;
+            case 2 : {         v+=ofs;           } break;
+            case 3 : { u+=ofs; v+=ofs; inverted = not inverted; } break;
+        }
+    }
+    if (inverted) {
+        --u;
+        --v;
+    }
+
+    Vtr::Index ptexIndex = refiner.GetPtexIndex(faceIndex);
+    assert(ptexIndex!=-1);
+
+    coord->Set(ptexIndex, (short)u, (short)v, (unsigned char)(inverted ? 2 : 0),
+        (unsigned char) depth, false);
+
+    return ++coord;
+}
+
 // XXXX manuelk work in progress for end-cap topology gathering
 #ifdef ENDCAP_TOPOPOLGY
 //
@@ -662,11 +814,13 @@ PatchTablesFactory::assignSharpnessIndex( PatchTables *tables, float sharpness )
 PatchTables *
 PatchTablesFactory::Create( TopologyRefiner const & refiner, Options options ) {
 
-    if (refiner.IsUniform()) {
-        return createUniform(refiner, options);
-    } else {
-        return createAdaptive(refiner, options);
+    PatchTables * tables = refiner.IsUniform() ?
+        createUniform(refiner, options) : createAdaptive(refiner, options);
+
+    if (options.compactStorage) {
+        tables->compact();
     }
+    return tables;
 }
 
 static void
@@ -676,12 +830,52 @@ gatherFVarPatchVertices(TopologyRefiner const & refiner,
     for (int channel=0; channel<refiner.GetNumFVarChannels(); ++channel) {
         ConstIndexArray fverts = refiner.GetFVarFaceValues(level, faceIndex, channel);
         for (int vert=0; vert<fverts.size(); ++vert) {
-            fptrs[channel][vert] = levelOffsets[channel] + fverts[(vert+rotation)%4];
+            fptrs[channel][vert] = levelOffsets[channel] + fverts[(vert+rotation)%fverts.size()];
         }
         fptrs[channel]+=fverts.size();
     }
 }
 
+//
+//  Gathers the face-varying values of a regular, boundary or corner patch for bi-cubic
+//  interpolation.  The values are stored with the same layout as the vertices of the patch,
+//  which have just been populated.  Patches whose face-varying topology does not match the
+//  vertex topology retain the bilinear interpolation of their corner values.
+//
+void
+PatchTablesFactory::gatherFVarBicubicPatchValues( TopologyRefiner const & refiner, int level,
+    Index face, PatchDescriptor::Type type, Index const * patchVerts, int numPatchVerts,
+    Index levelVertOffset, Index const * levelFVarOffsets, PatchParam const * patchParam,
+    PatchTables * tables ) {
+
+    assert(numPatchVerts<=16);
+
+    Index patchIndex = (Index)(patchParam - &tables->_paramTable[0]),
+          vertOffset = (Index)(patchVerts - &tables->_patchVerts[0]);
+
+    Index levelPatchVerts[16];
+    for (int i=0; i<numPatchVerts; ++i) {
+        levelPatchVerts[i] = patchVerts[i] - levelVertOffset;
+    }
+
+    for (int channel=0; channel<refiner.GetNumFVarChannels(); ++channel) {
+
+        FVarPatchTables::Channel & fvarChannel = tables->_fvarPatchTables->_channels[channel];
+        if (fvarChannel.patchTypes.empty()) {
+            continue;
+        }
+
+        Index * values = &fvarChannel.patchValueIndices[vertOffset];
+
+        if (refiner.gatherFVarPatchValues(level, face, levelPatchVerts, numPatchVerts, channel, values)) {
+            for (int i=0; i<numPatchVerts; ++i) {
+                values[i] += levelFVarOffsets[channel];
+            }
+            fvarChannel.patchTypes[patchIndex] = (unsigned char)type;
+        }
+    }
+}
+
 PatchTables *
 PatchTablesFactory::createUniform( TopologyRefiner const & refiner, Options options ) {
 
@@ -836,7 +1030,13 @@ PatchTablesFactory::createAdaptive( TopologyRefiner const & refiner, Options opt
     PatchCounters             patchInventory;
     std::vector<PatchFaceTag> patchTags;
 
-    identifyAdaptivePatches(refiner, patchInventory, patchTags, options);
+    bool isLoop = (refiner.GetSchemeType() == Sdc::SCHEME_LOOP);
+
+    if (isLoop) {
+        identifyAdaptiveLoopPatches(refiner, patchInventory, patchTags);
+    } else {
+        identifyAdaptivePatches(refiner, patchInventory, patchTags, options);
+    }
 
     //
     //  Create the instance of the tables and allocate and initialize its members based on
@@ -852,7 +1052,7 @@ PatchTablesFactory::createAdaptive( TopologyRefiner const & refiner, Options opt
     // sort through the inventory and push back non-empty patch arrays
     typedef PatchDescriptorVector DescVec;
 
-    DescVec const & descs = PatchDescriptor::GetAdaptivePatchDescriptors(Sdc::SCHEME_CATMARK);
+    DescVec const & descs = PatchDescriptor::GetAdaptivePatchDescriptors(refiner.GetSchemeType());
 
     int voffset=0, poffset=0, qoffset=0;
     for (DescVec::const_iterator it=descs.begin(); it!=descs.end(); ++it) {
@@ -877,7 +1077,11 @@ PatchTablesFactory::createAdaptive( TopologyRefiner const & refiner, Options opt
     //
     //  Now populate the patches:
     //
-    populateAdaptivePatches(refiner, patchInventory, patchTags, tables, options);
+    if (isLoop) {
+        populateAdaptiveLoopPatches(refiner, patchInventory, patchTags, tables, options);
+    } else {
+        populateAdaptivePatches(refiner, patchInventory, patchTags, tables, options);
+    }
 
     return tables;
 }
@@ -929,7 +1133,16 @@ PatchTablesFactory::identifyAdaptivePatches( TopologyRefiner const & refiner,
 
         Vtr::Refinement::SparseTag const * vtrFaceTags = refineNext ? &refineNext->_parentFaceTag[0] : 0;
 
-        for (int faceIndex = 0; faceIndex < level->getNumFaces(); ++faceIndex) {
+        //
+        //  The patch of each face is identified independently, so the faces can be inspected
+        //  concurrently -- the patches are counted once all faces of the level are tagged:
+        //
+        int numFaces = level->getNumFaces();
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (options.parallelCreation)
+#endif
+        for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
 
             if (level->isHole(faceIndex)) {
                 continue;
@@ -1078,61 +1291,50 @@ PatchTablesFactory::identifyAdaptivePatches( TopologyRefiner const & refiner,
                 }
             }
 
-            //
-            //  Identify and increment counts for regular patches (both non-transitional and
-            //  transitional) and extra-ordinary patches (always non-transitional):
-            //
-            if (patchTag._isRegular) {
-                int transIndex = patchTag._transitionType;
-                int transRot   = patchTag._transitionRot;
+        }
 
-                if (!patchTag._isSingleCrease && patchTag._boundaryCount == 0) {
-                    patchInventory.R[transIndex]++;
-                } else if (patchTag._isSingleCrease && patchTag._boundaryCount == 0) {
-                    patchInventory.S[transIndex][transRot]++;
-                } else if (patchTag._boundaryCount == 1) {
-                    patchInventory.B[transIndex][transRot]++;
-                } else {
-                    patchInventory.C[transIndex][transRot]++;
-                }
-            } else {
-                // if end-cap patches use a stencils-driven basis, we don't need
-                // to track regular / boundary cases
-                if (not options.adaptiveStencilTables) {
-                    if (patchTag._boundaryCount == 0) {
-                        patchInventory.G++;
-                    } else {
-                        patchInventory.GB++;
-                    }
-                } else {
-                    patchInventory.GP++;
-                }
-            }
+        //
+        //  Identify and increment counts for regular patches (both non-transitional and
+        //  transitional) and extra-ordinary patches (always non-transitional):
+        //
+        std::vector<PatchCounters> blockCounts;
+        countLevelPatches(levelPatchTags, numFaces, options.adaptiveStencilTables!=0,
+            options.parallelCreation, blockCounts);
+
+        for (int block = 0; block < (int)blockCounts.size(); ++block) {
+            patchInventory.add(blockCounts[block]);
         }
+
         levelPatchTags += level->getNumFaces();
     }
 }
 
 //
-//  Populate all adaptive patches now that the tables to hold data for them have been allocated.
-//  We need the inventory (counts per patch type) and the patch tags per face that were previously
-//  idenified.
+//  Populates the patches of the faces [faceBegin, faceEnd) of a level, given the offsets of the
+//  first patch of each type of the block in the patch arrays (see populateAdaptivePatches()).
 //
 void
-PatchTablesFactory::populateAdaptivePatches( TopologyRefiner const & refiner,
-                                             PatchCounters const &   patchInventory,
-                                             PatchTagVector const &  patchTags,
-                                             PatchTables *           tables,
-                                             Options                 options ) {
+PatchTablesFactory::populateAdaptivePatchBlock( TopologyRefiner const & refiner,
+                                                PatchCounters const &   patchInventory,
+                                                PatchCounters           patchOffsets,
+                                                int                     i,
+                                                int                     faceBegin,
+                                                int                     faceEnd,
+                                                PatchFaceTag const *    levelPatchTags,
+                                                int                     levelVertOffset,
+                                                int const *             levelFVarVertOffsets,
+                                                PatchTables *           tables,
+                                                Options                 options ) {
+
+    Vtr::Level const * level = &refiner.getLevel(i);
 
     //
-    //  Setup convenience pointers at the beginning of each patch array for each
-    // table (patches, ptex)
+    //  Setup convenience pointers at the first patch of the block in each patch array for
+    //  each table (patches, ptex)
     //
     PatchCVPointers    iptrs;
     PatchParamPointers pptrs;
     PatchFVarPointers  fptrs;
-    SharpnessIndexPointers sptrs;
 
     typedef PatchDescriptorVector DescVec;
 
@@ -1146,11 +1348,12 @@ PatchTablesFactory::populateAdaptivePatches( TopologyRefiner const & refiner,
             continue;
         }
 
-        iptrs.getValue( *it ) = tables->getPatchArrayVertices(arrayIndex).begin();
-        pptrs.getValue( *it ) = tables->getPatchParams(arrayIndex).begin();
-        if (patchInventory.hasSingleCreasedPatches()) {
-            sptrs.getValue( *it ) = tables->getSharpnessIndices(arrayIndex);
-        }
+        // XXXX manuelk Gregory basis patches only point to the 4 corners of the 0-ring
+        int firstPatch = patchOffsets.getValue( *it ),
+            numCVs = (it->GetType()==PatchDescriptor::GREGORY_BASIS) ? 4 : it->GetNumControlVertices();
+
+        iptrs.getValue( *it ) = tables->getPatchArrayVertices(arrayIndex).begin() + firstPatch * numCVs;
+        pptrs.getValue( *it ) = tables->getPatchParams(arrayIndex).begin() + firstPatch;
 
         if (tables->_fvarPatchTables) {
             // XXXX manuelk revisit when implementing bi-cubic fvar interp !!!
@@ -1159,14 +1362,191 @@ PatchTablesFactory::populateAdaptivePatches( TopologyRefiner const & refiner,
             Index ** fptr = (Index **)alloca(nchannels*sizeof(Index *));
             for (int channel=0; channel<nchannels; ++channel) {
 
-                fptr[channel] = tables->getFVarVerts(arrayIndex, channel).begin();
+                fptr[channel] = tables->getFVarVerts(arrayIndex, channel).begin() +
+                    firstPatch * it->GetNumFVarControlVertices();
             }
             fptrs.getValue( *it ) = fptr;
         }
     }
 
-    unsigned int * quad_G_C0_P = patchInventory.G>0 ? &tables->_quadOffsetsTable[0] : 0,
-                 * quad_G_C1_P = patchInventory.GB>0 ? &tables->_quadOffsetsTable[patchInventory.G*4] : 0;
+    unsigned int * quad_G_C0_P = patchInventory.G>0 ?
+                     &tables->_quadOffsetsTable[patchOffsets.G*4] : 0,
+                 * quad_G_C1_P = patchInventory.GB>0 ?
+                     &tables->_quadOffsetsTable[(patchInventory.G + patchOffsets.GB)*4] : 0;
+
+    bool hasGregoryBasis = (options.adaptiveStencilTables != 0);
+
+    for (int faceIndex = faceBegin; faceIndex < faceEnd; ++faceIndex) {
+
+        if (level->isHole(faceIndex)) {
+            continue;
+        }
+
+        const PatchFaceTag& patchTag = levelPatchTags[faceIndex];
+        if (not patchTag._hasPatch) {
+            continue;
+        }
+
+        if (patchTag._isRegular) {
+            Index patchVerts[16];
+
+            int tIndex = patchTag._transitionType;
+            int rIndex = patchTag._transitionRot;
+            int bIndex = patchTag._boundaryIndex;
+
+            if (!patchTag._isSingleCrease && patchTag._boundaryCount == 0) {
+                int const permuteInterior[16] = { 5, 6, 7, 8, 4, 0, 1, 9, 15, 3, 2, 10, 14, 13, 12, 11 };
+
+                level->gatherQuadRegularInteriorPatchVertices(faceIndex, patchVerts, rIndex);
+                offsetAndPermuteIndices(patchVerts, 16, levelVertOffset, permuteInterior, iptrs.R[tIndex]);
+
+                iptrs.R[tIndex] += 16;
+                pptrs.R[tIndex] = computePatchParam(refiner, i, faceIndex, rIndex, pptrs.R[tIndex]);
+
+                if (tables->_fvarPatchTables) {
+                    gatherFVarPatchVertices(refiner, i, faceIndex, rIndex, levelFVarVertOffsets, fptrs.R[tIndex]);
+                    gatherFVarBicubicPatchValues(refiner, i, faceIndex, PatchDescriptor::REGULAR,
+                        iptrs.R[tIndex]-16, 16, levelVertOffset, levelFVarVertOffsets, pptrs.R[tIndex]-1, tables);
+                }
+            } else {
+                //  For the boundary and corner cases, the Hbr code makes some adjustments to the
+                //  rotations here from the way they were defined earlier.  That raises questions
+                //  as to the purpose of the earlier assignments and their naming.  I'd prefer to
+                //  label the sets of rotations for their intended purpose, and to compute and
+                //  assign them earlier for use here with no adjustment.
+                //
+                //  Non-transition case:
+                //      rot = 0;  // outside switch
+                //      f->_adaptiveFlags.brots = (f->_adaptiveFlags.rots + 1) % 4;
+                //  Transition case:
+                //      rot = f->_adaptiveFlags.brots;  //  is this now same as transition rots?
+                //
+                //  Both cases of "rot" above are now handled with the "transition rotation" -- still
+                //  not clear what the purpose of the other is.  Need to look into usage of these
+                //  adaptive-flag rotations in:
+                //      getOneRing, computePatchParam, computeFVarData
+                //  It may be that a separate "face rotation" flag is warranted if we need something
+                //  else dependent on the boundary orientation.
+                //
+                if (patchTag._isSingleCrease && patchTag._boundaryCount==0) {
+                    int const permuteInterior[16] = { 5, 6, 7, 8, 4, 0, 1, 9, 15, 3, 2, 10, 14, 13, 12, 11 };
+                    level->gatherQuadRegularInteriorPatchVertices(faceIndex, patchVerts, bIndex);
+                    offsetAndPermuteIndices(patchVerts, 16, levelVertOffset, permuteInterior, iptrs.S[tIndex][rIndex]);
+
+                    iptrs.S[tIndex][rIndex] += 16;
+                    pptrs.S[tIndex][rIndex] = computePatchParam(refiner, i, faceIndex, bIndex, pptrs.S[tIndex][rIndex]);
+
+                    if (tables->_fvarPatchTables) {
+                        gatherFVarPatchVertices(refiner, i, faceIndex, bIndex, levelFVarVertOffsets, fptrs.S[tIndex][rIndex]);
+                    }
+                } else if (patchTag._boundaryCount == 1) {
+                    int const permuteBoundary[12] = { 11, 3, 0, 4, 10, 2, 1, 5, 9, 8, 7, 6 };
+
+                    level->gatherQuadRegularBoundaryPatchVertices(faceIndex, patchVerts, bIndex);
+                    offsetAndPermuteIndices(patchVerts, 12, levelVertOffset, permuteBoundary, iptrs.B[tIndex][rIndex]);
+
+                    iptrs.B[tIndex][rIndex] += 12;
+                    pptrs.B[tIndex][rIndex] = computePatchParam(refiner, i, faceIndex, bIndex, pptrs.B[tIndex][rIndex]);
+
+                    if (tables->_fvarPatchTables) {
+                        gatherFVarPatchVertices(refiner, i, faceIndex, bIndex, levelFVarVertOffsets, fptrs.B[tIndex][rIndex]);
+                        gatherFVarBicubicPatchValues(refiner, i, faceIndex, PatchDescriptor::BOUNDARY,
+                            iptrs.B[tIndex][rIndex]-12, 12, levelVertOffset, levelFVarVertOffsets, pptrs.B[tIndex][rIndex]-1, tables);
+                    }
+                } else {
+                    int const permuteCorner[9] = { 8, 3, 0, 7, 2, 1, 6, 5, 4 };
+
+                    level->gatherQuadRegularCornerPatchVertices(faceIndex, patchVerts, bIndex);
+                    offsetAndPermuteIndices(patchVerts, 9, levelVertOffset, permuteCorner, iptrs.C[tIndex][rIndex]);
+
+                    bIndex = (bIndex+3)%4;
+
+                    iptrs.C[tIndex][rIndex] += 9;
+                    pptrs.C[tIndex][rIndex] = computePatchParam(refiner, i, faceIndex, bIndex, pptrs.C[tIndex][rIndex]);
+
+                    if (tables->_fvarPatchTables) {
+                        gatherFVarPatchVertices(refiner, i, faceIndex, bIndex, levelFVarVertOffsets, fptrs.C[tIndex][rIndex]);
+                        gatherFVarBicubicPatchValues(refiner, i, faceIndex, PatchDescriptor::CORNER,
+                            iptrs.C[tIndex][rIndex]-9, 9, levelVertOffset, levelFVarVertOffsets, pptrs.C[tIndex][rIndex]-1, tables);
+                    }
+                }
+            }
+        } else {
+            if (hasGregoryBasis) {
+                // Gregory basis end-cap (20 CVs - no quad-offsets / valence tables)
+                // Gregory Boundary Patch (4 CVs 0-ring for varying interpolation)
+                Vtr::ConstIndexArray faceVerts = level->getFaceVertices(faceIndex);
+                for (int j = 0; j < 4; ++j) {
+                    iptrs.GP[j] = faceVerts[j] + levelVertOffset;
+                }
+                iptrs.GP += 4;
+
+                pptrs.GP = computePatchParam(refiner, i, faceIndex, 0, pptrs.GP);
+
+                if (tables->_fvarPatchTables) {
+                    gatherFVarPatchVertices(refiner, i, faceIndex, 0, levelFVarVertOffsets, fptrs.GP);
+                }
+            } else {
+                if (patchTag._boundaryCount == 0) {
+                    // Gregory Regular Patch (4 CVs + quad-offsets / valence tables)
+                    Vtr::ConstIndexArray faceVerts = level->getFaceVertices(faceIndex);
+                    for (int j = 0; j < 4; ++j) {
+                        iptrs.G[j] = faceVerts[j] + levelVertOffset;
+                    }
+                    iptrs.G += 4;
+
+                    getQuadOffsets(*level, faceIndex, quad_G_C0_P);
+                    quad_G_C0_P += 4;
+
+                    pptrs.G = computePatchParam(refiner, i, faceIndex, 0, pptrs.G);
+
+                    if (tables->_fvarPatchTables) {
+                        gatherFVarPatchVertices(refiner, i, faceIndex, 0, levelFVarVertOffsets, fptrs.G);
+                    }
+                } else {
+                    // Gregory Boundary Patch (4 CVs + quad-offsets / valence tables)
+                    Vtr::ConstIndexArray faceVerts = level->getFaceVertices(faceIndex);
+                    for (int j = 0; j < 4; ++j) {
+                        iptrs.GB[j] = faceVerts[j] + levelVertOffset;
+                    }
+                    iptrs.GB += 4;
+
+                    getQuadOffsets(*level, faceIndex, quad_G_C1_P);
+                    quad_G_C1_P += 4;
+
+                    //int bIndex = (patchTag._boundaryIndex+1)%4;
+
+                    pptrs.GB = computePatchParam(refiner, i, faceIndex, 0, pptrs.GB);
+
+                    if (tables->_fvarPatchTables) {
+                        gatherFVarPatchVertices(refiner, i, faceIndex, 0, levelFVarVertOffsets, fptrs.GB);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//
+//  Populate all adaptive patches now that the tables to hold data for them have been allocated.
+//  We need the inventory (counts per patch type) and the patch tags per face that were previously
+//  idenified.
+//
+//  The faces of each level are divided into blocks whose patches are counted and located in the
+//  patch arrays ahead of time, so that the blocks can be populated concurrently.  Assigning the
+//  sharpness indices and building the end-cap stencils depend on the order of the faces, so they
+//  are dealt with in a subsequent serial traversal.
+//
+void
+PatchTablesFactory::populateAdaptivePatches( TopologyRefiner const & refiner,
+                                             PatchCounters const &   patchInventory,
+                                             PatchTagVector const &  patchTags,
+                                             PatchTables *           tables,
+                                             Options                 options ) {
+
+    typedef PatchDescriptorVector DescVec;
+
+    DescVec const & descs = PatchDescriptor::GetAdaptivePatchDescriptors(Sdc::SCHEME_CATMARK);
 
     std::vector<unsigned char> gregoryVertexFlags;
 
@@ -1176,6 +1556,8 @@ PatchTablesFactory::populateAdaptivePatches( TopologyRefiner const & refiner,
     //
     bool hasGregoryPatches = (patchInventory.G > 0) or (patchInventory.GB > 0) or (patchInventory.GP > 0);
     GregoryBasisFactory * gregoryStencilsFactory = 0;
+    std::vector<Index> gregoryBasisFaces;
+    std::vector<int> gregoryBasisLevels;
 #ifdef ENDCAP_TOPOPOLGY
     int numGregoryBasisVertices=0;
     std::vector<Index> gregoryBasisIndices;
@@ -1191,6 +1573,9 @@ PatchTablesFactory::populateAdaptivePatches( TopologyRefiner const & refiner,
             gregoryStencilsFactory =
                 new GregoryBasisFactory(refiner, *adaptiveStencils, npatches, maxvalence);
 
+            gregoryBasisFaces.reserve(npatches);
+            gregoryBasisLevels.reserve(npatches);
+
 #ifdef ENDCAP_TOPOPOLGY
             gregoryBasisIndices.reserve(npatches);
             tables->_endcapTopology.resize(npatches*20);
@@ -1206,185 +1591,140 @@ PatchTablesFactory::populateAdaptivePatches( TopologyRefiner const & refiner,
     int levelVertOffset = 0;
     int * levelFVarVertOffsets = 0;
     if (tables->_fvarPatchTables) {
-         levelFVarVertOffsets = (int *)alloca(refiner.GetNumFVarChannels());
+         levelFVarVertOffsets = (int *)alloca(refiner.GetNumFVarChannels()*sizeof(int));
          memset(levelFVarVertOffsets, 0, refiner.GetNumFVarChannels()*sizeof(int));
     }
 
+    bool hasGregoryBasis = (options.adaptiveStencilTables != 0);
+
+    PatchCounters patchOffsets;
+
+    std::vector<PatchCounters> blockOffsets;
+
     for (int i = 0; i < refiner.GetNumLevels(); ++i) {
         Vtr::Level const * level = &refiner.getLevel(i);
 
         const PatchFaceTag * levelPatchTags = &patchTags[levelFaceOffset];
 
-        for (int faceIndex = 0; faceIndex < level->getNumFaces(); ++faceIndex) {
+        int numFaces = level->getNumFaces();
 
-            if (level->isHole(faceIndex)) {
-                continue;
-            }
+        //
+        //  Count the patches of each block and convert the counts into the offsets of the
+        //  first patch of each type of the blocks in the patch arrays:
+        //
+        countLevelPatches(levelPatchTags, numFaces, hasGregoryBasis,
+            options.parallelCreation, blockOffsets);
 
-            const PatchFaceTag& patchTag = levelPatchTags[faceIndex];
-            if (not patchTag._hasPatch) {
-                continue;
-            }
+        int numBlocks = (int)blockOffsets.size(),
+            blockSize = (numFaces + numBlocks - 1) / numBlocks;
 
-            if (patchTag._isRegular) {
-                Index patchVerts[16];
+        for (int block = 0; block < numBlocks; ++block) {
+            PatchCounters blockCount = blockOffsets[block];
+            blockOffsets[block] = patchOffsets;
+            patchOffsets.add(blockCount);
+        }
 
-                int tIndex = patchTag._transitionType;
-                int rIndex = patchTag._transitionRot;
-                int bIndex = patchTag._boundaryIndex;
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (options.parallelCreation)
+#endif
+        for (int block = 0; block < numBlocks; ++block) {
+            int faceBegin = block * blockSize,
+                faceEnd   = std::min(faceBegin + blockSize, numFaces);
 
-                if (!patchTag._isSingleCrease && patchTag._boundaryCount == 0) {
-                    int const permuteInterior[16] = { 5, 6, 7, 8, 4, 0, 1, 9, 15, 3, 2, 10, 14, 13, 12, 11 };
+            populateAdaptivePatchBlock(refiner, patchInventory, blockOffsets[block],
+                i, faceBegin, faceEnd, levelPatchTags, levelVertOffset, levelFVarVertOffsets,
+                    tables, options);
+        }
 
-                    level->gatherQuadRegularInteriorPatchVertices(faceIndex, patchVerts, rIndex);
-                    offsetAndPermuteIndices(patchVerts, 16, levelVertOffset, permuteInterior, iptrs.R[tIndex]);
+        levelFaceOffset += level->getNumFaces();
+        levelVertOffset += level->getNumVertices();
+        if (tables->_fvarPatchTables) {
+            int nchannels = refiner.GetNumFVarChannels();
+            for (int channel=0; channel<nchannels; ++channel) {
+                levelFVarVertOffsets[channel] += refiner.GetNumFVarValues(i, channel);
+            }
+        }
+    }
 
-                    iptrs.R[tIndex] += 16;
-                    pptrs.R[tIndex] = computePatchParam(refiner, i, faceIndex, rIndex, pptrs.R[tIndex]);
+    //
+    //  Assign the sharpness indices of the single-crease patches, and mark the vertices and
+    //  gather the bases of the gregory patches, in the order of the faces:
+    //
+    if (patchInventory.hasSingleCreasedPatches() or hasGregoryPatches) {
 
-                    if (tables->_fvarPatchTables) {
-                        gatherFVarPatchVertices(refiner, i, faceIndex, rIndex, levelFVarVertOffsets, fptrs.R[tIndex]);
-                    }
-                } else {
-                    //  For the boundary and corner cases, the Hbr code makes some adjustments to the
-                    //  rotations here from the way they were defined earlier.  That raises questions
-                    //  as to the purpose of the earlier assignments and their naming.  I'd prefer to
-                    //  label the sets of rotations for their intended purpose, and to compute and
-                    //  assign them earlier for use here with no adjustment.
-                    //
-                    //  Non-transition case:
-                    //      rot = 0;  // outside switch
-                    //      f->_adaptiveFlags.brots = (f->_adaptiveFlags.rots + 1) % 4;
-                    //  Transition case:
-                    //      rot = f->_adaptiveFlags.brots;  //  is this now same as transition rots?
-                    //
-                    //  Both cases of "rot" above are now handled with the "transition rotation" -- still
-                    //  not clear what the purpose of the other is.  Need to look into usage of these
-                    //  adaptive-flag rotations in:
-                    //      getOneRing, computePatchParam, computeFVarData
-                    //  It may be that a separate "face rotation" flag is warranted if we need something
-                    //  else dependent on the boundary orientation.
-                    //
-                    if (patchTag._isSingleCrease && patchTag._boundaryCount==0) {
-                        int const permuteInterior[16] = { 5, 6, 7, 8, 4, 0, 1, 9, 15, 3, 2, 10, 14, 13, 12, 11 };
-                        level->gatherQuadRegularInteriorPatchVertices(faceIndex, patchVerts, bIndex);
-                        offsetAndPermuteIndices(patchVerts, 16, levelVertOffset, permuteInterior, iptrs.S[tIndex][rIndex]);
+        SharpnessIndexPointers sptrs;
 
-                        int creaseEdge = (bIndex+2)%4;
-                        float sharpness = level->getEdgeSharpness((level->getFaceEdges(faceIndex)[creaseEdge]));
-                        sharpness = std::min(sharpness, (float)(options.maxIsolationLevel-i));
+        if (patchInventory.hasSingleCreasedPatches()) {
+            for (DescVec::const_iterator it=descs.begin(); it!=descs.end(); ++it) {
 
-                        iptrs.S[tIndex][rIndex] += 16;
-                        pptrs.S[tIndex][rIndex] = computePatchParam(refiner, i, faceIndex, bIndex, pptrs.S[tIndex][rIndex]);
-                        *sptrs.S[tIndex][rIndex]++ = assignSharpnessIndex(tables, sharpness);
+                Index arrayIndex = tables->findPatchArray(*it);
 
-                        if (tables->_fvarPatchTables) {
-                            gatherFVarPatchVertices(refiner, i, faceIndex, bIndex, levelFVarVertOffsets, fptrs.S[tIndex][rIndex]);
-                        }
-                    } else if (patchTag._boundaryCount == 1) {
-                        int const permuteBoundary[12] = { 11, 3, 0, 4, 10, 2, 1, 5, 9, 8, 7, 6 };
+                if (arrayIndex==Vtr::INDEX_INVALID) {
+                    continue;
+                }
+                sptrs.getValue( *it ) = tables->getSharpnessIndices(arrayIndex);
+            }
+        }
 
-                        level->gatherQuadRegularBoundaryPatchVertices(faceIndex, patchVerts, bIndex);
-                        offsetAndPermuteIndices(patchVerts, 12, levelVertOffset, permuteBoundary, iptrs.B[tIndex][rIndex]);
+        levelFaceOffset = 0;
+        levelVertOffset = 0;
 
-                        iptrs.B[tIndex][rIndex] += 12;
-                        pptrs.B[tIndex][rIndex] = computePatchParam(refiner, i, faceIndex, bIndex, pptrs.B[tIndex][rIndex]);
+        for (int i = 0; i < refiner.GetNumLevels(); ++i) {
+            Vtr::Level const * level = &refiner.getLevel(i);
 
-                        if (tables->_fvarPatchTables) {
-                            gatherFVarPatchVertices(refiner, i, faceIndex, bIndex, levelFVarVertOffsets, fptrs.B[tIndex][rIndex]);
-                        }
-                    } else {
-                        int const permuteCorner[9] = { 8, 3, 0, 7, 2, 1, 6, 5, 4 };
+            const PatchFaceTag * levelPatchTags = &patchTags[levelFaceOffset];
+
+            for (int faceIndex = 0; faceIndex < level->getNumFaces(); ++faceIndex) {
+
+                if (level->isHole(faceIndex)) {
+                    continue;
+                }
 
-                        level->gatherQuadRegularCornerPatchVertices(faceIndex, patchVerts, bIndex);
-                        offsetAndPermuteIndices(patchVerts, 9, levelVertOffset, permuteCorner, iptrs.C[tIndex][rIndex]);
+                const PatchFaceTag& patchTag = levelPatchTags[faceIndex];
+                if (not patchTag._hasPatch) {
+                    continue;
+                }
 
-                        bIndex = (bIndex+3)%4;
+                if (patchTag._isRegular) {
+                    if (patchTag._isSingleCrease && patchTag._boundaryCount==0) {
+                        int tIndex = patchTag._transitionType;
+                        int rIndex = patchTag._transitionRot;
+                        int bIndex = patchTag._boundaryIndex;
 
-                        iptrs.C[tIndex][rIndex] += 9;
-                        pptrs.C[tIndex][rIndex] = computePatchParam(refiner, i, faceIndex, bIndex, pptrs.C[tIndex][rIndex]);
+                        int creaseEdge = (bIndex+2)%4;
+                        float sharpness = level->getEdgeSharpness((level->getFaceEdges(faceIndex)[creaseEdge]));
+                        sharpness = std::min(sharpness, (float)(options.maxIsolationLevel-i));
 
-                        if (tables->_fvarPatchTables) {
-                            gatherFVarPatchVertices(refiner, i, faceIndex, bIndex, levelFVarVertOffsets, fptrs.C[tIndex][rIndex]);
-                        }
+                        *sptrs.S[tIndex][rIndex]++ = assignSharpnessIndex(tables, sharpness);
                     }
-                }
-            } else {
-                if (gregoryStencilsFactory) {
-                    // Gregory basis end-cap (20 CVs - no quad-offsets / valence tables)
-                    assert(i==refiner.GetMaxLevel());
-                    // Gregory Boundary Patch (4 CVs 0-ring for varying interpolation)
+                } else {
                     Vtr::ConstIndexArray faceVerts = level->getFaceVertices(faceIndex);
                     for (int j = 0; j < 4; ++j) {
-                        iptrs.GP[j] = faceVerts[j] + levelVertOffset;
-                        gregoryVertexFlags[iptrs.GP[j]] = true;
+                        gregoryVertexFlags[faceVerts[j] + levelVertOffset] = true;
                     }
-                    iptrs.GP += 4;
-
+                    if (gregoryStencilsFactory) {
 #ifdef ENDCAP_TOPOPOLGY
-                    bool edgeSkip[4];
-                    numGregoryBasisVertices = gatherGregoryBasisTopology(*level, faceIndex, numGregoryBasisVertices,
-                        levelPatchTags, edgeSkip, gregoryBasisIndices, tables->_endcapTopology);
+                        bool edgeSkip[4];
+                        numGregoryBasisVertices = gatherGregoryBasisTopology(*level, faceIndex, numGregoryBasisVertices,
+                            levelPatchTags, edgeSkip, gregoryBasisIndices, tables->_endcapTopology);
 #endif
-                    gregoryStencilsFactory->AddPatchBasis(faceIndex);
-
-                    pptrs.GP = computePatchParam(refiner, i, faceIndex, 0, pptrs.GP);
-
-                    if (tables->_fvarPatchTables) {
-                        gatherFVarPatchVertices(refiner, i, faceIndex, 0, levelFVarVertOffsets, fptrs.GP);
-                    }
-                } else {
-                    if (patchTag._boundaryCount == 0) {
-                        // Gregory Regular Patch (4 CVs + quad-offsets / valence tables)
-                        Vtr::ConstIndexArray faceVerts = level->getFaceVertices(faceIndex);
-                        for (int j = 0; j < 4; ++j) {
-                            iptrs.G[j] = faceVerts[j] + levelVertOffset;
-                            gregoryVertexFlags[iptrs.G[j]] = true;
-                        }
-                        iptrs.G += 4;
-
-                        getQuadOffsets(*level, faceIndex, quad_G_C0_P);
-                        quad_G_C0_P += 4;
-
-                        pptrs.G = computePatchParam(refiner, i, faceIndex, 0, pptrs.G);
-
-                        if (tables->_fvarPatchTables) {
-                            gatherFVarPatchVertices(refiner, i, faceIndex, 0, levelFVarVertOffsets, fptrs.G);
-                        }
-                    } else {
-                        // Gregory Boundary Patch (4 CVs + quad-offsets / valence tables)
-                        Vtr::ConstIndexArray faceVerts = level->getFaceVertices(faceIndex);
-                        for (int j = 0; j < 4; ++j) {
-                            iptrs.GB[j] = faceVerts[j] + levelVertOffset;
-                            gregoryVertexFlags[iptrs.GB[j]] = true;
-                        }
-                        iptrs.GB += 4;
-
-                        getQuadOffsets(*level, faceIndex, quad_G_C1_P);
-                        quad_G_C1_P += 4;
-
-                        //int bIndex = (patchTag._boundaryIndex+1)%4;
-
-                        pptrs.GB = computePatchParam(refiner, i, faceIndex, 0, pptrs.GB);
-
-                        if (tables->_fvarPatchTables) {
-                            gatherFVarPatchVertices(refiner, i, faceIndex, 0, levelFVarVertOffsets, fptrs.GB);
-                        }
+                        gregoryBasisFaces.push_back(faceIndex);
+                        gregoryBasisLevels.push_back(i);
                     }
                 }
             }
-        }
-        levelFaceOffset += level->getNumFaces();
-        levelVertOffset += level->getNumVertices();
-        if (tables->_fvarPatchTables) {
-            int nchannels = refiner.GetNumFVarChannels();
-            for (int channel=0; channel<nchannels; ++channel) {
-                levelFVarVertOffsets[channel] += refiner.GetNumFVarValues(i, channel);
-            }
+            levelFaceOffset += level->getNumFaces();
+            levelVertOffset += level->getNumVertices();
         }
     }
 
     if (gregoryStencilsFactory) {
+        // The bases are gathered in the order of the faces, so that the end-cap
+        // stencils match the order of the patches
+        if (not gregoryBasisFaces.empty()) {
+            gregoryStencilsFactory->AddPatchBases((int)gregoryBasisFaces.size(),
+                &gregoryBasisFaces[0], &gregoryBasisLevels[0], options.parallelCreation);
+        }
         tables->_endcapStencilTables =
             gregoryStencilsFactory->CreateStencilTables();
         delete gregoryStencilsFactory;
@@ -1411,43 +1751,246 @@ PatchTablesFactory::populateAdaptivePatches( TopologyRefiner const & refiner,
 
             Vtr::Level const * level = &refiner.getLevel(i);
 
-            if (i == levelLast) {
-
-                int vTableOffset = vOffset * SizePerVertex;
-
-                for (int vIndex = 0; vIndex < level->getNumVertices(); ++vIndex) {
-                    int* vTableEntry = &vTable[vTableOffset];
-
-                    //
-                    //  If not marked as a vertex of a gregory patch, just set to 0 to ignore.  Otherwise
-                    //  gather the one-ring around the vertex and set its resulting size (note the negative
-                    //  size used to distinguish between boundary/interior):
-                    //
-                    //if (!gregoryVertexFlags[vIndex + vOffset]) {
-                        vTableEntry[0] = 0;
-                    //} else {
-
-                        int * ringDest = vTableEntry + 1,
-                              ringSize = level->gatherManifoldVertexRingFromIncidentQuads(vIndex, vOffset, ringDest);
-
-                        if (ringSize & 1) {
-                            // boundary vertex : duplicate boundary vertex index
-                            // and store negative valence.
-                            ringSize++;
-                            vTableEntry[ringSize]=vTableEntry[ringSize-1];
-                            vTableEntry[0] = -ringSize/2;
-                        } else {
-                            vTableEntry[0] = ringSize/2;
-                        }
-                    //}
-                    vTableOffset += SizePerVertex;
+            //  Gregory patches precede the last level only where isolation was limited per
+            //  face, so only the vertices marked for them are gathered in earlier levels:
+            bool isLevelLast = (i == levelLast);
+
+            int numVertices = level->getNumVertices();
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+            #pragma omp parallel for if (options.parallelCreation)
+#endif
+            for (int vIndex = 0; vIndex < numVertices; ++vIndex) {
+                int* vTableEntry = &vTable[(vOffset + vIndex) * SizePerVertex];
+
+                if (not isLevelLast and not gregoryVertexFlags[vIndex + vOffset]) {
+                    continue;
                 }
+
+                //
+                //  If not marked as a vertex of a gregory patch, just set to 0 to ignore.  Otherwise
+                //  gather the one-ring around the vertex and set its resulting size (note the negative
+                //  size used to distinguish between boundary/interior):
+                //
+                //if (!gregoryVertexFlags[vIndex + vOffset]) {
+                    vTableEntry[0] = 0;
+                //} else {
+
+                    int * ringDest = vTableEntry + 1,
+                          ringSize = level->gatherManifoldVertexRingFromIncidentQuads(vIndex, vOffset, ringDest);
+
+                    if (ringSize & 1) {
+                        // boundary vertex : duplicate boundary vertex index
+                        // and store negative valence.
+                        ringSize++;
+                        vTableEntry[ringSize]=vTableEntry[ringSize-1];
+                        vTableEntry[0] = -ringSize/2;
+                    } else {
+                        vTableEntry[0] = ringSize/2;
+                    }
+                //}
             }
             vOffset += level->getNumVertices();
         }
     }
 }
 
+//
+//  Identify the patches of the triangles of a Loop mesh at all levels:  triangles whose
+//  neighborhood is regular -- including the supported boundary configurations -- are
+//  represented by box-spline patches, and all others by end-cap patches.
+//
+void
+PatchTablesFactory::identifyAdaptiveLoopPatches( TopologyRefiner const & refiner,
+                                                 PatchCounters &         patchInventory,
+                                                 PatchTagVector &        patchTags ) {
+
+    patchTags.resize(refiner.GetNumFacesTotal());
+
+    PatchFaceTag * levelPatchTags = &patchTags[0];
+
+    for (int i = 0; i < refiner.GetNumLevels(); ++i) {
+        Vtr::Level const * level = &refiner.getLevel(i);
+
+        bool isLevelFirst = (i == 0);
+        bool isLevelLast  = (i == refiner.GetMaxLevel());
+
+        Vtr::Refinement const * refinePrev = isLevelFirst ? 0 : &refiner.getRefinement(i-1);
+        Vtr::Refinement const * refineNext = isLevelLast  ? 0 : &refiner.getRefinement(i);
+
+        Vtr::Refinement::SparseTag const * vtrFaceTags = refineNext ? &refineNext->_parentFaceTag[0] : 0;
+
+        for (int faceIndex = 0; faceIndex < level->getNumFaces(); ++faceIndex) {
+
+            PatchFaceTag& patchTag = levelPatchTags[faceIndex];
+
+            patchTag.clear();
+            patchTag._hasPatch = false;
+
+            if (level->isHole(faceIndex)) {
+                continue;
+            }
+
+            //  As for quads, faces that were refined or are "incomplete" have no patch
+            //  (see identifyAdaptivePatches()).  Unlike quads, the children of a face
+            //  that was not selected have no incomplete face-vertex, and so may all have
+            //  complete vertices when the neighbors of the face were selected -- the tag
+            //  of the child face must be inspected too:
+            if (vtrFaceTags and vtrFaceTags[faceIndex]._selected) {
+                continue;
+            }
+
+            Vtr::ConstIndexArray fVerts = level->getFaceVertices(faceIndex);
+            assert(fVerts.size() == 3);
+
+            if (!isLevelFirst and (refinePrev->_childFaceTag[faceIndex]._incomplete or
+                                   refinePrev->_childVertexTag[fVerts[0]]._incomplete or
+                                   refinePrev->_childVertexTag[fVerts[1]]._incomplete or
+                                   refinePrev->_childVertexTag[fVerts[2]]._incomplete)) {
+                continue;
+            }
+
+            //  Patches for non-manifold faces not yet supported
+            assert(!level->getFaceCompositeVTag(fVerts)._nonManifold);
+
+            patchTag._hasPatch  = true;
+            patchTag._isRegular = level->isTriRegularPatch(faceIndex);
+
+            if (patchTag._isRegular) {
+                ++patchInventory.L;
+            } else {
+                ++patchInventory.LB;
+            }
+        }
+        levelPatchTags += level->getNumFaces();
+    }
+}
+
+//
+//  Populate the patches of the triangles of a Loop mesh:  regular patches gather the 12
+//  vertices of their box-spline -- those missing on boundaries being replaced by the
+//  first vertex of the face (with weights of 0, see PatchTables::GetLoopBasisWeights())
+//  -- while end-caps retain the vertices of their face and the stencils of the 15 CVs
+//  of their quartic Bezier triangle.
+//
+void
+PatchTablesFactory::populateAdaptiveLoopPatches( TopologyRefiner const & refiner,
+                                                 PatchCounters const &   patchInventory,
+                                                 PatchTagVector const &  patchTags,
+                                                 PatchTables *           tables,
+                                                 Options                 options ) {
+
+    PatchCVPointers    iptrs;
+    PatchParamPointers pptrs;
+    PatchFVarPointers  fptrs;
+
+    typedef PatchDescriptorVector DescVec;
+
+    DescVec const & descs = PatchDescriptor::GetAdaptivePatchDescriptors(Sdc::SCHEME_LOOP);
+
+    for (DescVec::const_iterator it=descs.begin(); it!=descs.end(); ++it) {
+
+        Index arrayIndex = tables->findPatchArray(*it);
+
+        if (arrayIndex==Vtr::INDEX_INVALID) {
+            continue;
+        }
+
+        iptrs.getValue( *it ) = tables->getPatchArrayVertices(arrayIndex).begin();
+        pptrs.getValue( *it ) = tables->getPatchParams(arrayIndex).begin();
+
+        if (tables->_fvarPatchTables) {
+            int nchannels = refiner.GetNumFVarChannels();
+
+            Index ** fptr = (Index **)alloca(nchannels*sizeof(Index *));
+            for (int channel=0; channel<nchannels; ++channel) {
+
+                fptr[channel] = tables->getFVarVerts(arrayIndex, channel).begin();
+            }
+            fptrs.getValue( *it ) = fptr;
+        }
+    }
+
+    LoopBasisFactory * loopStencilsFactory = 0;
+    if (patchInventory.LB > 0) {
+        loopStencilsFactory = new LoopBasisFactory(refiner,
+            options.adaptiveStencilTables, patchInventory.LB);
+    }
+
+    int levelFaceOffset = 0;
+    int levelVertOffset = 0;
+    int * levelFVarVertOffsets = 0;
+    if (tables->_fvarPatchTables) {
+         levelFVarVertOffsets = (int *)alloca(refiner.GetNumFVarChannels()*sizeof(int));
+         memset(levelFVarVertOffsets, 0, refiner.GetNumFVarChannels()*sizeof(int));
+    }
+
+    for (int i = 0; i < refiner.GetNumLevels(); ++i) {
+        Vtr::Level const * level = &refiner.getLevel(i);
+
+        const PatchFaceTag * levelPatchTags = &patchTags[levelFaceOffset];
+
+        for (int faceIndex = 0; faceIndex < level->getNumFaces(); ++faceIndex) {
+
+            const PatchFaceTag& patchTag = levelPatchTags[faceIndex];
+            if (not patchTag._hasPatch) {
+                continue;
+            }
+
+            if (patchTag._isRegular) {
+                int boundaryMask = 0;
+                bool isVertexMask = false;
+                level->isTriRegularPatch(faceIndex, &boundaryMask, &isVertexMask);
+
+                Index patchVerts[12];
+                level->gatherTriRegularPatchVertices(faceIndex, patchVerts);
+                for (int j = 0; j < 12; ++j) {
+                    if (patchVerts[j] == Vtr::INDEX_INVALID) {
+                        patchVerts[j] = patchVerts[0];
+                    }
+                    iptrs.L[j] = patchVerts[j] + levelVertOffset;
+                }
+                iptrs.L += 12;
+
+                pptrs.L = computePatchParam(refiner, i, faceIndex, 0, pptrs.L);
+                pptrs.L[-1].bitField.SetBoundary((unsigned char)boundaryMask, isVertexMask);
+
+                if (tables->_fvarPatchTables) {
+                    gatherFVarPatchVertices(refiner, i, faceIndex, 0, levelFVarVertOffsets, fptrs.L);
+                }
+            } else {
+                Vtr::ConstIndexArray faceVerts = level->getFaceVertices(faceIndex);
+                for (int j = 0; j < 3; ++j) {
+                    iptrs.LB[j] = faceVerts[j] + levelVertOffset;
+                }
+                iptrs.LB += 3;
+
+                loopStencilsFactory->AddPatchBasis(faceIndex, i);
+
+                pptrs.LB = computePatchParam(refiner, i, faceIndex, 0, pptrs.LB);
+
+                if (tables->_fvarPatchTables) {
+                    gatherFVarPatchVertices(refiner, i, faceIndex, 0, levelFVarVertOffsets, fptrs.LB);
+                }
+            }
+        }
+        levelFaceOffset += level->getNumFaces();
+        levelVertOffset += level->getNumVertices();
+        if (tables->_fvarPatchTables) {
+            int nchannels = refiner.GetNumFVarChannels();
+            for (int channel=0; channel<nchannels; ++channel) {
+                levelFVarVertOffsets[channel] += refiner.GetNumFVarValues(i, channel);
+            }
+        }
+    }
+
+    if (loopStencilsFactory) {
+        tables->_endcapStencilTables =
+            loopStencilsFactory->CreateStencilTables();
+        delete loopStencilsFactory;
+    }
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
@@ -60,6 +60,8 @@ public:
              triangulateQuads(false),
              generateFVarTables(false),
              useSingleCreasePatch(false),
+             compactStorage(false),
+             parallelCreation(false),
              maxIsolationLevel(maxIsolation),
              adaptiveStencilTables(0) { }
 
@@ -67,6 +69,8 @@ public:
                      triangulateQuads  : 1,    ///< Triangulate 'QUADS' primitives (Uniform mode only)
                      generateFVarTables : 1,   ///< Generate face-varying patch tables
                      useSingleCreasePatch : 1, ///< Use single crease patch
+                     compactStorage : 1,       ///< Store the patch vertices and PatchParams with the compact encoding (see PatchTables::IsCompact())
+                     parallelCreation : 1,     ///< Identify and populate adaptive patches and Gregory end-cap stencils concurrently (OpenMP)
                      maxIsolationLevel : 4;    ///< Cap the sharpnness of single creased patches to be consistent to other feature isolations.
 
         StencilTables const * adaptiveStencilTables;
@@ -102,6 +106,26 @@ private:
                                          PatchTables * tables,
                                          Options options );
 
+    static void populateAdaptivePatchBlock( TopologyRefiner const & refiner,
+                                            PatchTypes<int> const & patchInventory,
+                                            PatchTypes<int> patchOffsets,
+                                            int level, int faceBegin, int faceEnd,
+                                            PatchFaceTag const * levelPatchTags,
+                                            int levelVertOffset,
+                                            int const * levelFVarVertOffsets,
+                                            PatchTables * tables,
+                                            Options options );
+
+    static void identifyAdaptiveLoopPatches( TopologyRefiner const & refiner,
+                                             PatchTypes<int> & patchInventory,
+                                             std::vector<PatchFaceTag> & patchTags );
+
+    static void populateAdaptiveLoopPatches( TopologyRefiner const & refiner,
+                                             PatchTypes<int> const & patchInventory,
+                                             std::vector<PatchFaceTag> const & patchTags,
+                                             PatchTables * tables,
+                                             Options options );
+
     //  Methods for allocating and managing the patch table data arrays:
     static void allocateTables( PatchTables * tables, int nlevels, bool hasSharpness );
 
@@ -112,6 +136,15 @@ private:
     static PatchParam * computePatchParam( TopologyRefiner const & refiner, int level,
                                            int face, int rotation, PatchParam * coord );
 
+    static PatchParam * computeTriPatchParam( TopologyRefiner const & refiner, int level,
+                                              int face, PatchParam * coord );
+
+    static void gatherFVarBicubicPatchValues( TopologyRefiner const & refiner, int level,
+                                              Index face, PatchDescriptor::Type type,
+                                              Index const * patchVerts, int numPatchVerts,
+                                              Index levelVertOffset, Index const * levelFVarOffsets,
+                                              PatchParam const * patchParam, PatchTables * tables );
+
     static void getQuadOffsets(Vtr::Level const & level, int face, unsigned int * result);
 
     static int assignSharpnessIndex( PatchTables *tables, float sharpness );
@@ -87,6 +87,14 @@ public:
         _weights.resize(nelems);
     }
 
+    // Releases the memory of all the stencils
+    void Release() {
+        clearBigStencils();
+        std::vector<unsigned char>().swap(_sizes);
+        std::vector<int>().swap(_indices);
+        std::vector<float>().swap(_weights);
+    }
+
     // Adds the contribution of a supporting vertex that was not yet
     // in the stencil
     void PushBackVertex(Index protoStencil, Index vert, float weight) {
@@ -379,7 +387,7 @@ public:
             Index n = _alloc->FindVertex(_id, src._id);
             if (Vtr::IndexIsValid(n)) {
                 _alloc->GetWeights(_id)[n] += weight;
-                assert(_alloc->GetWeights(_id)[n]>0.0f);
+                assert(_alloc->GetWeights(_id)[n]!=0.0f);
             } else {
                 _alloc->PushBackVertex(_id, src._id, weight);
             }
@@ -205,7 +205,10 @@ protected:
 protected:
 
     friend class StencilTablesFactory;
+    friend class LimitStencilTablesFactory;
     friend class GregoryBasisFactory;
+    friend class LoopBasisFactory;
+    friend class TopologyPartition;
 
     int _numControlVertices;              // number of control vertices
 
@@ -323,6 +326,7 @@ public:
     }
 
 private:
+    friend class StencilTablesFactory;
     friend class LimitStencilTablesFactory;
 
     // Resize the table arrays (factory helper)
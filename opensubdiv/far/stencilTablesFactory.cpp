@@ -51,6 +51,94 @@ StencilTablesFactory::generateControlVertStencils(
     }
 }
 
+//
+// Chunks of stencils emitted by CreateChunked() -- a single StencilTables is
+// reused for all chunks, its memory reserved up-front to fit the budget
+//
+class StencilTablesFactory::ChunkSink {
+
+public:
+
+    ChunkSink(ChunkCallback callback, void * clientData, size_t maxChunkSize,
+        int numControlVertices, bool generateOffsets) :
+            _callback(callback), _clientData(clientData),
+            _maxChunkSize(maxChunkSize), _generateOffsets(generateOffsets),
+            _firstStencil(0), _chunkSize(0) {
+
+        _chunk._numControlVertices = numControlVertices;
+
+        size_t stencilSize = sizeof(unsigned char) +
+                (generateOffsets ? sizeof(Index) : 0),
+               elementSize = sizeof(Index) + sizeof(float);
+
+        // a stencil has at most 255 elements and a chunk at least one stencil
+        _chunk._sizes.reserve(maxChunkSize/(stencilSize+elementSize) + 1);
+        _chunk._indices.reserve(maxChunkSize/elementSize + 255);
+        _chunk._weights.reserve(maxChunkSize/elementSize + 255);
+    }
+
+    // Appends the stencils of a level to the current chunk (releasing the
+    // memory of the allocator once done)
+    void Append(StencilAllocator & alloc) {
+        for (int i=0; i<alloc.GetNumStencils(); ++i) {
+            append(alloc.GetSize(i), alloc.GetIndices(i), alloc.GetWeights(i));
+        }
+        alloc.Release();
+    }
+
+    // Appends the stencils of the control vertices to the current chunk
+    void AppendControlVertices() {
+        float weight = 1.0f;
+        for (Index i=0; i<_chunk._numControlVertices; ++i) {
+            append(1, &i, &weight);
+        }
+    }
+
+    // Emits the current chunk (if not empty)
+    void Flush() {
+        int nstencils = _chunk.GetNumStencils();
+        if (nstencils==0) {
+            return;
+        }
+        if (_generateOffsets) {
+            _chunk.generateOffsets();
+        }
+        _callback(_chunk, _firstStencil, _clientData);
+
+        _firstStencil += nstencils;
+        _chunkSize = 0;
+        _chunk._sizes.clear();
+        _chunk._offsets.clear();
+        _chunk._indices.clear();
+        _chunk._weights.clear();
+    }
+
+private:
+
+    void append(unsigned char size, Index const * indices, float const * weights) {
+        size_t stencilSize = sizeof(unsigned char) +
+            (_generateOffsets ? sizeof(Index) : 0) +
+                size * (sizeof(Index) + sizeof(float));
+
+        if (_chunkSize + stencilSize > _maxChunkSize) {
+            Flush();
+        }
+        _chunk._sizes.push_back(size);
+        _chunk._indices.insert(_chunk._indices.end(), indices, indices+size);
+        _chunk._weights.insert(_chunk._weights.end(), weights, weights+size);
+        _chunkSize += stencilSize;
+    }
+
+    ChunkCallback _callback;
+    void        * _clientData;
+    size_t        _maxChunkSize;
+    bool          _generateOffsets;
+
+    StencilTables _chunk;
+    Index         _firstStencil;
+    size_t        _chunkSize;
+};
+
 //
 // StencilTables factory
 //
@@ -58,13 +146,59 @@ StencilTables const *
 StencilTablesFactory::Create(TopologyRefiner const & refiner,
     Options options) {
 
-    StencilTables * result = new StencilTables;
+    return create(refiner, options, 0, 0, 0);
+}
 
-    int maxlevel = std::min(int(options.maxLevel), refiner.GetMaxLevel());
+void
+StencilTablesFactory::CreateChunked(TopologyRefiner const & refiner,
+    ChunkCallback callback, void * clientData, size_t maxChunkSize,
+        Options options) {
+
+    assert(callback);
+
+    bool faceVarying = options.interpolationMode==INTERPOLATE_FACE_VARYING;
+
+    ChunkSink sink(callback, clientData, maxChunkSize, faceVarying ?
+        refiner.GetNumFVarValues(0, options.fvarChannel) : refiner.GetNumVertices(0),
+            options.generateOffsets);
+
+    create(refiner, options, 0, 0, &sink);
+}
+
+StencilTables const *
+StencilTablesFactory::CreateStreaming(TopologyRefiner & refiner,
+    TopologyRefiner::UniformOptions refineOptions, Options options) {
+
+    assert(refiner.GetNumLevels()==1);
+
+    refineOptions.refinementLevel =
+        std::min(refineOptions.refinementLevel, options.maxLevel);
+
+    return create(refiner, options, &refiner, &refineOptions, 0);
+}
+
+StencilTables const *
+StencilTablesFactory::create(TopologyRefiner const & refiner,
+    Options options, TopologyRefiner * streamingRefiner,
+        TopologyRefiner::UniformOptions const * streamingOptions,
+            ChunkSink * sink) {
+
+    StencilTables * result = sink ? 0 : new StencilTables;
+
+    bool faceVarying = options.interpolationMode==INTERPOLATE_FACE_VARYING;
+    int fvarChannel = options.fvarChannel;
+    assert((not faceVarying) or fvarChannel<refiner.GetNumFVarChannels());
+
+    int maxlevel = streamingRefiner ? int(streamingOptions->refinementLevel) :
+        std::min(int(options.maxLevel), refiner.GetMaxLevel());
     if (maxlevel==0 and (not options.generateControlVerts)) {
         return result;
     }
 
+    if (sink and options.generateControlVerts) {
+        sink->AppendControlVertices();
+    }
+
     // 'maxsize' reflects the size of the default supporting basis factorized
     // in the stencils, with a little bit of head-room. Each subdivision scheme
     // has a set valence for 'regular' vertices, which drives the size of the
@@ -79,7 +213,8 @@ StencilTablesFactory::Create(TopologyRefiner const & refiner,
     int maxsize = 0;
     bool interpolateVarying = false;
     switch (options.interpolationMode) {
-        case INTERPOLATE_VERTEX: {
+        case INTERPOLATE_VERTEX:
+        case INTERPOLATE_FACE_VARYING: {
                 Sdc::SchemeType type = refiner.GetSchemeType();
                 switch (type) {
                     case Sdc::SCHEME_BILINEAR : maxsize = 5; break;
@@ -107,12 +242,35 @@ StencilTablesFactory::Create(TopologyRefiner const & refiner,
     //
     for (int level=1;level<=maxlevel; ++level) {
 
-        dstAlloc->Resize(refiner.GetNumVertices(level));
+        if (streamingRefiner) {
+            streamingRefiner->refineUniformLevel(*streamingOptions);
+        }
 
-        if (options.interpolationMode==INTERPOLATE_VERTEX) {
-            refiner.Interpolate(level, *srcAlloc, *dstAlloc);
+        if (faceVarying) {
+            dstAlloc->Resize(refiner.GetNumFVarValues(level, fvarChannel));
+            refiner.InterpolateFaceVarying(level, *srcAlloc, *dstAlloc, fvarChannel);
         } else {
-            refiner.InterpolateVarying(level, *srcAlloc, *dstAlloc);
+            dstAlloc->Resize(refiner.GetNumVertices(level));
+            if (options.interpolationMode==INTERPOLATE_VERTEX) {
+                refiner.Interpolate(level, *srcAlloc, *dstAlloc);
+            } else {
+                refiner.InterpolateVarying(level, *srcAlloc, *dstAlloc);
+            }
+        }
+
+        if (streamingRefiner) {
+            // the parent level (and its refinement) are no longer needed
+            streamingRefiner->discardLevelTopology(level-1);
+        }
+
+        if (sink and options.generateIntermediateLevels) {
+            // emit the stencils of the last level no longer needed: the
+            // parent level when factorizing, the new level otherwise
+            if (not options.factorizeIntermediateLevels) {
+                sink->Append(allocators[level]);
+            } else if (level>1) {
+                sink->Append(allocators[level-1]);
+            }
         }
 
         if (options.generateIntermediateLevels) {
@@ -132,6 +290,16 @@ StencilTablesFactory::Create(TopologyRefiner const & refiner,
         }
     }
 
+    if (sink) {
+        if (not options.generateIntermediateLevels) {
+            sink->Append(*srcAlloc);
+        } else if (options.factorizeIntermediateLevels and maxlevel>0) {
+            sink->Append(allocators[maxlevel]);
+        }
+        sink->Flush();
+        return 0;
+    }
+
     // Copy stencils from the pool allocator into the tables
     {
         // Add total number of stencils, weights & indices
@@ -147,7 +315,8 @@ StencilTablesFactory::Create(TopologyRefiner const & refiner,
         }
 
         // Allocate
-        result->_numControlVertices = refiner.GetNumVertices(0);
+        result->_numControlVertices = faceVarying ?
+            refiner.GetNumFVarValues(0, fvarChannel) : refiner.GetNumVertices(0);
 
         if (options.generateControlVerts) {
             nstencils += result->_numControlVertices;
@@ -187,6 +356,211 @@ StencilTablesFactory::Create(TopologyRefiner const & refiner,
 
 //------------------------------------------------------------------------------
 
+namespace {
+
+//
+// Returns true if the limit masks of the scheme resolve the limit of a vertex:
+// the masks are those of smooth interior vertices, of boundaries and of their
+// sharpened corners, so semi-sharp and non-manifold features, as well as
+// infinitely sharp vertices and creases in the interior, are not resolved
+//
+bool
+isVertexLimitable(Sdc::Options schemeOptions, Vtr::Level const & level, Index vert) {
+
+    Vtr::Level::VTag vTag = level.getVertexTag(vert);
+
+    if (vTag._nonManifold or vTag._semiSharp) {
+        return false;
+    }
+    if (not vTag._boundary) {
+        return vTag._rule == Sdc::Crease::RULE_SMOOTH;
+    }
+    if (vTag._rule == Sdc::Crease::RULE_CREASE) {
+        return true;
+    }
+    return (vTag._rule == Sdc::Crease::RULE_CORNER) and
+           (level.getVertexFaces(vert).size() == 1) and
+           (schemeOptions.GetVtxBoundaryInterpolation() ==
+               Sdc::Options::VTX_BOUNDARY_EDGE_AND_CORNER);
+}
+
+//
+// Accumulates the limit position and tangent masks of every vertex of 'level'
+// into limit stencils, factorized from the stencils of the vertices of that
+// level ('cvStencils')
+//
+template <Sdc::SchemeType SCHEME> void
+factorizeLimitMasks(Sdc::Options schemeOptions, Vtr::Level const & level,
+    StencilTables const & cvStencils, LimitStencilAllocator & alloc) {
+
+    Sdc::Scheme<SCHEME> scheme(schemeOptions);
+
+    int maxWeightsPerMask = 1 + 2 * level.getMaxValence();
+    std::vector<float> weights(3 * maxWeightsPerMask);
+
+    //  Assign both parent and child as the same level (see TopologyRefiner::limit())
+    Vtr::VertexInterface vHood(level, level);
+
+    for (int vert = 0; vert < level.getNumVertices(); ++vert) {
+
+        //  Vertices supporting only holes (when pruned) have no limit -- keep
+        //  their position with null tangents:
+        if (level.getVertexTag(vert)._incomplete) {
+            alloc[vert].AddWithWeight(cvStencils[vert], 1.0f, 0.0f, 0.0f);
+            continue;
+        }
+
+        ConstIndexArray vEdges = level.getVertexEdges(vert);
+
+        float * pWeights = &weights[0],
+              * t1Weights = pWeights + maxWeightsPerMask,
+              * t2Weights = t1Weights + maxWeightsPerMask;
+
+        Vtr::MaskInterface pMask(pWeights, pWeights+1, pWeights+1+vEdges.size()),
+                           t1Mask(t1Weights, t1Weights+1, t1Weights+1+vEdges.size()),
+                           t2Mask(t2Weights, t2Weights+1, t2Weights+1+vEdges.size());
+
+        vHood.SetIndex(vert, vert);
+
+        scheme.ComputeVertexLimitMask(vHood, pMask, t1Mask, t2Mask);
+
+        //  Masks may differ in their number of face weights (all are applied to
+        //  the vertex opposite in each incident face)
+        ProtoLimitStencil dst = alloc[vert];
+
+        ConstIndexArray      vFaces = level.getVertexFaces(vert);
+        ConstLocalIndexArray vInFace = level.getVertexFaceLocalIndices(vert);
+        for (int i = 0; i < vFaces.size(); ++i) {
+            float pW  = (i < pMask.GetNumFaceWeights())  ? pMask.FaceWeight(i)  : 0.0f,
+                  t1W = (i < t1Mask.GetNumFaceWeights()) ? t1Mask.FaceWeight(i) : 0.0f,
+                  t2W = (i < t2Mask.GetNumFaceWeights()) ? t2Mask.FaceWeight(i) : 0.0f;
+            if (pW==0.0f and t1W==0.0f and t2W==0.0f) {
+                continue;
+            }
+            assert(not pMask.AreFaceWeightsForFaceCenters() and
+                   not t1Mask.AreFaceWeightsForFaceCenters() and
+                   not t2Mask.AreFaceWeightsForFaceCenters());
+
+            ConstIndexArray fVerts = level.getFaceVertices(vFaces[i]);
+
+            LocalIndex vOppInFace = (vInFace[i] + 2);
+            if (vOppInFace >= fVerts.size()) vOppInFace -= (LocalIndex)fVerts.size();
+
+            dst.AddWithWeight(cvStencils[fVerts[vOppInFace]], pW, t1W, t2W);
+        }
+        for (int i = 0; i < vEdges.size(); ++i) {
+            float pW  = (i < pMask.GetNumEdgeWeights())  ? pMask.EdgeWeight(i)  : 0.0f,
+                  t1W = (i < t1Mask.GetNumEdgeWeights()) ? t1Mask.EdgeWeight(i) : 0.0f,
+                  t2W = (i < t2Mask.GetNumEdgeWeights()) ? t2Mask.EdgeWeight(i) : 0.0f;
+
+            ConstIndexArray eVerts = level.getEdgeVertices(vEdges[i]);
+            Index vertOppositeEdge = (eVerts[0] == vert) ? eVerts[1] : eVerts[0];
+
+            dst.AddWithWeight(cvStencils[vertOppositeEdge], pW, t1W, t2W);
+        }
+        dst.AddWithWeight(cvStencils[vert], pMask.VertexWeight(0),
+            t1Mask.VertexWeight(0), t2Mask.VertexWeight(0));
+    }
+}
+
+} // end namespace
+
+LimitStencilTables const *
+StencilTablesFactory::CreateLimit(TopologyRefiner const & refiner,
+    Options options) {
+
+    assert(refiner.IsUniform() and
+        options.interpolationMode==INTERPOLATE_VERTEX);
+
+    // The limit masks require the faces of the scheme's regular size, which
+    // the base level does not guarantee
+    int maxlevel = std::min(int(options.maxLevel), refiner.GetMaxLevel());
+    if (maxlevel==0) {
+        return 0;
+    }
+
+    Vtr::Level const & level = refiner.getLevel(maxlevel);
+
+    // The masks are gathered from the neighborhood of each vertex
+    assert(level.getNumVertexEdgesTotal()>0 and level.getNumVertexFacesTotal()>0);
+
+    // Features the limit masks do not resolve are rejected rather than given
+    // the limit of a smooth or boundary vertex
+    if (refiner.GetSchemeType()!=Sdc::SCHEME_BILINEAR) {
+        for (int vert=0; vert<level.getNumVertices(); ++vert) {
+            if ((not level.getVertexTag(vert)._incomplete) and
+                (not isVertexLimitable(refiner.GetSchemeOptions(), level, vert))) {
+                return 0;
+            }
+        }
+    }
+
+    LimitStencilTables * result = new LimitStencilTables;
+    result->_numControlVertices = refiner.GetNumVertices(0);
+
+    // Stencils of the vertices at 'maxlevel', from which the limit stencils
+    // are factorized
+    Options cvOptions;
+    cvOptions.generateOffsets = true;
+    cvOptions.generateControlVerts = false;
+    cvOptions.generateIntermediateLevels = false;
+    cvOptions.maxLevel = maxlevel;
+
+    StencilTables const * cvStencils = Create(refiner, cvOptions);
+
+    // The limit masks gather the 1-ring of each vertex, which widens the
+    // supporting basis of the stencils of that level (see create())
+    int maxsize = 0;
+    switch (refiner.GetSchemeType()) {
+        case Sdc::SCHEME_BILINEAR : maxsize = 5; break;
+        case Sdc::SCHEME_CATMARK  : maxsize = 26; break;
+        case Sdc::SCHEME_LOOP     : maxsize = 20; break;
+        default:
+            assert(0);
+    }
+
+    LimitStencilAllocator alloc(maxsize);
+    alloc.Resize(level.getNumVertices());
+
+    switch (refiner.GetSchemeType()) {
+        case Sdc::SCHEME_CATMARK:
+            factorizeLimitMasks<Sdc::SCHEME_CATMARK>(
+                refiner.GetSchemeOptions(), level, *cvStencils, alloc);
+            break;
+        case Sdc::SCHEME_LOOP:
+            factorizeLimitMasks<Sdc::SCHEME_LOOP>(
+                refiner.GetSchemeOptions(), level, *cvStencils, alloc);
+            break;
+        case Sdc::SCHEME_BILINEAR:
+            factorizeLimitMasks<Sdc::SCHEME_BILINEAR>(
+                refiner.GetSchemeOptions(), level, *cvStencils, alloc);
+            break;
+    }
+
+    delete cvStencils;
+
+    // Copy the proto-stencils into the limit stencil tables
+    result->resize(alloc.GetNumStencils(), alloc.GetNumVerticesTotal());
+
+    LimitStencil dst(&result->_sizes.at(0), &result->_indices.at(0),
+        &result->_weights.at(0), &result->_duWeights.at(0),
+            &result->_dvWeights.at(0));
+
+    for (int i=0; i<alloc.GetNumStencils(); ++i) {
+        *dst._size = alloc.CopyLimitStencil(i, dst._indices, dst._weights,
+            dst._duWeights, dst._dvWeights);
+        dst.Next();
+    }
+
+    if (options.generateOffsets) {
+        result->generateOffsets();
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
 StencilTables const *
 StencilTablesFactory::Create(int numTables, StencilTables const ** tables) {
 
@@ -245,6 +619,49 @@ LimitStencilTablesFactory::Create(TopologyRefiner const & refiner,
     LocationArrayVec const & locationArrays, StencilTables const * cvStencils,
         PatchTables const * patchTables) {
 
+    return create(refiner, locationArrays, cvStencils, patchTables, -1);
+}
+
+LimitStencilTables const *
+LimitStencilTablesFactory::CreateFaceVarying(TopologyRefiner const & refiner,
+    LocationArrayVec const & locationArrays, PatchTables const & patchTables,
+        int channel) {
+
+    if (refiner.IsUniform() or (channel<0) or
+        (channel>=refiner.GetNumFVarChannels()) or
+            (not patchTables.GetFVarPatchTables())) {
+        return 0;
+    }
+    return create(refiner, locationArrays, 0, &patchTables, channel);
+}
+
+//
+// Face-varying value stencils : the face-varying values of all the levels,
+// factorized over the face-varying values of the control cage (which are
+// added as single-index stencils of weight 1.0f)
+//
+StencilTables const *
+LimitStencilTablesFactory::createFVarValueStencils(
+    TopologyRefiner const & refiner, int channel) {
+
+    StencilTablesFactory::Options options;
+    options.interpolationMode = StencilTablesFactory::INTERPOLATE_FACE_VARYING;
+    options.generateOffsets = true;
+    options.generateControlVerts = true;
+    options.generateIntermediateLevels = true;
+    options.maxLevel = refiner.GetMaxLevel();
+    options.fvarChannel = channel;
+
+    return StencilTablesFactory::Create(refiner, options);
+}
+
+LimitStencilTables const *
+LimitStencilTablesFactory::create(TopologyRefiner const & refiner,
+    LocationArrayVec const & locationArrays, StencilTables const * cvStencils,
+        PatchTables const * patchTables, int fvarChannel) {
+
+    bool faceVarying = fvarChannel>=0;
+
     // Compute the total number of stencils to generate
     int numStencils=0, numLimitStencils=0;
     for (int i=0; i<(int)locationArrays.size(); ++i) {
@@ -260,7 +677,10 @@ LimitStencilTablesFactory::Create(TopologyRefiner const & refiner,
     int maxlevel = refiner.GetMaxLevel(), maxsize=17;
 
     StencilTables const * cvstencils = cvStencils;
-    if (not cvstencils) {
+    if (faceVarying) {
+        assert(patchTables and (not cvStencils));
+        cvstencils = createFVarValueStencils(refiner, fvarChannel);
+    } else if (not cvstencils) {
         // Generate stencils for the control vertices - this is necessary to
         // properly factorize patches with control vertices at level 0 (natural
         // regular patches, such as in a torus)
@@ -338,7 +758,9 @@ LimitStencilTablesFactory::Create(TopologyRefiner const & refiner,
 
             if (handle) {
                 ProtoLimitStencil dst = alloc[currentStencil];
-                if (uniform) {
+                if (faceVarying) {
+                    patchtables->LimitFaceVarying(*handle, s, t, *cvstencils, dst, fvarChannel);
+                } else if (uniform) {
                     patchtables->Interpolate(*handle, s, t, *cvstencils, dst);
                 } else {
                     patchtables->Limit(*handle, s, t, *cvstencils, dst);
@@ -377,7 +799,8 @@ LimitStencilTablesFactory::Create(TopologyRefiner const & refiner,
         // XXXX manuelk should offset creation be optional ?
         result->generateOffsets();
     }
-    result->_numControlVertices = refiner.GetNumVertices(0);
+    result->_numControlVertices = faceVarying ?
+        refiner.GetNumFVarValues(0, fvarChannel) : refiner.GetNumVertices(0);
 
     return result;
 }
@@ -29,6 +29,7 @@
 
 #include "../far/kernelBatch.h"
 #include "../far/patchTables.h"
+#include "../far/topologyRefiner.h"
 
 #include <vector>
 
@@ -37,8 +38,6 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Far {
 
-class TopologyRefiner;
-
 class Stencil;
 class StencilTables;
 class LimitStencil;
@@ -52,7 +51,8 @@ public:
 
     enum Mode {
         INTERPOLATE_VERTEX=0,
-        INTERPOLATE_VARYING
+        INTERPOLATE_VARYING,
+        INTERPOLATE_FACE_VARYING
     };
 
     struct Options {
@@ -62,7 +62,8 @@ public:
                     generateControlVerts(false),
                     generateIntermediateLevels(true),
                     factorizeIntermediateLevels(true),
-                    maxLevel(10) { }
+                    maxLevel(10),
+                    fvarChannel(0) { }
 
         unsigned int interpolationMode           : 2, ///< interpolation mode
                      generateOffsets             : 1, ///< populate optional "_offsets" field
@@ -72,14 +73,22 @@ public:
                                                       ///  vertices or from the stencils of the
                                                       ///  previous level
                      maxLevel                    : 4; ///< generate stencils up to 'maxLevel'
+
+        unsigned int fvarChannel;                     ///< face-varying channel to interpolate
+                                                      ///  (INTERPOLATE_FACE_VARYING only)
     };
 
     /// \brief Instantiates StencilTables from TopologyRefiner that have been
     ///        refined uniformly or adaptively.
     ///
     /// \note The factory only creates stencils for vertices that have already
-    ///       been refined in the TopologyRefiner. Use RefineUniform() or
-    ///       RefineAdaptive() before constructing the stencils.
+    ///       been refined in the TopologyRefiner. Use RefineUniform(),
+    ///       RefineAdaptive() or RefineRegion() before constructing the stencils.
+    ///
+    /// With INTERPOLATE_FACE_VARYING, the stencils are those of the
+    /// face-varying values of channel 'fvarChannel' and are factorized over
+    /// the face-varying values of the control cage instead of its vertices
+    /// (GetNumControlVertices() returns the number of such values).
     ///
     /// @param refiner  The TopologyRefiner containing the topology
     ///
@@ -88,6 +97,107 @@ public:
     static StencilTables const * Create(TopologyRefiner const & refiner,
         Options options = Options());
 
+    /// \brief Instantiates StencilTables while refining a TopologyRefiner
+    ///        uniformly, one level at a time.
+    ///
+    /// The topology of each level is discarded as soon as the next level and
+    /// its stencils exist, so peak memory is that of two consecutive levels
+    /// rather than the sum of all levels.  On return, the refiner retains the
+    /// full topology of the base level and of the last level only: the
+    /// intermediate levels retain their component counts, but their topology
+    /// can no longer be queried or interpolated.
+    ///
+    /// \note The refiner must not have been refined.  Refinement stops at the
+    ///       lesser of the refinement level and 'maxLevel'.
+    ///
+    /// @param refiner        The unrefined TopologyRefiner to refine
+    ///
+    /// @param refineOptions  Options controlling the uniform refinement
+    ///
+    /// @param options        Options controlling the creation of the tables
+    ///
+    static StencilTables const * CreateStreaming(TopologyRefiner & refiner,
+        TopologyRefiner::UniformOptions refineOptions, Options options = Options());
+
+    /// \brief Receives a chunk of the stencils generated by CreateChunked()
+    ///
+    /// @param chunk         Tables holding the stencils of the chunk (only valid
+    ///                      for the duration of the call)
+    ///
+    /// @param firstStencil  Index of the first stencil of the chunk in the
+    ///                      tables that Create() returns for the same options
+    ///
+    /// @param clientData    Client data given to CreateChunked()
+    ///
+    typedef void (* ChunkCallback)(StencilTables const & chunk,
+        Index firstStencil, void * clientData);
+
+    /// \brief Generates the stencils of a TopologyRefiner as Create() does,
+    ///        but emits them to a callback in chunks of bounded size instead
+    ///        of returning them as a single StencilTables.
+    ///
+    /// Stencils are emitted in order, as soon as those of a level are no
+    /// longer needed to factorize the next, and the memory of their level is
+    /// then released.  Peak memory is that of the stencils of two consecutive
+    /// levels and of one chunk, rather than that of all levels twice.  The
+    /// control vertex indices of the stencils in each chunk are those of the
+    /// control cage, while offsets (if generated) are local to the chunk.
+    ///
+    /// @param refiner       The TopologyRefiner containing the topology
+    ///
+    /// @param callback      Function receiving each chunk
+    ///
+    /// @param clientData    Client data passed to the callback
+    ///
+    /// @param maxChunkSize  Memory budget of a chunk (in bytes) -- a chunk
+    ///                      holds at least one stencil
+    ///
+    /// @param options       Options controlling the creation of the tables
+    ///
+    static void CreateChunked(TopologyRefiner const & refiner,
+        ChunkCallback callback, void * clientData, size_t maxChunkSize,
+            Options options = Options());
+
+
+    /// \brief Instantiates LimitStencilTables for the limit positions and
+    ///        tangents of the vertices of the last level of a TopologyRefiner
+    ///        that has been refined uniformly.
+    ///
+    /// The resulting tables hold one stencil per vertex of the last level
+    /// (up to 'maxLevel'), in the order of the vertices of that level, so that
+    /// a single stencil pass over the control vertices yields the limit
+    /// positions (UpdateValues) and tangents (UpdateDerivs) of a uniformly
+    /// refined mesh.
+    ///
+    /// Tangents are the derivatives of the limit surface with respect to unit
+    /// length edges of the last level: 'du' along the first edge incident to
+    /// each vertex and 'dv' towards the next edge (see
+    /// Sdc::Scheme::ComputeVertexLimitMask()).  They are exact for regular
+    /// vertices, but only span the tangent plane at extraordinary vertices, so
+    /// normals should be computed as their normalized cross product.
+    ///
+    /// \note The last level must have been refined with its full topology
+    ///       (see TopologyRefiner::UniformOptions::fullTopologyInLastLevel)
+    ///       and only the 'generateOffsets' and 'maxLevel' options apply.
+    ///       At least one level of refinement is required (the limit masks
+    ///       apply to the regular faces of the scheme).
+    ///
+    /// \note The limit masks resolve smooth vertices and the boundaries (and
+    ///       sharpened corners) of the mesh only.  The limits of semi-sharp,
+    ///       non-manifold and interior infinitely sharp features are not
+    ///       resolved and no tables are created if the last level has such
+    ///       vertices -- semi-sharp features vanish once the refinement
+    ///       exceeds their sharpness.
+    ///
+    /// @param refiner  The TopologyRefiner containing the topology
+    ///
+    /// @param options  Options controlling the creation of the tables
+    ///
+    /// @return         The tables, or 0 if the refiner is not refined or
+    ///                 its last level has features that are not resolved
+    ///
+    static LimitStencilTables const * CreateLimit(TopologyRefiner const & refiner,
+        Options options = Options());
 
     /// \brief Instantiates StencilTables by concatenating an array of existing
     ///        stencil tables.
@@ -114,6 +224,16 @@ private:
 
     // Generate stencils for the coarse control-vertices (single weight = 1.0f)
     static void generateControlVertStencils(int numControlVerts, Stencil & dst);
+
+    // Accumulates stencils into chunks for CreateChunked()
+    class ChunkSink;
+
+    // Refines the 'streamingRefiner' (if any) as the stencils are generated
+    // and emits them to the 'sink' (if any) instead of returning tables
+    static StencilTables const * create(TopologyRefiner const & refiner,
+        Options options, TopologyRefiner * streamingRefiner,
+            TopologyRefiner::UniformOptions const * streamingOptions,
+                ChunkSink * sink);
 };
 
 /// \brief A specialized factory for LimitStencilTables
@@ -165,6 +285,39 @@ public:
         LocationArrayVec const & locationArrays,
             StencilTables const * cvStencils=0,
                 PatchTables const * patchTables=0);
+
+    /// \brief Instantiates face-varying LimitStencilTables from a
+    ///        TopologyRefiner that has been refined adaptively.
+    ///
+    /// The stencils interpolate the face-varying values of the control cage
+    /// (instead of its vertices) and honor the face-varying boundary
+    /// interpolation rules of the channel wherever the PatchTables carry
+    /// bi-cubic face-varying patches (see PatchTables::GetFVarPatchType()).
+    ///
+    /// @param refiner          The TopologyRefiner containing the topology
+    ///
+    /// @param locationArrays   An array of surface location descriptors
+    ///                         (see LocationArray)
+    ///
+    /// @param patchTables      A set of PatchTables generated from the
+    ///                         TopologyRefiner with face-varying tables
+    ///                         (see PatchTablesFactory::Options::generateFVarTables)
+    ///
+    /// @param channel          The face-varying primvar channel index
+    ///
+    static LimitStencilTables const * CreateFaceVarying(TopologyRefiner const & refiner,
+        LocationArrayVec const & locationArrays,
+            PatchTables const & patchTables, int channel=0);
+
+private:
+
+    // Generate stencils for the face-varying values of all the levels
+    static StencilTables const * createFVarValueStencils(
+        TopologyRefiner const & refiner, int channel);
+
+    static LimitStencilTables const * create(TopologyRefiner const & refiner,
+        LocationArrayVec const & locationArrays, StencilTables const * cvStencils,
+            PatchTables const * patchTables, int fvarChannel);
 };
 
 
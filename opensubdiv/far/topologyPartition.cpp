@@ -0,0 +1,639 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#include "../far/topologyPartition.h"
+#include "../far/topologyRefiner.h"
+#include "../far/topologyRefinerFactory.h"
+#include "../far/stencilTables.h"
+#include "../far/patchTables.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+TopologyPartition::TopologyPartition(TopologyRefiner const & refiner,
+    int refinementLevel, int numClusters, int const * faceClusters) :
+        _refiner(refiner), _level(refinementLevel), _numVertices(0) {
+
+    assert(numClusters>0 and faceClusters);
+
+    int nfaces = refiner.GetNumFaces(0);
+
+    //  Ptex indices are initialized on demand -- initialize them here so that
+    //  clusters can be processed concurrently:
+    refiner.GetNumPtexFaces();
+
+    //
+    //  Sort the faces by cluster (preserving their order within each cluster):
+    //
+    _clusterFaceOffsets.resize(numClusters+1, 0);
+    for (int face=0; face<nfaces; ++face) {
+        assert(faceClusters[face]>=0 and faceClusters[face]<numClusters);
+        ++_clusterFaceOffsets[faceClusters[face]+1];
+    }
+    for (int cluster=0; cluster<numClusters; ++cluster) {
+        _clusterFaceOffsets[cluster+1] += _clusterFaceOffsets[cluster];
+    }
+    _clusterFaces.resize(nfaces);
+
+    std::vector<Index> clusterSizes(numClusters, 0);
+    for (int face=0; face<nfaces; ++face) {
+        int cluster = faceClusters[face];
+        _clusterFaces[_clusterFaceOffsets[cluster] + clusterSizes[cluster]++] = face;
+    }
+
+    //
+    //  Global numbering of the refined vertices -- the refined base vertices, then
+    //  the vertices interior to base edges and those interior to the faces of each
+    //  cluster:
+    //
+    int edgeInteriorVerts = (1 << _level) - 1;
+
+    _clusterInteriorOffsets.resize(numClusters+1);
+    _clusterInteriorOffsets[0] = refiner.GetNumVertices(0) +
+                                 refiner.GetNumEdges(0) * edgeInteriorVerts;
+    for (int cluster=0; cluster<numClusters; ++cluster) {
+        ConstIndexArray faces = GetClusterFaces(cluster);
+
+        int nverts = 0;
+        for (int i=0; i<faces.size(); ++i) {
+            nverts += getNumFaceInteriorVertices(refiner.GetFaceVertices(0, faces[i]).size());
+        }
+        _clusterInteriorOffsets[cluster+1] = _clusterInteriorOffsets[cluster] + nverts;
+    }
+    _numVertices = _clusterInteriorOffsets[numClusters];
+}
+
+int
+TopologyPartition::getNumFaceInteriorVertices(int faceSize) const {
+
+    if (_level==0) {
+        return 0;
+    }
+    if (_refiner.GetSchemeType()==Sdc::SCHEME_LOOP) {
+        //  Triangles split into triangles:
+        int n = 1 << _level;
+        return (n-1) * (n-2) / 2;
+    } else {
+        //  N-sided faces split into N quads -- the face vertex, the vertices
+        //  interior to the N edges from it and those interior to the N quads:
+        int n = (1 << (_level-1)) - 1;
+        return 1 + faceSize * n + faceSize * n * n;
+    }
+}
+
+int
+TopologyPartition::ComputeFaceClusters(TopologyRefiner const & refiner,
+    int maxClusterSize, std::vector<int> & faceClusters) {
+
+    assert(maxClusterSize>0);
+
+    int nfaces = refiner.GetNumFaces(0),
+        nclusters = 0;
+
+    faceClusters.assign(nfaces, -1);
+
+    std::vector<Index> queue;
+    queue.reserve(maxClusterSize);
+
+    for (int seed=0; seed<nfaces; ++seed) {
+        if (faceClusters[seed]>=0) {
+            continue;
+        }
+        int cluster = nclusters++;
+
+        queue.clear();
+        queue.push_back(seed);
+        faceClusters[seed] = cluster;
+
+        for (int head=0; head<(int)queue.size(); ++head) {
+            ConstIndexArray fedges = refiner.GetFaceEdges(0, queue[head]);
+
+            for (int i=0; i<fedges.size(); ++i) {
+                ConstIndexArray efaces = refiner.GetEdgeFaces(0, fedges[i]);
+
+                for (int j=0; j<efaces.size(); ++j) {
+                    if (faceClusters[efaces[j]]<0 and (int)queue.size()<maxClusterSize) {
+                        faceClusters[efaces[j]] = cluster;
+                        queue.push_back(efaces[j]);
+                    }
+                }
+            }
+        }
+    }
+    return nclusters;
+}
+
+//
+//  The faces of a cluster refiner -- those of the cluster followed by the halo of all
+//  other faces incident the vertices of the cluster (sorted by index):
+//
+void
+TopologyPartition::gatherClusterFaces(int cluster, std::vector<Index> & faces) const {
+
+    ConstIndexArray cfaces = GetClusterFaces(cluster);
+
+    std::vector<Index> halo;
+    for (int i=0; i<cfaces.size(); ++i) {
+        ConstIndexArray fverts = _refiner.GetFaceVertices(0, cfaces[i]);
+
+        for (int j=0; j<fverts.size(); ++j) {
+            ConstIndexArray vfaces = _refiner.GetVertexFaces(0, fverts[j]);
+
+            for (int k=0; k<vfaces.size(); ++k) {
+                if (not std::binary_search(cfaces.begin(), cfaces.end(), vfaces[k])) {
+                    halo.push_back(vfaces[k]);
+                }
+            }
+        }
+    }
+    std::sort(halo.begin(), halo.end());
+    halo.erase(std::unique(halo.begin(), halo.end()), halo.end());
+
+    faces.assign(cfaces.begin(), cfaces.end());
+    faces.insert(faces.end(), halo.begin(), halo.end());
+}
+
+//
+//  The vertices of a cluster refiner -- those of all of its faces sorted by index, so
+//  that local indices are found by binary search:
+//
+void
+TopologyPartition::gatherClusterVertices(std::vector<Index> const & faces,
+    std::vector<Index> & verts) const {
+
+    verts.clear();
+    for (int i=0; i<(int)faces.size(); ++i) {
+        ConstIndexArray fverts = _refiner.GetFaceVertices(0, faces[i]);
+        verts.insert(verts.end(), fverts.begin(), fverts.end());
+    }
+    std::sort(verts.begin(), verts.end());
+    verts.erase(std::unique(verts.begin(), verts.end()), verts.end());
+}
+
+namespace {
+    inline Index
+    findLocalIndex(std::vector<Index> const & sorted, Index index) {
+        return (Index)(std::lower_bound(sorted.begin(), sorted.end(), index) - sorted.begin());
+    }
+}
+
+void
+TopologyPartition::GetClusterBaseVertices(int cluster, std::vector<Index> & baseVerts) const {
+
+    std::vector<Index> faces;
+    gatherClusterFaces(cluster, faces);
+    gatherClusterVertices(faces, baseVerts);
+}
+
+TopologyRefiner *
+TopologyPartition::CreateClusterRefiner(int cluster) const {
+
+    typedef TopologyRefinerFactoryBase::TopologyDescriptor Descriptor;
+    typedef TopologyRefinerFactory<Descriptor>             Factory;
+
+    std::vector<Index> faces, verts;
+    gatherClusterFaces(cluster, faces);
+    gatherClusterVertices(faces, verts);
+
+    int nfaces = (int)faces.size();
+    assert(nfaces>0);
+
+    std::vector<int>   vertsPerFace(nfaces);
+    std::vector<Index> vertIndices,
+                       holes,
+                       edges;
+    for (int face=0; face<nfaces; ++face) {
+        ConstIndexArray fverts = _refiner.GetFaceVertices(0, faces[face]),
+                        fedges = _refiner.GetFaceEdges(0, faces[face]);
+
+        vertsPerFace[face] = fverts.size();
+        for (int i=0; i<fverts.size(); ++i) {
+            vertIndices.push_back(findLocalIndex(verts, fverts[i]));
+        }
+        edges.insert(edges.end(), fedges.begin(), fedges.end());
+
+        if (_refiner.IsHole(0, faces[face])) {
+            holes.push_back(face);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    //  Sharpness of edges and vertices is assigned as is -- features sharpened by
+    //  the factory on construction are sharpened identically for the vertices of
+    //  the cluster, whose neighborhood is complete:
+    std::vector<Index> creaseVerts;
+    std::vector<float> creaseWeights;
+    for (int i=0; i<(int)edges.size(); ++i) {
+        float sharpness = _refiner.GetEdgeSharpness(0, edges[i]);
+        if (sharpness>0.0f) {
+            ConstIndexArray everts = _refiner.GetEdgeVertices(0, edges[i]);
+            creaseVerts.push_back(findLocalIndex(verts, everts[0]));
+            creaseVerts.push_back(findLocalIndex(verts, everts[1]));
+            creaseWeights.push_back(sharpness);
+        }
+    }
+
+    std::vector<Index> corners;
+    std::vector<float> cornerWeights;
+    for (int i=0; i<(int)verts.size(); ++i) {
+        float sharpness = _refiner.GetVertexSharpness(0, verts[i]);
+        if (sharpness>0.0f) {
+            corners.push_back(i);
+            cornerWeights.push_back(sharpness);
+        }
+    }
+
+    Descriptor desc;
+    desc.numVertices = (int)verts.size();
+    desc.numFaces = nfaces;
+    desc.numVertsPerFace = &vertsPerFace[0];
+    desc.vertIndicesPerFace = &vertIndices[0];
+    desc.numCreases = (int)creaseWeights.size();
+    desc.creaseVertexIndexPairs = creaseWeights.empty() ? 0 : &creaseVerts[0];
+    desc.creaseWeights = creaseWeights.empty() ? 0 : &creaseWeights[0];
+    desc.numCorners = (int)corners.size();
+    desc.cornerVertexIndices = corners.empty() ? 0 : &corners[0];
+    desc.cornerWeights = corners.empty() ? 0 : &cornerWeights[0];
+    desc.numHoles = (int)holes.size();
+    desc.holeIndices = holes.empty() ? 0 : &holes[0];
+
+    return Factory::Create(desc,
+        Factory::Options(_refiner.GetSchemeType(), _refiner.GetSchemeOptions()));
+}
+
+//
+//  Identification of the global vertices of a cluster -- the origin of every component
+//  of each level is traced from the base level:  a base vertex, a position along a base
+//  edge (a parameter in [0, 2^level] from the first vertex of the edge in the base mesh)
+//  or the interior of a base face.
+//
+namespace {
+    struct Origin {
+        enum Type { VERTEX, EDGE, FACE };
+
+        void Set(Type t, Index b, int param0=0, int param1=0) {
+            type = t;
+            base = b;
+            p0 = param0;
+            p1 = param1;
+        }
+
+        Type  type;
+        Index base;     // base component of the cluster refiner
+        int   p0, p1;   // parameters on a base edge (of the vertex or edge end points)
+    };
+}
+
+void
+TopologyPartition::GetClusterVertexMap(int cluster, TopologyRefiner const & clusterRefiner,
+    std::vector<Index> & vertexMap) const {
+
+    TopologyRefiner const & refiner = clusterRefiner;
+
+    assert(refiner.IsUniform() and refiner.GetMaxLevel()==_level);
+
+    std::vector<Index> faces, verts;
+    gatherClusterFaces(cluster, faces);
+    gatherClusterVertices(faces, verts);
+
+    int nClusterFaces = GetClusterFaces(cluster).size(),
+        edgeParam = 1 << _level;
+
+    assert(refiner.GetNumFaces(0)==(int)faces.size() and
+           refiner.GetNumVertices(0)==(int)verts.size());
+
+    //
+    //  Identify the base edges corresponding to those of the cluster refiner (through
+    //  the edges of corresponding faces), and the base components of the cluster:
+    //
+    std::vector<Index> baseEdges(refiner.GetNumEdges(0), Vtr::INDEX_INVALID);
+    std::vector<bool>  clusterEdges(refiner.GetNumEdges(0), false),
+                       clusterVerts(refiner.GetNumVertices(0), false);
+
+    std::vector<Origin> faceOrigins(refiner.GetNumFaces(0)),
+                        edgeOrigins(refiner.GetNumEdges(0)),
+                        vertOrigins(refiner.GetNumVertices(0));
+
+    for (int face=0; face<(int)faces.size(); ++face) {
+        ConstIndexArray fedges = refiner.GetFaceEdges(0, face),
+                        gedges = _refiner.GetFaceEdges(0, faces[face]),
+                        fverts = refiner.GetFaceVertices(0, face);
+
+        for (int i=0; i<fedges.size(); ++i) {
+            Index edge = fedges[i];
+            if (not Vtr::IndexIsValid(baseEdges[edge])) {
+                baseEdges[edge] = gedges[i];
+
+                Index v0 = verts[refiner.GetEdgeVertices(0, edge)[0]];
+                if (v0==_refiner.GetEdgeVertices(0, gedges[i])[0]) {
+                    edgeOrigins[edge].Set(Origin::EDGE, edge, 0, edgeParam);
+                } else {
+                    edgeOrigins[edge].Set(Origin::EDGE, edge, edgeParam, 0);
+                }
+            }
+            if (face<nClusterFaces) {
+                clusterEdges[edge] = true;
+                clusterVerts[fverts[i]] = true;
+            }
+        }
+        faceOrigins[face].Set(Origin::FACE, face);
+    }
+    for (int vert=0; vert<(int)verts.size(); ++vert) {
+        vertOrigins[vert].Set(Origin::VERTEX, vert);
+    }
+
+    //
+    //  Propagate the origins through each refinement:
+    //
+    for (int level=0; level<_level; ++level) {
+
+        std::vector<Origin> childFaceOrigins,
+                            childEdgeOrigins,
+                            childVertOrigins(refiner.GetNumVertices(level+1));
+
+        for (int vert=0; vert<refiner.GetNumVertices(level); ++vert) {
+            childVertOrigins[refiner.GetVertexChildVertex(level, vert)] = vertOrigins[vert];
+        }
+        for (int edge=0; edge<refiner.GetNumEdges(level); ++edge) {
+            Origin const & origin = edgeOrigins[edge];
+
+            Origin & childVert = childVertOrigins[refiner.GetEdgeChildVertex(level, edge)];
+            if (origin.type==Origin::EDGE) {
+                childVert.Set(Origin::EDGE, origin.base, (origin.p0 + origin.p1) / 2);
+            } else {
+                childVert = origin;
+            }
+        }
+        for (int face=0; face<refiner.GetNumFaces(level); ++face) {
+            Index childVert = refiner.GetFaceChildVertex(level, face);
+            if (Vtr::IndexIsValid(childVert)) {
+                childVertOrigins[childVert] = faceOrigins[face];
+            }
+        }
+
+        //  Faces and edges are not needed for the last level:
+        if (level+1 < _level) {
+            childFaceOrigins.resize(refiner.GetNumFaces(level+1));
+            childEdgeOrigins.resize(refiner.GetNumEdges(level+1));
+
+            for (int face=0; face<refiner.GetNumFaces(level); ++face) {
+                ConstIndexArray cfaces = refiner.GetFaceChildFaces(level, face),
+                                cedges = refiner.GetFaceChildEdges(level, face);
+                for (int i=0; i<cfaces.size(); ++i) {
+                    childFaceOrigins[cfaces[i]] = faceOrigins[face];
+                }
+                for (int i=0; i<cedges.size(); ++i) {
+                    childEdgeOrigins[cedges[i]] = faceOrigins[face];
+                }
+            }
+            for (int edge=0; edge<refiner.GetNumEdges(level); ++edge) {
+                Origin const &  origin = edgeOrigins[edge];
+                ConstIndexArray cedges = refiner.GetEdgeChildEdges(level, edge);
+
+                if (origin.type==Origin::EDGE) {
+                    Index childVert = refiner.GetEdgeChildVertex(level, edge);
+                    int   midParam  = (origin.p0 + origin.p1) / 2;
+
+                    for (int i=0; i<2; ++i) {
+                        int endParam = (i==0) ? origin.p0 : origin.p1;
+                        if (refiner.GetEdgeVertices(level+1, cedges[i])[0]==childVert) {
+                            childEdgeOrigins[cedges[i]].Set(Origin::EDGE, origin.base, midParam, endParam);
+                        } else {
+                            childEdgeOrigins[cedges[i]].Set(Origin::EDGE, origin.base, endParam, midParam);
+                        }
+                    }
+                } else {
+                    childEdgeOrigins[cedges[0]] = origin;
+                    childEdgeOrigins[cedges[1]] = origin;
+                }
+            }
+        }
+        faceOrigins.swap(childFaceOrigins);
+        edgeOrigins.swap(childEdgeOrigins);
+        vertOrigins.swap(childVertOrigins);
+    }
+
+    //
+    //  Assign the global vertices of the cluster:
+    //
+    Index edgeVertsOffset = _refiner.GetNumVertices(0),
+          faceVertsOffset = _clusterInteriorOffsets[cluster];
+
+    vertexMap.resize(vertOrigins.size());
+    for (int vert=0; vert<(int)vertOrigins.size(); ++vert) {
+        Origin const & origin = vertOrigins[vert];
+
+        Index & globalVert = vertexMap[vert];
+        globalVert = Vtr::INDEX_INVALID;
+
+        if (origin.type==Origin::VERTEX) {
+            if (clusterVerts[origin.base]) {
+                globalVert = verts[origin.base];
+            }
+        } else if (origin.type==Origin::EDGE) {
+            if (clusterEdges[origin.base]) {
+                globalVert = edgeVertsOffset + baseEdges[origin.base] * (edgeParam-1) + origin.p0 - 1;
+            }
+        } else if (origin.base < nClusterFaces) {
+            globalVert = faceVertsOffset++;
+        }
+    }
+    assert(faceVertsOffset==_clusterInteriorOffsets[cluster+1]);
+}
+
+StencilTables const *
+TopologyPartition::CreateStencilTables(StencilTables const * const * clusterStencils,
+    std::vector<Index> const * vertexMaps) const {
+
+    int nclusters = GetNumClusters();
+
+    //
+    //  Select the cluster providing the stencil of each global vertex -- vertices shared
+    //  by clusters have identical stencils in each:
+    //
+    std::vector<Index> sourceClusters(_numVertices, Vtr::INDEX_INVALID),
+                       sourceStencils(_numVertices, Vtr::INDEX_INVALID);
+
+    StencilTables * result = new StencilTables;
+    result->_sizes.resize(_numVertices, 0);
+
+    int nelems = 0;
+    for (int cluster=0; cluster<nclusters; ++cluster) {
+        StencilTables const & stencils = *clusterStencils[cluster];
+        std::vector<Index> const & vertexMap = vertexMaps[cluster];
+
+        assert(stencils.GetNumStencils()==(int)vertexMap.size());
+
+        for (int i=0; i<(int)vertexMap.size(); ++i) {
+            Index vert = vertexMap[i];
+            if (Vtr::IndexIsValid(vert) and not Vtr::IndexIsValid(sourceClusters[vert])) {
+                sourceClusters[vert] = cluster;
+                sourceStencils[vert] = i;
+                result->_sizes[vert] = stencils.GetSizes()[i];
+                nelems += stencils.GetSizes()[i];
+            }
+        }
+    }
+    result->resize(_numVertices, nelems);
+    result->generateOffsets();
+    result->_numControlVertices = _refiner.GetNumVertices(0);
+
+    //
+    //  Copy the stencils, remapping their control vertices to the base mesh:
+    //
+    std::vector<Index> baseVerts;
+    for (int cluster=0; cluster<nclusters; ++cluster) {
+        StencilTables const & stencils = *clusterStencils[cluster];
+        std::vector<Index> const & vertexMap = vertexMaps[cluster];
+
+        GetClusterBaseVertices(cluster, baseVerts);
+
+        Index const * srcIndices = stencils.GetControlIndices().empty() ? 0 : &stencils.GetControlIndices()[0];
+        float const * srcWeights = stencils.GetWeights().empty() ? 0 : &stencils.GetWeights()[0];
+
+        for (int i=0, offset=0; i<(int)vertexMap.size(); ++i) {
+            int   size = stencils.GetSizes()[i];
+            Index vert = vertexMap[i];
+
+            if (Vtr::IndexIsValid(vert) and sourceClusters[vert]==cluster and sourceStencils[vert]==i) {
+                Index * dstIndices = &result->_indices[result->_offsets[vert]];
+                float * dstWeights = &result->_weights[result->_offsets[vert]];
+
+                for (int j=0; j<size; ++j) {
+                    dstIndices[j] = baseVerts[srcIndices[offset+j]];
+                }
+                memcpy(dstWeights, srcWeights + offset, size*sizeof(float));
+            }
+            offset += size;
+        }
+    }
+    return result;
+}
+
+PatchTables const *
+TopologyPartition::CreatePatchTables(PatchTables const * const * clusterPatches,
+    TopologyRefiner const * const * clusterRefiners,
+    std::vector<Index> const * vertexMaps) const {
+
+    int nclusters = GetNumClusters();
+
+    assert(clusterPatches[0]->GetNumPatchArrays()==1);
+
+    PatchDescriptor desc = clusterPatches[0]->GetPatchArrayDescriptor(0);
+
+    int npatchverts = desc.GetNumControlVertices();
+
+    //
+    //  Identify the patches of the faces of each cluster (rather than of the halo) from
+    //  their ptex indices -- those of the cluster faces come first:
+    //
+    std::vector<int> ptexCounts(nclusters);
+
+    int npatches = 0,
+        maxValence = 0;
+    for (int cluster=0; cluster<nclusters; ++cluster) {
+        TopologyRefiner const & refiner = *clusterRefiners[cluster];
+        PatchTables const &     patches = *clusterPatches[cluster];
+
+        assert(patches.GetNumPatchArrays()==1 and patches.GetPatchArrayDescriptor(0)==desc);
+
+        int nfaces = GetClusterFaces(cluster).size();
+        ptexCounts[cluster] = (nfaces < refiner.GetNumFaces(0)) ?
+            refiner.GetPtexIndex(nfaces) : refiner.GetNumPtexFaces();
+
+        for (int patch=0; patch<patches.GetNumPatches(0); ++patch) {
+            npatches += (patches.GetPatchParam(0, patch).faceIndex < ptexCounts[cluster]);
+        }
+        maxValence = std::max(maxValence, patches.GetMaxValence());
+    }
+
+    PatchTables * tables = new PatchTables(maxValence);
+
+    tables->_numPtexFaces = _refiner.GetNumPtexFaces();
+
+    Index voffset = 0,
+          poffset = 0;
+    tables->reservePatchArrays(1);
+    tables->pushPatchArray(desc, npatches, &voffset, &poffset, 0);
+
+    tables->_patchVerts.resize(npatches * npatchverts);
+    tables->_paramTable.resize(npatches);
+
+    Index      * iptr = tables->_patchVerts.empty() ? 0 : &tables->_patchVerts[0];
+    PatchParam * pptr = tables->_paramTable.empty() ? 0 : &tables->_paramTable[0];
+
+    Index levelVertOffset = _refiner.GetNumVertices(0);
+
+    std::vector<Index> ptexIndices;
+    for (int cluster=0; cluster<nclusters; ++cluster) {
+        TopologyRefiner const &    refiner   = *clusterRefiners[cluster];
+        PatchTables const &        patches   = *clusterPatches[cluster];
+        std::vector<Index> const & vertexMap = vertexMaps[cluster];
+
+        ConstIndexArray faces = GetClusterFaces(cluster);
+
+        ptexIndices.resize(ptexCounts[cluster]);
+        for (int face=0; face<faces.size(); ++face) {
+            Index first = refiner.GetPtexIndex(face),
+                  last  = (face+1<faces.size()) ? refiner.GetPtexIndex(face+1) : ptexCounts[cluster];
+            for (Index ptex=first; ptex<last; ++ptex) {
+                ptexIndices[ptex] = _refiner.GetPtexIndex(faces[face]) + (ptex - first);
+            }
+        }
+
+        Index clusterVertOffset = refiner.GetNumVertices(0);
+
+        for (int patch=0; patch<patches.GetNumPatches(0); ++patch) {
+            PatchParam param = patches.GetPatchParam(0, patch);
+            if (param.faceIndex >= ptexCounts[cluster]) {
+                continue;
+            }
+            Index buffer[PatchTables::MAX_PATCH_VERTICES];
+            ConstIndexArray cvs = patches.GetPatchVertices(0, patch, buffer);
+            for (int i=0; i<cvs.size(); ++i) {
+                Index vert = vertexMap[cvs[i] - clusterVertOffset];
+                assert(Vtr::IndexIsValid(vert));
+                *iptr++ = levelVertOffset + vert;
+            }
+            param.faceIndex = ptexIndices[param.faceIndex];
+            *pptr++ = param;
+        }
+    }
+
+    if (clusterPatches[0]->IsCompact()) {
+        tables->compact();
+    }
+    return tables;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
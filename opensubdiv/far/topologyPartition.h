@@ -0,0 +1,205 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef FAR_TOPOLOGY_PARTITION_H
+#define FAR_TOPOLOGY_PARTITION_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class TopologyRefiner;
+class StencilTables;
+class PatchTables;
+
+/// \brief Partitioning of a base mesh into clusters of faces refined independently
+///
+/// Meshes too large to be refined as a whole are partitioned into clusters of
+/// base faces.  For each cluster, a TopologyRefiner is created from the faces
+/// of the cluster and a halo of the faces incident its vertices -- the support
+/// of all refined vertices of the cluster faces -- so that each cluster can be
+/// refined uniformly and its stencils and patches created independently (in
+/// parallel, or on different hosts) with memory proportional to the cluster.
+///
+/// The vertices of the refined level of the whole mesh are given a global
+/// numbering:  refined base vertices keep their base indices and are followed
+/// by the vertices interior to each base edge (in the order of the edges and
+/// from the first vertex of each edge) and then by the vertices interior to the
+/// faces of each cluster.  GetClusterVertexMap() identifies the global vertex of
+/// each refined vertex of a cluster, with which the stencils and patches of all
+/// clusters can be stitched together.
+///
+/// \note Face-varying channels of the base mesh are not partitioned.
+///
+class TopologyPartition {
+
+public:
+
+    /// \brief Constructor
+    ///
+    /// @param refiner          TopologyRefiner with the base level of the mesh
+    ///                         (refinement of the refiner is not required)
+    ///
+    /// @param refinementLevel  Level of uniform refinement to be applied to
+    ///                         the clusters
+    ///
+    /// @param numClusters      Number of clusters
+    ///
+    /// @param faceClusters     Cluster of each base face (see ComputeFaceClusters())
+    ///
+    TopologyPartition(TopologyRefiner const & refiner, int refinementLevel,
+        int numClusters, int const * faceClusters);
+
+    /// \brief Assigns base faces to clusters of contiguous faces
+    ///
+    /// Clusters are grown breadth-first across the edges of the base faces
+    /// until reaching the given size (or exhausting their connected region).
+    ///
+    /// @param refiner         TopologyRefiner with the base level of the mesh
+    ///
+    /// @param maxClusterSize  Maximum number of faces of each cluster
+    ///
+    /// @param faceClusters    Vector populated with the cluster of each face
+    ///
+    /// @return                The number of clusters
+    ///
+    static int ComputeFaceClusters(TopologyRefiner const & refiner,
+        int maxClusterSize, std::vector<int> & faceClusters);
+
+    /// \brief Returns the number of clusters
+    int GetNumClusters() const { return (int)_clusterFaceOffsets.size()-1; }
+
+    /// \brief Returns the level of uniform refinement of the clusters
+    int GetRefinementLevel() const { return _level; }
+
+    /// \brief Returns the base faces of a cluster
+    ConstIndexArray GetClusterFaces(int cluster) const {
+        return ConstIndexArray(&_clusterFaces[_clusterFaceOffsets[cluster]],
+            _clusterFaceOffsets[cluster+1]-_clusterFaceOffsets[cluster]);
+    }
+
+    /// \brief Returns the number of vertices of the refined level of the whole mesh
+    int GetNumVertices() const { return _numVertices; }
+
+    /// \brief Returns a new TopologyRefiner for a cluster and its halo
+    ///
+    /// The faces of the cluster are the first faces of the base level of the
+    /// refiner, in the order of GetClusterFaces(), followed by those of the
+    /// halo.  The refiner is to be refined uniformly to the refinement level
+    /// of the partition.
+    ///
+    TopologyRefiner * CreateClusterRefiner(int cluster) const;
+
+    /// \brief Gathers the base vertices of a cluster refiner
+    ///
+    /// @param cluster      The cluster
+    ///
+    /// @param baseVerts    Vector populated with the index in the base mesh
+    ///                     of each base vertex of the cluster refiner
+    ///
+    void GetClusterBaseVertices(int cluster, std::vector<Index> & baseVerts) const;
+
+    /// \brief Maps the refined vertices of a cluster to global vertices
+    ///
+    /// @param cluster         The cluster
+    ///
+    /// @param clusterRefiner  The refiner created for the cluster, refined
+    ///                        uniformly to the refinement level
+    ///
+    /// @param vertexMap       Vector populated with the global index of each
+    ///                        vertex of the last level of the cluster refiner
+    ///                        (INDEX_INVALID for vertices of the halo)
+    ///
+    void GetClusterVertexMap(int cluster, TopologyRefiner const & clusterRefiner,
+        std::vector<Index> & vertexMap) const;
+
+    /// \brief Stitches the stencils of all clusters
+    ///
+    /// @param clusterStencils  Stencils of the last level of each cluster
+    ///                         refiner (created without intermediate levels
+    ///                         or control vertices)
+    ///
+    /// @param vertexMaps       Vertex map of each cluster
+    ///
+    /// @return                 Stencils of the global vertices in terms of the
+    ///                         vertices of the base mesh
+    ///
+    StencilTables const * CreateStencilTables(
+        StencilTables const * const * clusterStencils,
+        std::vector<Index> const * vertexMaps) const;
+
+    /// \brief Stitches the uniform patches of all clusters
+    ///
+    /// @param clusterPatches   Uniform patches of the last level of each
+    ///                         cluster refiner
+    ///
+    /// @param clusterRefiners  Refiner of each cluster
+    ///
+    /// @param vertexMaps       Vertex map of each cluster
+    ///
+    /// @return                 Patches of the cluster faces, whose vertices
+    ///                         follow the base vertices (as for uniform patches
+    ///                         of the last level) and whose ptex indices are
+    ///                         those of the base mesh
+    ///
+    PatchTables const * CreatePatchTables(
+        PatchTables const * const * clusterPatches,
+        TopologyRefiner const * const * clusterRefiners,
+        std::vector<Index> const * vertexMaps) const;
+
+private:
+
+    void gatherClusterFaces(int cluster, std::vector<Index> & faces) const;
+    void gatherClusterVertices(std::vector<Index> const & faces,
+        std::vector<Index> & verts) const;
+
+    int getNumFaceInteriorVertices(int faceSize) const;
+
+private:
+
+    TopologyRefiner const & _refiner;
+
+    int _level;
+    int _numVertices;
+
+    std::vector<Index> _clusterFaceOffsets;
+    std::vector<Index> _clusterFaces;
+    std::vector<Index> _clusterInteriorOffsets;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // FAR_TOPOLOGY_PARTITION_H
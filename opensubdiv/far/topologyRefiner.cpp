@@ -22,13 +22,20 @@
 //   language governing permissions and limitations under the Apache License.
 //
 #include "../far/topologyRefiner.h"
+#include "../far/topologyRefinerFactory.h"
 #include "../vtr/sparseSelector.h"
 #include "../vtr/quadRefinement.h"
 #include "../vtr/triRefinement.h"
+#include "../vtr/stopwatch.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 
+#ifdef _MSC_VER
+    #define snprintf _snprintf
+#endif
+
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -45,12 +52,17 @@ TopologyRefiner::TopologyRefiner(Sdc::SchemeType schemeType, Sdc::Options scheme
     _isUniform(true),
     _hasHoles(false),
     _useSingleCreasePatch(false),
+    _considerFVarChannels(false),
     _maxLevel(0) {
 
     //  Need to revisit allocation scheme here -- want to use smart-ptrs for these
     //  but will probably have to settle for explicit new/delete...
     _levels.reserve(10);
     _levels.push_back(new Vtr::Level);
+
+    for (int i = 0; i < Statistics::NUM_FACTORY_STAGES; ++i) {
+        _factoryTimes[i] = 0.0;
+    }
 }
 
 TopologyRefiner::~TopologyRefiner() {
@@ -77,6 +89,8 @@ TopologyRefiner::Unrefine() {
         delete _refinements[i];
     }
     _refinements.clear();
+    _maskTables.clear();
+    _maxLevel = 0;
 }
 
 
@@ -136,6 +150,96 @@ TopologyRefiner::GetNumHoles(int level) const {
     return sum;
 }
 
+//
+//  Instrumentation -- the stages and relations of Far and Vtr are enumerated in the same
+//  order:
+//
+void
+TopologyRefiner::GetStatistics(Statistics & statistics) const {
+
+    assert((int)Statistics::NUM_REFINEMENT_STAGES == (int)Vtr::Refinement::NUM_STAGES);
+    assert((int)Statistics::NUM_RELATIONS == (int)Vtr::Level::NUM_RELATIONS);
+
+    for (int i = 0; i < Statistics::NUM_FACTORY_STAGES; ++i) {
+        statistics.factoryTimes[i] = _factoryTimes[i];
+    }
+
+    statistics.levels.resize(_levels.size());
+    for (int level = 0; level < (int)_levels.size(); ++level) {
+        Vtr::Level const & lvl = *_levels[level];
+
+        Statistics::LevelStatistics & levelStats = statistics.levels[level];
+
+        for (int i = 0; i < Statistics::NUM_REFINEMENT_STAGES; ++i) {
+            levelStats.refinementTimes[i] = level ?
+                _refinements[level-1]->getStageTime((Vtr::Refinement::Stage)i) : 0.0;
+        }
+        for (int i = 0; i < Statistics::NUM_RELATIONS; ++i) {
+            levelStats.relationMemory[i] = lvl.getRelationMemoryUsage((Vtr::Level::Relation)i);
+        }
+        levelStats.tagMemory        = lvl.getTagMemoryUsage();
+        levelStats.sharpnessMemory  = lvl.getSharpnessMemoryUsage();
+        levelStats.fvarMemory       = lvl.getFVarMemoryUsage();
+        levelStats.refinementMemory = level ? _refinements[level-1]->getMemoryUsage() : 0;
+    }
+}
+
+std::string
+TopologyRefiner::GetStatisticsReport() const {
+
+    Statistics statistics;
+    GetStatistics(statistics);
+
+    static char const * factoryStageNames[Statistics::NUM_FACTORY_STAGES] = {
+        "sizing", "assignment", "tags", "fvar" };
+    static char const * refinementStageNames[Statistics::NUM_REFINEMENT_STAGES] = {
+        "select", "p->c", "c->p", "tags", "topology", "sharpness", "fvar" };
+    static char const * relationNames[Statistics::NUM_RELATIONS] = {
+        "fv", "fe", "ev", "ef", "vf", "ve" };
+
+    std::string report("TopologyRefiner statistics (times in ms, memory in KB)\n");
+
+    char line[256];
+    report += "  factory:";
+    for (int i = 0; i < Statistics::NUM_FACTORY_STAGES; ++i) {
+        snprintf(line, 256, " %s %.3f", factoryStageNames[i], 1000.0 * statistics.factoryTimes[i]);
+        report += line;
+    }
+    report += "\n";
+
+    size_t totalMemory = 0;
+    for (int level = 0; level < (int)statistics.levels.size(); ++level) {
+        Statistics::LevelStatistics const & levelStats = statistics.levels[level];
+
+        snprintf(line, 256, "  level %d: faces %d edges %d verts %d\n    time:", level,
+            GetNumFaces(level), GetNumEdges(level), GetNumVertices(level));
+        report += line;
+        for (int i = 0; i < Statistics::NUM_REFINEMENT_STAGES; ++i) {
+            snprintf(line, 256, " %s %.3f", refinementStageNames[i], 1000.0 * levelStats.refinementTimes[i]);
+            report += line;
+        }
+
+        size_t levelMemory = levelStats.tagMemory + levelStats.sharpnessMemory +
+                             levelStats.fvarMemory + levelStats.refinementMemory;
+        report += "\n    memory:";
+        for (int i = 0; i < Statistics::NUM_RELATIONS; ++i) {
+            snprintf(line, 256, " %s %.1f", relationNames[i], levelStats.relationMemory[i] / 1024.0);
+            report += line;
+            levelMemory += levelStats.relationMemory[i];
+        }
+        snprintf(line, 256, " tags %.1f sharpness %.1f fvar %.1f refinement %.1f total %.1f\n",
+            levelStats.tagMemory / 1024.0, levelStats.sharpnessMemory / 1024.0,
+            levelStats.fvarMemory / 1024.0, levelStats.refinementMemory / 1024.0,
+            levelMemory / 1024.0);
+        report += line;
+
+        totalMemory += levelMemory;
+    }
+    snprintf(line, 256, "  total memory %.1f\n", totalMemory / 1024.0);
+    report += line;
+    return report;
+}
+
 //
 //  Ptex information accessors
 //
@@ -311,6 +415,22 @@ TopologyRefiner::RefineUniform(UniformOptions options) {
     //
     _isUniform = true;
     _maxLevel = options.refinementLevel;
+    _maskTables.clear();
+
+    for (int i = 1; i <= (int)options.refinementLevel; ++i) {
+        refineUniformLevel(options);
+    }
+}
+
+//
+//  Append the next level of a uniform refinement -- allocating the child level and the
+//  refinement from the last level to it:
+//
+void
+TopologyRefiner::refineUniformLevel(UniformOptions const & options) {
+
+    int i = (int)_levels.size();
+    assert(i <= (int)options.refinementLevel);
 
     Sdc::Split splitType = (_subdivType == Sdc::SCHEME_LOOP) ? Sdc::SPLIT_TO_TRIS : Sdc::SPLIT_TO_QUADS;
 
@@ -318,28 +438,209 @@ TopologyRefiner::RefineUniform(UniformOptions options) {
     //  Initialize refinement options for Vtr -- adjusting full-topology for the last level:
     //
     Vtr::Refinement::Options refineOptions;
-    refineOptions._sparse = false;
+    refineOptions._sparse   = options.pruneHoles and _hasHoles;
+    refineOptions._parallel = options.parallelRefinement;
+    refineOptions._timeStages = options.recordStatistics;
+    refineOptions._faceTopologyOnly =
+        options.fullTopologyInLastLevel ? false : (i == options.refinementLevel);
+
+    Vtr::Level& parentLevel = getLevel(i-1);
+    Vtr::Level& childLevel  = *(new Vtr::Level);
+
+    Vtr::Refinement* refinement = 0;
+    if (splitType == Sdc::SPLIT_TO_QUADS) {
+        refinement = new Vtr::QuadRefinement(parentLevel, childLevel, _subdivOptions);
+    } else {
+        refinement = new Vtr::TriRefinement(parentLevel, childLevel, _subdivOptions);
+    }
 
-    for (int i = 1; i <= (int)options.refinementLevel; ++i) {
-        refineOptions._faceTopologyOnly =
-            options.fullTopologyInLastLevel ? false : (i == options.refinementLevel);
+    //
+    //  When pruning holes, select all faces that are not holes -- Vtr completes the
+    //  selection with the components needed to support them:
+    //
+    if (refineOptions._sparse) {
+        Vtr::SparseSelector selector(*refinement);
+        Vtr::Stopwatch      selectionTimer;
 
-        Vtr::Level& parentLevel = getLevel(i-1);
-        Vtr::Level& childLevel  = *(new Vtr::Level);
+        for (Vtr::Index face = 0; face < parentLevel.getNumFaces(); ++face) {
+            if (not parentLevel.isHole(face)) {
+                selector.selectFace(face);
+            }
+        }
+        if (options.recordStatistics) {
+            refinement->setStageTime(Vtr::Refinement::STAGE_SPARSE_SELECTION, selectionTimer.lap());
+        }
+    }
+    refinement->refine(refineOptions);
 
-        Vtr::Refinement* refinement = 0;
-        if (splitType == Sdc::SPLIT_TO_QUADS) {
-            refinement = new Vtr::QuadRefinement(parentLevel, childLevel, _subdivOptions);
+    _levels.push_back(&childLevel);
+    _refinements.push_back(refinement);
+
+    _isUniform = true;
+    _maxLevel = i;
+}
+
+//
+//  Discard the topology of a level that is no longer needed, along with the refinement
+//  from it to the next level.  The component counts of the level are retained so that
+//  the sizes of all levels remain available, and the base level is always retained:
+//
+void
+TopologyRefiner::discardLevelTopology(int level) {
+
+    assert(level>=0 and level<(int)_levels.size()-1);
+
+    if (level > 0) {
+        _levels[level]->releaseTopology();
+    }
+
+    delete _refinements[level];
+    _refinements[level] = 0;
+
+    if (level < (int)_maskTables.size()) {
+        _maskTables[level] = MaskTable();
+    }
+}
+
+//
+//  Indices of the components of a level in a full uniform refinement -- the children
+//  of a level are ordered by the type of their parent and then by the index of their
+//  parent, so their unpruned indices follow from the unpruned indices of the parent
+//  level.  Faces of the base level vary in size while those of refined levels are
+//  all regular, so only the children of base faces require their offsets gathered:
+//
+void
+TopologyRefiner::getUnprunedIndices(int level, std::vector<Index> & faceIndices,
+    std::vector<Index> & edgeIndices, std::vector<Index> & vertIndices) const {
+
+    assert(level>=0 and level<=GetMaxLevel());
+
+    Vtr::Level const & baseLevel = getLevel(0);
+
+    int numFaces = baseLevel.getNumFaces(),
+        numEdges = baseLevel.getNumEdges(),
+        numVerts = baseLevel.getNumVertices();
+
+    faceIndices.resize(numFaces);
+    edgeIndices.resize(numEdges);
+    vertIndices.resize(numVerts);
+    for (int i=0; i<numFaces; ++i) faceIndices[i] = i;
+    for (int i=0; i<numEdges; ++i) edgeIndices[i] = i;
+    for (int i=0; i<numVerts; ++i) vertIndices[i] = i;
+
+    bool hasFaceVerts = (_subdivType != Sdc::SCHEME_LOOP);
+    int  regFaceSize  = (_subdivType == Sdc::SCHEME_LOOP) ? 3 : 4;
+
+    std::vector<Index> cFaceIndices, cEdgeIndices, cVertIndices;
+    for (int i=1; i<=level; ++i) {
+
+        Vtr::Refinement const & refinement = getRefinement(i-1);
+        Vtr::Level const & parent = refinement.parent(),
+                         & child  = refinement.child();
+
+        //  Offsets of the child faces and edges of each parent face:
+        std::vector<Index> faceChildFaceOffsets(parent.getNumFaces()),
+                           faceChildEdgeOffsets(parent.getNumFaces());
+
+        int numChildFacesFromFaces = 0,
+            numChildEdgesFromFaces = 0;
+        if (i == 1) {
+            for (Index face = 0; face < parent.getNumFaces(); ++face) {
+                faceChildFaceOffsets[face] = numChildFacesFromFaces;
+                faceChildEdgeOffsets[face] = numChildEdgesFromFaces;
+                numChildFacesFromFaces += refinement.getFaceChildFaces(face).size();
+                numChildEdgesFromFaces += refinement.getFaceChildEdges(face).size();
+            }
         } else {
-            refinement = new Vtr::TriRefinement(parentLevel, childLevel, _subdivOptions);
+            for (Index face = 0; face < parent.getNumFaces(); ++face) {
+                faceChildFaceOffsets[face] = 4 * faceIndices[face];
+                faceChildEdgeOffsets[face] = regFaceSize * faceIndices[face];
+            }
+            numChildFacesFromFaces = 4 * numFaces;
+            numChildEdgesFromFaces = regFaceSize * numFaces;
         }
-        refinement->refine(refineOptions);
 
-        _levels.push_back(&childLevel);
-        _refinements.push_back(refinement);
+        //  Child vertices originate from vertices, faces and edges in that order:
+        Index firstChildVertFromFace = numVerts,
+              firstChildVertFromEdge = numVerts + (hasFaceVerts ? numFaces : 0);
+
+        cFaceIndices.resize(child.getNumFaces());
+        cEdgeIndices.resize(child.getNumEdges());
+        cVertIndices.resize(child.getNumVertices());
+
+        for (Index face = 0; face < parent.getNumFaces(); ++face) {
+
+            ConstIndexArray cFaces = refinement.getFaceChildFaces(face);
+            for (int j = 0; j < cFaces.size(); ++j) {
+                if (Vtr::IndexIsValid(cFaces[j])) {
+                    cFaceIndices[cFaces[j]] = faceChildFaceOffsets[face] + j;
+                }
+            }
+            ConstIndexArray cEdges = refinement.getFaceChildEdges(face);
+            for (int j = 0; j < cEdges.size(); ++j) {
+                if (Vtr::IndexIsValid(cEdges[j])) {
+                    cEdgeIndices[cEdges[j]] = faceChildEdgeOffsets[face] + j;
+                }
+            }
+            if (hasFaceVerts) {
+                Index cVert = refinement.getFaceChildVertex(face);
+                if (Vtr::IndexIsValid(cVert)) {
+                    cVertIndices[cVert] = firstChildVertFromFace + faceIndices[face];
+                }
+            }
+        }
+        for (Index edge = 0; edge < parent.getNumEdges(); ++edge) {
+
+            ConstIndexArray cEdges = refinement.getEdgeChildEdges(edge);
+            for (int j = 0; j < 2; ++j) {
+                if (Vtr::IndexIsValid(cEdges[j])) {
+                    cEdgeIndices[cEdges[j]] = numChildEdgesFromFaces + 2 * edgeIndices[edge] + j;
+                }
+            }
+            Index cVert = refinement.getEdgeChildVertex(edge);
+            if (Vtr::IndexIsValid(cVert)) {
+                cVertIndices[cVert] = firstChildVertFromEdge + edgeIndices[edge];
+            }
+        }
+        for (Index vert = 0; vert < parent.getNumVertices(); ++vert) {
+
+            Index cVert = refinement.getVertexChildVertex(vert);
+            if (Vtr::IndexIsValid(cVert)) {
+                cVertIndices[cVert] = vertIndices[vert];
+            }
+        }
+
+        numVerts = firstChildVertFromEdge + numEdges;
+        numEdges = numChildEdgesFromFaces + 2 * numEdges;
+        numFaces = numChildFacesFromFaces;
+
+        faceIndices.swap(cFaceIndices);
+        edgeIndices.swap(cEdgeIndices);
+        vertIndices.swap(cVertIndices);
     }
 }
 
+void
+TopologyRefiner::GetUnprunedFaceIndices(int level, std::vector<Index> & indices) const {
+
+    std::vector<Index> edgeIndices, vertIndices;
+    getUnprunedIndices(level, indices, edgeIndices, vertIndices);
+}
+
+void
+TopologyRefiner::GetUnprunedEdgeIndices(int level, std::vector<Index> & indices) const {
+
+    std::vector<Index> faceIndices, vertIndices;
+    getUnprunedIndices(level, faceIndices, indices, vertIndices);
+}
+
+void
+TopologyRefiner::GetUnprunedVertexIndices(int level, std::vector<Index> & indices) const {
+
+    std::vector<Index> faceIndices, edgeIndices;
+    getUnprunedIndices(level, faceIndices, edgeIndices, indices);
+}
+
 
 void
 TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
@@ -351,7 +652,9 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
     //
     _isUniform = false;
     _maxLevel = options.isolationLevel;
+    _maskTables.clear();
     _useSingleCreasePatch = options.useSingleCreasePatch;
+    _considerFVarChannels = options.considerFVarChannels;
 
     //
     //  Initialize refinement options for Vtr:
@@ -360,9 +663,29 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
 
     refineOptions._sparse           = true;
     refineOptions._faceTopologyOnly = not options.fullTopologyInLastLevel;
+    refineOptions._timeStages       = options.recordStatistics;
 
     Sdc::Split splitType = (_subdivType == Sdc::SCHEME_LOOP) ? Sdc::SPLIT_TO_TRIS : Sdc::SPLIT_TO_QUADS;
 
+    //
+    //  Resolve the isolation limits of the base faces (if any), which are propagated to
+    //  the faces of each level from their parents as levels are refined:
+    //
+    std::vector<unsigned char> faceIsolationLevels;
+    if (options.baseFaceIsolationLevels or options.baseFaceIsolationCallback) {
+        int numFaces = _levels[0]->getNumFaces();
+
+        faceIsolationLevels.resize(numFaces);
+        for (Index face = 0; face < numFaces; ++face) {
+            int faceLevel = options.baseFaceIsolationCallback ?
+                options.baseFaceIsolationCallback(face, options.baseFaceIsolationData) :
+                options.baseFaceIsolationLevels[face];
+
+            faceIsolationLevels[face] = (unsigned char)
+                std::max(0, std::min(faceLevel, (int)options.isolationLevel));
+        }
+    }
+
     for (int i = 1; i <= (int)options.isolationLevel; ++i) {
         //  Keeping full topology on for debugging -- may need to go back a level and "prune"
         //  its topology if we don't use the full depth
@@ -388,8 +711,12 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
         //  we should prune the previous level generated, as it is now the last...
         //
         Vtr::SparseSelector selector(*refinement);
+        Vtr::Stopwatch      selectionTimer;
 
-        selectFeatureAdaptiveComponents(selector);
+        selectFeatureAdaptiveComponents(selector, faceIsolationLevels);
+        if (options.recordStatistics) {
+            refinement->setStageTime(Vtr::Refinement::STAGE_SPARSE_SELECTION, selectionTimer.lap());
+        }
         if (selector.isSelectionEmpty()) {
             _maxLevel = i - 1;
 
@@ -403,11 +730,593 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
         _levels.push_back(&childLevel);
         _refinements.push_back(refinement);
 
+        if (not faceIsolationLevels.empty()) {
+            std::vector<unsigned char> childIsolationLevels(childLevel.getNumFaces());
+            for (Index face = 0; face < childLevel.getNumFaces(); ++face) {
+                childIsolationLevels[face] =
+                    faceIsolationLevels[refinement->getChildFaceParentFace(face)];
+            }
+            faceIsolationLevels.swap(childIsolationLevels);
+        }
+
         //childLevel.print(refinement);
         //assert(childLevel.validateTopology());
     }
 }
 
+//
+//  Region of interest refinement -- sparse refinement of the faces of the region to a
+//  uniform level, where membership in the region is propagated from parent to child
+//  faces (the faces of the supporting ring generated by Vtr are never in the region):
+//
+void
+TopologyRefiner::RefineRegion(RegionOptions options) {
+
+    assert(_levels[0]->getNumVertices() > 0);  //  Make sure the base level has been initialized
+
+    _isUniform = false;
+    _maxLevel = options.refinementLevel;
+    _maskTables.clear();
+    _useSingleCreasePatch = false;
+    _considerFVarChannels = false;
+
+    Vtr::Refinement::Options refineOptions;
+
+    refineOptions._sparse           = true;
+    refineOptions._faceTopologyOnly = false;
+    refineOptions._timeStages       = options.recordStatistics;
+
+    Sdc::Split splitType = (_subdivType == Sdc::SCHEME_LOOP) ? Sdc::SPLIT_TO_TRIS : Sdc::SPLIT_TO_QUADS;
+
+    //
+    //  Resolve the base faces of the region from those and the vertices given -- the
+    //  region is tagged with its refinement level and the rest of the mesh with zero,
+    //  as isolation levels are assigned to faces for adaptive refinement:
+    //
+    Vtr::Level const & baseLevel = getLevel(0);
+
+    unsigned char regionLevel = (unsigned char) options.refinementLevel;
+
+    std::vector<unsigned char> faceRegionLevels(baseLevel.getNumFaces(), 0);
+    for (int i = 0; i < options.numBaseFaces; ++i) {
+        assert(options.baseFaces[i] < baseLevel.getNumFaces());
+        faceRegionLevels[options.baseFaces[i]] = regionLevel;
+    }
+    for (int i = 0; i < options.numBaseVertices; ++i) {
+        assert(options.baseVertices[i] < baseLevel.getNumVertices());
+        ConstIndexArray vFaces = baseLevel.getVertexFaces(options.baseVertices[i]);
+        for (int j = 0; j < vFaces.size(); ++j) {
+            faceRegionLevels[vFaces[j]] = regionLevel;
+        }
+    }
+
+    for (int i = 1; i <= (int)options.refinementLevel; ++i) {
+
+        Vtr::Level& parentLevel     = getLevel(i-1);
+        Vtr::Level& childLevel      = *(new Vtr::Level);
+
+        Vtr::Refinement* refinement = 0;
+        if (splitType == Sdc::SPLIT_TO_QUADS) {
+            refinement = new Vtr::QuadRefinement(parentLevel, childLevel, _subdivOptions);
+        } else {
+            refinement = new Vtr::TriRefinement(parentLevel, childLevel, _subdivOptions);
+        }
+
+        //  As with adaptive refinement, stop when nothing is selected (see RefineAdaptive()):
+        Vtr::SparseSelector selector(*refinement);
+        Vtr::Stopwatch      selectionTimer;
+
+        selectRegionComponents(selector, faceRegionLevels);
+        if (options.recordStatistics) {
+            refinement->setStageTime(Vtr::Refinement::STAGE_SPARSE_SELECTION, selectionTimer.lap());
+        }
+        if (selector.isSelectionEmpty()) {
+            _maxLevel = i - 1;
+
+            delete refinement;
+            delete &childLevel;
+            break;
+        }
+
+        refinement->refine(refineOptions);
+
+        _levels.push_back(&childLevel);
+        _refinements.push_back(refinement);
+
+        std::vector<unsigned char> childRegionLevels(childLevel.getNumFaces());
+        for (Index face = 0; face < childLevel.getNumFaces(); ++face) {
+            childRegionLevels[face] = faceRegionLevels[refinement->getChildFaceParentFace(face)];
+        }
+        faceRegionLevels.swap(childRegionLevels);
+    }
+}
+//
+//  Update of sharpness in place -- the base level is tagged again as on construction and
+//  each refinement of a uniform refinement updates its child level from its parent (an
+//  adaptive refinement, or one whose refinements were discarded, is discarded instead):
+//
+bool
+TopologyRefiner::UpdateSharpness() {
+
+    if (GetNumFVarChannels() > 0) {
+        return false;
+    }
+
+    TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(*this);
+
+    bool isRetained = _isUniform;
+    for (int i=0; isRetained and i<(int)_refinements.size(); ++i) {
+        isRetained = (_refinements[i] != 0);
+    }
+    if (not isRetained) {
+        Unrefine();
+        return false;
+    }
+    for (int i=0; i<(int)_refinements.size(); ++i) {
+        _refinements[i]->updateSharpness();
+    }
+
+    //  Masks depend on sharpness and any cached are computed again:
+    if (HasCachedMasks()) {
+        CacheMasks();
+    }
+    return true;
+}
+
+//
+//  Interpolation of buffers of floats -- for each child vertex the mask is computed once
+//  (as in the templated interpolateChildVertsFrom...() methods) and the weighted sources
+//  gathered, so that all elements of the vertex are accumulated in a single pass.  As with
+//  the CPU stencil kernel of Osd, common lengths are accumulated with fixed-size loops that
+//  the compiler can vectorize:
+//
+#if defined ( __INTEL_COMPILER ) or defined ( __ICC )
+    #define __ALIGN_DATA __declspec(align(32))
+#else
+    #define __ALIGN_DATA
+#endif
+
+namespace {
+    template <int numElems> inline void
+    accumulateFixed(float * dst, float const * const * srcs, float const * weights, int numSrcs,
+                    int offset = 0) {
+
+        __ALIGN_DATA float result[numElems];
+
+        for (int k = 0; k < numElems; ++k) {
+            result[k] = 0.0f;
+        }
+        for (int j = 0; j < numSrcs; ++j) {
+            float const * src    = srcs[j] + offset;
+            float         weight = weights[j];
+#if defined ( __INTEL_COMPILER ) or defined ( __ICC )
+    #pragma simd
+#endif
+            for (int k = 0; k < numElems; ++k) {
+                result[k] += src[k] * weight;
+            }
+        }
+        for (int k = 0; k < numElems; ++k) {
+            dst[k] = result[k];
+        }
+    }
+
+    inline void
+    accumulate(float * dst, float const * const * srcs, float const * weights, int numSrcs,
+               int length) {
+
+        switch (length) {
+            case 1: accumulateFixed<1>(dst, srcs, weights, numSrcs); return;
+            case 2: accumulateFixed<2>(dst, srcs, weights, numSrcs); return;
+            case 3: accumulateFixed<3>(dst, srcs, weights, numSrcs); return;
+            case 4: accumulateFixed<4>(dst, srcs, weights, numSrcs); return;
+            case 8: accumulateFixed<8>(dst, srcs, weights, numSrcs); return;
+            default: break;
+        }
+        //  Longer vertices are accumulated in blocks of the fixed sizes:
+        int offset = 0;
+        for ( ; offset + 8 <= length; offset += 8) {
+            accumulateFixed<8>(dst + offset, srcs, weights, numSrcs, offset);
+        }
+        for ( ; offset + 4 <= length; offset += 4) {
+            accumulateFixed<4>(dst + offset, srcs, weights, numSrcs, offset);
+        }
+        for ( ; offset < length; ++offset) {
+            accumulateFixed<1>(dst + offset, srcs, weights, numSrcs, offset);
+        }
+    }
+
+    //
+    //  Applies the masks of child vertices (as gathered by gatherChildVertexMasks() or
+    //  cached) to buffers of floats -- sources of the masks are parent vertices in the
+    //  source buffer or, as their one's complement, child vertices in the destination:
+    //
+    class BufferAccumulator {
+    public:
+        BufferAccumulator(float const * src, int srcStride, float * dst, int dstStride,
+                          int length, int maxSources) :
+            _src(src), _dst(dst), _srcStride(srcStride), _dstStride(dstStride),
+            _length(length), _srcs(maxSources) { }
+
+        void addMask(Index cVert, Index const * sources, float const * weights,
+                     int numSources) {
+
+            if ((int)_srcs.size() < numSources) {
+                _srcs.resize(numSources);
+            }
+            for (int i = 0; i < numSources; ++i) {
+                _srcs[i] = (sources[i] < 0) ? (_dst + ~sources[i] * _dstStride)
+                                            : (_src +  sources[i] * _srcStride);
+            }
+            accumulate(_dst + cVert * _dstStride, &_srcs[0], weights, numSources, _length);
+        }
+
+    private:
+        float const * _src;
+        float       * _dst;
+
+        int _srcStride,
+            _dstStride,
+            _length;
+
+        std::vector<float const *> _srcs;
+    };
+}
+
+void
+TopologyRefiner::Interpolate(float const * src, VertexBufferDescriptor const & srcDesc,
+                             float * dst, VertexBufferDescriptor const & dstDesc) const {
+
+    for (int level = 1; level <= GetMaxLevel(); ++level) {
+
+        Interpolate(level, src, (level == 1) ? srcDesc : dstDesc, dst, dstDesc);
+
+        src = dst;
+        dst += GetNumVertices(level) * dstDesc.stride;
+    }
+}
+
+void
+TopologyRefiner::Interpolate(int level, float const * src, VertexBufferDescriptor const & srcDesc,
+                             float * dst, VertexBufferDescriptor const & dstDesc) const {
+
+    assert(level>0 and level<=(int)_refinements.size() and _refinements[level-1]);
+    assert(srcDesc.length == dstDesc.length);
+
+    Vtr::Refinement const & refinement = getRefinement(level-1);
+
+    if (MaskTable const * masks = getMaskTable(level)) {
+        interpolateBufferFromMasks(refinement, *masks, src, srcDesc, dst, dstDesc);
+        return;
+    }
+
+    Vtr::Level const & parent = refinement.parent();
+
+    BufferAccumulator accumulator(src + srcDesc.offset, srcDesc.stride,
+        dst + dstDesc.offset, dstDesc.stride, dstDesc.length,
+        1 + 2 * std::max(parent.getMaxValence(), parent.getMaxEdgeFaces()));
+
+    switch (_subdivType) {
+    case Sdc::SCHEME_CATMARK:
+        gatherChildVertexMasks<Sdc::SCHEME_CATMARK>(refinement, accumulator);
+        break;
+    case Sdc::SCHEME_LOOP:
+        gatherChildVertexMasks<Sdc::SCHEME_LOOP>(refinement, accumulator);
+        break;
+    case Sdc::SCHEME_BILINEAR:
+        gatherChildVertexMasks<Sdc::SCHEME_BILINEAR>(refinement, accumulator);
+        break;
+    }
+}
+
+void
+TopologyRefiner::interpolateBufferFromMasks(Vtr::Refinement const & refinement,
+                                            MaskTable const & masks,
+                                            float const * src, VertexBufferDescriptor const & srcDesc,
+                                            float * dst, VertexBufferDescriptor const & dstDesc) const {
+
+    Vtr::Level const & parent = refinement.parent();
+
+    BufferAccumulator accumulator(src + srcDesc.offset, srcDesc.stride,
+        dst + dstDesc.offset, dstDesc.stride, dstDesc.length,
+        1 + 2 * std::max(parent.getMaxValence(), parent.getMaxEdgeFaces()));
+
+    //  Child vertices of faces are interpolated first, as other masks refer to them:
+    Index firstChildVerts[3] = { refinement.getFirstChildVertexFromFaces(),
+                                 refinement.getFirstChildVertexFromEdges(),
+                                 refinement.getFirstChildVertexFromVertices() };
+    int   numChildVerts[3]   = { refinement.getNumChildVerticesFromFaces(),
+                                 refinement.getNumChildVerticesFromEdges(),
+                                 refinement.getNumChildVerticesFromVertices() };
+
+    for (int pass = 0; pass < 3; ++pass) {
+        for (int i = 0; i < numChildVerts[pass]; ++i) {
+
+            Index cVert  = firstChildVerts[pass] + i,
+                  offset = masks.offsets[cVert];
+
+            accumulator.addMask(cVert, &masks.sources[offset], &masks.weights[offset],
+                masks.sizes[cVert]);
+        }
+    }
+}
+
+void
+TopologyRefiner::InterpolateVarying(float const * src, VertexBufferDescriptor const & srcDesc,
+                                    float * dst, VertexBufferDescriptor const & dstDesc) const {
+
+    for (int level = 1; level <= GetMaxLevel(); ++level) {
+
+        InterpolateVarying(level, src, (level == 1) ? srcDesc : dstDesc, dst, dstDesc);
+
+        src = dst;
+        dst += GetNumVertices(level) * dstDesc.stride;
+    }
+}
+
+void
+TopologyRefiner::InterpolateVarying(int level, float const * src, VertexBufferDescriptor const & srcDesc,
+                                    float * dst, VertexBufferDescriptor const & dstDesc) const {
+
+    assert(level>0 and level<=(int)_refinements.size() and _refinements[level-1]);
+    assert(srcDesc.length == dstDesc.length);
+
+    Vtr::Refinement const & refinement = getRefinement(level-1);
+    Vtr::Level const & parent = refinement.parent();
+
+    BufferAccumulator accumulator(src + srcDesc.offset, srcDesc.stride,
+        dst + dstDesc.offset, dstDesc.stride, dstDesc.length, parent.getMaxValence());
+
+    //  Varying weights are uniform -- the average of the face, edge or vertex:
+    std::vector<float> weights(std::max(parent.getMaxValence(), 2));
+
+    if (refinement.getNumChildVerticesFromFaces() > 0) {
+        for (Index face = 0; face < parent.getNumFaces(); ++face) {
+
+            Index cVert = refinement.getFaceChildVertex(face);
+            if (not Vtr::IndexIsValid(cVert)) continue;
+
+            ConstIndexArray fVerts = parent.getFaceVertices(face);
+
+            std::fill(weights.begin(), weights.begin() + fVerts.size(), 1.0f / (float) fVerts.size());
+            accumulator.addMask(cVert, &fVerts[0], &weights[0], fVerts.size());
+        }
+    }
+    for (Index edge = 0; edge < parent.getNumEdges(); ++edge) {
+
+        Index cVert = refinement.getEdgeChildVertex(edge);
+        if (not Vtr::IndexIsValid(cVert)) continue;
+
+        ConstIndexArray eVerts = parent.getEdgeVertices(edge);
+
+        weights[0] = weights[1] = 0.5f;
+        accumulator.addMask(cVert, &eVerts[0], &weights[0], 2);
+    }
+    for (Index vert = 0; vert < parent.getNumVertices(); ++vert) {
+
+        Index cVert = refinement.getVertexChildVertex(vert);
+        if (not Vtr::IndexIsValid(cVert)) continue;
+
+        weights[0] = 1.0f;
+        accumulator.addMask(cVert, &vert, &weights[0], 1);
+    }
+}
+
+//
+//  Caching of subdivision masks -- the masks of the child vertices of each refinement
+//  are gathered into tables that Interpolate() applies in place of computed masks:
+//
+void
+TopologyRefiner::CacheMasks() {
+
+    _maskTables.clear();
+    _maskTables.resize(_refinements.size());
+
+    for (int i = 0; i < (int)_refinements.size(); ++i) {
+
+        //  Refinements discarded when streaming have no masks:
+        if (not _refinements[i]) continue;
+
+        Vtr::Refinement const & refinement = *_refinements[i];
+
+        MaskTable & masks = _maskTables[i];
+
+        int numChildVerts = refinement.child().getNumVertices();
+
+        masks.sizes.resize(numChildVerts);
+        masks.offsets.resize(numChildVerts);
+
+        //  Reserve for the masks of all parent components (face-vertices, then two
+        //  vertices and the faces of each edge, then each vertex and its edges and faces):
+        Vtr::Level const & parent = refinement.parent();
+
+        int maxSources = 3 * parent.getNumFaceVerticesTotal() + 4 * parent.getNumEdges() +
+                         parent.getNumVertices();
+        masks.sources.reserve(maxSources);
+        masks.weights.reserve(maxSources);
+
+        switch (_subdivType) {
+        case Sdc::SCHEME_CATMARK:
+            gatherChildVertexMasks<Sdc::SCHEME_CATMARK>(refinement, masks);
+            break;
+        case Sdc::SCHEME_LOOP:
+            gatherChildVertexMasks<Sdc::SCHEME_LOOP>(refinement, masks);
+            break;
+        case Sdc::SCHEME_BILINEAR:
+            gatherChildVertexMasks<Sdc::SCHEME_BILINEAR>(refinement, masks);
+            break;
+        }
+
+        //  Release the excess capacity reserved (significant for sparse refinement):
+        if (masks.sources.capacity() > masks.sources.size() + masks.sources.size() / 4) {
+            std::vector<Index>(masks.sources).swap(masks.sources);
+            std::vector<float>(masks.weights).swap(masks.weights);
+        }
+    }
+}
+
+//
+//  Computes the mask of each child vertex of a refinement (as the templated methods
+//  interpolateChildVertsFrom...() do) and passes its sources and weights, in the order
+//  in which they are to be applied, to the given functor.  Child vertices of faces are
+//  gathered first, as the masks of other child vertices may refer to them:
+//
+template <Sdc::SchemeType SCHEME, class MASKS>
+void
+TopologyRefiner::gatherChildVertexMasks(Vtr::Refinement const & refinement, MASKS & masks) const {
+
+    Sdc::Scheme<SCHEME> scheme(_subdivOptions);
+
+    Vtr::Level const & parent = refinement.parent();
+    Vtr::Level const & child  = refinement.child();
+
+    //  Buffers for the weights of a mask and the sources they apply to -- large enough
+    //  for the vertex-vertex mask (vertex, edges and faces) or any other:
+    int maxWeights = 1 + 2 * std::max(parent.getMaxValence(), parent.getMaxEdgeFaces());
+
+    std::vector<float> weightBuffer(2 * maxWeights);
+    std::vector<Index> sourceBuffer(maxWeights);
+
+    float * weights    = &weightBuffer[0],
+          * maskBuffer = weights + maxWeights;
+    Index * sources    = &sourceBuffer[0];
+
+    //
+    //  Child vertices of faces:
+    //
+    if (refinement.getNumChildVerticesFromFaces() > 0) {
+
+        for (Index face = 0; face < parent.getNumFaces(); ++face) {
+
+            Index cVert = refinement.getFaceChildVertex(face);
+            if (not Vtr::IndexIsValid(cVert)) continue;
+
+            ConstIndexArray fVerts = parent.getFaceVertices(face);
+
+            Vtr::MaskInterface fMask(weights, 0, 0);
+            Vtr::FaceInterface fHood(fVerts.size());
+
+            scheme.ComputeFaceVertexMask(fHood, fMask);
+
+            for (int i = 0; i < fVerts.size(); ++i) {
+                sources[i] = fVerts[i];
+            }
+            masks.addMask(cVert, sources, weights, fVerts.size());
+        }
+    }
+
+    //
+    //  Child vertices of edges -- face weights apply to the child vertices of faces
+    //  or to the vertices opposite the edge:
+    //
+    Vtr::EdgeInterface eHood(parent);
+
+    for (Index edge = 0; edge < parent.getNumEdges(); ++edge) {
+
+        Index cVert = refinement.getEdgeChildVertex(edge);
+        if (not Vtr::IndexIsValid(cVert)) continue;
+
+        ConstIndexArray eVerts = parent.getEdgeVertices(edge),
+                        eFaces = parent.getEdgeFaces(edge);
+
+        float * eFaceWeights = maskBuffer;
+
+        Vtr::MaskInterface eMask(weights, 0, eFaceWeights);
+
+        eHood.SetIndex(edge);
+
+        Sdc::Crease::Rule pRule = (parent.getEdgeSharpness(edge) > 0.0f) ? Sdc::Crease::RULE_CREASE : Sdc::Crease::RULE_SMOOTH;
+        Sdc::Crease::Rule cRule = child.getVertexRule(cVert);
+
+        scheme.ComputeEdgeVertexMask(eHood, eMask, pRule, cRule);
+
+        sources[0] = eVerts[0];
+        sources[1] = eVerts[1];
+
+        int numSources = 2;
+        if (eMask.GetNumFaceWeights() > 0) {
+
+            for (int i = 0; i < eFaces.size(); ++i) {
+
+                if (eMask.AreFaceWeightsForFaceCenters()) {
+                    Index cVertOfFace = refinement.getFaceChildVertex(eFaces[i]);
+                    assert(Vtr::IndexIsValid(cVertOfFace));
+
+                    sources[numSources] = ~cVertOfFace;
+                } else {
+                    ConstIndexArray pFaceEdges = parent.getFaceEdges(eFaces[i]),
+                                    pFaceVerts = parent.getFaceVertices(eFaces[i]);
+
+                    int eInFace = 0;
+                    for ( ; pFaceEdges[eInFace] != edge; ++eInFace ) ;
+
+                    int vInFace = eInFace + 2;
+                    if (vInFace >= pFaceVerts.size()) vInFace -= pFaceVerts.size();
+
+                    sources[numSources] = pFaceVerts[vInFace];
+                }
+                weights[numSources++] = eFaceWeights[i];
+            }
+        }
+        masks.addMask(cVert, sources, weights, numSources);
+    }
+
+    //
+    //  Child vertices of vertices -- smaller weights are applied first to improve precision
+    //  (faces, then edges and the vertex last):
+    //
+    Vtr::VertexInterface vHood(parent, child);
+
+    for (Index vert = 0; vert < parent.getNumVertices(); ++vert) {
+
+        Index cVert = refinement.getVertexChildVertex(vert);
+        if (not Vtr::IndexIsValid(cVert)) continue;
+
+        ConstIndexArray vEdges = parent.getVertexEdges(vert),
+                        vFaces = parent.getVertexFaces(vert);
+
+        float   vVertWeight,
+              * vEdgeWeights = maskBuffer,
+              * vFaceWeights = vEdgeWeights + vEdges.size();
+
+        Vtr::MaskInterface vMask(&vVertWeight, vEdgeWeights, vFaceWeights);
+
+        vHood.SetIndex(vert, cVert);
+
+        Sdc::Crease::Rule pRule = parent.getVertexRule(vert);
+        Sdc::Crease::Rule cRule = child.getVertexRule(cVert);
+
+        scheme.ComputeVertexVertexMask(vHood, vMask, pRule, cRule);
+
+        int numSources = 0;
+        if (vMask.GetNumFaceWeights() > 0) {
+            assert(vMask.AreFaceWeightsForFaceCenters());
+
+            for (int i = 0; i < vFaces.size(); ++i) {
+                Index cVertOfFace = refinement.getFaceChildVertex(vFaces[i]);
+                assert(Vtr::IndexIsValid(cVertOfFace));
+
+                sources[numSources]   = ~cVertOfFace;
+                weights[numSources++] = vFaceWeights[i];
+            }
+        }
+        if (vMask.GetNumEdgeWeights() > 0) {
+
+            for (int i = 0; i < vEdges.size(); ++i) {
+                ConstIndexArray eVerts = parent.getEdgeVertices(vEdges[i]);
+                Index pVertOppositeEdge = (eVerts[0] == vert) ? eVerts[1] : eVerts[0];
+
+                sources[numSources]   = pVertOppositeEdge;
+                weights[numSources++] = vEdgeWeights[i];
+            }
+        }
+        sources[numSources]   = vert;
+        weights[numSources++] = vVertWeight;
+
+        masks.addMask(cVert, sources, weights, numSources);
+    }
+}
+
 //
 //   Method for selecting components for sparse refinement based on the feature-adaptive needs
 //   of patch generation.
@@ -425,11 +1334,75 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
 //   become part of a class that encompasses both the feature adaptive tagging and the
 //   identification of the intended patch that result from it.
 //
+namespace {
+    //
+    //  Faces whose isolation is limited are represented by patches at the level of their
+    //  limit (irregular patches included) -- unless they cannot be represented by a single
+    //  patch (non-manifold, not of the regular face size or adjacent to such faces, or quads
+    //  with more than one boundary edge or vertex that is not a corner), in which case they are
+    //  isolated further regardless of their limit:
+    //
+    inline bool
+    isPatchRepresentable(Vtr::Level const & level, Index face, Vtr::Level::VTag compFaceVTag,
+                         int regularFaceSize) {
+
+        if (compFaceVTag._nonManifold) {
+            return false;
+        }
+
+        Vtr::ConstIndexArray fEdges = level.getFaceEdges(face);
+        Vtr::ConstIndexArray fVerts = level.getFaceVertices(face);
+
+        //  The patch gathers the rings of its vertices from the incident faces (only the
+        //  base level may contain irregular faces):
+        if (fVerts.size() != regularFaceSize) {
+            return false;
+        }
+        if (level.getDepth() == 0) {
+            for (int i = 0; i < fVerts.size(); ++i) {
+                Vtr::ConstIndexArray vFaces = level.getVertexFaces(fVerts[i]);
+                for (int j = 0; j < vFaces.size(); ++j) {
+                    if (level.getFaceVertices(vFaces[j]).size() != regularFaceSize) {
+                        return false;
+                    }
+                }
+            }
+        }
+        //  Loop end-caps are supported for all boundary configurations:
+        if (not compFaceVTag._boundary or (regularFaceSize == 3)) {
+            return true;
+        }
+
+        int boundaryEdgeMask = 0;
+        int boundaryVertMask = 0;
+        for (int i = 0; i < fEdges.size(); ++i) {
+            boundaryEdgeMask |= level.getEdgeTag(fEdges[i])._boundary << i;
+            boundaryVertMask |= level.getVertexTag(fVerts[i])._boundary << i;
+        }
+
+        //  Boundary edges (or a boundary vertex) of a quad supported as patches:
+        static unsigned short const quadEdgeMasks = (1 << 0x0) | (1 << 0x1) | (1 << 0x2) |
+                                                    (1 << 0x3) | (1 << 0x4) | (1 << 0x6) |
+                                                    (1 << 0x8) | (1 << 0x9) | (1 << 0xc);
+        static unsigned short const quadVertMasks = (1 << 0x0) | (1 << 0x1) | (1 << 0x2) |
+                                                    (1 << 0x4) | (1 << 0x8);
+        if (boundaryEdgeMask) {
+            return (quadEdgeMasks >> boundaryEdgeMask) & 1;
+        }
+        return (quadVertMasks >> boundaryVertMask) & 1;
+    }
+}
+
 void
-TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::SparseSelector& selector) {
+TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::SparseSelector& selector,
+                                                 std::vector<unsigned char> const & faceIsolationLevels) {
 
     Vtr::Level const& level = selector.getRefinement().parent();
 
+    //  Faces whose isolation limit has been reached are not selected (see RefineAdaptive()):
+    int  childDepth     = level.getDepth() + 1;
+    bool limitIsolation = not faceIsolationLevels.empty();
+
     int  regularFaceSize           =  selector.getRefinement()._regFaceSize;
     bool considerSingleCreasePatch = _useSingleCreasePatch && (regularFaceSize == 4);
 
@@ -462,6 +1435,8 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::SparseSelector& selector)
             continue;
         }
 
+        bool limitReached = limitIsolation and (faceIsolationLevels[face] < childDepth);
+
         //
         //  Combine the tags for all vertices of the face and quickly accept/reject based on
         //  the presence/absence of properties where we can (further inspection is likely to
@@ -483,6 +1458,10 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::SparseSelector& selector)
             //  Warrants further inspection -- isolate for now
             //    - will want to defer inf-sharp treatment to below
             selectFace = true;
+        } else if (regularFaceSize == 3) {
+            //  Regular Loop patches support boundaries and corners but no other sharp
+            //  features (see Vtr::Level::isTriRegularPatch()):
+            selectFace = not level.isTriRegularPatch(face);
         } else if (!(compFaceVTag._rule & Sdc::Crease::RULE_SMOOTH)) {
             //  None of the vertices is Smooth, so we have all vertices either Crease or Corner,
             //  though some may be regular patches, this currently warrants isolation as we only
@@ -524,12 +1503,57 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::SparseSelector& selector)
             }
         }
 
+        if (not selectFace and _considerFVarChannels) {
+            //  Face-varying values that do not follow the vertex rules (discts edges, linear
+            //  boundaries or corners) also need to be isolated to obtain bicubic face-varying
+            //  patches -- the limit over a face only depends on the rules at its corners:
+            for (int channel = 0; channel < level.getNumFVarChannels(); ++channel) {
+                Vtr::FVarLevel const & fvarLevel = *level._fvarChannels[channel];
+                if (fvarLevel._isLinear) {
+                    continue;
+                }
+                for (int i = 0; i < faceVerts.size(); ++i) {
+                    if (!fvarLevel.valueTopologyMatches(fvarLevel.getVertexValueOffset(faceVerts[i]))) {
+                        selectFace = true;
+                        break;
+                    }
+                }
+                if (selectFace) {
+                    break;
+                }
+            }
+        }
+
+        if (selectFace and limitReached) {
+            selectFace = not isPatchRepresentable(level, face, compFaceVTag, regularFaceSize);
+        }
+
         if (selectFace) {
             selector.selectFace(face);
         }
     }
 }
 
+//
+//  Selection of a region of interest (see RefineRegion()) -- every face of the region is
+//  selected, while faces outside of it are selected as if their isolation was limited to
+//  the base level, i.e. only where necessary to be represented by patches:
+//
+void
+TopologyRefiner::selectRegionComponents(Vtr::SparseSelector& selector,
+                                        std::vector<unsigned char> const & faceRegionLevels) {
+
+    selectFeatureAdaptiveComponents(selector, faceRegionLevels);
+
+    Vtr::Level const& level = selector.getRefinement().parent();
+
+    for (Vtr::Index face = 0; face < level.getNumFaces(); ++face) {
+        if (faceRegionLevels[face] and not level.isHole(face)) {
+            selector.selectFace(face);
+        }
+    }
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
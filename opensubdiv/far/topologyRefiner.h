@@ -37,8 +37,10 @@
 #include "../vtr/fvarRefinement.h"
 #include "../vtr/maskInterfaces.h"
 #include "../far/types.h"
+#include "../far/vertexBufferDescriptor.h"
 
 #include <vector>
+#include <string>
 #include <cassert>
 #include <cstdio>
 
@@ -109,37 +111,109 @@ public:
 
         UniformOptions(int level) :
             refinementLevel(level),
-            fullTopologyInLastLevel(false) { }
+            fullTopologyInLastLevel(false),
+            parallelRefinement(false),
+            pruneHoles(false),
+            recordStatistics(false) { }
 
         unsigned int refinementLevel:4,         ///< Number of refinement iterations
-                     fullTopologyInLastLevel:1; ///< Skip secondary topological relationships
+                     fullTopologyInLastLevel:1, ///< Skip secondary topological relationships
                                                 ///< at the highest level of refinement.
+                     parallelRefinement:1,      ///< Populate the topology of each level
+                                                ///< concurrently (requires OpenMP) -- the
+                                                ///< result is identical to serial refinement
+                     pruneHoles:1,              ///< Omit components beneath holes that do
+                                                ///< not support the remaining faces
+                     recordStatistics:1;        ///< Time the stages of refinement (see
+                                                ///< GetStatistics())
     };
 
     /// \brief Refine the topology uniformly
     ///
+    /// When holes are pruned, the refinement of each level is sparse:  only the
+    /// faces that are not holes are refined, along with the ring of components
+    /// supporting them (all faces of the ring being holes).  Components of the
+    /// refined levels are indexed compactly -- the parent-to-child relationships
+    /// map the components of a level to those of the next, with invalid indices
+    /// for those omitted.  The refinement remains uniform in every other respect
+    /// and the stencils and patches created from it scale with the faces that
+    /// are not holes.
+    ///
     /// @param options   Options controlling uniform refinement
     ///
     void RefineUniform(UniformOptions options);
 
+    /// \brief Returns the indices the faces of a level would have if holes were
+    ///        not pruned (see UniformOptions::pruneHoles)
+    ///
+    /// The indices are those of a full uniform refinement of the base level, so
+    /// that data associated with the components of a pruned (or otherwise sparse)
+    /// level can be related to that of an unpruned one.  Without pruning, they
+    /// are the identity.
+    ///
+    /// @param level    The refinement level
+    ///
+    /// @param indices  Vector populated with the unpruned index of each face
+    ///
+    void GetUnprunedFaceIndices(int level, std::vector<Index> & indices) const;
+
+    /// \brief Returns the indices the edges of a level would have if holes were
+    ///        not pruned (see GetUnprunedFaceIndices())
+    void GetUnprunedEdgeIndices(int level, std::vector<Index> & indices) const;
+
+    /// \brief Returns the indices the vertices of a level would have if holes
+    ///        were not pruned (see GetUnprunedFaceIndices())
+    void GetUnprunedVertexIndices(int level, std::vector<Index> & indices) const;
+
     //
     // Adaptive refinement
     //
 
+    /// \brief Returns the maximum isolation level of a base face (see AdaptiveOptions)
+    typedef int (* IsolationLevelCallback)(Index baseFace, void const * clientData);
+
     /// \brief Adaptive refinement options
+    ///
+    /// The isolation of features can be further limited for each base face, e.g.
+    /// to isolate less in regions distant from (or not visible to) a camera.  A
+    /// face not isolated to the full isolation level is represented by patches
+    /// at the level of its limit -- irregular patches included.  Base faces that
+    /// are not quads (or triangles for Loop) are always isolated at least once.
+    ///
+    /// \note Patches of adjacent faces limited to different levels only meet
+    ///       at the limit where neither is irregular.
+    ///
     struct AdaptiveOptions {
 
         AdaptiveOptions(int level) :
             isolationLevel(level),
             fullTopologyInLastLevel(false),
-            useSingleCreasePatch(false) { }
+            useSingleCreasePatch(false),
+            considerFVarChannels(false),
+            recordStatistics(false),
+            baseFaceIsolationLevels(0),
+            baseFaceIsolationCallback(0),
+            baseFaceIsolationData(0) { }
 
         unsigned int isolationLevel:4,          ///< Number of iterations applied to isolate
                                                 ///< extraordinary vertices and creases
                      fullTopologyInLastLevel:1, ///< Skip secondary topological relationships
                                                 ///< at the highest level of refinement.
-                     useSingleCreasePatch:1;    ///< Use 'single-crease' patch and stop
+                     useSingleCreasePatch:1,    ///< Use 'single-crease' patch and stop
                                                 ///< isolation where applicable
+                     considerFVarChannels:1,    ///< Also isolate face-varying values whose
+                                                ///< topology does not match the vertices
+                                                ///< (smooth face-varying patches)
+                     recordStatistics:1;        ///< Time the stages of refinement (see
+                                                ///< GetStatistics())
+
+        int const *            baseFaceIsolationLevels;   ///< Optional maximum isolation
+                                                          ///< level of each base face
+        IsolationLevelCallback baseFaceIsolationCallback; ///< Optional callback for the
+                                                          ///< maximum isolation level of
+                                                          ///< each base face (instead of
+                                                          ///< the levels above)
+        void const *           baseFaceIsolationData;     ///< Client data for the callback
     };
 
     /// \brief Feature Adaptive topology refinement
@@ -148,9 +222,137 @@ public:
     ///
     void RefineAdaptive(AdaptiveOptions options);
 
+    //
+    // Region of interest refinement
+    //
+
+    /// \brief Region of interest refinement options
+    ///
+    /// The region is given by a set of base faces and/or base vertices (a vertex
+    /// contributing all of its incident faces).  Faces of the region are refined
+    /// uniformly to the given level, along with the minimal ring of neighboring
+    /// faces required to support the limit of the region -- the rest of the mesh
+    /// is left unrefined.  As with adaptive refinement, base faces that are not
+    /// quads (or triangles for Loop) are always refined at least once, so that
+    /// every face can be represented by patches.
+    ///
+    /// \note Patches of faces inside and outside the region only meet at the
+    ///       limit where neither is irregular.
+    ///
+    struct RegionOptions {
+
+        RegionOptions(int level) :
+            refinementLevel(level),
+            recordStatistics(false),
+            numBaseFaces(0),
+            baseFaces(0),
+            numBaseVertices(0),
+            baseVertices(0) { }
+
+        unsigned int refinementLevel:4,         ///< Number of refinement iterations
+                                                ///< applied to the region
+                     recordStatistics:1;        ///< Time the stages of refinement (see
+                                                ///< GetStatistics())
+
+        int           numBaseFaces;     ///< Number of base faces in the region
+        Index const * baseFaces;        ///< Base faces of the region
+        int           numBaseVertices;  ///< Number of base vertices in the region
+        Index const * baseVertices;     ///< Base vertices whose incident faces are
+                                        ///< included in the region
+    };
+
+    /// \brief Refine the topology uniformly within a region of interest
+    ///
+    /// The resulting refiner is sparse (IsUniform() returns false) and is used
+    /// as an adaptively refined one, i.e. to create stencils or adaptive patches.
+    ///
+    /// @param options   Options controlling region refinement
+    ///
+    void RefineRegion(RegionOptions options);
+
     /// \brief Unrefine the topology (keep control cage)
     void Unrefine();
 
+    //
+    // Sharpness updates
+    //
+
+    /// \brief Reassign the sharpness of a base edge (see UpdateSharpness())
+    ///
+    /// @param edge       Index of the base edge, in [0, GetNumEdges(0))
+    ///
+    /// @param sharpness  Non-negative sharpness of the edge
+    ///
+    void SetBaseEdgeSharpness(Index edge, float sharpness) {
+        assert(edge>=0 and edge<GetNumEdges(0));
+        assert(sharpness>=Sdc::Crease::SHARPNESS_SMOOTH);
+        setBaseEdgeSharpness(edge, sharpness);
+    }
+
+    /// \brief Reassign the sharpness of a base vertex (see UpdateSharpness())
+    ///
+    /// @param vert       Index of the base vertex, in [0, GetNumVertices(0))
+    ///
+    /// @param sharpness  Non-negative sharpness of the vertex
+    ///
+    void SetBaseVertexSharpness(Index vert, float sharpness) {
+        assert(vert>=0 and vert<GetNumVertices(0));
+        assert(sharpness>=Sdc::Crease::SHARPNESS_SMOOTH);
+        setBaseVertexSharpness(vert, sharpness);
+    }
+
+    /// \brief Update all levels following the reassignment of base sharpness
+    ///
+    /// Component tags of the base level are derived again from the new sharpness
+    /// values (boundaries, corners and non-manifold features are sharpened as they
+    /// were on construction) and the sharpness values are subdivided through all
+    /// levels of a uniform refinement -- the topology of every level is retained,
+    /// so the cost is a small fraction of rebuilding and refining the refiner.
+    ///
+    /// Since the features isolated by adaptive refinement depend on sharpness, an
+    /// adaptive (or region) refinement is not updated:  it is discarded as with
+    /// Unrefine() and false is returned -- RefineAdaptive() (or RefineRegion())
+    /// must then be applied again, the topology of the base level being retained.
+    /// The same applies to a uniform refinement whose levels were discarded by
+    /// StencilTablesFactory::CreateStreaming().
+    ///
+    /// Refiners with face-varying channels are not supported:  the tags of the
+    /// face-varying values also depend on sharpness, so nothing is updated and
+    /// false is returned -- the refiner is to be created again by its factory.
+    ///
+    /// Stencils, patches or any other tables created from the refiner are to be
+    /// created again to reflect the new sharpness.
+    ///
+    /// @return  true if all levels were updated in place, false if the refinement
+    ///          was discarded or the refiner has face-varying channels
+    ///
+    bool UpdateSharpness();
+
+    //
+    // Cached subdivision masks
+    //
+
+    /// \brief Compute and retain the subdivision masks of all refined vertices
+    ///
+    /// Interpolate() otherwise computes the masks of all refined vertices on each
+    /// call (as does the StencilTablesFactory through it).  Once cached, the masks
+    /// of each level are applied from tables of source vertices and weights, which
+    /// benefits the interpolation of several primvar buffers through the same
+    /// refinement.  The templated, buffer and parallel variants of Interpolate()
+    /// all apply the cached masks, with results identical to computed masks.
+    /// Varying and face-varying interpolation do not depend on these masks.
+    ///
+    /// The cached masks are discarded with the refinement (Unrefine(), or a new
+    /// refinement) and computed again by UpdateSharpness().
+    ///
+    void CacheMasks();
+
+    /// \brief Discard the cached subdivision masks (see CacheMasks())
+    void ClearCachedMasks() { _maskTables.clear(); }
+
+    /// \brief Returns true if the subdivision masks are cached (see CacheMasks())
+    bool HasCachedMasks() const { return not _maskTables.empty(); }
+
     //@{
     ///  @name Primvar data interpolation
     ///
@@ -218,6 +420,48 @@ public:
     ///
     template <class T, class U> void Interpolate(int level, T const & src, U & dst) const;
 
+    /// \brief Apply vertex interpolation weights to a buffer of floats
+    ///
+    /// An alternative to the templated Interpolate() for primvar data made of
+    /// plain floats:  the mask of each refined vertex is computed once and
+    /// applied to all elements of the vertex, with fixed-size (vectorizable)
+    /// kernels for the most common lengths.  Only vertex weights are applied:
+    /// varying data is interpolated with the buffer variants of
+    /// InterpolateVarying().
+    ///
+    /// The destination buffer must allocate data for all the refined vertices,
+    /// the vertices of each level following those of the previous level (at
+    /// least GetNumVerticesTotal()-GetNumVertices(0) vertices of dstDesc.stride)
+    ///
+    /// @param src      Source buffer (control vertex data)
+    ///
+    /// @param srcDesc  Layout of the source buffer
+    ///
+    /// @param dst      Destination buffer (refined vertex data)
+    ///
+    /// @param dstDesc  Layout of the destination buffer (of the same length
+    ///                 as the source)
+    ///
+    void Interpolate(float const * src, VertexBufferDescriptor const & srcDesc,
+                     float * dst, VertexBufferDescriptor const & dstDesc) const;
+
+    /// \brief Apply vertex interpolation weights to a buffer of floats for a
+    ///        single level of refinement
+    ///
+    /// @param level    The refinement level
+    ///
+    /// @param src      Source buffer (vertex data of the previous level)
+    ///
+    /// @param srcDesc  Layout of the source buffer
+    ///
+    /// @param dst      Destination buffer (at least GetNumVertices(level))
+    ///
+    /// @param dstDesc  Layout of the destination buffer (of the same length
+    ///                 as the source)
+    ///
+    void Interpolate(int level, float const * src, VertexBufferDescriptor const & srcDesc,
+                     float * dst, VertexBufferDescriptor const & dstDesc) const;
+
 
     /// \brief Apply only varying interpolation weights to a primvar buffer
     ///
@@ -250,6 +494,40 @@ public:
     ///
     template <class T, class U> void InterpolateVarying(int level, T const & src, U & dst) const;
 
+    /// \brief Apply only varying interpolation weights to a buffer of floats
+    ///
+    /// The buffer counterpart of the templated InterpolateVarying(), with the
+    /// same layouts as the buffer variants of Interpolate()
+    ///
+    /// @param src      Source buffer (control vertex data)
+    ///
+    /// @param srcDesc  Layout of the source buffer
+    ///
+    /// @param dst      Destination buffer (refined vertex data)
+    ///
+    /// @param dstDesc  Layout of the destination buffer (of the same length
+    ///                 as the source)
+    ///
+    void InterpolateVarying(float const * src, VertexBufferDescriptor const & srcDesc,
+                            float * dst, VertexBufferDescriptor const & dstDesc) const;
+
+    /// \brief Apply only varying interpolation weights to a buffer of floats
+    ///        for a single level of refinement
+    ///
+    /// @param level    The refinement level
+    ///
+    /// @param src      Source buffer (vertex data of the previous level)
+    ///
+    /// @param srcDesc  Layout of the source buffer
+    ///
+    /// @param dst      Destination buffer (at least GetNumVertices(level))
+    ///
+    /// @param dstDesc  Layout of the destination buffer (of the same length
+    ///                 as the source)
+    ///
+    void InterpolateVarying(int level, float const * src, VertexBufferDescriptor const & srcDesc,
+                            float * dst, VertexBufferDescriptor const & dstDesc) const;
+
     /// \brief Apply face-varying interpolation weights to a primvar buffer
     //         associated with a particular face-varying channel
     ///
@@ -257,6 +535,33 @@ public:
 
     template <class T, class U> void InterpolateFaceVarying(int level, T const & src, U & dst, int channel = 0) const;
 
+    /// \brief Multithreaded variants of Interpolate(), InterpolateVarying()
+    ///        and InterpolateFaceVarying()
+    ///
+    /// The child vertices (or face-varying values) of each level that originate
+    /// from faces, edges and vertices are interpolated in three successive
+    /// passes, the vertices of each pass being distributed over threads with
+    /// OpenMP.  The results are identical to the serial variants.
+    ///
+    /// The primvar class must support concurrent calls of Clear() and
+    /// AddWithWeight() (and AddVaryingWithWeight()) for distinct destination
+    /// instances.
+    ///
+    /// \note The calling code must be compiled with OpenMP support and with
+    ///       OPENSUBDIV_HAS_OPENMP defined, otherwise these methods are serial.
+    ///
+    template <class T, class U> void ParallelInterpolate(T const * src, U * dst) const;
+
+    template <class T, class U> void ParallelInterpolate(int level, T const & src, U & dst) const;
+
+    template <class T, class U> void ParallelInterpolateVarying(T const * src, U * dst) const;
+
+    template <class T, class U> void ParallelInterpolateVarying(int level, T const & src, U & dst) const;
+
+    template <class T, class U> void ParallelInterpolateFaceVarying(T const * src, U * dst, int channel = 0) const;
+
+    template <class T, class U> void ParallelInterpolateFaceVarying(int level, T const & src, U & dst, int channel = 0) const;
+
     template <class T, class U> void LimitFaceVarying(T const & src, U * dst, int channel = 0) const;
 
 
@@ -493,6 +798,80 @@ public:
 
     //@}
 
+    //@{
+    /// @name Instrumentation
+    ///
+
+    /// \brief Timings and memory usage of the construction and refinement
+    ///
+    /// The stages of construction and refinement are only timed when requested
+    /// by the 'recordStatistics' option of TopologyRefinerFactory, RefineUniform()
+    /// or RefineAdaptive() (times are zero otherwise).  Memory usage is that of
+    /// the topology at the time of the query.
+    ///
+    struct Statistics {
+
+        /// \brief Stages of the construction of the base level by the factory
+        enum FactoryStage {
+            FACTORY_TOPOLOGY_SIZING = 0,  ///< Sizing and allocation of the topology
+            FACTORY_TOPOLOGY_ASSIGNMENT,  ///< Assignment (or completion) and validation
+            FACTORY_TAGS_AND_SHARPNESS,   ///< Sharpness and tags of all components
+            FACTORY_FVAR_CHANNELS,        ///< Face-varying channels
+
+            NUM_FACTORY_STAGES
+        };
+
+        /// \brief Stages of the refinement of each level (see Vtr::Refinement)
+        enum RefinementStage {
+            REFINE_SPARSE_SELECTION = 0,  ///< Selection of features (adaptive only)
+            REFINE_PARENT_TO_CHILD,       ///< Child components of the parent level
+            REFINE_CHILD_TO_PARENT,       ///< Parent components of the child level
+            REFINE_COMPONENT_TAGS,        ///< Tags propagated to the child level
+            REFINE_TOPOLOGY,              ///< Topological relations of the child level
+            REFINE_SHARPNESS,             ///< Subdivided sharpness values
+            REFINE_FVAR_CHANNELS,         ///< Face-varying channels
+
+            NUM_REFINEMENT_STAGES
+        };
+
+        /// \brief Topological relations of each level (see Vtr::Level)
+        enum Relation {
+            FACE_VERTICES = 0,
+            FACE_EDGES,
+            EDGE_VERTICES,
+            EDGE_FACES,
+            VERTEX_FACES,
+            VERTEX_EDGES,
+
+            NUM_RELATIONS
+        };
+
+        struct LevelStatistics {
+            double refinementTimes[NUM_REFINEMENT_STAGES]; ///< Seconds spent refining the
+                                                           ///< level from the previous one
+
+            size_t relationMemory[NUM_RELATIONS]; ///< Bytes of each relation (including
+                                                  ///< offsets and local indices)
+            size_t tagMemory,                     ///< Bytes of component tags
+                   sharpnessMemory,               ///< Bytes of sharpness values
+                   fvarMemory,                    ///< Bytes of face-varying channels
+                   refinementMemory;              ///< Bytes of the refinement from the
+                                                  ///< previous level (parent-child maps)
+        };
+
+        double factoryTimes[NUM_FACTORY_STAGES];  ///< Seconds spent in each stage
+
+        std::vector<LevelStatistics> levels;      ///< One per level
+    };
+
+    /// \brief Gathers the timings and memory usage of all levels
+    void GetStatistics(Statistics & statistics) const;
+
+    /// \brief Returns a printable report of the statistics (one line per level)
+    std::string GetStatisticsReport() const;
+
+    //@}
+
 protected:
 
     //
@@ -547,6 +926,9 @@ protected:
     friend class TopologyRefinerFactoryBase;
     friend class PatchTablesFactory;
     friend class GregoryBasisFactory;
+    friend class LoopBasisFactory;
+    friend class StencilTablesFactory;
+    friend class TopologyRefinerCache;
 
     Vtr::Level       & getLevel(int l)       { return *_levels[l]; }
     Vtr::Level const & getLevel(int l) const { return *_levels[l]; }
@@ -554,23 +936,84 @@ protected:
     Vtr::Refinement       & getRefinement(int l)       { return *_refinements[l]; }
     Vtr::Refinement const & getRefinement(int l) const { return *_refinements[l]; }
 
+    //  Face-varying topology queries for the bicubic face-varying patches:
+    bool isFVarChannelLinear(int channel) const {
+        return _levels[0]->_fvarChannels[channel]->_isLinear;
+    }
+    bool gatherFVarPatchValues(int level, Index face, Index const patchVerts[], int numPatchVerts,
+                               int channel, Index patchValues[]) const {
+        return _levels[level]->_fvarChannels[channel]->gatherPatchValues(face, patchVerts, numPatchVerts, patchValues);
+    }
+
 private:
-    void selectFeatureAdaptiveComponents(Vtr::SparseSelector& selector);
+    void selectFeatureAdaptiveComponents(Vtr::SparseSelector& selector,
+                                         std::vector<unsigned char> const & faceIsolationLevels);
+    void selectRegionComponents(Vtr::SparseSelector& selector,
+                                std::vector<unsigned char> const & faceRegionLevels);
+
+    //  Incremental uniform refinement -- appending a level and discarding the topology
+    //  of earlier levels no longer needed (see StencilTablesFactory::CreateStreaming):
+    void refineUniformLevel(UniformOptions const & options);
+    void discardLevelTopology(int level);
+
+    //  Indices of the components of a level in a full uniform refinement (see
+    //  GetUnprunedFaceIndices()):
+    void getUnprunedIndices(int level, std::vector<Index> & faceIndices,
+        std::vector<Index> & edgeIndices, std::vector<Index> & vertIndices) const;
+
+    //
+    //  Subdivision masks of the child vertices of a refinement (see CacheMasks()) -- the
+    //  sources of each mask are vertices of the parent level or, as their one's complement,
+    //  child vertices originating from faces (which are interpolated first):
+    //
+    struct MaskTable {
+
+        void addMask(Index cVert, Index const * sources, float const * weights, int numSources) {
+            sizes[cVert]   = numSources;
+            offsets[cVert] = (Index)this->sources.size();
+            this->sources.insert(this->sources.end(), sources, sources + numSources);
+            this->weights.insert(this->weights.end(), weights, weights + numSources);
+        }
+
+        std::vector<int>   sizes;
+        std::vector<Index> offsets;
+        std::vector<Index> sources;
+        std::vector<float> weights;
+    };
+
+    MaskTable const * getMaskTable(int level) const {
+        return ((level <= (int)_maskTables.size()) and not _maskTables[level-1].sizes.empty()) ?
+            &_maskTables[level-1] : 0;
+    }
+
+    template <Sdc::SchemeType SCHEME, class MASKS> void gatherChildVertexMasks(Vtr::Refinement const &, MASKS & masks) const;
+
+    template <class T, class U> void interpolate(int level, T const & src, U & dst, bool parallel) const;
+    template <class T, class U> void interpolateFaceVarying(int level, T const & src, U & dst, int channel, bool parallel) const;
+
+    template <class T, class U> void interpolateFromMasks(Vtr::Refinement const &, MaskTable const &, T const & src, U & dst, bool parallel) const;
+
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpolateChildVertsFromFaces(Vtr::Refinement const &, T const & src, U & dst, bool parallel) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpolateChildVertsFromEdges(Vtr::Refinement const &, T const & src, U & dst, bool parallel) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpolateChildVertsFromVerts(Vtr::Refinement const &, T const & src, U & dst, bool parallel) const;
+
+    template <class T, class U> void varyingInterpolateChildVertsFromFaces(Vtr::Refinement const &, T const & src, U & dst, bool parallel) const;
+    template <class T, class U> void varyingInterpolateChildVertsFromEdges(Vtr::Refinement const &, T const & src, U & dst, bool parallel) const;
+    template <class T, class U> void varyingInterpolateChildVertsFromVerts(Vtr::Refinement const &, T const & src, U & dst, bool parallel) const;
+
+    template <Sdc::SchemeType SCHEME, class T, class U> void faceVaryingInterpolateChildVertsFromFaces(Vtr::Refinement const &, T const & src, U & dst, int channel, bool parallel) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void faceVaryingInterpolateChildVertsFromEdges(Vtr::Refinement const &, T const & src, U & dst, int channel, bool parallel) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void faceVaryingInterpolateChildVertsFromVerts(Vtr::Refinement const &, T const & src, U & dst, int channel, bool parallel) const;
 
-    template <Sdc::SchemeType SCHEME, class T, class U> void interpolateChildVertsFromFaces(Vtr::Refinement const &, T const & src, U & dst) const;
-    template <Sdc::SchemeType SCHEME, class T, class U> void interpolateChildVertsFromEdges(Vtr::Refinement const &, T const & src, U & dst) const;
-    template <Sdc::SchemeType SCHEME, class T, class U> void interpolateChildVertsFromVerts(Vtr::Refinement const &, T const & src, U & dst) const;
 
-    template <class T, class U> void varyingInterpolateChildVertsFromFaces(Vtr::Refinement const &, T const & src, U & dst) const;
-    template <class T, class U> void varyingInterpolateChildVertsFromEdges(Vtr::Refinement const &, T const & src, U & dst) const;
-    template <class T, class U> void varyingInterpolateChildVertsFromVerts(Vtr::Refinement const &, T const & src, U & dst) const;
 
-    template <Sdc::SchemeType SCHEME, class T, class U> void faceVaryingInterpolateChildVertsFromFaces(Vtr::Refinement const &, T const & src, U & dst, int channel) const;
-    template <Sdc::SchemeType SCHEME, class T, class U> void faceVaryingInterpolateChildVertsFromEdges(Vtr::Refinement const &, T const & src, U & dst, int channel) const;
-    template <Sdc::SchemeType SCHEME, class T, class U> void faceVaryingInterpolateChildVertsFromVerts(Vtr::Refinement const &, T const & src, U & dst, int channel) const;
 
     template <Sdc::SchemeType SCHEME, class T, class U> void limit(T const & src, U * dst) const;
 
+    void interpolateBufferFromMasks(Vtr::Refinement const &, MaskTable const &,
+        float const * src, VertexBufferDescriptor const & srcDesc,
+        float * dst, VertexBufferDescriptor const & dstDesc) const;
+
     template <Sdc::SchemeType SCHEME, class T, class U> void faceVaryingLimit(T const & src, U * dst, int channel) const;
 
     void initializePtexIndices() const;
@@ -583,12 +1026,19 @@ private:
     unsigned int _isUniform : 1,
                  _hasHoles : 1,
                  _useSingleCreasePatch : 1,
+                 _considerFVarChannels : 1,
                  _maxLevel : 4;
 
     std::vector<Vtr::Level *>      _levels;
     std::vector<Vtr::Refinement *> _refinements;
 
     std::vector<Index> _ptexIndices;
+
+    //  Cached subdivision masks of each refinement (see CacheMasks()):
+    std::vector<MaskTable> _maskTables;
+
+    //  Timings of the construction of the base level (see TopologyRefinerFactory):
+    double _factoryTimes[Statistics::NUM_FACTORY_STAGES];
 };
 
 template <class T, class U>
@@ -608,33 +1058,106 @@ template <class T, class U>
 inline void
 TopologyRefiner::Interpolate(int level, T const & src, U & dst) const {
 
+    interpolate(level, src, dst, false);
+}
+
+template <class T, class U>
+inline void
+TopologyRefiner::interpolate(int level, T const & src, U & dst, bool parallel) const {
+
     assert(level>0 and level<=(int)_refinements.size());
 
     Vtr::Refinement const & refinement = getRefinement(level-1);
 
+    if (MaskTable const * masks = getMaskTable(level)) {
+        interpolateFromMasks(refinement, *masks, src, dst, parallel);
+        return;
+    }
+
     switch (_subdivType) {
     case Sdc::SCHEME_CATMARK:
-        interpolateChildVertsFromFaces<Sdc::SCHEME_CATMARK>(refinement, src, dst);
-        interpolateChildVertsFromEdges<Sdc::SCHEME_CATMARK>(refinement, src, dst);
-        interpolateChildVertsFromVerts<Sdc::SCHEME_CATMARK>(refinement, src, dst);
+        interpolateChildVertsFromFaces<Sdc::SCHEME_CATMARK>(refinement, src, dst, parallel);
+        interpolateChildVertsFromEdges<Sdc::SCHEME_CATMARK>(refinement, src, dst, parallel);
+        interpolateChildVertsFromVerts<Sdc::SCHEME_CATMARK>(refinement, src, dst, parallel);
         break;
     case Sdc::SCHEME_LOOP:
-        interpolateChildVertsFromFaces<Sdc::SCHEME_LOOP>(refinement, src, dst);
-        interpolateChildVertsFromEdges<Sdc::SCHEME_LOOP>(refinement, src, dst);
-        interpolateChildVertsFromVerts<Sdc::SCHEME_LOOP>(refinement, src, dst);
+        interpolateChildVertsFromFaces<Sdc::SCHEME_LOOP>(refinement, src, dst, parallel);
+        interpolateChildVertsFromEdges<Sdc::SCHEME_LOOP>(refinement, src, dst, parallel);
+        interpolateChildVertsFromVerts<Sdc::SCHEME_LOOP>(refinement, src, dst, parallel);
         break;
     case Sdc::SCHEME_BILINEAR:
-        interpolateChildVertsFromFaces<Sdc::SCHEME_BILINEAR>(refinement, src, dst);
-        interpolateChildVertsFromEdges<Sdc::SCHEME_BILINEAR>(refinement, src, dst);
-        interpolateChildVertsFromVerts<Sdc::SCHEME_BILINEAR>(refinement, src, dst);
+        interpolateChildVertsFromFaces<Sdc::SCHEME_BILINEAR>(refinement, src, dst, parallel);
+        interpolateChildVertsFromEdges<Sdc::SCHEME_BILINEAR>(refinement, src, dst, parallel);
+        interpolateChildVertsFromVerts<Sdc::SCHEME_BILINEAR>(refinement, src, dst, parallel);
         break;
     }
 }
 
+template <class T, class U>
+inline void
+TopologyRefiner::interpolateFromMasks(Vtr::Refinement const & refinement,
+    MaskTable const & masks, T const & src, U & dst, bool parallel) const {
+
+    const Vtr::Level& parent = refinement.parent();
+
+    //  Child vertices of faces, edges and vertices are interpolated in turn (the masks of
+    //  the latter refer to the former), along with the varying weights of their parent:
+    Index firstChildVerts[3] = { refinement.getFirstChildVertexFromFaces(),
+                                 refinement.getFirstChildVertexFromEdges(),
+                                 refinement.getFirstChildVertexFromVertices() };
+    int   numChildVerts[3]   = { refinement.getNumChildVerticesFromFaces(),
+                                 refinement.getNumChildVerticesFromEdges(),
+                                 refinement.getNumChildVerticesFromVertices() };
+
+    for (int pass = 0; pass < 3; ++pass) {
+
+        Vtr::Index cVertBegin = firstChildVerts[pass],
+                   cVertEnd   = cVertBegin + numChildVerts[pass];
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (parallel)
+#endif
+        for (Vtr::Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
+
+            int                size    = masks.sizes[cVert];
+            Vtr::Index const * sources = &masks.sources[masks.offsets[cVert]];
+            float const *      weights = &masks.weights[masks.offsets[cVert]];
+
+            dst[cVert].Clear();
+
+            for (int i = 0; i < size; ++i) {
+                if (sources[i] < 0) {
+                    dst[cVert].AddWithWeight(dst[~sources[i]], weights[i]);
+                } else {
+                    dst[cVert].AddWithWeight(src[sources[i]], weights[i]);
+                }
+            }
+
+            Vtr::Index pIndex = refinement.getChildVertexParentIndex(cVert);
+            if (pass == 0) {
+                ConstIndexArray fVerts = parent.getFaceVertices(pIndex);
+
+                float fVaryingWeight = 1.0f / (float) fVerts.size();
+
+                for (int i = 0; i < fVerts.size(); ++i) {
+                    dst[cVert].AddVaryingWithWeight(src[fVerts[i]], fVaryingWeight);
+                }
+            } else if (pass == 1) {
+                ConstIndexArray eVerts = parent.getEdgeVertices(pIndex);
+
+                dst[cVert].AddVaryingWithWeight(src[eVerts[0]], 0.5f);
+                dst[cVert].AddVaryingWithWeight(src[eVerts[1]], 0.5f);
+            } else {
+                dst[cVert].AddVaryingWithWeight(src[pIndex], 1.0f);
+            }
+        }
+    }
+}
+
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
 TopologyRefiner::interpolateChildVertsFromFaces(
-    Vtr::Refinement const & refinement, T const & src, U & dst) const {
+    Vtr::Refinement const & refinement, T const & src, U & dst, bool parallel) const {
 
     if (refinement.getNumChildVerticesFromFaces() == 0) return;
 
@@ -642,32 +1165,40 @@ TopologyRefiner::interpolateChildVertsFromFaces(
 
     const Vtr::Level& parent = refinement.parent();
 
-    float * fVertWeights = (float *)alloca(parent.getMaxValence()*sizeof(float));
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        float * fVertWeights = (float *)alloca(parent.getMaxValence()*sizeof(float));
 
-    for (int face = 0; face < parent.getNumFaces(); ++face) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp for
+#endif
+        for (int face = 0; face < parent.getNumFaces(); ++face) {
 
-        Vtr::Index cVert = refinement.getFaceChildVertex(face);
-        if (!Vtr::IndexIsValid(cVert))
-            continue;
+            Vtr::Index cVert = refinement.getFaceChildVertex(face);
+            if (!Vtr::IndexIsValid(cVert))
+                continue;
 
-        //  Declare and compute mask weights for this vertex relative to its parent face:
-        ConstIndexArray fVerts = parent.getFaceVertices(face);
+            //  Declare and compute mask weights for this vertex relative to its parent face:
+            ConstIndexArray fVerts = parent.getFaceVertices(face);
 
-        float fVaryingWeight = 1.0f / (float) fVerts.size();
+            float fVaryingWeight = 1.0f / (float) fVerts.size();
 
-        Vtr::MaskInterface fMask(fVertWeights, 0, 0);
-        Vtr::FaceInterface fHood(fVerts.size());
+            Vtr::MaskInterface fMask(fVertWeights, 0, 0);
+            Vtr::FaceInterface fHood(fVerts.size());
 
-        scheme.ComputeFaceVertexMask(fHood, fMask);
+            scheme.ComputeFaceVertexMask(fHood, fMask);
 
-        //  Apply the weights to the parent face's vertices:
-        dst[cVert].Clear();
+            //  Apply the weights to the parent face's vertices:
+            dst[cVert].Clear();
 
-        for (int i = 0; i < fVerts.size(); ++i) {
+            for (int i = 0; i < fVerts.size(); ++i) {
 
-            dst[cVert].AddWithWeight(src[fVerts[i]], fVertWeights[i]);
+                dst[cVert].AddWithWeight(src[fVerts[i]], fVertWeights[i]);
 
-            dst[cVert].AddVaryingWithWeight(src[fVerts[i]], fVaryingWeight);
+                dst[cVert].AddVaryingWithWeight(src[fVerts[i]], fVaryingWeight);
+            }
         }
     }
 }
@@ -675,69 +1206,77 @@ TopologyRefiner::interpolateChildVertsFromFaces(
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
 TopologyRefiner::interpolateChildVertsFromEdges(
-    Vtr::Refinement const & refinement, T const & src, U & dst) const {
+    Vtr::Refinement const & refinement, T const & src, U & dst, bool parallel) const {
 
     Sdc::Scheme<SCHEME> scheme(_subdivOptions);
 
     const Vtr::Level& parent = refinement.parent();
     const Vtr::Level& child  = refinement.child();
 
-    Vtr::EdgeInterface eHood(parent);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        Vtr::EdgeInterface eHood(parent);
 
-    float   eVertWeights[2],
-          * eFaceWeights = (float *)alloca(parent.getMaxEdgeFaces()*sizeof(float));
+        float   eVertWeights[2],
+              * eFaceWeights = (float *)alloca(parent.getMaxEdgeFaces()*sizeof(float));
 
-    for (int edge = 0; edge < parent.getNumEdges(); ++edge) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp for
+#endif
+        for (int edge = 0; edge < parent.getNumEdges(); ++edge) {
 
-        Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
-        if (!Vtr::IndexIsValid(cVert))
-            continue;
+            Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
+            if (!Vtr::IndexIsValid(cVert))
+                continue;
 
-        //  Declare and compute mask weights for this vertex relative to its parent edge:
-        ConstIndexArray eVerts = parent.getEdgeVertices(edge),
-                        eFaces = parent.getEdgeFaces(edge);
+            //  Declare and compute mask weights for this vertex relative to its parent edge:
+            ConstIndexArray eVerts = parent.getEdgeVertices(edge),
+                            eFaces = parent.getEdgeFaces(edge);
 
-        Vtr::MaskInterface eMask(eVertWeights, 0, eFaceWeights);
+            Vtr::MaskInterface eMask(eVertWeights, 0, eFaceWeights);
 
-        eHood.SetIndex(edge);
+            eHood.SetIndex(edge);
 
-        Sdc::Crease::Rule pRule = (parent.getEdgeSharpness(edge) > 0.0f) ? Sdc::Crease::RULE_CREASE : Sdc::Crease::RULE_SMOOTH;
-        Sdc::Crease::Rule cRule = child.getVertexRule(cVert);
+            Sdc::Crease::Rule pRule = (parent.getEdgeSharpness(edge) > 0.0f) ? Sdc::Crease::RULE_CREASE : Sdc::Crease::RULE_SMOOTH;
+            Sdc::Crease::Rule cRule = child.getVertexRule(cVert);
 
-        scheme.ComputeEdgeVertexMask(eHood, eMask, pRule, cRule);
+            scheme.ComputeEdgeVertexMask(eHood, eMask, pRule, cRule);
 
-        //  Apply the weights to the parent edges's vertices and (if applicable) to
-        //  the child vertices of its incident faces:
-        dst[cVert].Clear();
-        dst[cVert].AddWithWeight(src[eVerts[0]], eVertWeights[0]);
-        dst[cVert].AddWithWeight(src[eVerts[1]], eVertWeights[1]);
+            //  Apply the weights to the parent edges's vertices and (if applicable) to
+            //  the child vertices of its incident faces:
+            dst[cVert].Clear();
+            dst[cVert].AddWithWeight(src[eVerts[0]], eVertWeights[0]);
+            dst[cVert].AddWithWeight(src[eVerts[1]], eVertWeights[1]);
 
-        dst[cVert].AddVaryingWithWeight(src[eVerts[0]], 0.5f);
-        dst[cVert].AddVaryingWithWeight(src[eVerts[1]], 0.5f);
+            dst[cVert].AddVaryingWithWeight(src[eVerts[0]], 0.5f);
+            dst[cVert].AddVaryingWithWeight(src[eVerts[1]], 0.5f);
 
-        if (eMask.GetNumFaceWeights() > 0) {
+            if (eMask.GetNumFaceWeights() > 0) {
 
-            for (int i = 0; i < eFaces.size(); ++i) {
+                for (int i = 0; i < eFaces.size(); ++i) {
 
-                if (eMask.AreFaceWeightsForFaceCenters()) {
-                    assert(refinement.getNumChildVerticesFromFaces() > 0);
-                    Vtr::Index cVertOfFace = refinement.getFaceChildVertex(eFaces[i]);
+                    if (eMask.AreFaceWeightsForFaceCenters()) {
+                        assert(refinement.getNumChildVerticesFromFaces() > 0);
+                        Vtr::Index cVertOfFace = refinement.getFaceChildVertex(eFaces[i]);
 
-                    assert(Vtr::IndexIsValid(cVertOfFace));
-                    dst[cVert].AddWithWeight(dst[cVertOfFace], eFaceWeights[i]);
-                } else {
-                    Vtr::Index            pFace      = eFaces[i];
-                    ConstIndexArray pFaceEdges = parent.getFaceEdges(pFace),
-                                    pFaceVerts = parent.getFaceVertices(pFace);
+                        assert(Vtr::IndexIsValid(cVertOfFace));
+                        dst[cVert].AddWithWeight(dst[cVertOfFace], eFaceWeights[i]);
+                    } else {
+                        Vtr::Index            pFace      = eFaces[i];
+                        ConstIndexArray pFaceEdges = parent.getFaceEdges(pFace),
+                                        pFaceVerts = parent.getFaceVertices(pFace);
 
-                    int eInFace = 0;
-                    for ( ; pFaceEdges[eInFace] != edge; ++eInFace ) ;
+                        int eInFace = 0;
+                        for ( ; pFaceEdges[eInFace] != edge; ++eInFace ) ;
 
-                    int vInFace = eInFace + 2;
-                    if (vInFace >= pFaceVerts.size()) vInFace -= pFaceVerts.size();
+                        int vInFace = eInFace + 2;
+                        if (vInFace >= pFaceVerts.size()) vInFace -= pFaceVerts.size();
 
-                    Vtr::Index pVertNext = pFaceVerts[vInFace];
-                    dst[cVert].AddWithWeight(src[pVertNext], eFaceWeights[i]);
+                        Vtr::Index pVertNext = pFaceVerts[vInFace];
+                        dst[cVert].AddWithWeight(src[pVertNext], eFaceWeights[i]);
+                    }
                 }
             }
         }
@@ -747,71 +1286,79 @@ TopologyRefiner::interpolateChildVertsFromEdges(
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
 TopologyRefiner::interpolateChildVertsFromVerts(
-    Vtr::Refinement const & refinement, T const & src, U & dst) const {
+    Vtr::Refinement const & refinement, T const & src, U & dst, bool parallel) const {
 
     Sdc::Scheme<SCHEME> scheme(_subdivOptions);
 
     const Vtr::Level& parent = refinement.parent();
     const Vtr::Level& child  = refinement.child();
 
-    Vtr::VertexInterface vHood(parent, child);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        Vtr::VertexInterface vHood(parent, child);
 
-    float * weightBuffer = (float *)alloca(2*parent.getMaxValence()*sizeof(float));
+        float * weightBuffer = (float *)alloca(2*parent.getMaxValence()*sizeof(float));
 
-    for (int vert = 0; vert < parent.getNumVertices(); ++vert) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp for
+#endif
+        for (int vert = 0; vert < parent.getNumVertices(); ++vert) {
 
-        Vtr::Index cVert = refinement.getVertexChildVertex(vert);
-        if (!Vtr::IndexIsValid(cVert))
-            continue;
+            Vtr::Index cVert = refinement.getVertexChildVertex(vert);
+            if (!Vtr::IndexIsValid(cVert))
+                continue;
 
-        //  Declare and compute mask weights for this vertex relative to its parent edge:
-        ConstIndexArray vEdges = parent.getVertexEdges(vert),
-                        vFaces = parent.getVertexFaces(vert);
+            //  Declare and compute mask weights for this vertex relative to its parent edge:
+            ConstIndexArray vEdges = parent.getVertexEdges(vert),
+                            vFaces = parent.getVertexFaces(vert);
 
-        float   vVertWeight,
-              * vEdgeWeights = weightBuffer,
-              * vFaceWeights = vEdgeWeights + vEdges.size();
+            float   vVertWeight,
+                  * vEdgeWeights = weightBuffer,
+                  * vFaceWeights = vEdgeWeights + vEdges.size();
 
-        Vtr::MaskInterface vMask(&vVertWeight, vEdgeWeights, vFaceWeights);
+            Vtr::MaskInterface vMask(&vVertWeight, vEdgeWeights, vFaceWeights);
 
-        vHood.SetIndex(vert, cVert);
+            vHood.SetIndex(vert, cVert);
 
-        Sdc::Crease::Rule pRule = parent.getVertexRule(vert);
-        Sdc::Crease::Rule cRule = child.getVertexRule(cVert);
+            Sdc::Crease::Rule pRule = parent.getVertexRule(vert);
+            Sdc::Crease::Rule cRule = child.getVertexRule(cVert);
 
-        scheme.ComputeVertexVertexMask(vHood, vMask, pRule, cRule);
+            scheme.ComputeVertexVertexMask(vHood, vMask, pRule, cRule);
 
-        //  Apply the weights to the parent vertex, the vertices opposite its incident
-        //  edges, and the child vertices of its incident faces:
-        //
-        //  In order to improve numerical precision, its better to apply smaller weights
-        //  first, so begin with the face-weights followed by the edge-weights and the
-        //  vertex weight last.
-        dst[cVert].Clear();
+            //  Apply the weights to the parent vertex, the vertices opposite its incident
+            //  edges, and the child vertices of its incident faces:
+            //
+            //  In order to improve numerical precision, its better to apply smaller weights
+            //  first, so begin with the face-weights followed by the edge-weights and the
+            //  vertex weight last.
+            dst[cVert].Clear();
 
-        if (vMask.GetNumFaceWeights() > 0) {
-            assert(vMask.AreFaceWeightsForFaceCenters());
+            if (vMask.GetNumFaceWeights() > 0) {
+                assert(vMask.AreFaceWeightsForFaceCenters());
 
-            for (int i = 0; i < vFaces.size(); ++i) {
+                for (int i = 0; i < vFaces.size(); ++i) {
 
-                Vtr::Index cVertOfFace = refinement.getFaceChildVertex(vFaces[i]);
-                assert(Vtr::IndexIsValid(cVertOfFace));
-                dst[cVert].AddWithWeight(dst[cVertOfFace], vFaceWeights[i]);
+                    Vtr::Index cVertOfFace = refinement.getFaceChildVertex(vFaces[i]);
+                    assert(Vtr::IndexIsValid(cVertOfFace));
+                    dst[cVert].AddWithWeight(dst[cVertOfFace], vFaceWeights[i]);
+                }
             }
-        }
-        if (vMask.GetNumEdgeWeights() > 0) {
+            if (vMask.GetNumEdgeWeights() > 0) {
 
-            for (int i = 0; i < vEdges.size(); ++i) {
+                for (int i = 0; i < vEdges.size(); ++i) {
 
-                ConstIndexArray eVerts = parent.getEdgeVertices(vEdges[i]);
-                Vtr::Index pVertOppositeEdge = (eVerts[0] == vert) ? eVerts[1] : eVerts[0];
+                    ConstIndexArray eVerts = parent.getEdgeVertices(vEdges[i]);
+                    Vtr::Index pVertOppositeEdge = (eVerts[0] == vert) ? eVerts[1] : eVerts[0];
 
-                dst[cVert].AddWithWeight(src[pVertOppositeEdge], vEdgeWeights[i]);
+                    dst[cVert].AddWithWeight(src[pVertOppositeEdge], vEdgeWeights[i]);
+                }
             }
-        }
-        dst[cVert].AddWithWeight(src[vert], vVertWeight);
+            dst[cVert].AddWithWeight(src[vert], vVertWeight);
 
-        dst[cVert].AddVaryingWithWeight(src[vert], 1.0f);
+            dst[cVert].AddVaryingWithWeight(src[vert], 1.0f);
+        }
     }
 }
 
@@ -840,20 +1387,23 @@ TopologyRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
 
     Vtr::Refinement const & refinement = getRefinement(level-1);
 
-    varyingInterpolateChildVertsFromFaces(refinement, src, dst);
-    varyingInterpolateChildVertsFromEdges(refinement, src, dst);
-    varyingInterpolateChildVertsFromVerts(refinement, src, dst);
+    varyingInterpolateChildVertsFromFaces(refinement, src, dst, false);
+    varyingInterpolateChildVertsFromEdges(refinement, src, dst, false);
+    varyingInterpolateChildVertsFromVerts(refinement, src, dst, false);
 }
 
 template <class T, class U>
 inline void
 TopologyRefiner::varyingInterpolateChildVertsFromFaces(
-    Vtr::Refinement const & refinement, T const & src, U & dst) const {
+    Vtr::Refinement const & refinement, T const & src, U & dst, bool parallel) const {
 
     if (refinement.getNumChildVerticesFromFaces() == 0) return;
 
     const Vtr::Level& parent = refinement.parent();
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (parallel)
+#endif
     for (int face = 0; face < parent.getNumFaces(); ++face) {
 
         Vtr::Index cVert = refinement.getFaceChildVertex(face);
@@ -876,10 +1426,13 @@ TopologyRefiner::varyingInterpolateChildVertsFromFaces(
 template <class T, class U>
 inline void
 TopologyRefiner::varyingInterpolateChildVertsFromEdges(
-    Vtr::Refinement const & refinement, T const & src, U & dst) const {
+    Vtr::Refinement const & refinement, T const & src, U & dst, bool parallel) const {
 
     const Vtr::Level& parent = refinement.parent();
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (parallel)
+#endif
     for (int edge = 0; edge < parent.getNumEdges(); ++edge) {
 
         Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
@@ -900,10 +1453,13 @@ TopologyRefiner::varyingInterpolateChildVertsFromEdges(
 template <class T, class U>
 inline void
 TopologyRefiner::varyingInterpolateChildVertsFromVerts(
-    Vtr::Refinement const & refinement, T const & src, U & dst) const {
+    Vtr::Refinement const & refinement, T const & src, U & dst, bool parallel) const {
 
     const Vtr::Level& parent = refinement.parent();
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (parallel)
+#endif
     for (int vert = 0; vert < parent.getNumVertices(); ++vert) {
 
         Vtr::Index cVert = refinement.getVertexChildVertex(vert);
@@ -938,25 +1494,32 @@ template <class T, class U>
 inline void
 TopologyRefiner::InterpolateFaceVarying(int level, T const & src, U & dst, int channel) const {
 
+    interpolateFaceVarying(level, src, dst, channel, false);
+}
+
+template <class T, class U>
+inline void
+TopologyRefiner::interpolateFaceVarying(int level, T const & src, U & dst, int channel, bool parallel) const {
+
     assert(level>0 and level<=(int)_refinements.size());
 
     Vtr::Refinement const & refinement = getRefinement(level-1);
 
     switch (_subdivType) {
     case Sdc::SCHEME_CATMARK:
-        faceVaryingInterpolateChildVertsFromFaces<Sdc::SCHEME_CATMARK>(refinement, src, dst, channel);
-        faceVaryingInterpolateChildVertsFromEdges<Sdc::SCHEME_CATMARK>(refinement, src, dst, channel);
-        faceVaryingInterpolateChildVertsFromVerts<Sdc::SCHEME_CATMARK>(refinement, src, dst, channel);
+        faceVaryingInterpolateChildVertsFromFaces<Sdc::SCHEME_CATMARK>(refinement, src, dst, channel, parallel);
+        faceVaryingInterpolateChildVertsFromEdges<Sdc::SCHEME_CATMARK>(refinement, src, dst, channel, parallel);
+        faceVaryingInterpolateChildVertsFromVerts<Sdc::SCHEME_CATMARK>(refinement, src, dst, channel, parallel);
         break;
     case Sdc::SCHEME_LOOP:
-        faceVaryingInterpolateChildVertsFromFaces<Sdc::SCHEME_LOOP>(refinement, src, dst, channel);
-        faceVaryingInterpolateChildVertsFromEdges<Sdc::SCHEME_LOOP>(refinement, src, dst, channel);
-        faceVaryingInterpolateChildVertsFromVerts<Sdc::SCHEME_LOOP>(refinement, src, dst, channel);
+        faceVaryingInterpolateChildVertsFromFaces<Sdc::SCHEME_LOOP>(refinement, src, dst, channel, parallel);
+        faceVaryingInterpolateChildVertsFromEdges<Sdc::SCHEME_LOOP>(refinement, src, dst, channel, parallel);
+        faceVaryingInterpolateChildVertsFromVerts<Sdc::SCHEME_LOOP>(refinement, src, dst, channel, parallel);
         break;
     case Sdc::SCHEME_BILINEAR:
-        faceVaryingInterpolateChildVertsFromFaces<Sdc::SCHEME_BILINEAR>(refinement, src, dst, channel);
-        faceVaryingInterpolateChildVertsFromEdges<Sdc::SCHEME_BILINEAR>(refinement, src, dst, channel);
-        faceVaryingInterpolateChildVertsFromVerts<Sdc::SCHEME_BILINEAR>(refinement, src, dst, channel);
+        faceVaryingInterpolateChildVertsFromFaces<Sdc::SCHEME_BILINEAR>(refinement, src, dst, channel, parallel);
+        faceVaryingInterpolateChildVertsFromEdges<Sdc::SCHEME_BILINEAR>(refinement, src, dst, channel, parallel);
+        faceVaryingInterpolateChildVertsFromVerts<Sdc::SCHEME_BILINEAR>(refinement, src, dst, channel, parallel);
         break;
     }
 }
@@ -964,7 +1527,7 @@ TopologyRefiner::InterpolateFaceVarying(int level, T const & src, U & dst, int c
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
 TopologyRefiner::faceVaryingInterpolateChildVertsFromFaces(
-    Vtr::Refinement const & refinement, T const & src, U & dst, int channel) const {
+    Vtr::Refinement const & refinement, T const & src, U & dst, int channel, bool parallel) const {
 
     if (refinement.getNumChildVerticesFromFaces() == 0) return;
 
@@ -976,34 +1539,42 @@ TopologyRefiner::faceVaryingInterpolateChildVertsFromFaces(
     const Vtr::FVarLevel& parentFVar = *parentLevel._fvarChannels[channel];
     const Vtr::FVarLevel& childFVar  = *childLevel._fvarChannels[channel];
 
-    float * fValueWeights = (float *)alloca(parentLevel.getMaxValence()*sizeof(float));
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        float * fValueWeights = (float *)alloca(parentLevel.getMaxValence()*sizeof(float));
 
-    for (int face = 0; face < parentLevel.getNumFaces(); ++face) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp for
+#endif
+        for (int face = 0; face < parentLevel.getNumFaces(); ++face) {
 
-        Vtr::Index cVert = refinement.getFaceChildVertex(face);
-        if (!Vtr::IndexIsValid(cVert))
-            continue;
+            Vtr::Index cVert = refinement.getFaceChildVertex(face);
+            if (!Vtr::IndexIsValid(cVert))
+                continue;
 
-        Vtr::Index cVertValue = childFVar.getVertexValueOffset(cVert);
+            Vtr::Index cVertValue = childFVar.getVertexValueOffset(cVert);
 
-        //  The only difference for face-varying here is that we get the values associated
-        //  with each face-vertex directly from the FVarLevel, rather than using the parent
-        //  face-vertices directly.  If any face-vertex has any sibling values, then we may
-        //  get the wrong one using the face-vertex index directly.
+            //  The only difference for face-varying here is that we get the values associated
+            //  with each face-vertex directly from the FVarLevel, rather than using the parent
+            //  face-vertices directly.  If any face-vertex has any sibling values, then we may
+            //  get the wrong one using the face-vertex index directly.
 
-        //  Declare and compute mask weights for this vertex relative to its parent face:
-        ConstIndexArray fValues = parentFVar.getFaceValues(face);
+            //  Declare and compute mask weights for this vertex relative to its parent face:
+            ConstIndexArray fValues = parentFVar.getFaceValues(face);
 
-        Vtr::MaskInterface fMask(fValueWeights, 0, 0);
-        Vtr::FaceInterface fHood(fValues.size());
+            Vtr::MaskInterface fMask(fValueWeights, 0, 0);
+            Vtr::FaceInterface fHood(fValues.size());
 
-        scheme.ComputeFaceVertexMask(fHood, fMask);
+            scheme.ComputeFaceVertexMask(fHood, fMask);
 
-        //  Apply the weights to the parent face's vertices:
-        dst[cVertValue].Clear();
+            //  Apply the weights to the parent face's vertices:
+            dst[cVertValue].Clear();
 
-        for (int i = 0; i < fValues.size(); ++i) {
-            dst[cVertValue].AddWithWeight(src[fValues[i]], fValueWeights[i]);
+            for (int i = 0; i < fValues.size(); ++i) {
+                dst[cVertValue].AddWithWeight(src[fValues[i]], fValueWeights[i]);
+            }
         }
     }
 }
@@ -1011,7 +1582,7 @@ TopologyRefiner::faceVaryingInterpolateChildVertsFromFaces(
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
 TopologyRefiner::faceVaryingInterpolateChildVertsFromEdges(
-    Vtr::Refinement const & refinement, T const & src, U & dst, int channel) const {
+    Vtr::Refinement const & refinement, T const & src, U & dst, int channel, bool parallel) const {
 
     Sdc::Scheme<SCHEME> scheme(_subdivOptions);
 
@@ -1022,130 +1593,138 @@ TopologyRefiner::faceVaryingInterpolateChildVertsFromEdges(
     const Vtr::FVarLevel&      parentFVar = *parentLevel._fvarChannels[channel];
     const Vtr::FVarLevel&      childFVar  = *childLevel._fvarChannels[channel];
 
-    //
-    //  Allocate and intialize (if linearly interpolated) interpolation weights for
-    //  the edge mask:
-    //
-    float   eVertWeights[2],
-          * eFaceWeights = (float *)alloca(parentLevel.getMaxEdgeFaces()*sizeof(float));
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        //
+        //  Allocate and intialize (if linearly interpolated) interpolation weights for
+        //  the edge mask:
+        //
+        float   eVertWeights[2],
+              * eFaceWeights = (float *)alloca(parentLevel.getMaxEdgeFaces()*sizeof(float));
 
-    Vtr::MaskInterface eMask(eVertWeights, 0, eFaceWeights);
+        Vtr::MaskInterface eMask(eVertWeights, 0, eFaceWeights);
 
-    bool isLinearFVar = parentFVar._isLinear;
-    if (isLinearFVar) {
-        eMask.SetNumVertexWeights(2);
-        eMask.SetNumEdgeWeights(0);
-        eMask.SetNumFaceWeights(0);
+        bool isLinearFVar = parentFVar._isLinear;
+        if (isLinearFVar) {
+            eMask.SetNumVertexWeights(2);
+            eMask.SetNumEdgeWeights(0);
+            eMask.SetNumFaceWeights(0);
 
-        eVertWeights[0] = 0.5f;
-        eVertWeights[1] = 0.5f;
-    }
+            eVertWeights[0] = 0.5f;
+            eVertWeights[1] = 0.5f;
+        }
 
-    Vtr::EdgeInterface eHood(parentLevel);
+        Vtr::EdgeInterface eHood(parentLevel);
 
-    for (int edge = 0; edge < parentLevel.getNumEdges(); ++edge) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp for
+#endif
+        for (int edge = 0; edge < parentLevel.getNumEdges(); ++edge) {
 
-        Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
-        if (!Vtr::IndexIsValid(cVert))
-            continue;
+            Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
+            if (!Vtr::IndexIsValid(cVert))
+                continue;
 
-        ConstIndexArray cVertValues = childFVar.getVertexValues(cVert);
+            ConstIndexArray cVertValues = childFVar.getVertexValues(cVert);
 
-        bool fvarEdgeVertMatchesVertex = childFVar.valueTopologyMatches(cVertValues[0]);
-        if (fvarEdgeVertMatchesVertex) {
-            //
-            //  If smoothly interpolated, compute new weights for the edge mask:
-            //
-            if (!isLinearFVar) {
-                eHood.SetIndex(edge);
+            bool fvarEdgeVertMatchesVertex = childFVar.valueTopologyMatches(cVertValues[0]);
+            if (fvarEdgeVertMatchesVertex) {
+                //
+                //  If smoothly interpolated, compute new weights for the edge mask:
+                //
+                if (!isLinearFVar) {
+                    eHood.SetIndex(edge);
 
-                Sdc::Crease::Rule pRule = (parentLevel.getEdgeSharpness(edge) > 0.0f)
-                                        ? Sdc::Crease::RULE_CREASE : Sdc::Crease::RULE_SMOOTH;
-                Sdc::Crease::Rule cRule = childLevel.getVertexRule(cVert);
+                    Sdc::Crease::Rule pRule = (parentLevel.getEdgeSharpness(edge) > 0.0f)
+                                            ? Sdc::Crease::RULE_CREASE : Sdc::Crease::RULE_SMOOTH;
+                    Sdc::Crease::Rule cRule = childLevel.getVertexRule(cVert);
 
-                scheme.ComputeEdgeVertexMask(eHood, eMask, pRule, cRule);
-            }
+                    scheme.ComputeEdgeVertexMask(eHood, eMask, pRule, cRule);
+                }
 
-            //  Apply the weights to the parent edges's vertices and (if applicable) to
-            //  the child vertices of its incident faces:
-            //
-            //  Even though the face-varying topology matches the vertex topology, we need
-            //  to be careful here when getting values corresponding to the two end-vertices.
-            //  While the edge may be continuous, the vertices at their ends may have
-            //  discontinuities elsewhere in their neighborhood (i.e. on the "other side"
-            //  of the end-vertex) and so have sibling values associated with them.  In most
-            //  cases the topology for an end-vertex will match and we can use it directly,
-            //  but we must still check and retrieve as needed.
-            //
-            //  Indices for values corresponding to face-vertices are guaranteed to match,
-            //  so we can use the child-vertex indices directly.
-            //
-            //  And by "directly", we always use getVertexValue(vertexIndex) to reference
-            //  values in the "src" to account for the possible indirection that may exist at
-            //  level 0 -- where there may be fewer values than vertices and an additional
-            //  indirection is necessary.  We can use a vertex index directly for "dst" when
-            //  it matches.
-            //
-            Vtr::Index eVertValues[2];
+                //  Apply the weights to the parent edges's vertices and (if applicable) to
+                //  the child vertices of its incident faces:
+                //
+                //  Even though the face-varying topology matches the vertex topology, we need
+                //  to be careful here when getting values corresponding to the two end-vertices.
+                //  While the edge may be continuous, the vertices at their ends may have
+                //  discontinuities elsewhere in their neighborhood (i.e. on the "other side"
+                //  of the end-vertex) and so have sibling values associated with them.  In most
+                //  cases the topology for an end-vertex will match and we can use it directly,
+                //  but we must still check and retrieve as needed.
+                //
+                //  Indices for values corresponding to face-vertices are guaranteed to match,
+                //  so we can use the child-vertex indices directly.
+                //
+                //  And by "directly", we always use getVertexValue(vertexIndex) to reference
+                //  values in the "src" to account for the possible indirection that may exist at
+                //  level 0 -- where there may be fewer values than vertices and an additional
+                //  indirection is necessary.  We can use a vertex index directly for "dst" when
+                //  it matches.
+                //
+                Vtr::Index eVertValues[2];
 
-            parentFVar.getEdgeFaceValues(edge, 0, eVertValues);
+                parentFVar.getEdgeFaceValues(edge, 0, eVertValues);
 
-            Index cVertValue = cVertValues[0];
+                Index cVertValue = cVertValues[0];
 
-            dst[cVertValue].Clear();
-            dst[cVertValue].AddWithWeight(src[eVertValues[0]], eVertWeights[0]);
-            dst[cVertValue].AddWithWeight(src[eVertValues[1]], eVertWeights[1]);
+                dst[cVertValue].Clear();
+                dst[cVertValue].AddWithWeight(src[eVertValues[0]], eVertWeights[0]);
+                dst[cVertValue].AddWithWeight(src[eVertValues[1]], eVertWeights[1]);
 
-            if (eMask.GetNumFaceWeights() > 0) {
+                if (eMask.GetNumFaceWeights() > 0) {
 
-                ConstIndexArray  eFaces = parentLevel.getEdgeFaces(edge);
+                    ConstIndexArray  eFaces = parentLevel.getEdgeFaces(edge);
 
-                for (int i = 0; i < eFaces.size(); ++i) {
-                    if (eMask.AreFaceWeightsForFaceCenters()) {
+                    for (int i = 0; i < eFaces.size(); ++i) {
+                        if (eMask.AreFaceWeightsForFaceCenters()) {
 
-                        Vtr::Index cVertOfFace = refinement.getFaceChildVertex(eFaces[i]);
-                        assert(Vtr::IndexIsValid(cVertOfFace));
+                            Vtr::Index cVertOfFace = refinement.getFaceChildVertex(eFaces[i]);
+                            assert(Vtr::IndexIsValid(cVertOfFace));
 
-                        Vtr::Index cValueOfFace = childFVar.getVertexValueOffset(cVertOfFace);
-                        dst[cVertValue].AddWithWeight(dst[cValueOfFace], eFaceWeights[i]);
-                    } else {
-                        Vtr::Index            pFace      = eFaces[i];
-                        ConstIndexArray pFaceEdges = parentLevel.getFaceEdges(pFace),
-                                        pFaceVerts = parentLevel.getFaceVertices(pFace);
+                            Vtr::Index cValueOfFace = childFVar.getVertexValueOffset(cVertOfFace);
+                            dst[cVertValue].AddWithWeight(dst[cValueOfFace], eFaceWeights[i]);
+                        } else {
+                            Vtr::Index            pFace      = eFaces[i];
+                            ConstIndexArray pFaceEdges = parentLevel.getFaceEdges(pFace),
+                                            pFaceVerts = parentLevel.getFaceVertices(pFace);
 
-                        int eInFace = 0;
-                        for ( ; pFaceEdges[eInFace] != edge; ++eInFace ) ;
+                            int eInFace = 0;
+                            for ( ; pFaceEdges[eInFace] != edge; ++eInFace ) ;
 
-                        //  Edge "i" spans vertices [i,i+1] so we want i+2...
-                        int vInFace = eInFace + 2;
-                        if (vInFace >= pFaceVerts.size()) vInFace -= pFaceVerts.size();
+                            //  Edge "i" spans vertices [i,i+1] so we want i+2...
+                            int vInFace = eInFace + 2;
+                            if (vInFace >= pFaceVerts.size()) vInFace -= pFaceVerts.size();
 
-                        Vtr::Index pValueNext = parentFVar.getFaceValues(pFace)[vInFace];
-                        dst[cVertValue].AddWithWeight(src[pValueNext], eFaceWeights[i]);
+                            Vtr::Index pValueNext = parentFVar.getFaceValues(pFace)[vInFace];
+                            dst[cVertValue].AddWithWeight(src[pValueNext], eFaceWeights[i]);
+                        }
                     }
                 }
-            }
-        } else {
-            //
-            //  Mismatched edge-verts should just be linearly interpolated between the pairs of
-            //  values for each sibling of the child edge-vertex -- the question is:  which face
-            //  holds that pair of values for a given sibling?
-            //
-            //  In the manifold case, the sibling and edge-face indices will correspond.  We
-            //  will eventually need to update this to account for > 3 incident faces.
-            //
-            for (int i = 0; i < cVertValues.size(); ++i) {
-                Vtr::Index eVertValues[2];
-                int      eFaceIndex = refineFVar.getChildValueParentSource(cVert, i);
-                assert(eFaceIndex == i);
-
-                parentFVar.getEdgeFaceValues(edge, eFaceIndex, eVertValues);
-
-                Index cVertValue = cVertValues[i];
-
-                dst[cVertValue].Clear();
-                dst[cVertValue].AddWithWeight(src[eVertValues[0]], 0.5);
-                dst[cVertValue].AddWithWeight(src[eVertValues[1]], 0.5);
+            } else {
+                //
+                //  Mismatched edge-verts should just be linearly interpolated between the pairs of
+                //  values for each sibling of the child edge-vertex -- the question is:  which face
+                //  holds that pair of values for a given sibling?
+                //
+                //  In the manifold case, the sibling and edge-face indices will correspond.  We
+                //  will eventually need to update this to account for > 3 incident faces.
+                //
+                for (int i = 0; i < cVertValues.size(); ++i) {
+                    Vtr::Index eVertValues[2];
+                    int      eFaceIndex = refineFVar.getChildValueParentSource(cVert, i);
+                    assert(eFaceIndex == i);
+
+                    parentFVar.getEdgeFaceValues(edge, eFaceIndex, eVertValues);
+
+                    Index cVertValue = cVertValues[i];
+
+                    dst[cVertValue].Clear();
+                    dst[cVertValue].AddWithWeight(src[eVertValues[0]], 0.5);
+                    dst[cVertValue].AddWithWeight(src[eVertValues[1]], 0.5);
+                }
             }
         }
     }
@@ -1154,7 +1733,7 @@ TopologyRefiner::faceVaryingInterpolateChildVertsFromEdges(
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
 TopologyRefiner::faceVaryingInterpolateChildVertsFromVerts(
-    Vtr::Refinement const & refinement, T const & src, U & dst, int channel) const {
+    Vtr::Refinement const & refinement, T const & src, U & dst, int channel, bool parallel) const {
 
     Sdc::Scheme<SCHEME> scheme(_subdivOptions);
 
@@ -1167,156 +1746,234 @@ TopologyRefiner::faceVaryingInterpolateChildVertsFromVerts(
 
     bool isLinearFVar = parentFVar._isLinear;
 
-    float * weightBuffer = (float *)alloca(2*parentLevel.getMaxValence()*sizeof(float));
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        float * weightBuffer = (float *)alloca(2*parentLevel.getMaxValence()*sizeof(float));
 
-    Vtr::Index * vEdgeValues = (Vtr::Index *)alloca(parentLevel.getMaxValence()*sizeof(Vtr::Index));
+        Vtr::Index * vEdgeValues = (Vtr::Index *)alloca(parentLevel.getMaxValence()*sizeof(Vtr::Index));
 
-    Vtr::VertexInterface vHood(parentLevel, childLevel);
+        Vtr::VertexInterface vHood(parentLevel, childLevel);
 
-    for (int vert = 0; vert < parentLevel.getNumVertices(); ++vert) {
-
-        Vtr::Index cVert = refinement.getVertexChildVertex(vert);
-        if (!Vtr::IndexIsValid(cVert))
-            continue;
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp for
+#endif
+        for (int vert = 0; vert < parentLevel.getNumVertices(); ++vert) {
 
-        ConstIndexArray pVertValues = parentFVar.getVertexValues(vert),
-                        cVertValues = childFVar.getVertexValues(cVert);
+            Vtr::Index cVert = refinement.getVertexChildVertex(vert);
+            if (!Vtr::IndexIsValid(cVert))
+                continue;
 
-        bool fvarVertVertMatchesVertex = childFVar.valueTopologyMatches(cVertValues[0]);
-        if (isLinearFVar && fvarVertVertMatchesVertex) {
-            dst[cVertValues[0]].Clear();
-            dst[cVertValues[0]].AddWithWeight(src[pVertValues[0]], 1.0f);
-            continue;
-        }
+            ConstIndexArray pVertValues = parentFVar.getVertexValues(vert),
+                            cVertValues = childFVar.getVertexValues(cVert);
 
-        if (fvarVertVertMatchesVertex) {
-            //
-            //  Declare and compute mask weights for this vertex relative to its parent edge:
-            //
-            //  (We really need to encapsulate this somewhere else for use here and in the
-            //  general case)
-            //
-            ConstIndexArray vEdges = parentLevel.getVertexEdges(vert);
+            bool fvarVertVertMatchesVertex = childFVar.valueTopologyMatches(cVertValues[0]);
+            if (isLinearFVar && fvarVertVertMatchesVertex) {
+                dst[cVertValues[0]].Clear();
+                dst[cVertValues[0]].AddWithWeight(src[pVertValues[0]], 1.0f);
+                continue;
+            }
 
-            float   vVertWeight;
-            float * vEdgeWeights = weightBuffer;
-            float * vFaceWeights = vEdgeWeights + vEdges.size();
+            if (fvarVertVertMatchesVertex) {
+                //
+                //  Declare and compute mask weights for this vertex relative to its parent edge:
+                //
+                //  (We really need to encapsulate this somewhere else for use here and in the
+                //  general case)
+                //
+                ConstIndexArray vEdges = parentLevel.getVertexEdges(vert);
 
-            Vtr::MaskInterface vMask(&vVertWeight, vEdgeWeights, vFaceWeights);
+                float   vVertWeight;
+                float * vEdgeWeights = weightBuffer;
+                float * vFaceWeights = vEdgeWeights + vEdges.size();
 
-            vHood.SetIndex(vert, cVert);
+                Vtr::MaskInterface vMask(&vVertWeight, vEdgeWeights, vFaceWeights);
 
-            Sdc::Crease::Rule pRule = parentLevel.getVertexRule(vert);
-            Sdc::Crease::Rule cRule = childLevel.getVertexRule(cVert);
+                vHood.SetIndex(vert, cVert);
 
-            scheme.ComputeVertexVertexMask(vHood, vMask, pRule, cRule);
+                Sdc::Crease::Rule pRule = parentLevel.getVertexRule(vert);
+                Sdc::Crease::Rule cRule = childLevel.getVertexRule(cVert);
 
-            //  Apply the weights to the parent vertex, the vertices opposite its incident
-            //  edges, and the child vertices of its incident faces:
-            //
-            //  Even though the face-varying topology matches the vertex topology, we need
-            //  to be careful here when getting values corresponding to vertices at the
-            //  ends of edges.  While the edge may be continuous, the end vertex may have
-            //  discontinuities elsewhere in their neighborhood (i.e. on the "other side"
-            //  of the end-vertex) and so have sibling values associated with them.  In most
-            //  cases the topology for an end-vertex will match and we can use it directly,
-            //  but we must still check and retrieve as needed.
-            //
-            //  Indices for values corresponding to face-vertices are guaranteed to match,
-            //  so we can use the child-vertex indices directly.
-            //
-            //  And by "directly", we always use getVertexValue(vertexIndex) to reference
-            //  values in the "src" to account for the possible indirection that may exist at
-            //  level 0 -- where there may be fewer values than vertices and an additional
-            //  indirection is necessary.  We can use a vertex index directly for "dst" when
-            //  it matches.
-            //
-            //  As with applying the mask to vertex data, in order to improve numerical
-            //  precision, its better to apply smaller weights first, so begin with the
-            //  face-weights followed by the edge-weights and the vertex weight last.
-            //
-            Vtr::Index pVertValue = pVertValues[0];
-            Vtr::Index cVertValue = cVertValues[0];
+                scheme.ComputeVertexVertexMask(vHood, vMask, pRule, cRule);
+
+                //  Apply the weights to the parent vertex, the vertices opposite its incident
+                //  edges, and the child vertices of its incident faces:
+                //
+                //  Even though the face-varying topology matches the vertex topology, we need
+                //  to be careful here when getting values corresponding to vertices at the
+                //  ends of edges.  While the edge may be continuous, the end vertex may have
+                //  discontinuities elsewhere in their neighborhood (i.e. on the "other side"
+                //  of the end-vertex) and so have sibling values associated with them.  In most
+                //  cases the topology for an end-vertex will match and we can use it directly,
+                //  but we must still check and retrieve as needed.
+                //
+                //  Indices for values corresponding to face-vertices are guaranteed to match,
+                //  so we can use the child-vertex indices directly.
+                //
+                //  And by "directly", we always use getVertexValue(vertexIndex) to reference
+                //  values in the "src" to account for the possible indirection that may exist at
+                //  level 0 -- where there may be fewer values than vertices and an additional
+                //  indirection is necessary.  We can use a vertex index directly for "dst" when
+                //  it matches.
+                //
+                //  As with applying the mask to vertex data, in order to improve numerical
+                //  precision, its better to apply smaller weights first, so begin with the
+                //  face-weights followed by the edge-weights and the vertex weight last.
+                //
+                Vtr::Index pVertValue = pVertValues[0];
+                Vtr::Index cVertValue = cVertValues[0];
 
-            dst[cVertValue].Clear();
-            if (vMask.GetNumFaceWeights() > 0) {
-                assert(vMask.AreFaceWeightsForFaceCenters());
+                dst[cVertValue].Clear();
+                if (vMask.GetNumFaceWeights() > 0) {
+                    assert(vMask.AreFaceWeightsForFaceCenters());
 
-                ConstIndexArray vFaces = parentLevel.getVertexFaces(vert);
+                    ConstIndexArray vFaces = parentLevel.getVertexFaces(vert);
 
-                for (int i = 0; i < vFaces.size(); ++i) {
+                    for (int i = 0; i < vFaces.size(); ++i) {
 
-                    Vtr::Index cVertOfFace  = refinement.getFaceChildVertex(vFaces[i]);
-                    assert(Vtr::IndexIsValid(cVertOfFace));
+                        Vtr::Index cVertOfFace  = refinement.getFaceChildVertex(vFaces[i]);
+                        assert(Vtr::IndexIsValid(cVertOfFace));
 
-                    Vtr::Index cValueOfFace = childFVar.getVertexValueOffset(cVertOfFace);
-                    dst[cVertValue].AddWithWeight(dst[cValueOfFace], vFaceWeights[i]);
+                        Vtr::Index cValueOfFace = childFVar.getVertexValueOffset(cVertOfFace);
+                        dst[cVertValue].AddWithWeight(dst[cValueOfFace], vFaceWeights[i]);
+                    }
                 }
-            }
-            if (vMask.GetNumEdgeWeights() > 0) {
+                if (vMask.GetNumEdgeWeights() > 0) {
 
-                parentFVar.getVertexEdgeValues(vert, vEdgeValues);
+                    parentFVar.getVertexEdgeValues(vert, vEdgeValues);
 
-                for (int i = 0; i < vEdges.size(); ++i) {
-                    dst[cVertValue].AddWithWeight(src[vEdgeValues[i]], vEdgeWeights[i]);
+                    for (int i = 0; i < vEdges.size(); ++i) {
+                        dst[cVertValue].AddWithWeight(src[vEdgeValues[i]], vEdgeWeights[i]);
+                    }
                 }
-            }
-            dst[cVertValue].AddWithWeight(src[pVertValue], vVertWeight);
-        } else {
-            //
-            //  Each FVar value associated with a vertex will be either a corner or a crease,
-            //  or potentially in transition from corner to crease:
-            //      - if the CHILD is a corner, there can be no transition so we have a corner
-            //      - otherwise if the PARENT is a crease, both will be creases (no transition)
-            //      - otherwise the parent must be a corner and the child a crease (transition)
-            //
-            Vtr::FVarLevel::ConstValueTagArray pValueTags = parentFVar.getVertexValueTags(vert);
-            Vtr::FVarLevel::ConstValueTagArray cValueTags = childFVar.getVertexValueTags(cVert);
-
-            for (int cSibling = 0; cSibling < cVertValues.size(); ++cSibling) {
-                int pSibling = refineFVar.getChildValueParentSource(cVert, cSibling);
-                assert(pSibling == cSibling);
-
-                Vtr::Index pVertValue = pVertValues[pSibling];
-                Vtr::Index cVertValue = cVertValues[cSibling];
-
-                dst[cVertValue].Clear();
-                if (cValueTags[cSibling].isCorner()) {
-                    dst[cVertValue].AddWithWeight(src[pVertValue], 1.0f);
-                } else {
-                    //
-                    //  We have either a crease or a transition from corner to crease -- in
-                    //  either case, we need the end values for the full/fractional crease:
-                    //
-                    Index pEndValues[2];
-                    parentFVar.getVertexCreaseEndValues(vert, pSibling, pEndValues);
-
-                    float vWeight = 0.75f;
-                    float eWeight = 0.125f;
-
-                    //
-                    //  If semisharp we need to apply fractional weighting -- if made sharp because
-                    //  of the other sibling (dependent-sharp) use the fractional weight from that
-                    //  other sibling (should only occur when there are 2):
-                    //
-                    if (pValueTags[pSibling].isSemiSharp()) {
-                        float wCorner = pValueTags[pSibling].isDepSharp()
-                                      ? refineFVar.getFractionalWeight(vert, !pSibling, cVert, !cSibling)
-                                      : refineFVar.getFractionalWeight(vert, pSibling, cVert, cSibling);
-                        float wCrease = 1.0f - wCorner;
-
-                        vWeight = wCrease * 0.75f + wCorner;
-                        eWeight = wCrease * 0.125f;
+                dst[cVertValue].AddWithWeight(src[pVertValue], vVertWeight);
+            } else {
+                //
+                //  Each FVar value associated with a vertex will be either a corner or a crease,
+                //  or potentially in transition from corner to crease:
+                //      - if the CHILD is a corner, there can be no transition so we have a corner
+                //      - otherwise if the PARENT is a crease, both will be creases (no transition)
+                //      - otherwise the parent must be a corner and the child a crease (transition)
+                //
+                Vtr::FVarLevel::ConstValueTagArray pValueTags = parentFVar.getVertexValueTags(vert);
+                Vtr::FVarLevel::ConstValueTagArray cValueTags = childFVar.getVertexValueTags(cVert);
+
+                for (int cSibling = 0; cSibling < cVertValues.size(); ++cSibling) {
+                    int pSibling = refineFVar.getChildValueParentSource(cVert, cSibling);
+                    assert(pSibling == cSibling);
+
+                    Vtr::Index pVertValue = pVertValues[pSibling];
+                    Vtr::Index cVertValue = cVertValues[cSibling];
+
+                    dst[cVertValue].Clear();
+                    if (cValueTags[cSibling].isCorner()) {
+                        dst[cVertValue].AddWithWeight(src[pVertValue], 1.0f);
+                    } else {
+                        //
+                        //  We have either a crease or a transition from corner to crease -- in
+                        //  either case, we need the end values for the full/fractional crease:
+                        //
+                        Index pEndValues[2];
+                        parentFVar.getVertexCreaseEndValues(vert, pSibling, pEndValues);
+
+                        float vWeight = 0.75f;
+                        float eWeight = 0.125f;
+
+                        //
+                        //  If semisharp we need to apply fractional weighting -- if made sharp because
+                        //  of the other sibling (dependent-sharp) use the fractional weight from that
+                        //  other sibling (should only occur when there are 2):
+                        //
+                        if (pValueTags[pSibling].isSemiSharp()) {
+                            float wCorner = pValueTags[pSibling].isDepSharp()
+                                          ? refineFVar.getFractionalWeight(vert, !pSibling, cVert, !cSibling)
+                                          : refineFVar.getFractionalWeight(vert, pSibling, cVert, cSibling);
+                            float wCrease = 1.0f - wCorner;
+
+                            vWeight = wCrease * 0.75f + wCorner;
+                            eWeight = wCrease * 0.125f;
+                        }
+                        dst[cVertValue].AddWithWeight(src[pEndValues[0]], eWeight);
+                        dst[cVertValue].AddWithWeight(src[pEndValues[1]], eWeight);
+                        dst[cVertValue].AddWithWeight(src[pVertValue], vWeight);
                     }
-                    dst[cVertValue].AddWithWeight(src[pEndValues[0]], eWeight);
-                    dst[cVertValue].AddWithWeight(src[pEndValues[1]], eWeight);
-                    dst[cVertValue].AddWithWeight(src[pVertValue], vWeight);
                 }
             }
         }
     }
 }
 
+//
+// Multithreaded interpolation
+//
+
+template <class T, class U>
+inline void
+TopologyRefiner::ParallelInterpolate(T const * src, U * dst) const {
+
+    for (int level=1; level<=GetMaxLevel(); ++level) {
+
+        ParallelInterpolate(level, src, dst);
+
+        src = dst;
+        dst += GetNumVertices(level);
+    }
+}
+
+template <class T, class U>
+inline void
+TopologyRefiner::ParallelInterpolate(int level, T const & src, U & dst) const {
+
+    interpolate(level, src, dst, true);
+}
+
+template <class T, class U>
+inline void
+TopologyRefiner::ParallelInterpolateVarying(T const * src, U * dst) const {
+
+    for (int level=1; level<=GetMaxLevel(); ++level) {
+
+        ParallelInterpolateVarying(level, src, dst);
+
+        src = dst;
+        dst += GetNumVertices(level);
+    }
+}
+
+template <class T, class U>
+inline void
+TopologyRefiner::ParallelInterpolateVarying(int level, T const & src, U & dst) const {
+
+    assert(level>0 and level<=(int)_refinements.size());
+
+    Vtr::Refinement const & refinement = getRefinement(level-1);
+
+    varyingInterpolateChildVertsFromFaces(refinement, src, dst, true);
+    varyingInterpolateChildVertsFromEdges(refinement, src, dst, true);
+    varyingInterpolateChildVertsFromVerts(refinement, src, dst, true);
+}
+
+template <class T, class U>
+inline void
+TopologyRefiner::ParallelInterpolateFaceVarying(T const * src, U * dst, int channel) const {
+
+    for (int level=1; level<=GetMaxLevel(); ++level) {
+
+        ParallelInterpolateFaceVarying(level, src, dst, channel);
+
+        src = dst;
+        dst += getLevel(level).getNumFVarValues();
+    }
+}
+
+template <class T, class U>
+inline void
+TopologyRefiner::ParallelInterpolateFaceVarying(int level, T const & src, U & dst, int channel) const {
+
+    interpolateFaceVarying(level, src, dst, channel, true);
+}
+
 template <class T, class U>
 inline void
 TopologyRefiner::Limit(T const & src, U * dst) const {
@@ -1345,8 +2002,8 @@ TopologyRefiner::limit(T const & src, U * dst) const {
     //      - does not support tangents yet (unclear how)
     //      - need to verify that each vertex is "limitable", i.e.:
     //          - is not semi-sharp, inf-sharp or non-manifold
-    //          - is "complete" wrt its parent (if refinement is sparse)
-    //      - copy (or weight by 1.0) src to dst when not "limitable"
+    //      - copy (or weight by 1.0) src to dst when not "limitable" (done for
+    //        vertices incomplete wrt their parent when the refinement is sparse)
     //      - currently requires one refinement to get rid of N-sided faces:
     //          - could limit regular vertices from level 0
     //
@@ -1362,6 +2019,13 @@ TopologyRefiner::limit(T const & src, U * dst) const {
     Vtr::VertexInterface vHood(level, level);
 
     for (int vert = 0; vert < level.getNumVertices(); ++vert) {
+        if (level.getVertexTag(vert)._incomplete) {
+            //  Supports only holes of a sparse refinement -- not limitable
+            dst[vert].Clear();
+            dst[vert].AddWithWeight(src[vert], 1.0f);
+            continue;
+        }
+
         ConstIndexArray vEdges = level.getVertexEdges(vert);
 
         float * vWeights = weightBuffer,
@@ -1451,6 +2115,15 @@ TopologyRefiner::faceVaryingLimit(T const & src, U * dst, int channel) const {
 
         ConstIndexArray vValues = fvarChannel.getVertexValues(vert);
 
+        if (level.getVertexTag(vert)._incomplete) {
+            //  Supports only holes of a sparse refinement -- not limitable
+            for (int i = 0; i < vValues.size(); ++i) {
+                dst[vValues[i]].Clear();
+                dst[vValues[i]].AddWithWeight(src[vValues[i]], 1.0f);
+            }
+            continue;
+        }
+
         bool fvarVertMatchesVertex = fvarChannel.valueTopologyMatches(vValues[0]);
         if (fvarChannel._isLinear && fvarVertMatchesVertex) {
             Vtr::Index srcValueIndex = fvarChannel.getVertexValue(vert);
@@ -0,0 +1,688 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../far/topologyRefinerCache.h"
+#include "../far/error.h"
+#include "../vtr/level.h"
+#include "../vtr/fvarLevel.h"
+#include "../vtr/refinement.h"
+#include "../vtr/fvarRefinement.h"
+#include "../vtr/quadRefinement.h"
+#include "../vtr/triRefinement.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _MSC_VER
+    #define snprintf _snprintf
+#endif
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    //
+    //  Version of the stored data -- to be incremented with any change to the layout or
+    //  to the members of the classes stored (which invalidates all previously stored):
+    //
+    char const STORAGE_MAGIC[8]  = { 'O', 'S', 'D', 'T', 'O', 'P', 'O', '\0' };
+    int const  STORAGE_VERSION   = 2;
+    int const  STORAGE_BYTEORDER = 0x01020304;
+
+    //
+    //  Keys combine two 32-bit hashes of different construction (FNV-1a and djb2) into a
+    //  64-bit value -- sized integer types are avoided for portability (see Vtr::Index):
+    //
+    class KeyHash {
+    public:
+        KeyHash() : _h0(2166136261u), _h1(5381u) { }
+
+        void Append(void const * data, size_t size) {
+            unsigned char const * bytes = static_cast<unsigned char const *>(data);
+            for (size_t i = 0; i < size; ++i) {
+                _h0 = (_h0 ^ bytes[i]) * 16777619u;
+                _h1 = (_h1 * 33u) + bytes[i];
+            }
+        }
+        void AppendInt(int value) {
+            Append(&value, sizeof(int));
+        }
+        template <typename T>
+        void AppendVector(std::vector<T> const & v) {
+            AppendInt((int)v.size());
+            if (not v.empty()) {
+                Append(&v[0], v.size() * sizeof(T));
+            }
+        }
+        std::string GetKey() const {
+            char key[32];
+            snprintf(key, 32, "%08x%08x", _h0 & 0xffffffffu, _h1 & 0xffffffffu);
+            return std::string(key);
+        }
+
+    private:
+        unsigned int _h0;
+        unsigned int _h1;
+    };
+
+    void
+    appendSchemeOptions(KeyHash & hash, Sdc::Options const & options) {
+
+        hash.AppendInt((int)options.GetVtxBoundaryInterpolation());
+        hash.AppendInt((int)options.GetFVarLinearInterpolation());
+        hash.AppendInt((int)options.GetCreasingMethod());
+        hash.AppendInt((int)options.GetTriangleSubdivision());
+    }
+}
+
+//
+//  The key identifies the base level as constructed by the factory -- its topology and
+//  any features assigned to it -- along with the scheme and the options of refinement:
+//
+std::string
+TopologyRefinerCache::computeKey(TopologyRefiner const & refiner,
+    std::vector<int> const & options) {
+
+    Vtr::Level const & base = refiner.getLevel(0);
+
+    KeyHash hash;
+
+    hash.Append(STORAGE_MAGIC, sizeof(STORAGE_MAGIC));
+    hash.AppendInt(STORAGE_VERSION);
+    hash.AppendInt((int)sizeof(Index));
+
+    hash.AppendInt((int)refiner.GetSchemeType());
+    appendSchemeOptions(hash, refiner.GetSchemeOptions());
+
+    hash.AppendInt(base.getNumVertices());
+    hash.AppendInt(base.getNumFaces());
+    hash.AppendInt(base.getNumEdges());
+    for (int face = 0; face < base.getNumFaces(); ++face) {
+        hash.AppendInt(base.getNumFaceVertices(face) | (base.isHole(face) << 16));
+    }
+    hash.AppendVector(base._faceVertIndices);
+    hash.AppendVector(base._edgeVertIndices);
+    hash.AppendVector(base._edgeSharpness);
+    hash.AppendVector(base._vertSharpness);
+
+    hash.AppendInt(base.getNumFVarChannels());
+    for (int channel = 0; channel < base.getNumFVarChannels(); ++channel) {
+        Vtr::FVarLevel const & fvar = *base._fvarChannels[channel];
+
+        appendSchemeOptions(hash, fvar._options);
+        hash.AppendInt(fvar._valueCount);
+        hash.AppendVector(fvar._faceVertValues);
+    }
+
+    hash.AppendVector(options);
+    return hash.GetKey();
+}
+
+std::string
+TopologyRefinerCache::ComputeKey(TopologyRefiner const & refiner,
+    TopologyRefiner::UniformOptions options) {
+
+    //  Parallel refinement does not affect the result and so is excluded:
+    std::vector<int> optionValues;
+    optionValues.push_back(0);
+    optionValues.push_back(options.refinementLevel);
+    optionValues.push_back(options.fullTopologyInLastLevel);
+
+    //  Pruning only affects meshes with holes (keys of others are unchanged):
+    if (options.pruneHoles and refiner.HasHoles()) {
+        optionValues.push_back(1);
+    }
+    return computeKey(refiner, optionValues);
+}
+
+std::string
+TopologyRefinerCache::ComputeKey(TopologyRefiner const & refiner,
+    TopologyRefiner::AdaptiveOptions options) {
+
+    std::vector<int> optionValues;
+    optionValues.push_back(1);
+    optionValues.push_back(options.isolationLevel);
+    optionValues.push_back(options.fullTopologyInLastLevel);
+    optionValues.push_back(options.useSingleCreasePatch);
+    optionValues.push_back(options.considerFVarChannels);
+
+    //  Isolation limits of the base faces (if any) as given rather than as clamped:
+    if (options.baseFaceIsolationLevels or options.baseFaceIsolationCallback) {
+        for (Index face = 0; face < refiner.GetNumFaces(0); ++face) {
+            optionValues.push_back(options.baseFaceIsolationCallback ?
+                options.baseFaceIsolationCallback(face, options.baseFaceIsolationData) :
+                options.baseFaceIsolationLevels[face]);
+        }
+    }
+    return computeKey(refiner, optionValues);
+}
+
+//
+//  Stored data is a sequence of ints and arrays -- each array prefixed by its size and
+//  the size of its elements, which are read back into the vectors of the restored refiner:
+//
+class TopologyRefinerCache::Writer {
+public:
+    Writer(std::vector<char> & data) : _data(data) { }
+
+    void WriteBytes(void const * src, size_t size) {
+        char const * bytes = static_cast<char const *>(src);
+        _data.insert(_data.end(), bytes, bytes + size);
+    }
+    void WriteInt(int value) {
+        WriteBytes(&value, sizeof(int));
+    }
+    template <typename T>
+    void WriteVector(std::vector<T> const & v) {
+        WriteInt((int)v.size());
+        WriteInt((int)sizeof(T));
+        if (not v.empty()) {
+            WriteBytes(static_cast<void const *>(&v[0]), v.size() * sizeof(T));
+        }
+    }
+
+private:
+    std::vector<char> & _data;
+};
+
+class TopologyRefinerCache::Reader {
+public:
+    Reader(char const * data, size_t size) :
+        _data(data), _size(size), _pos(0), _valid(true) { }
+
+    bool IsValid() const { return _valid; }
+    void Invalidate()    { _valid = false; }
+
+    void ReadBytes(void * dst, size_t size) {
+        if (_valid and (size <= (_size - _pos))) {
+            std::memcpy(dst, _data + _pos, size);
+            _pos += size;
+        } else {
+            _valid = false;
+        }
+    }
+    int ReadInt() {
+        int value = 0;
+        ReadBytes(&value, sizeof(int));
+        return value;
+    }
+    bool ReadBool() {
+        return ReadInt() != 0;
+    }
+    template <typename T>
+    void ReadVector(std::vector<T> & v) {
+        int count    = ReadInt();
+        int elemSize = ReadInt();
+        if ((count < 0) or (elemSize != (int)sizeof(T)) or
+            ((size_t)count > (_size - _pos) / sizeof(T))) {
+            _valid = false;
+        }
+        if (not _valid) return;
+
+        v.resize(count);
+        if (count) {
+            ReadBytes(static_cast<void *>(&v[0]), count * sizeof(T));
+        }
+    }
+
+private:
+    char const * _data;
+    size_t       _size;
+    size_t       _pos;
+    bool         _valid;
+};
+
+//
+//  Storage of each class -- all members that are not references to other instances (which
+//  are restored from the order of the levels and refinements) are written in turn:
+//
+
+void
+TopologyRefinerCache::writeLevel(Writer & w, Vtr::Level const & level) {
+
+    w.WriteInt(level._faceCount);
+    w.WriteInt(level._edgeCount);
+    w.WriteInt(level._vertCount);
+    w.WriteInt(level._depth);
+    w.WriteInt(level._maxEdgeFaces);
+    w.WriteInt(level._maxValence);
+    w.WriteInt(level._uniformFaceSize);
+
+    w.WriteVector(level._faceVertOffsets);
+    w.WriteVector(level._faceVertIndices);
+    w.WriteVector(level._faceEdgeIndices);
+    w.WriteVector(level._faceTags);
+
+    w.WriteVector(level._edgeVertIndices);
+    w.WriteVector(level._edgeFaceOffsets);
+    w.WriteVector(level._edgeFaceIndices);
+    w.WriteVector(level._edgeSharpness);
+    w.WriteVector(level._edgeTags);
+
+    w.WriteVector(level._vertFaceOffsets);
+    w.WriteVector(level._vertFaceIndices);
+    w.WriteVector(level._vertFaceLocalIndices);
+    w.WriteVector(level._vertEdgeOffsets);
+    w.WriteVector(level._vertEdgeIndices);
+    w.WriteVector(level._vertEdgeLocalIndices);
+    w.WriteVector(level._vertSharpness);
+    w.WriteVector(level._vertTags);
+
+    w.WriteInt((int)level._fvarChannels.size());
+    for (int channel = 0; channel < (int)level._fvarChannels.size(); ++channel) {
+        Vtr::FVarLevel const & fvar = *level._fvarChannels[channel];
+
+        w.WriteInt((int)fvar._options.GetVtxBoundaryInterpolation());
+        w.WriteInt((int)fvar._options.GetFVarLinearInterpolation());
+        w.WriteInt((int)fvar._options.GetCreasingMethod());
+        w.WriteInt((int)fvar._options.GetTriangleSubdivision());
+
+        w.WriteInt(fvar._isLinear);
+        w.WriteInt(fvar._hasSmoothBoundaries);
+        w.WriteInt(fvar._hasDependentSharpness);
+        w.WriteInt(fvar._valueCount);
+
+        w.WriteVector(fvar._faceVertValues);
+        w.WriteVector(fvar._edgeTags);
+        w.WriteVector(fvar._vertSiblingCounts);
+        w.WriteVector(fvar._vertSiblingOffsets);
+        w.WriteVector(fvar._vertFaceSiblings);
+        w.WriteVector(fvar._vertValueIndices);
+        w.WriteVector(fvar._vertValueTags);
+        w.WriteVector(fvar._vertValueCreaseEnds);
+    }
+}
+
+void
+TopologyRefinerCache::readLevel(Reader & r, Vtr::Level & level) {
+
+    level._faceCount       = r.ReadInt();
+    level._edgeCount       = r.ReadInt();
+    level._vertCount       = r.ReadInt();
+    level._depth           = r.ReadInt();
+    level._maxEdgeFaces    = r.ReadInt();
+    level._maxValence      = r.ReadInt();
+    level._uniformFaceSize = r.ReadInt();
+
+    r.ReadVector(level._faceVertOffsets);
+    r.ReadVector(level._faceVertIndices);
+    r.ReadVector(level._faceEdgeIndices);
+    r.ReadVector(level._faceTags);
+
+    r.ReadVector(level._edgeVertIndices);
+    r.ReadVector(level._edgeFaceOffsets);
+    r.ReadVector(level._edgeFaceIndices);
+    r.ReadVector(level._edgeSharpness);
+    r.ReadVector(level._edgeTags);
+
+    r.ReadVector(level._vertFaceOffsets);
+    r.ReadVector(level._vertFaceIndices);
+    r.ReadVector(level._vertFaceLocalIndices);
+    r.ReadVector(level._vertEdgeOffsets);
+    r.ReadVector(level._vertEdgeIndices);
+    r.ReadVector(level._vertEdgeLocalIndices);
+    r.ReadVector(level._vertSharpness);
+    r.ReadVector(level._vertTags);
+
+    int numChannels = r.ReadInt();
+    for (int channel = 0; r.IsValid() and (channel < numChannels); ++channel) {
+        Vtr::FVarLevel * fvar = new Vtr::FVarLevel(level);
+        level._fvarChannels.push_back(fvar);
+
+        Sdc::Options options;
+        options.SetVtxBoundaryInterpolation((Sdc::Options::VtxBoundaryInterpolation)r.ReadInt());
+        options.SetFVarLinearInterpolation((Sdc::Options::FVarLinearInterpolation)r.ReadInt());
+        options.SetCreasingMethod((Sdc::Options::CreasingMethod)r.ReadInt());
+        options.SetTriangleSubdivision((Sdc::Options::TriangleSubdivision)r.ReadInt());
+        fvar->setOptions(options);
+
+        fvar->_isLinear              = r.ReadBool();
+        fvar->_hasSmoothBoundaries   = r.ReadBool();
+        fvar->_hasDependentSharpness = r.ReadBool();
+        fvar->_valueCount            = r.ReadInt();
+
+        r.ReadVector(fvar->_faceVertValues);
+        r.ReadVector(fvar->_edgeTags);
+        r.ReadVector(fvar->_vertSiblingCounts);
+        r.ReadVector(fvar->_vertSiblingOffsets);
+        r.ReadVector(fvar->_vertFaceSiblings);
+        r.ReadVector(fvar->_vertValueIndices);
+        r.ReadVector(fvar->_vertValueTags);
+        r.ReadVector(fvar->_vertValueCreaseEnds);
+    }
+}
+
+void
+TopologyRefinerCache::writeRefinement(Writer & w, Vtr::Refinement const & refinement) {
+
+    w.WriteInt(refinement._uniform);
+    w.WriteInt(refinement._parallel);
+
+    w.WriteInt(refinement._childFaceFromFaceCount);
+    w.WriteInt(refinement._childEdgeFromFaceCount);
+    w.WriteInt(refinement._childEdgeFromEdgeCount);
+    w.WriteInt(refinement._childVertFromFaceCount);
+    w.WriteInt(refinement._childVertFromEdgeCount);
+    w.WriteInt(refinement._childVertFromVertCount);
+
+    w.WriteInt(refinement._firstChildFaceFromFace);
+    w.WriteInt(refinement._firstChildEdgeFromFace);
+    w.WriteInt(refinement._firstChildEdgeFromEdge);
+    w.WriteInt(refinement._firstChildVertFromFace);
+    w.WriteInt(refinement._firstChildVertFromEdge);
+    w.WriteInt(refinement._firstChildVertFromVert);
+
+    w.WriteInt(refinement._faceChildFaceStride);
+    w.WriteInt(refinement._faceChildEdgeStride);
+
+    w.WriteVector(refinement._faceChildFaceIndices);
+    w.WriteVector(refinement._faceChildEdgeIndices);
+    w.WriteVector(refinement._faceChildVertIndex);
+    w.WriteVector(refinement._edgeChildEdgeIndices);
+    w.WriteVector(refinement._edgeChildVertIndex);
+    w.WriteVector(refinement._vertChildVertIndex);
+
+    w.WriteVector(refinement._childFaceParentIndex);
+    w.WriteVector(refinement._childEdgeParentIndex);
+    w.WriteVector(refinement._childVertexParentIndex);
+
+    w.WriteVector(refinement._childFaceTag);
+    w.WriteVector(refinement._childEdgeTag);
+    w.WriteVector(refinement._childVertexTag);
+
+    w.WriteVector(refinement._parentFaceTag);
+    w.WriteVector(refinement._parentEdgeTag);
+    w.WriteVector(refinement._parentVertexTag);
+
+    w.WriteInt((int)refinement._fvarChannels.size());
+    for (int channel = 0; channel < (int)refinement._fvarChannels.size(); ++channel) {
+        w.WriteVector(refinement._fvarChannels[channel]->_childValueParentSource);
+    }
+}
+
+void
+TopologyRefinerCache::readRefinement(Reader & r, Vtr::Refinement & refinement) {
+
+    refinement._uniform  = r.ReadBool();
+    refinement._parallel = r.ReadBool();
+
+    refinement._childFaceFromFaceCount = r.ReadInt();
+    refinement._childEdgeFromFaceCount = r.ReadInt();
+    refinement._childEdgeFromEdgeCount = r.ReadInt();
+    refinement._childVertFromFaceCount = r.ReadInt();
+    refinement._childVertFromEdgeCount = r.ReadInt();
+    refinement._childVertFromVertCount = r.ReadInt();
+
+    refinement._firstChildFaceFromFace = r.ReadInt();
+    refinement._firstChildEdgeFromFace = r.ReadInt();
+    refinement._firstChildEdgeFromEdge = r.ReadInt();
+    refinement._firstChildVertFromFace = r.ReadInt();
+    refinement._firstChildVertFromEdge = r.ReadInt();
+    refinement._firstChildVertFromVert = r.ReadInt();
+
+    refinement._faceChildFaceStride = r.ReadInt();
+    refinement._faceChildEdgeStride = r.ReadInt();
+
+    r.ReadVector(refinement._faceChildFaceIndices);
+    r.ReadVector(refinement._faceChildEdgeIndices);
+    r.ReadVector(refinement._faceChildVertIndex);
+    r.ReadVector(refinement._edgeChildEdgeIndices);
+    r.ReadVector(refinement._edgeChildVertIndex);
+    r.ReadVector(refinement._vertChildVertIndex);
+
+    r.ReadVector(refinement._childFaceParentIndex);
+    r.ReadVector(refinement._childEdgeParentIndex);
+    r.ReadVector(refinement._childVertexParentIndex);
+
+    r.ReadVector(refinement._childFaceTag);
+    r.ReadVector(refinement._childEdgeTag);
+    r.ReadVector(refinement._childVertexTag);
+
+    r.ReadVector(refinement._parentFaceTag);
+    r.ReadVector(refinement._parentEdgeTag);
+    r.ReadVector(refinement._parentVertexTag);
+
+    //  Offsets of the child faces and edges of faces are shared with the parent
+    //  when not implied by a fixed stride (see the allocation of the subclasses):
+    Vtr::Level const & parent = *refinement._parent;
+    if (not (refinement._faceChildFaceStride and refinement._faceChildEdgeStride)) {
+        if (parent._faceVertOffsets.empty()) {
+            r.Invalidate();
+            return;
+        }
+        if (not refinement._faceChildFaceStride) {
+            refinement._faceChildFaceOffsets = parent.shareFaceVertOffsets();
+        }
+        if (not refinement._faceChildEdgeStride) {
+            refinement._faceChildEdgeOffsets = parent.shareFaceVertOffsets();
+        }
+    }
+
+    Vtr::Level & child = *refinement._child;
+
+    int numChannels = r.ReadInt();
+    if ((numChannels != parent.getNumFVarChannels()) or
+        (numChannels != child.getNumFVarChannels())) {
+        r.Invalidate();
+        return;
+    }
+    for (int channel = 0; r.IsValid() and (channel < numChannels); ++channel) {
+        Vtr::FVarRefinement * fvarRefinement = new Vtr::FVarRefinement(refinement,
+            *parent._fvarChannels[channel], *child._fvarChannels[channel]);
+        refinement._fvarChannels.push_back(fvarRefinement);
+
+        r.ReadVector(fvarRefinement->_childValueParentSource);
+    }
+}
+
+void
+TopologyRefinerCache::Serialize(TopologyRefiner const & refiner,
+    std::string const & key, std::vector<char> & data) {
+
+    data.clear();
+
+    Writer w(data);
+
+    w.WriteBytes(STORAGE_MAGIC, sizeof(STORAGE_MAGIC));
+    w.WriteInt(STORAGE_VERSION);
+    w.WriteInt(STORAGE_BYTEORDER);
+    w.WriteVector(std::vector<char>(key.begin(), key.end()));
+
+    int numLevels = (int)refiner._levels.size();
+
+    w.WriteInt(refiner._isUniform);
+    w.WriteInt(refiner._hasHoles);
+    w.WriteInt(refiner._useSingleCreasePatch);
+    w.WriteInt(refiner._considerFVarChannels);
+    w.WriteInt(refiner._maxLevel);
+    w.WriteInt(numLevels);
+    w.WriteVector(refiner._ptexIndices);
+
+    //  Refinements discarded by streaming refinement are recorded as absent:
+    std::vector<int> hasRefinement(numLevels - 1);
+    for (int i = 0; i < numLevels - 1; ++i) {
+        hasRefinement[i] = (refiner._refinements[i] != 0);
+    }
+    w.WriteVector(hasRefinement);
+
+    for (int i = 0; i < numLevels; ++i) {
+        writeLevel(w, *refiner._levels[i]);
+    }
+    for (int i = 0; i < numLevels - 1; ++i) {
+        if (hasRefinement[i]) {
+            writeRefinement(w, *refiner._refinements[i]);
+        }
+    }
+}
+
+bool
+TopologyRefinerCache::Deserialize(TopologyRefiner & refiner,
+    std::string const & key, void const * data, size_t size) {
+
+    Reader r(static_cast<char const *>(data), size);
+
+    char magic[sizeof(STORAGE_MAGIC)];
+    r.ReadBytes(magic, sizeof(STORAGE_MAGIC));
+
+    int version   = r.ReadInt();
+    int byteOrder = r.ReadInt();
+
+    std::vector<char> storedKey;
+    r.ReadVector(storedKey);
+
+    if (not r.IsValid() or
+        std::memcmp(magic, STORAGE_MAGIC, sizeof(STORAGE_MAGIC)) or
+        (version != STORAGE_VERSION) or (byteOrder != STORAGE_BYTEORDER) or
+        (std::string(storedKey.begin(), storedKey.end()) != key)) {
+        return false;
+    }
+
+    bool isUniform            = r.ReadBool();
+    bool hasHoles             = r.ReadBool();
+    bool useSingleCreasePatch = r.ReadBool();
+    bool considerFVarChannels = r.ReadBool();
+    int  maxLevel             = r.ReadInt();
+    int  numLevels            = r.ReadInt();
+
+    std::vector<Index> ptexIndices;
+    r.ReadVector(ptexIndices);
+
+    std::vector<int> hasRefinement;
+    r.ReadVector(hasRefinement);
+
+    if (not r.IsValid() or (numLevels < 1) or (numLevels > 16) or (maxLevel > 15) or
+        ((int)hasRefinement.size() != numLevels - 1)) {
+        return false;
+    }
+
+    //
+    //  Restore into new levels and refinements -- assigned to the refiner only when all
+    //  have been successfully read.  Refinements are constructed between levels that are
+    //  still empty (as on refinement) and so before the levels are read:
+    //
+    std::vector<Vtr::Level *>      levels(numLevels);
+    std::vector<Vtr::Refinement *> refinements(numLevels - 1, (Vtr::Refinement *)0);
+
+    for (int i = 0; i < numLevels; ++i) {
+        levels[i] = new Vtr::Level;
+    }
+    for (int i = 0; i < numLevels - 1; ++i) {
+        if (hasRefinement[i]) {
+            if (refiner._subdivType == Sdc::SCHEME_LOOP) {
+                refinements[i] = new Vtr::TriRefinement(*levels[i], *levels[i+1], refiner._subdivOptions);
+            } else {
+                refinements[i] = new Vtr::QuadRefinement(*levels[i], *levels[i+1], refiner._subdivOptions);
+            }
+        }
+    }
+
+    for (int i = 0; r.IsValid() and (i < numLevels); ++i) {
+        readLevel(r, *levels[i]);
+    }
+    for (int i = 0; r.IsValid() and (i < numLevels - 1); ++i) {
+        if (refinements[i]) {
+            readRefinement(r, *refinements[i]);
+        }
+    }
+
+    if (not r.IsValid()) {
+        for (int i = 0; i < (int)levels.size(); ++i) {
+            delete levels[i];
+        }
+        for (int i = 0; i < (int)refinements.size(); ++i) {
+            delete refinements[i];
+        }
+        return false;
+    }
+
+    refiner.Unrefine();
+    delete refiner._levels[0];
+
+    refiner._levels.swap(levels);
+    refiner._refinements.swap(refinements);
+    refiner._ptexIndices.swap(ptexIndices);
+
+    refiner._isUniform            = isUniform;
+    refiner._hasHoles             = hasHoles;
+    refiner._useSingleCreasePatch = useSingleCreasePatch;
+    refiner._considerFVarChannels = considerFVarChannels;
+    refiner._maxLevel             = maxLevel;
+    return true;
+}
+
+bool
+TopologyRefinerCache::Save(TopologyRefiner const & refiner,
+    std::string const & key, char const * filename) {
+
+    std::vector<char> data;
+    Serialize(refiner, key, data);
+
+    FILE * fp = fopen(filename, "wb");
+    if (not fp) {
+        Warning("TopologyRefinerCache cannot open \"%s\" for writing", filename);
+        return false;
+    }
+    bool written = (fwrite(&data[0], 1, data.size(), fp) == data.size());
+    written = (fclose(fp) == 0) and written;
+
+    if (not written) {
+        Warning("TopologyRefinerCache failed writing \"%s\"", filename);
+        remove(filename);
+    }
+    return written;
+}
+
+bool
+TopologyRefinerCache::Load(TopologyRefiner & refiner,
+    std::string const & key, char const * filename) {
+
+    //  A missing file is an expected cache miss and so is not reported:
+    FILE * fp = fopen(filename, "rb");
+    if (not fp) {
+        return false;
+    }
+
+    std::vector<char> data;
+    if (fseek(fp, 0, SEEK_END) == 0) {
+        long size = ftell(fp);
+        if ((size > 0) and (fseek(fp, 0, SEEK_SET) == 0)) {
+            data.resize((size_t)size);
+            if (fread(&data[0], 1, data.size(), fp) != data.size()) {
+                data.clear();
+            }
+        }
+    }
+    fclose(fp);
+
+    return not data.empty() and Deserialize(refiner, key, &data[0], data.size());
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,176 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef FAR_TOPOLOGY_REFINER_CACHE_H
+#define FAR_TOPOLOGY_REFINER_CACHE_H
+
+#include "../version.h"
+
+#include "../far/topologyRefiner.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Vtr {
+    class Level;
+    class Refinement;
+}
+
+namespace Far {
+
+/// \brief Persistent storage of the refined topology of a TopologyRefiner
+///
+/// The complete state of a refined TopologyRefiner -- the topology and tags of
+/// all levels, the parent-child mappings of all refinements and all of their
+/// face-varying channels -- is saved in a binary form from which it is loaded
+/// again without any refinement.
+///
+/// The stored state is identified by a key computed from the base level of a
+/// refiner (its topology, sharpness, holes and face-varying values, along with
+/// the scheme and its options) and the options of its refinement.  A client
+/// creates the base level as usual with a TopologyRefinerFactory, computes the
+/// key and attempts to load the refined state before resorting to refinement:
+///
+/// \code
+///     TopologyRefiner::UniformOptions options(level);
+///
+///     std::string key = TopologyRefinerCache::ComputeKey(*refiner, options);
+///     if (not TopologyRefinerCache::Load(*refiner, key, filename)) {
+///         refiner->RefineUniform(options);
+///         TopologyRefinerCache::Save(*refiner, key, filename);
+///     }
+/// \endcode
+///
+/// The stored data is a header followed by a flat sequence of arrays that are
+/// copied into the restored refiner, whether read from a file with Load() or
+/// from memory with Deserialize().  The data is specific to the platform and
+/// version that stored it -- a mismatch in either results in a failure to load
+/// (and so a refinement to be stored again).
+///
+class TopologyRefinerCache {
+
+public:
+
+    /// \brief Returns the key of a refiner to be refined uniformly
+    ///
+    /// @param refiner  TopologyRefiner with the base level of the mesh
+    ///
+    /// @param options  Options of the uniform refinement
+    ///
+    static std::string ComputeKey(TopologyRefiner const & refiner,
+        TopologyRefiner::UniformOptions options);
+
+    /// \brief Returns the key of a refiner to be refined adaptively
+    ///
+    /// @param refiner  TopologyRefiner with the base level of the mesh
+    ///
+    /// @param options  Options of the adaptive refinement
+    ///
+    static std::string ComputeKey(TopologyRefiner const & refiner,
+        TopologyRefiner::AdaptiveOptions options);
+
+    /// \brief Stores the state of a refined TopologyRefiner in a file
+    ///
+    /// @param refiner   The refined TopologyRefiner
+    ///
+    /// @param key       Key computed from the refiner prior to its refinement
+    ///
+    /// @param filename  Path of the file to write
+    ///
+    /// @return          false if the file could not be written
+    ///
+    static bool Save(TopologyRefiner const & refiner, std::string const & key,
+        char const * filename);
+
+    /// \brief Restores the state of a TopologyRefiner from a file
+    ///
+    /// All levels of the refiner (including its base level) are replaced with
+    /// those stored.  The refiner is left unchanged when the file is missing,
+    /// was stored with a different key, or is otherwise incompatible.
+    ///
+    /// @param refiner   The TopologyRefiner to restore
+    ///
+    /// @param key       Key computed from the unrefined refiner
+    ///
+    /// @param filename  Path of the file to read
+    ///
+    /// @return          true if the refiner was restored
+    ///
+    static bool Load(TopologyRefiner & refiner, std::string const & key,
+        char const * filename);
+
+    /// \brief Stores the state of a refined TopologyRefiner in memory
+    ///
+    /// @param refiner  The refined TopologyRefiner
+    ///
+    /// @param key      Key computed from the refiner prior to its refinement
+    ///
+    /// @param data     Vector populated with the stored data
+    ///
+    static void Serialize(TopologyRefiner const & refiner, std::string const & key,
+        std::vector<char> & data);
+
+    /// \brief Restores the state of a TopologyRefiner from memory
+    ///
+    /// @param refiner  The TopologyRefiner to restore (see Load())
+    ///
+    /// @param key      Key computed from the unrefined refiner
+    ///
+    /// @param data     The stored data
+    ///
+    /// @param size     The size of the stored data in bytes
+    ///
+    /// @return         true if the refiner was restored
+    ///
+    static bool Deserialize(TopologyRefiner & refiner, std::string const & key,
+        void const * data, size_t size);
+
+private:
+
+    class Writer;
+    class Reader;
+
+    static std::string computeKey(TopologyRefiner const & refiner,
+        std::vector<int> const & options);
+
+    static void writeLevel(Writer & w, Vtr::Level const & level);
+    static void readLevel(Reader & r, Vtr::Level & level);
+
+    static void writeRefinement(Writer & w, Vtr::Refinement const & refinement);
+    static void readRefinement(Reader & r, Vtr::Refinement & refinement);
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // FAR_TOPOLOGY_REFINER_CACHE_H
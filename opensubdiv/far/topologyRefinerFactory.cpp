@@ -83,13 +83,14 @@ TopologyRefinerFactoryBase::prepareComponentTopologySizing(TopologyRefiner& refi
 
 bool
 TopologyRefinerFactoryBase::prepareComponentTopologyAssignment(TopologyRefiner& refiner, bool fullValidation,
-                                                               TopologyCallback callback, void const * callbackData) {
+                                                               TopologyCallback callback, void const * callbackData,
+                                                               bool parallelCompletion) {
 
     Vtr::Level& baseLevel = refiner.getLevel(0);
 
     bool completeMissingTopology = (baseLevel.getNumEdges() == 0);
     if (completeMissingTopology) {
-        baseLevel.completeTopologyFromFaceVertices();
+        baseLevel.completeTopologyFromFaceVertices(parallelCompletion);
     }
 
     bool valid = true;
@@ -134,7 +135,7 @@ TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& re
         Vtr::Level::ETag& eTag       = baseLevel._edgeTags[eIndex];
         float&          eSharpness = baseLevel._edgeSharpness[eIndex];
 
-        eTag._boundary = (baseLevel._edgeFaceCountsAndOffsets[eIndex*2 + 0] < 2);
+        eTag._boundary = (baseLevel.getNumEdgeFaces(eIndex) < 2);
         if (eTag._boundary || (eTag._nonManifold && sharpenNonManFeatures)) {
             eSharpness = Sdc::Crease::SHARPNESS_INFINITE;
         }
@@ -290,7 +291,7 @@ TopologyRefinerFactory<TopologyRefinerFactoryBase::TopologyDescriptor>::assignCo
 
             int idx = desc.cornerVertexIndices[vert];
 
-            if (idx > 0 and idx < refiner.GetNumVertices(0)) {
+            if (idx >= 0 and idx < refiner.GetNumVertices(0)) {
                 refiner.setBaseVertexSharpness(idx, desc.cornerWeights[vert]);
             } else {
                 char msg[1024];
@@ -28,6 +28,7 @@
 
 #include "../far/topologyRefiner.h"
 #include "../far/error.h"
+#include "../vtr/stopwatch.h"
 
 #include <cassert>
 
@@ -99,9 +100,13 @@ protected:
     //
     typedef Vtr::Level::ValidationCallback TopologyCallback;
 
+    //  Tags and sharpness of the base level are prepared again on sharpness updates:
+    friend class TopologyRefiner;
+
     static bool prepareComponentTopologySizing(TopologyRefiner& refiner);
     static bool prepareComponentTopologyAssignment(TopologyRefiner& refiner, bool fullValidation,
-                                                   TopologyCallback callback, void const * callbackData);
+                                                   TopologyCallback callback, void const * callbackData,
+                                                   bool parallelCompletion = false);
     static bool prepareComponentTagsAndSharpness(TopologyRefiner& refiner);
     static bool prepareFaceVaryingChannels(TopologyRefiner& refiner);
 };
@@ -130,7 +135,9 @@ public:
         Options(Sdc::SchemeType sdcType = Sdc::SCHEME_CATMARK, Sdc::Options sdcOptions = Sdc::Options()) :
             schemeType(sdcType),
             schemeOptions(sdcOptions),
-            validateFullTopology(false) { }
+            validateFullTopology(false),
+            parallelTopology(false),
+            recordStatistics(false) { }
 
         Sdc::SchemeType schemeType;             ///< The subdivision scheme type identifier
         Sdc::Options    schemeOptions;          ///< The full set of options for the scheme,
@@ -138,6 +145,11 @@ public:
         unsigned int validateFullTopology : 1;  ///< Apply more extensive validation of
                                                 ///< the constructed topology -- intended
                                                 ///< for debugging.
+        unsigned int parallelTopology : 1;      ///< Complete the topology missing from
+                                                ///< the face-vertices (edges and incident
+                                                ///< components) in parallel
+        unsigned int recordStatistics : 1;      ///< Time the stages of construction (see
+                                                ///< TopologyRefiner::GetStatistics())
     };
 
     /// \brief Instantiates TopologyRefiner from client-provided topological
@@ -216,6 +228,12 @@ TopologyRefinerFactory<MESH>::populateBaseLevel(TopologyRefiner& refiner, MESH c
     //  Both the specialized methods and those that follow them may find fault in the
     //  construction and trigger failure at any time:
     //
+    //  The time spent in each step is optionally recorded in the refiner:
+    //
+    typedef TopologyRefiner::Statistics Statistics;
+
+    bool           timeStages = options.recordStatistics;
+    Vtr::Stopwatch stageTimer;
 
     //
     //  Sizing of the topology -- this is a required specialization for MESH.  This defines
@@ -225,17 +243,22 @@ TopologyRefinerFactory<MESH>::populateBaseLevel(TopologyRefiner& refiner, MESH c
     if (not resizeComponentTopology(refiner, mesh)) return false;
     if (not prepareComponentTopologySizing(refiner)) return false;
 
+    if (timeStages) refiner._factoryTimes[Statistics::FACTORY_TOPOLOGY_SIZING] = stageTimer.lap();
+
     //
     //  Assignment of the topology -- this is a required specialization for MESH.  If edges
     //  are specified, all other topological relations are expected to be defined for them.
     //  Otherwise edges and remaining topology will be completed from the face-vertices:
     //
     bool             validate = options.validateFullTopology;
+    bool             parallel = options.parallelTopology;
     TopologyCallback callback = reinterpret_cast<TopologyCallback>(reportInvalidTopology);
     void const *     userData = &mesh;
         
     if (not assignComponentTopology(refiner, mesh)) return false;
-    if (not prepareComponentTopologyAssignment(refiner, validate, callback, userData)) return false;
+    if (not prepareComponentTopologyAssignment(refiner, validate, callback, userData, parallel)) return false;
+
+    if (timeStages) refiner._factoryTimes[Statistics::FACTORY_TOPOLOGY_ASSIGNMENT] = stageTimer.lap();
 
     //
     //  User assigned and internal tagging of components -- an optional specialization for
@@ -244,12 +267,16 @@ TopologyRefinerFactory<MESH>::populateBaseLevel(TopologyRefiner& refiner, MESH c
     if (not assignComponentTags(refiner, mesh)) return false;
     if (not prepareComponentTagsAndSharpness(refiner)) return false;
 
+    if (timeStages) refiner._factoryTimes[Statistics::FACTORY_TAGS_AND_SHARPNESS] = stageTimer.lap();
+
     //
     //  Defining channels of face-varying primvar data -- an optional specialization for MESH.
     //
     if (not assignFaceVaryingTopology(refiner, mesh)) return false;
     if (not prepareFaceVaryingChannels(refiner)) return false;
 
+    if (timeStages) refiner._factoryTimes[Statistics::FACTORY_FVAR_CHANNELS] = stageTimer.lap();
+
     return true;
 }
 
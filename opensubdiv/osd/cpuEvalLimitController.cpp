@@ -26,6 +26,10 @@
 #include "../osd/cpuEvalLimitContext.h"
 #include "../osd/cpuEvalLimitKernel.h"
 #include "../far/patchTables.h"
+#include "../far/patchBVH.h"
+#include "../far/bezierPatchCache.h"
+
+#include <cmath>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -45,6 +49,135 @@ computeSubPatchCoords(Far::PatchParam pparam, float & u, float & v ) {
     pparam.bitField.Rotate(u, v);
 }
 
+// Evaluates the vertex data of a patch at the normalized (s,t) location
+static void
+evalVertexPatch( Far::PatchTables const & ptables,
+                 Far::PatchTables::PatchHandle const & handle,
+                 Far::PatchParam const & pparam,
+                 float s, float t,
+                 Far::BezierPatchCache const * bezierPatches,
+                 VertexBufferDescriptor const & inDesc,
+                 float const * in,
+                 VertexBufferDescriptor const & outDesc,
+                 float * outQ,
+                 float * outDQU,
+                 float * outDQV ) {
+
+    typedef Far::PatchDescriptor Desc;
+
+    if (bezierPatches and bezierPatches->HasPatch(handle) and
+        inDesc.length <= bezierPatches->GetLength()) {
+
+        VertexBufferDescriptor bezierDesc(0, inDesc.length, bezierPatches->GetLength());
+
+        evalBezier( pparam.bitField, s, t,
+                    bezierDesc,
+                    bezierPatches->GetPatchPoints(handle),
+                    outDesc,
+                    outQ, outDQU, outDQV );
+        return;
+    }
+
+    Far::Index buffer[Far::PatchTables::MAX_PATCH_VERTICES];
+    Far::ConstIndexArray cvs = ptables.GetPatchVertices(handle, buffer);
+
+    Far::PatchDescriptor desc = ptables.GetPatchDescriptor(handle);
+    switch (desc.GetType()) {
+        case Desc::REGULAR  : evalBSpline( pparam.bitField, s, t, cvs.begin(),
+                                           inDesc, in, outDesc,
+                                           outQ, outDQU, outDQV );
+                              break;
+        case Desc::BOUNDARY : evalBoundary( pparam.bitField, s, t, cvs.begin(),
+                                            inDesc, in, outDesc,
+                                            outQ, outDQU, outDQV );
+                              break;
+        case Desc::CORNER   : evalCorner( pparam.bitField, s, t, cvs.begin(),
+                                          inDesc, in, outDesc,
+                                          outQ, outDQU, outDQV );
+                              break;
+        case Desc::GREGORY  : evalGregory( pparam.bitField, t, s, cvs.begin(),
+                                           &ptables.GetVertexValenceTable()[0],
+                                           ptables.GetPatchQuadOffsets(handle).begin(),
+                                           ptables.GetMaxValence(),
+                                           inDesc, in, outDesc,
+                                           outQ, outDQU, outDQV );
+                              break;
+        case Desc::GREGORY_BOUNDARY : evalGregoryBoundary( pparam.bitField, t, s, cvs.begin(),
+                                                           &ptables.GetVertexValenceTable()[0],
+                                                           ptables.GetPatchQuadOffsets(handle).begin(),
+                                                           ptables.GetMaxValence(),
+                                                           inDesc, in, outDesc,
+                                                           outQ, outDQU, outDQV );
+                                      break;
+        case Desc::GREGORY_BASIS : {
+                                       Far::StencilTables const * stencils =
+                                           ptables.GetEndCapStencilTables();
+                                       assert(stencils and stencils->GetNumStencils()>0);
+                                       evalGregoryBasis( pparam.bitField, s, t,
+                                                         *stencils,
+                                                         ptables.GetEndCapStencilIndex(handle),
+                                                         inDesc, in, outDesc,
+                                                         outQ, outDQU, outDQV );
+                                   } break;
+        case Desc::LOOP     : evalLoop( pparam.bitField, s, t, cvs.begin(),
+                                        inDesc, in, outDesc,
+                                        outQ, outDQU, outDQV );
+                              break;
+        case Desc::LOOP_BASIS : {
+                                    Far::StencilTables const * stencils =
+                                        ptables.GetEndCapStencilTables();
+                                    assert(stencils and stencils->GetNumStencils()>0);
+                                    evalLoopBasis( pparam.bitField, s, t,
+                                                   *stencils,
+                                                   ptables.GetEndCapStencilIndex(handle),
+                                                   inDesc, in, outDesc,
+                                                   outQ, outDQU, outDQV );
+                                } break;
+        default:
+            assert(0);
+    }
+}
+
+// Evaluates the face-varying data of a patch at the normalized (s,t) location
+static void
+evalFacevaryingPatch( Far::PatchTables const & ptables,
+                      Far::PatchTables::PatchHandle const & handle,
+                      Far::PatchParam const & pparam,
+                      float s, float t,
+                      int channel,
+                      VertexBufferDescriptor const & inDesc,
+                      float const * in,
+                      VertexBufferDescriptor const & outDesc,
+                      float * outQ ) {
+
+    typedef Far::PatchDescriptor Desc;
+
+    assert(ptables.GetFVarPatchTables());
+
+    Far::ConstIndexArray values = ptables.GetFVarPatchValues(handle, channel);
+
+    switch (ptables.GetFVarPatchType(handle, channel)) {
+        case Desc::REGULAR  : evalBSpline( pparam.bitField, s, t, values.begin(),
+                                           inDesc, in, outDesc, outQ, 0, 0 );
+                              break;
+        case Desc::BOUNDARY : evalBoundary( pparam.bitField, s, t, values.begin(),
+                                            inDesc, in, outDesc, outQ, 0, 0 );
+                              break;
+        case Desc::CORNER   : evalCorner( pparam.bitField, s, t, values.begin(),
+                                          inDesc, in, outDesc, outQ, 0, 0 );
+                              break;
+        case Desc::QUADS    : pparam.bitField.Rotate(s, t);
+                              evalBilinear( t, s, values.begin(),
+                                            inDesc, in, outDesc, outQ );
+                              break;
+        case Desc::TRIANGLES : evalLinear( pparam.bitField, s, t, values.begin(),
+                                           inDesc, in, outDesc, outQ );
+                               break;
+        default:
+            assert(0);
+    }
+}
+
 // Vertex interpolation of a sample at the limit
 int
 CpuEvalLimitController::EvalLimitSample( LimitLocation const & coord,
@@ -53,7 +186,6 @@ CpuEvalLimitController::EvalLimitSample( LimitLocation const & coord,
                                          float * outQ,
                                          float * outDQU,
                                          float * outDQV ) const {
-    typedef Far::PatchDescriptor Desc;
 
     float s=coord.s,
           t=coord.t;
@@ -72,63 +204,13 @@ CpuEvalLimitController::EvalLimitSample( LimitLocation const & coord,
         Far::PatchParam pparam = ptables.GetPatchParam(*handle);
         pparam.bitField.Normalize(s, t);
 
-        Far::ConstIndexArray cvs = ptables.GetPatchVertices(*handle);
-
-        Far::PatchDescriptor desc = ptables.GetPatchDescriptor(*handle);
-        switch (desc.GetType()) {
-            case Desc::REGULAR  : evalBSpline( pparam.bitField, s, t, cvs.begin(),
-                                               vertexData.inDesc,
-                                               vertexData.in,
-                                               outDesc,
-                                               outQ, outDQU, outDQV );
-                                  break;
-            case Desc::BOUNDARY : evalBoundary( pparam.bitField, s, t, cvs.begin(),
-                                                vertexData.inDesc,
-                                                vertexData.in,
-                                                outDesc,
-                                                outQ, outDQU, outDQV );
-                                  break;
-            case Desc::CORNER   : evalCorner( pparam.bitField, s, t, cvs.begin(),
-                                              vertexData.inDesc,
-                                              vertexData.in,
-                                              outDesc,
-                                              outQ, outDQU, outDQV );
-                                  break;
-            case Desc::GREGORY  : evalGregory( pparam.bitField, t, s, cvs.begin(),
-                                               &ptables.GetVertexValenceTable()[0],
-                                               ptables.GetPatchQuadOffsets(*handle).begin(),
-                                               ptables.GetMaxValence(),
-                                               vertexData.inDesc,
-                                               vertexData.in,
-                                               outDesc,
-                                               outQ, outDQU, outDQV );
-                                  break;
-            case Desc::GREGORY_BOUNDARY : evalGregoryBoundary( pparam.bitField, t, s, cvs.begin(),
-                                                               &ptables.GetVertexValenceTable()[0],
-                                                               ptables.GetPatchQuadOffsets(*handle).begin(),
-                                                               ptables.GetMaxValence(),
-                                                               vertexData.inDesc,
-                                                               vertexData.in,
-                                                               outDesc,
-                                                               outQ, outDQU, outDQV );
-                                          break;
-            case Desc::GREGORY_BASIS : {
-                                           Far::StencilTables const * stencils =
-                                               ptables.GetEndCapStencilTables();
-                                           assert(stencils and stencils->GetNumStencils()>0);
-                                           evalGregoryBasis( pparam.bitField, s, t,
-                                                             *stencils,
-                                                             ptables.GetEndCapStencilIndex(*handle),
-                                                             vertexData.inDesc,
-                                                             vertexData.in,
-                                                             vertexData.outDesc,
-                                                             outQ, outDQU, outDQV );
-                                       } break;
-            default:
-                assert(0);
-        }
+        evalVertexPatch( ptables, *handle, pparam, s, t,
+                         _currentBindState.bezierPatches,
+                         vertexData.inDesc,
+                         vertexData.in,
+                         outDesc,
+                         outQ, outDQU, outDQV );
     }
-    assert(0);
     return 1;
 }
 
@@ -156,7 +238,8 @@ CpuEvalLimitController::_EvalLimitSample( LimitLocation const & coords,
 
     Far::PatchDescriptor desc = ptables.GetPatchDescriptor(*handle);
 
-    Far::ConstIndexArray cvs = ptables.GetPatchVertices(*handle);
+    Far::Index buffer[Far::PatchTables::MAX_PATCH_VERTICES];
+    Far::ConstIndexArray cvs = ptables.GetPatchVertices(*handle, buffer);
 
     if (vertexData.in) {
 
@@ -171,66 +254,36 @@ CpuEvalLimitController::_EvalLimitSample( LimitLocation const & coords,
                   * outDu = vertexData.outDu ? vertexData.outDu+doffset : 0,
                   * outDv = vertexData.outDv ? vertexData.outDv+doffset : 0;
 
-            switch (desc.GetType()) {
-                case Desc::REGULAR  : evalBSpline( pparam.bitField, s, t, cvs.begin(),
-                                                   vertexData.inDesc,
-                                                   vertexData.in,
-                                                   vertexData.outDesc,
-                                                   out, outDu, outDv );
-                                      break;
-                case Desc::BOUNDARY : evalBoundary( pparam.bitField, s, t, cvs.begin(),
-                                                    vertexData.inDesc,
-                                                    vertexData.in,
-                                                    vertexData.outDesc,
-                                                    out, outDu, outDv );
-                                      break;
-                case Desc::CORNER   : evalCorner( pparam.bitField, s, t, cvs.begin(),
-                                                  vertexData.inDesc,
-                                                  vertexData.in,
-                                                  vertexData.outDesc,
-                                                  out, outDu, outDv );
-                                      break;
-                case Desc::GREGORY  : evalGregory( pparam.bitField, t, s, cvs.begin(),
-                                                   &ptables.GetVertexValenceTable()[0],
-                                                   ptables.GetPatchQuadOffsets(*handle).begin(),
-                                                   ptables.GetMaxValence(),
-                                                   vertexData.inDesc,
-                                                   vertexData.in,
-                                                   vertexData.outDesc,
-                                                   out, outDu, outDv );
-                                      break;
-                case Desc::GREGORY_BOUNDARY : evalGregoryBoundary( pparam.bitField, t, s, cvs.begin(),
-                                                                   &ptables.GetVertexValenceTable()[0],
-                                                                   ptables.GetPatchQuadOffsets(*handle).begin(),
-                                                                   ptables.GetMaxValence(),
-                                                                   vertexData.inDesc,
-                                                                   vertexData.in,
-                                                                   vertexData.outDesc,
-                                                                   out, outDu, outDv );
-                                              break;
-                case Desc::GREGORY_BASIS : {
-                                               Far::StencilTables const * stencils =
-                                                   ptables.GetEndCapStencilTables();
-                                               assert(stencils and stencils->GetNumStencils()>0);
-                                               evalGregoryBasis( pparam.bitField, s, t,
-                                                                 *stencils,
-                                                                 ptables.GetEndCapStencilIndex(*handle),
-                                                                 vertexData.inDesc,
-                                                                 vertexData.in,
-                                                                 vertexData.outDesc,
-                                                                 out, outDu, outDv );
-                                           } break;
-                default:
-                    assert(0);
-            }
+            evalVertexPatch( ptables, *handle, pparam, s, t,
+                             _currentBindState.bezierPatches,
+                             vertexData.inDesc,
+                             vertexData.in,
+                             vertexData.outDesc,
+                             out, outDu, outDv );
         }
     }
 
+    // normalized (un-rotated) coordinates for the face-varying patches
+    float ns = s,
+          nt = t;
+
     pparam.bitField.Rotate(s, t);
 
     VaryingData const & varyingData = _currentBindState.varyingData;
 
-    if (varyingData.in and varyingData.out) {
+    if (varyingData.in and varyingData.out and
+        (desc.GetType()==Desc::LOOP or desc.GetType()==Desc::LOOP_BASIS)) {
+
+        // the corners of the triangle are the first 3 vertices of the patch
+        int offset = varyingData.outDesc.stride * index;
+
+        evalLinear( pparam.bitField, ns, nt, cvs.begin(),
+                    varyingData.inDesc,
+                    varyingData.in,
+                    varyingData.outDesc,
+                    varyingData.out+offset);
+
+    } else if (varyingData.in and varyingData.out) {
 
         static int const zeroRings[6][4] = { {5, 6,10, 9},   // regular
                                              {1, 2, 6, 5},   // boundary / single-crease
@@ -265,26 +318,529 @@ CpuEvalLimitController::_EvalLimitSample( LimitLocation const & coords,
 
     }
 
-    // Note : currently we only support bilinear boundary interpolation rules
-    // for limit face-varying data.
-
     FacevaryingData const & facevaryingData = _currentBindState.facevaryingData;
 
     if (facevaryingData.in and facevaryingData.out) {
 
             int offset = facevaryingData.outDesc.stride * index;
 
-            static int const zeroRing[4] = {0,1,2,3};
+            if (facevaryingData.channel>=0) {
+
+                evalFacevaryingPatch( ptables, *handle, pparam, ns, nt,
+                                      facevaryingData.channel,
+                                      facevaryingData.inDesc,
+                                      facevaryingData.in,
+                                      facevaryingData.outDesc,
+                                      facevaryingData.out+offset );
+            } else {
+
+                static int const zeroRing[4] = {0,1,2,3};
+
+                // face-varying data is ordered with 4 CVs / patch
+                evalBilinear( s, t, zeroRing,
+                              facevaryingData.inDesc,
+                              &facevaryingData.in[handle->patchIndex*4*facevaryingData.outDesc.stride],
+                              facevaryingData.outDesc,
+                              facevaryingData.out+offset);
+            }
+    }
+    return 1;
+}
+
+//
+// Limit surface queries
+//
+// The Newton solvers below work in the normalized parametric space of each
+// patch candidate returned by the PatchBVH, with the Jacobian of the surface
+// given by the derivatives of the patch kernels.
+//
+namespace {
+
+    inline float dot(float const * a, float const * b) {
+        return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+    }
+
+    inline float clamp01(float x) {
+        return x<0.0f ? 0.0f : (x>1.0f ? 1.0f : x);
+    }
+
+    // Evaluates the positions of the patches of a PatchTables
+    class PatchSolver {
+    public:
+
+        typedef Far::PatchTables::PatchHandle Handle;
+
+        PatchSolver( Far::PatchTables const & ptables,
+                     Far::BezierPatchCache const * bezierPatches,
+                     VertexBufferDescriptor const & inDesc,
+                     float const * in ) :
+            _ptables(ptables),
+            _bezierPatches(bezierPatches),
+            _inDesc(inDesc.offset, 3, inDesc.stride),
+            _outDesc(0, 3, 3),
+            _in(in) { }
+
+        // position at (u,v)
+        void Eval(Handle const & handle, Far::PatchParam const & pparam,
+            float u, float v, float P[3]) const {
+            evalVertexPatch(_ptables, handle, pparam, u, v,
+                _bezierPatches, _inDesc, _in, _outDesc, P, 0, 0);
+        }
+
+        // position & partial derivatives at (u,v)
+        void Eval(Handle const & handle, Far::PatchParam const & pparam,
+            float u, float v, float P[3], float Pu[3], float Pv[3]) const {
+
+            float Ds[3], Dt[3];
+            evalVertexPatch(_ptables, handle, pparam, u, v,
+                _bezierPatches, _inDesc, _in, _outDesc, P, Ds, Dt);
+
+            // the kernels scale the derivatives to the level of the patch and
+            // the Gregory kernels are evaluated with swapped coordinates (see
+            // evalVertexPatch)
+            Far::PatchDescriptor::Type type =
+                _ptables.GetPatchDescriptor(handle).GetType();
+            bool swapped = type==Far::PatchDescriptor::GREGORY or
+                           type==Far::PatchDescriptor::GREGORY_BOUNDARY;
+
+            float scale = 1.0f / float(1 << pparam.bitField.GetDepth());
+            for (int k=0; k<3; ++k) {
+                Pu[k] = (swapped ? Dt[k] : Ds[k]) * scale;
+                Pv[k] = (swapped ? Ds[k] : Dt[k]) * scale;
+            }
+        }
+
+        // converts normalized patch coordinates to a ptex location
+        static LimitLocation GetLocation(Far::PatchParam const & pparam,
+            float u, float v) {
+
+            float frac = pparam.bitField.GetParamFraction();
+
+            LimitLocation location;
+            location.ptexIndex = pparam.faceIndex;
+            location.s = ((float)pparam.bitField.GetU() + u) * frac;
+            location.t = ((float)pparam.bitField.GetV() + v) * frac;
+            return location;
+        }
+
+        // true if the domain of the patch is a triangle (Loop patches) : the
+        // lower-left half of the unit square, or the upper-right half if the
+        // triangle is inverted (rotation 2)
+        bool IsTriangle(Handle const & handle) const {
+            Far::PatchDescriptor::Type type =
+                _ptables.GetPatchDescriptor(handle).GetType();
+            return type==Far::PatchDescriptor::LOOP or
+                   type==Far::PatchDescriptor::LOOP_BASIS;
+        }
+
+        // projects normalized patch coordinates onto the domain of the patch
+        static void Clamp(Far::PatchParam const & pparam, bool triangle,
+            float & u, float & v) {
+
+            u = clamp01(u);
+            v = clamp01(v);
+            if (triangle) {
+                float d = u+v-1.0f;
+                if (pparam.bitField.GetRotation()==2 ? d<0.0f : d>0.0f) {
+                    u -= 0.5f*d;
+                    v -= 0.5f*d;
+                }
+            }
+        }
+
+        // initial guesses of the solvers
+        static int GetNumSeeds() { return 5; }
+
+        static void GetSeed(Far::PatchParam const & pparam, bool triangle,
+            int i, float & u, float & v) {
+            static float const seeds[5][2] = { {0.50f, 0.50f},
+                                               {0.25f, 0.25f},
+                                               {0.75f, 0.25f},
+                                               {0.75f, 0.75f},
+                                               {0.25f, 0.75f} };
+            static float const triSeeds[5][2] = { {0.333f, 0.333f},
+                                                  {0.167f, 0.167f},
+                                                  {0.667f, 0.167f},
+                                                  {0.167f, 0.667f},
+                                                  {0.450f, 0.450f} };
+            if (triangle) {
+                u = triSeeds[i][0];
+                v = triSeeds[i][1];
+                if (pparam.bitField.GetRotation()==2) {
+                    u = 1.0f-u;
+                    v = 1.0f-v;
+                }
+            } else {
+                u = seeds[i][0];
+                v = seeds[i][1];
+            }
+        }
+
+    private:
+
+        Far::PatchTables const & _ptables;
+
+        Far::BezierPatchCache const * _bezierPatches;
+
+        VertexBufferDescriptor _inDesc,
+                               _outDesc;
+
+        float const * _in;
+    };
+
+    // Ray / patch intersection : the ray is represented as the intersection
+    // of 2 planes and the Newton iterations search for the (u,v) location
+    // that lies on both planes.
+    class RayVisitor {
+    public:
+
+        RayVisitor( PatchSolver const & solver,
+                    Far::PatchTables const & ptables,
+                    float const origin[3],
+                    float const direction[3] ) :
+            _solver(solver), _ptables(ptables), _found(false), _tHit(FLT_MAX) {
+
+            for (int k=0; k<3; ++k) {
+                _origin[k] = origin[k];
+                _direction[k] = direction[k];
+            }
+
+            // build 2 planes containing the ray
+            float const * d = direction;
+            if (fabsf(d[0]) > fabsf(d[1]) and fabsf(d[0]) > fabsf(d[2])) {
+                _n1[0] = d[1]; _n1[1] = -d[0]; _n1[2] = 0.0f;
+            } else {
+                _n1[0] = 0.0f; _n1[1] = d[2]; _n1[2] = -d[1];
+            }
+            _n2[0] = d[1]*_n1[2] - d[2]*_n1[1];
+            _n2[1] = d[2]*_n1[0] - d[0]*_n1[2];
+            _n2[2] = d[0]*_n1[1] - d[1]*_n1[0];
+
+            float l1 = sqrtf(dot(_n1, _n1)),
+                  l2 = sqrtf(dot(_n2, _n2));
+            for (int k=0; k<3; ++k) {
+                _n1[k] /= l1;
+                _n2[k] /= l2;
+            }
+            _d1 = -dot(_n1, origin);
+            _d2 = -dot(_n2, origin);
+        }
+
+        float operator() (PatchSolver::Handle const & handle, float tmax) {
+
+            Far::PatchParam pparam = _ptables.GetPatchParam(handle);
+
+            bool triangle = _solver.IsTriangle(handle);
+
+            static int const maxIterations = 16;
+            static float const epsilon = 1.0e-4f;
+
+            bool hitPatch = false;
+            for (int seed=0; seed<PatchSolver::GetNumSeeds() and not hitPatch; ++seed) {
+
+                float u, v, P[3], Pu[3], Pv[3];
+                PatchSolver::GetSeed(pparam, triangle, seed, u, v);
+
+                for (int i=0; i<maxIterations; ++i) {
+
+                    _solver.Eval(handle, pparam, u, v, P, Pu, Pv);
+
+                    float f1 = dot(_n1, P) + _d1,
+                          f2 = dot(_n2, P) + _d2;
+
+                    float j11 = dot(_n1, Pu), j12 = dot(_n1, Pv),
+                          j21 = dot(_n2, Pu), j22 = dot(_n2, Pv),
+                          det = j11*j22 - j12*j21;
+
+                    float scale = sqrtf(dot(Pu, Pu)) + sqrtf(dot(Pv, Pv));
+
+                    if (fabsf(f1)+fabsf(f2) <= epsilon*scale) {
+
+                        // converged : check that the hit is within the
+                        // domain of the patch and on the ray
+                        float dP[3] = { P[0]-_origin[0], P[1]-_origin[1], P[2]-_origin[2] },
+                              t = dot(dP, _direction) / dot(_direction, _direction);
+
+                        if (t>=0.0f and t<=tmax and t<_tHit) {
+                            hitPatch = _found = true;
+                            _tHit = t;
+                            _hit = PatchSolver::GetLocation(pparam, u, v);
+                        }
+                        break;
+                    }
+
+                    if (fabsf(det) <= FLT_MIN) {
+                        break;
+                    }
+
+                    float du = ( j22*f1 - j12*f2) / det,
+                          dv = (-j21*f1 + j11*f2) / det;
+
+                    // the iterations are clamped to the domain of the patch :
+                    // a root outside of it belongs to another patch
+                    float nu = u-du,
+                          nv = v-dv;
+                    PatchSolver::Clamp(pparam, triangle, nu, nv);
+                    if (nu==u and nv==v) {
+                        break;
+                    }
+                    u = nu;
+                    v = nv;
+                }
+            }
+            // note : only the first root found on a patch is retained
+            return hitPatch ? _tHit : tmax;
+        }
+
+        bool Found() const { return _found; }
+
+        float GetHitDistance() const { return _tHit; }
+
+        LimitLocation const & GetHit() const { return _hit; }
+
+    private:
+
+        PatchSolver const & _solver;
+        Far::PatchTables const & _ptables;
+
+        float _origin[3],
+              _direction[3],
+              _n1[3], _n2[3],
+              _d1, _d2;
+
+        bool _found;
+        float _tHit;
+        LimitLocation _hit;
+    };
+
+    // Closest point : Gauss-Newton minimization of the squared distance,
+    // projected onto the domain of the patch
+    class PointVisitor {
+    public:
+
+        PointVisitor( PatchSolver const & solver,
+                      Far::PatchTables const & ptables,
+                      float const point[3] ) :
+            _solver(solver), _ptables(ptables), _found(false), _distance(FLT_MAX) {
+
+            for (int k=0; k<3; ++k) {
+                _point[k] = point[k];
+            }
+        }
+
+        float operator() (PatchSolver::Handle const & handle, float maxDist) {
+
+            Far::PatchParam pparam = _ptables.GetPatchParam(handle);
+
+            bool triangle = _solver.IsTriangle(handle);
+
+            static int const maxIterations = 32;
+            static float const epsilon = 1.0e-5f;
+
+            for (int seed=0; seed<PatchSolver::GetNumSeeds(); ++seed) {
+
+                float u, v, P[3], Pu[3], Pv[3];
+                PatchSolver::GetSeed(pparam, triangle, seed, u, v);
+
+                for (int i=0; i<maxIterations; ++i) {
+
+                    _solver.Eval(handle, pparam, u, v, P, Pu, Pv);
+
+                    float r[3] = { P[0]-_point[0], P[1]-_point[1], P[2]-_point[2] };
+
+                    float g1 = dot(Pu, r),
+                          g2 = dot(Pv, r);
+
+                    float h11 = dot(Pu, Pu), h12 = dot(Pu, Pv), h22 = dot(Pv, Pv),
+                          det = h11*h22 - h12*h12;
+
+                    if (fabsf(det) <= FLT_MIN) {
+                        break;
+                    }
+
+                    float du = ( h22*g1 - h12*g2) / det,
+                          dv = (-h12*g1 + h11*g2) / det;
+
+                    float nu = u-du,
+                          nv = v-dv;
+
+                    // if the step leaves the domain of the patch, the
+                    // parameters are pinned to each boundary crossed in turn
+                    // and the other one is solved along the boundary curve
+                    // (along the (1,-1) direction for the diagonal edge of a
+                    // triangle) : the closest of these candidates is retained
+                    bool inverted = pparam.bitField.GetRotation()==2;
+
+                    float cu[3], cv[3];
+                    int ncandidates = 0;
+                    if (nu<0.0f or nu>1.0f) {
+                        cu[ncandidates] = clamp01(nu);
+                        cv[ncandidates] = v - g2/h22;
+                        ++ncandidates;
+                    }
+                    if (nv<0.0f or nv>1.0f) {
+                        cu[ncandidates] = u - g1/h11;
+                        cv[ncandidates] = clamp01(nv);
+                        ++ncandidates;
+                    }
+                    if (triangle and (inverted ? nu+nv<1.0f : nu+nv>1.0f)) {
+                        float Pd[3] = { Pu[0]-Pv[0], Pu[1]-Pv[1], Pu[2]-Pv[2] },
+                              hd = dot(Pd, Pd),
+                              w = hd>FLT_MIN ? dot(Pd, r)/hd : 0.0f,
+                              d = 0.5f*(u+v-1.0f);
+                        cu[ncandidates] = u - d - w;
+                        cv[ncandidates] = v - d + w;
+                        ++ncandidates;
+                    }
+                    float bestDistSq = FLT_MAX;
+                    for (int j=0; j<ncandidates; ++j) {
+
+                        PatchSolver::Clamp(pparam, triangle, cu[j], cv[j]);
+
+                        float Q[3];
+                        _solver.Eval(handle, pparam, cu[j], cv[j], Q);
+
+                        float rq[3] = { Q[0]-_point[0], Q[1]-_point[1], Q[2]-_point[2] },
+                              dq = dot(rq, rq);
+                        if (dq<bestDistSq) {
+                            bestDistSq = dq;
+                            nu = cu[j];
+                            nv = cv[j];
+                        }
+                    }
+                    PatchSolver::Clamp(pparam, triangle, nu, nv);
+
+                    // the Gauss-Newton step overshoots when the point is far
+                    // from a curved patch : backtrack until the distance
+                    // decreases
+                    float distSq = dot(r, r);
+                    bool accepted = false;
+                    for (int j=0; j<8 and not accepted; ++j) {
+
+                        float Q[3];
+                        _solver.Eval(handle, pparam, nu, nv, Q);
+
+                        float rq[3] = { Q[0]-_point[0], Q[1]-_point[1], Q[2]-_point[2] };
+                        if (dot(rq, rq) < distSq) {
+                            accepted = true;
+                        } else {
+                            nu = 0.5f*(u+nu);
+                            nv = 0.5f*(v+nv);
+                        }
+                    }
+
+                    if (not accepted or
+                        (fabsf(nu-u)<=epsilon and fabsf(nv-v)<=epsilon)) {
+                        if (accepted) {
+                            u = nu;
+                            v = nv;
+                        }
+                        break;
+                    }
+                    u = nu;
+                    v = nv;
+                }
+
+                _solver.Eval(handle, pparam, u, v, P);
+
+                float r[3] = { P[0]-_point[0], P[1]-_point[1], P[2]-_point[2] },
+                      dist = sqrtf(dot(r, r));
+
+                if (dist<=maxDist and dist<_distance) {
+                    _found = true;
+                    _distance = dist;
+                    _closest = PatchSolver::GetLocation(pparam, u, v);
+                }
+            }
+            return std::min(maxDist, _distance);
+        }
+
+        bool Found() const { return _found; }
+
+        float GetDistance() const { return _distance; }
+
+        LimitLocation const & GetClosest() const { return _closest; }
+
+    private:
+
+        PatchSolver const & _solver;
+        Far::PatchTables const & _ptables;
+
+        float _point[3];
+
+        bool _found;
+        float _distance;
+        LimitLocation _closest;
+    };
+}
+
+int
+CpuEvalLimitController::IntersectRay( float const origin[3],
+                                      float const direction[3],
+                                      Far::PatchBVH const & bvh,
+                                      CpuEvalLimitContext * context,
+                                      LimitLocation & hit,
+                                      float * tHit,
+                                      float tMax ) const {
+
+    VertexData const & vertexData = _currentBindState.vertexData;
+
+    if (not context or not vertexData.in or vertexData.inDesc.length<3) {
+        return 0;
+    }
+
+    if (dot(direction, direction)==0.0f) {
+        return 0;
+    }
+
+    Far::PatchTables const & ptables = context->GetPatchTables();
+
+    PatchSolver solver(ptables, _currentBindState.bezierPatches,
+        vertexData.inDesc, vertexData.in);
 
-            // XXXX manuelk this assumes FVar data is ordered with 4 CVs / patch :
-            //              bi-cubic FVar interpolation will require proper topology
-            //              accessors in Far::PatchTables and this code will change
-            evalBilinear( s, t, zeroRing,
-                          facevaryingData.inDesc,
-                          &facevaryingData.in[handle->patchIndex*4*facevaryingData.outDesc.stride],
-                          facevaryingData.outDesc,
-                          facevaryingData.out+offset);
+    RayVisitor visitor(solver, ptables, origin, direction);
 
+    bvh.TraverseRay(origin, direction, 0.0f, tMax, visitor);
+
+    if (not visitor.Found()) {
+        return 0;
+    }
+    hit = visitor.GetHit();
+    if (tHit) {
+        *tHit = visitor.GetHitDistance();
+    }
+    return 1;
+}
+
+int
+CpuEvalLimitController::FindClosestPoint( float const point[3],
+                                          Far::PatchBVH const & bvh,
+                                          CpuEvalLimitContext * context,
+                                          LimitLocation & closest,
+                                          float * distance,
+                                          float maxDistance ) const {
+
+    VertexData const & vertexData = _currentBindState.vertexData;
+
+    if (not context or not vertexData.in or vertexData.inDesc.length<3) {
+        return 0;
+    }
+
+    Far::PatchTables const & ptables = context->GetPatchTables();
+
+    PatchSolver solver(ptables, _currentBindState.bezierPatches,
+        vertexData.inDesc, vertexData.in);
+
+    PointVisitor visitor(solver, ptables, point);
+
+    bvh.TraversePoint(point, maxDistance, visitor);
+
+    if (not visitor.Found()) {
+        return 0;
+    }
+    closest = visitor.GetClosest();
+    if (distance) {
+        *distance = visitor.GetDistance();
     }
     return 1;
 }
@@ -29,9 +29,13 @@
 
 #include "../osd/vertexDescriptor.h"
 
+#include <cfloat>
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
+namespace Far{ class PatchBVH; class BezierPatchCache; }
+
 namespace Osd {
 
 struct LimitLocation;
@@ -120,27 +124,54 @@ public:
 
     /// \brief Binds the face-varying-interpolated data streams
     ///
-    /// Note : currently we only support bilinear boundary interpolation rules
-    /// for face-varying data. Although Hbr supports 3 addition smooth rule sets,
-    /// the feature-adaptive patch interpolation code currently does not support
-    /// them, and neither does this EvalContext
+    /// When a face-varying channel is specified, the data is interpolated
+    /// with the face-varying patches of the PatchTables of the EvalContext,
+    /// which honor the face-varying boundary interpolation rules (Sdc::Options)
+    /// of the channel : the bi-cubic face-varying patches are evaluated at the
+    /// limit and the remaining patches bilinearly (see
+    /// Far::PatchTables::GetFVarPatchType()). The input data must then contain
+    /// the face-varying values of all the levels of the TopologyRefiner (see
+    /// Far::TopologyRefiner::InterpolateFaceVarying()).
     ///
-    /// @param iDesc  data descriptor shared by all input data buffers
+    /// Otherwise the input data is expected to hold the 4 corner values of
+    /// every patch and is interpolated bilinearly.
     ///
-    /// @param inQ    input face-varying data
+    /// @param iDesc    data descriptor shared by all input data buffers
     ///
-    /// @param oDesc  data descriptor for the outQ data buffer
+    /// @param inQ      input face-varying data
+    ///
+    /// @param oDesc    data descriptor for the outQ data buffer
     ///
-    /// @param outQ   output face-varying data
+    /// @param outQ     output face-varying data
+    ///
+    /// @param channel  face-varying channel of the PatchTables (-1 for the
+    ///                 bilinear interpolation of per-patch corner values)
     ///
     template<class INPUT_BUFFER, class OUTPUT_BUFFER>
     void BindFacevaryingBuffers( VertexBufferDescriptor const & iDesc, INPUT_BUFFER *inQ,
-                                 VertexBufferDescriptor const & oDesc, OUTPUT_BUFFER *outQ ) {
+                                 VertexBufferDescriptor const & oDesc, OUTPUT_BUFFER *outQ,
+                                 int channel=-1 ) {
         _currentBindState.facevaryingData.inDesc = iDesc;
         _currentBindState.facevaryingData.in = inQ ? inQ->BindCpuBuffer() : 0;
 
         _currentBindState.facevaryingData.outDesc = oDesc;
         _currentBindState.facevaryingData.out = outQ ? outQ->BindCpuBuffer() : 0;
+
+        _currentBindState.facevaryingData.channel = channel;
+    }
+
+    /// \brief Binds a cache of the Bezier form of the patches
+    ///
+    /// Regular, boundary and corner patches found in the cache are evaluated
+    /// from their contiguous Bezier points instead of gathering their
+    /// B-spline control vertices. The cache must have been updated from the
+    /// bound input vertex data, starting at the offset of its descriptor and
+    /// with at least as many floats per vertex.
+    ///
+    /// @param bezierPatches  Bezier patch cache (NULL to unbind)
+    ///
+    void BindBezierPatches( Far::BezierPatchCache const * bezierPatches ) {
+        _currentBindState.bezierPatches = bezierPatches;
     }
 
     /// \brief Vertex interpolation of a single sample at the limit
@@ -199,6 +230,67 @@ public:
         return n;
     }
 
+    /// \brief Finds the nearest intersection of a ray with the limit surface
+    ///
+    /// Candidate patches are culled with the bounds of the PatchBVH, then the
+    /// intersection with each candidate is solved with Newton iterations in
+    /// the parametric space of the patch. The positions are read from the
+    /// first 3 components of the bound input vertex buffer.
+    ///
+    /// @param origin     origin of the ray
+    ///
+    /// @param direction  direction of the ray (does not need to be normalized)
+    ///
+    /// @param bvh        a PatchBVH built from the patch tables of 'context'
+    ///                   and refitted to the bound vertex data
+    ///
+    /// @param context    the EvalLimitContext that the controller will evaluate
+    ///
+    /// @param hit        location of the intersection on the limit surface
+    ///
+    /// @param tHit       ray parameter of the intersection (optional)
+    ///
+    /// @param tMax       maximum ray parameter
+    ///
+    /// @return 1 if an intersection was found
+    ///
+    int IntersectRay( float const origin[3],
+                      float const direction[3],
+                      Far::PatchBVH const & bvh,
+                      CpuEvalLimitContext * context,
+                      LimitLocation & hit,
+                      float * tHit=0,
+                      float tMax=FLT_MAX ) const;
+
+    /// \brief Finds the point of the limit surface closest to a given point
+    ///
+    /// Candidate patches are visited nearest bounds first, and the closest
+    /// point on each patch is solved with Gauss-Newton iterations clamped to
+    /// the parametric domain of the patch. The positions are read from the
+    /// first 3 components of the bound input vertex buffer.
+    ///
+    /// @param point      location of the query
+    ///
+    /// @param bvh        a PatchBVH built from the patch tables of 'context'
+    ///                   and refitted to the bound vertex data
+    ///
+    /// @param context    the EvalLimitContext that the controller will evaluate
+    ///
+    /// @param closest    location of the closest point on the limit surface
+    ///
+    /// @param distance   distance to the closest point (optional)
+    ///
+    /// @param maxDistance  maximum distance of the search
+    ///
+    /// @return 1 if a point was found within 'maxDistance'
+    ///
+    int FindClosestPoint( float const point[3],
+                          Far::PatchBVH const & bvh,
+                          CpuEvalLimitContext * context,
+                          LimitLocation & closest,
+                          float * distance=0,
+                          float maxDistance=FLT_MAX ) const;
+
     void Unbind() {
         _currentBindState.Reset();
     }
@@ -247,18 +339,21 @@ protected:
     // Facevarying interpolated streams
     struct FacevaryingData {
 
-        FacevaryingData() : in(0), out(0) { }
+        FacevaryingData() : in(0), out(0), channel(-1) { }
 
         void Reset() {
             in = out = NULL;
             inDesc.Reset();
             outDesc.Reset();
+            channel = -1;
         }
 
         VertexBufferDescriptor inDesc,
                                outDesc;
         float * in,
               * out;
+
+        int channel; // face-varying channel of the patches (-1 : bilinear per-patch data)
     };
 
 
@@ -272,17 +367,20 @@ private:
     // It doesn't take an ownership of vertex buffers.
     struct BindState {
 
-        BindState() { }
+        BindState() : bezierPatches(0) { }
 
         void Reset() {
             vertexData.Reset();
             varyingData.Reset();
             facevaryingData.Reset();
+            bezierPatches = 0;
         }
 
         VertexData       vertexData;      // vertex interpolated data descriptor
         VaryingData      varyingData;     // varying interpolated data descriptor
         FacevaryingData  facevaryingData; // face-varying interpolated data descriptor
+
+        Far::BezierPatchCache const * bezierPatches; // optional Bezier form of the vertex data
     };
 
     BindState _currentBindState;
@@ -69,6 +69,37 @@ evalBilinear(float u, float v,
     }
 }
 
+// Evaluates the linear interpolation of the 3 corners of a triangle patch
+void
+evalLinear(Far::PatchParam::BitField bits,
+           float u, float v,
+           Far::Index const * vertexIndices,
+           VertexBufferDescriptor const & inDesc,
+           float const * inQ,
+           VertexBufferDescriptor const & outDesc,
+           float * outQ) {
+
+    assert( outQ and inDesc.length <= (outDesc.stride-outDesc.offset) );
+
+    float w[3];
+    Far::PatchTables::GetLinearWeights(bits, u, v, w, 0, 0);
+
+    float const * inOffset = inQ + inDesc.offset;
+
+    float * Q = outQ + outDesc.offset;
+
+    memset(Q, 0, inDesc.length*sizeof(float));
+
+    for (int i=0; i<3; ++i) {
+
+        float const * in = inOffset + vertexIndices[i]*inDesc.stride;
+
+        for (int k=0; k<inDesc.length; ++k) {
+            Q[k] += w[i] * in[k];
+        }
+    }
+}
+
 #ifdef TENSOR_PRODUCT_CUBIC_SPLINES
 
 // manuelk code was refactored to use the matrix formulation of cubic splines
@@ -187,6 +218,53 @@ evalBSpline(Far::PatchParam::BitField bits,
     }
 }
 
+// Evaluates the 16 contiguous Bezier points of a patch (see
+// Far::BezierPatchCache)
+void
+evalBezier(Far::PatchParam::BitField bits,
+           float s, float t,
+           VertexBufferDescriptor const & inDesc,
+           float const * inQ,
+           VertexBufferDescriptor const & outDesc,
+           float * outQ,
+           float * outDQ1,
+           float * outDQ2 ) {
+
+    // make sure that we have enough space to store results
+    assert( outQ and inDesc.length <= (outDesc.stride-outDesc.offset) );
+
+    float Q[16], dQ1[16], dQ2[16];
+    Far::PatchTables::GetBasisWeights(Far::PatchTables::BASIS_BEZIER, bits, s, t,
+        outQ ? Q : 0, outDQ1 ? dQ1 : 0, outDQ2 ? dQ2 : 0);
+
+    float const * inOffset = inQ + inDesc.offset;
+
+    outQ += outDesc.offset;
+
+    memset(outQ, 0, inDesc.length*sizeof(float));
+    if (outDQ1) {
+        memset(outDQ1, 0, inDesc.length*sizeof(float));
+    }
+    if (outDQ2) {
+        memset(outDQ2, 0, inDesc.length*sizeof(float));
+    }
+
+    for (int i=0; i<16; ++i) {
+
+        float const * in = inOffset + i*inDesc.stride;
+
+        for (int k=0; k<inDesc.length; ++k) {
+            outQ[k] += Q[i] * in[k];
+            if (outDQ1) {
+                outDQ1[k] += dQ1[i] * in[k];
+            }
+            if (outDQ2) {
+                outDQ2[k] += dQ2[i] * in[k];
+            }
+        }
+    }
+}
+
 void
 evalBoundary(Far::PatchParam::BitField bits,
              float s, float t,
@@ -519,200 +597,138 @@ j];
     }
 }
 
-/*
-static float ef[7] = {
-    0.813008f, 0.500000f, 0.363636f, 0.287505f,
-    0.238692f, 0.204549f, 0.179211f };
-*/
-
-static float ef[27] = {
-    0.812816f, 0.500000f, 0.363644f, 0.287514f,
-    0.238688f, 0.204544f, 0.179229f, 0.159657f,
-    0.144042f, 0.131276f, 0.120632f, 0.111614f,
-    0.103872f, 0.09715f, 0.0912559f, 0.0860444f,
-    0.0814022f, 0.0772401f, 0.0734867f, 0.0700842f,
-    0.0669851f, 0.0641504f, 0.0615475f, 0.0591488f,
-    0.0569311f, 0.0548745f, 0.0529621f
-};
-
-inline float
-csf(Far::Index n, Far::Index j) {
-    if (j%2 == 0) {
-        return cosf((2.0f * float(M_PI) * float(float(j-0)/2.0f))/(float(n)+3.0f));
-    } else {
-        return sinf((2.0f * float(M_PI) * float(float(j-1)/2.0f))/(float(n)+3.0f));
-    }
-}
-
-
+// Evaluates a Loop patch from its 12 control vertices (quartic box-spline)
 void
-evalGregory(Far::PatchParam::BitField bits, float u, float v,
-            Far::Index const * vertexIndices,
-            Far::Index const * vertexValenceBuffer,
-            unsigned int const * quadOffsetBuffer,
-            int maxValence,
-            VertexBufferDescriptor const & inDesc,
-            float const * inQ,
-            VertexBufferDescriptor const & outDesc,
-            float * outQ,
-            float * outDQ1,
-            float * outDQ2 ) {
+evalLoop(Far::PatchParam::BitField bits,
+         float u, float v,
+         Far::Index const * vertexIndices,
+         VertexBufferDescriptor const & inDesc,
+         float const * inQ,
+         VertexBufferDescriptor const & outDesc,
+         float * outQ,
+         float * outDQU,
+         float * outDQV ) {
 
-    // make sure that we have enough space to store results
     assert( outQ and inDesc.length <= (outDesc.stride-outDesc.offset) );
 
-    int valences[4], length=inDesc.length;
-
-    float const * inOffset = inQ + inDesc.offset;
+    // note : the derivative weights are required to fold the weights of the
+    // boundary control vertices consistently
+    bool derivs = outDQU or outDQV;
 
-    float  *r  = (float*)alloca((maxValence+2)*4*length*sizeof(float)), *rp,
-           *e0 = r + maxValence*4*length,
-           *e1 = e0 + 4*length;
-    memset(r, 0, (maxValence+2)*4*length*sizeof(float));
+    float Q[12], dQU[12], dQV[12];
+    Far::PatchTables::GetLoopBasisWeights(bits, u, v,
+        Q, derivs ? dQU : 0, derivs ? dQV : 0);
 
-    float *f=(float*)alloca(maxValence*length*sizeof(float)),
-          *pos=(float*)alloca(length*sizeof(float)),
-          *opos=(float*)alloca(length*4*sizeof(float));
-    memset(opos, 0, length*4*sizeof(float));
+    float const * inOffset = inQ + inDesc.offset;
 
-    for (int vid=0; vid < 4; ++vid) {
+    outQ += outDesc.offset;
 
-        int vertexID = vertexIndices[vid];
+    memset(outQ, 0, inDesc.length*sizeof(float));
+    if (outDQU) {
+        memset(outDQU, 0, inDesc.length*sizeof(float));
+    }
+    if (outDQV) {
+        memset(outDQV, 0, inDesc.length*sizeof(float));
+    }
 
-        const int *valenceTable = vertexValenceBuffer + vertexID * (2*maxValence+1);
-        int valence = abs(*valenceTable);
-        assert(valence<=maxValence);
-        valences[vid] = valence;
+    for (int i=0; i<12; ++i) {
 
-        memcpy(pos, inOffset + vertexID*inDesc.stride, length*sizeof(float));
+        float const * in = inOffset + vertexIndices[i]*inDesc.stride;
 
-        rp=r+vid*maxValence*length;
+        for (int k=0; k<inDesc.length; ++k) {
+            outQ[k] += Q[i] * in[k];
+            if (outDQU) {
+                outDQU[k] += dQU[i] * in[k];
+            }
+            if (outDQV) {
+                outDQV[k] += dQV[i] * in[k];
+            }
+        }
+    }
+}
 
-        int vofs = vid*length;
+// Evaluates a Loop end-cap from the stencils of its 15 quartic Bezier points
+void
+evalLoopBasis(Far::PatchParam::BitField bits, float u, float v,
+              Far::StencilTables const & basisStencils,
+              int stencilIndex,
+              VertexBufferDescriptor const & inDesc,
+              float const * inQ,
+              VertexBufferDescriptor const & outDesc,
+              float * outQ,
+              float * outDQU,
+              float * outDQV ) {
 
-        for (int i=0; i<valence; ++i) {
-            Far::Index im = (i+valence-1)%valence,
-                       ip = (i+1)%valence;
+    assert( outQ and inDesc.length <= (outDesc.stride-outDesc.offset) );
 
-            int idx_neighbor   = valenceTable[2*i  + 0 + 1];
-            int idx_diagonal   = valenceTable[2*i  + 1 + 1];
-            int idx_neighbor_p = valenceTable[2*ip + 0 + 1];
-            int idx_neighbor_m = valenceTable[2*im + 0 + 1];
-            int idx_diagonal_m = valenceTable[2*im + 1 + 1];
+    int length = inDesc.length;
 
-            float const * neighbor   = inOffset + idx_neighbor   * inDesc.stride;
-            float const * diagonal   = inOffset + idx_diagonal   * inDesc.stride;
-            float const * neighbor_p = inOffset + idx_neighbor_p * inDesc.stride;
-            float const * neighbor_m = inOffset + idx_neighbor_m * inDesc.stride;
-            float const * diagonal_m = inOffset + idx_diagonal_m * inDesc.stride;
+    bool derivs = outDQU or outDQV;
 
-            float  *fp = f+i*length;
+    float BU[15], DU[15], DV[15];
+    Far::PatchTables::GetLoopBezierWeights(bits, u, v,
+        BU, derivs ? DU : 0, derivs ? DV : 0);
 
-            for (int k=0; k<length; ++k) {
-                fp[k] = (pos[k]*float(valence) + (neighbor_p[k]+neighbor[k])*2.0f + diagonal[k])/(float(valence)+5.0f);
+    float const *inOffset = inQ + inDesc.offset;
 
-                opos[vofs+k] += fp[k];
-                rp[i*length+k] =(neighbor_p[k]-neighbor_m[k])/3.0f + (diagonal[k]-diagonal_m[k])/6.0f;
-            }
+    float * Q = outQ + outDesc.offset;
 
-        }
+    memset(Q, 0, length*sizeof(float));
+    if (outDQU) {
+        memset(outDQU, 0, length*sizeof(float));
+    }
+    if (outDQV) {
+        memset(outDQV, 0, length*sizeof(float));
+    }
 
-        for (int k=0; k<length; ++k) {
-            opos[vofs+k] /= valence;
-        }
+    for (int i=0; i<15; ++i) {
 
-        for (int i=0; i<valence; ++i) {
-            int im = (i+valence-1)%valence;
+        Far::Stencil s = basisStencils.GetStencil(stencilIndex + i);
+        Far::Index const * srcIndices = s.GetVertexIndices();
+        float const * srcWeights = s.GetWeights();
+        for (int j=0; j<s.GetSize(); ++j) {
+            float const * in = inOffset + srcIndices[j]*inDesc.stride;
+            float w = BU[i] * srcWeights[j];
             for (int k=0; k<length; ++k) {
-                float e = 0.5f*(f[i*length+k]+f[im*length+k]);
-                e0[vofs+k] += csf(valence-3, 2*i) * e;
-                e1[vofs+k] += csf(valence-3, 2*i+1) * e;
+                Q[k] += in[k] * w;
+                if (outDQU) {
+                    outDQU[k] += in[k] * DU[i] * srcWeights[j];
+                }
+                if (outDQV) {
+                    outDQV[k] += in[k] * DV[i] * srcWeights[j];
+                }
             }
         }
-
-        for (int k=0; k<length; ++k) {
-            e0[vofs+k] *= ef[valence-3];
-            e1[vofs+k] *= ef[valence-3];
-        }
     }
+}
 
-    // Control Vertices based on :
-    // "Approximating Subdivision Surfaces with Gregory Patches for Hardware Tessellation"
-    // Loop, Schaefer, Ni, Castafio (ACM ToG Siggraph Asia 2009)
-    //
-    //  P3         e3-      e2+         E2
-    //     O--------O--------O--------O
-    //     |        |        |        |
-    //     |        |        |        |
-    //     |        | f3-    | f2+    |
-    //     |        O        O        |
-    // e3+ O------O            O------O e2-
-    //     |     f3+          f2-     |
-    //     |                          |
-    //     |                          |
-    //     |      f0-         f1+     |
-    // e0- O------O            O------O e1+
-    //     |        O        O        |
-    //     |        | f0+    | f1-    |
-    //     |        |        |        |
-    //     |        |        |        |
-    //     O--------O--------O--------O
-    //  P0         e0+      e1-         E1
-    //
-
-    float *Ep=(float*)alloca(length*4*sizeof(float)),
-          *Em=(float*)alloca(length*4*sizeof(float)),
-          *Fp=(float*)alloca(length*4*sizeof(float)),
-          *Fm=(float*)alloca(length*4*sizeof(float));
-
-    for (int vid=0; vid<4; ++vid) {
-
-        int ip = (vid+1)%4;
-        int im = (vid+3)%4;
-        int n = valences[vid];
-        unsigned int const *quadOffsets = quadOffsetBuffer;
-
-        int start = quadOffsets[vid] & 0x00ff;
-        int prev = (quadOffsets[vid] & 0xff00) / 256;
-
-        for (int k=0, ofs=vid*length; k<length; ++k, ++ofs) {
-
-            Ep[ofs] = opos[ofs] + e0[ofs] * csf(n-3, 2*start) + e1[ofs]*csf(n-3, 2*start +1);
-            Em[ofs] = opos[ofs] + e0[ofs] * csf(n-3, 2*prev ) + e1[ofs]*csf(n-3, 2*prev + 1);
-        }
-
-        Far::Index np = valences[ip],
-                   nm = valences[im];
-
-        Far::Index prev_p = (quadOffsets[ip] & 0xff00) / 256,
-                   start_m = quadOffsets[im] & 0x00ff;
-
-        float *Em_ip=(float*)alloca(length*sizeof(float)),
-              *Ep_im=(float*)alloca(length*sizeof(float));
+void
+evalGregory(Far::PatchParam::BitField bits, float u, float v,
+            Far::Index const * vertexIndices,
+            Far::Index const * vertexValenceBuffer,
+            unsigned int const * quadOffsetBuffer,
+            int maxValence,
+            VertexBufferDescriptor const & inDesc,
+            float const * inQ,
+            VertexBufferDescriptor const & outDesc,
+            float * outQ,
+            float * outDQ1,
+            float * outDQ2 ) {
 
-        for (int k=0, ipofs=ip*length, imofs=im*length; k<length; ++k, ++ipofs, ++imofs) {
-            Em_ip[k] = opos[ipofs] + e0[ipofs]*csf(np-3, 2*prev_p)  + e1[ipofs]*csf(np-3, 2*prev_p+1);
-            Ep_im[k] = opos[imofs] + e0[imofs]*csf(nm-3, 2*start_m) + e1[imofs]*csf(nm-3, 2*start_m+1);
-        }
+    // make sure that we have enough space to store results
+    assert( outQ and inDesc.length <= (outDesc.stride-outDesc.offset) );
 
-        float s1 = 3.0f - 2.0f*csf(n-3,2)-csf(np-3,2),
-              s2 = 2.0f*csf(n-3,2),
-              s3 = 3.0f -2.0f*cosf(2.0f*float(M_PI)/float(n)) - cosf(2.0f*float(M_PI)/float(nm));
+    int length=inDesc.length;
 
-        rp = r + vid*maxValence*length;
-        for (int k=0, ofs=vid*length; k<length; ++k, ++ofs) {
-            Fp[ofs] = (csf(np-3,2)*opos[ofs] + s1*Ep[ofs] + s2*Em_ip[k] + rp[start*length+k])/3.0f;
-            Fm[ofs] = (csf(nm-3,2)*opos[ofs] + s3*Em[ofs] + s2*Ep_im[k] - rp[prev*length+k])/3.0f;
-        }
-    }
+    // gather the 20 control points of the patch
+    float * points = (float*)alloca(20*length*sizeof(float));
+    Far::PatchTables::ComputeGregoryPoints(Far::PatchDescriptor::GREGORY,
+        vertexIndices, vertexValenceBuffer, quadOffsetBuffer, maxValence,
+        inQ + inDesc.offset, inDesc.stride, length, points);
 
     float * p[20];
-    for (int i=0, ofs=0; i<4; ++i, ofs+=length) {
-        p[i*5+0] = opos + ofs;
-        p[i*5+1] =   Ep + ofs;
-        p[i*5+2] =   Em + ofs;
-        p[i*5+3] =   Fp + ofs;
-        p[i*5+4] =   Fm + ofs;
+    for (int i=0; i<20; ++i) {
+        p[i] = points + i*length;
     }
 
     float U = 1-u, V=1-v;
@@ -793,313 +809,20 @@ evalGregoryBoundary(Far::PatchParam::BitField bits, float u, float v,
                     float * outDQ1,
                     float * outDQ2 ) {
 
-    // vertex
-
     // make sure that we have enough space to store results
     assert( outQ and inDesc.length <= (outDesc.stride-outDesc.offset) );
 
-    int valences[4], zerothNeighbors[4], length=inDesc.length;
-
-    float const * inOffset = inQ + inDesc.offset;
-
-    float  *r  = (float*)alloca((maxValence+2)*4*length*sizeof(float)), *rp,
-           *e0 = r + maxValence*4*length,
-           *e1 = e0 + 4*length;
-    memset(r, 0, (maxValence+2)*4*length*sizeof(float));
-
-    float *f=(float*)alloca(maxValence*length*sizeof(float)),
-          *org=(float*)alloca(length*4*sizeof(float)),
-          *opos=(float*)alloca(length*4*sizeof(float));
-
-    memset(opos, 0, length*4*sizeof(float));
-
-    for (int vid=0; vid < 4; ++vid) {
-
-        int vertexID = vertexIndices[vid];
-
-        const int *valenceTable = vertexValenceBuffer + vertexID * (2*maxValence+1);
-        int valence = *valenceTable,
-            ivalence = abs(valence);
+    int length=inDesc.length;
 
-        assert(ivalence<=maxValence);
-        valences[vid] = valence;
-
-        int vofs = vid * length;
-
-        float *pos=org + vofs;
-        memcpy(pos, inOffset + vertexID*inDesc.stride, length*sizeof(float));
-
-        int boundaryEdgeNeighbors[2];
-        Far::Index currNeighbor = 0,
-                   ibefore=0,
-                   zerothNeighbor=0;
-
-        rp=r+vid*maxValence*length;
-
-        for (int i=0; i<ivalence; ++i) {
-            Far::Index im = (i+ivalence-1)%ivalence,
-                       ip = (i+1)%ivalence;
-
-            int idx_neighbor   = valenceTable[2*i  + 0 + 1];
-            int idx_diagonal   = valenceTable[2*i  + 1 + 1];
-            int idx_neighbor_p = valenceTable[2*ip + 0 + 1];
-            int idx_neighbor_m = valenceTable[2*im + 0 + 1];
-            int idx_diagonal_m = valenceTable[2*im + 1 + 1];
-
-            int valenceNeighbor = vertexValenceBuffer[idx_neighbor * (2*maxValence+1)];
-            if (valenceNeighbor < 0) {
-
-                if (currNeighbor<2) {
-                    boundaryEdgeNeighbors[currNeighbor] = idx_neighbor;
-                }
-                currNeighbor++;
-
-                if (currNeighbor == 1)    {
-                    ibefore = i;
-                    zerothNeighbor = i;
-                } else {
-                    if (i-ibefore == 1) {
-                        int tmp = boundaryEdgeNeighbors[0];
-                        boundaryEdgeNeighbors[0] = boundaryEdgeNeighbors[1];
-                        boundaryEdgeNeighbors[1] = tmp;
-                        zerothNeighbor = i;
-                    }
-                }
-            }
-
-            float const * neighbor   = inOffset + idx_neighbor   * inDesc.stride;
-            float const * diagonal   = inOffset + idx_diagonal   * inDesc.stride;
-            float const * neighbor_p = inOffset + idx_neighbor_p * inDesc.stride;
-            float const * neighbor_m = inOffset + idx_neighbor_m * inDesc.stride;
-            float const * diagonal_m = inOffset + idx_diagonal_m * inDesc.stride;
-
-            float *fp = f+i*length;
-
-            for (int k=0; k<length; ++k) {
-                fp[k] = (pos[k]*float(ivalence) + (neighbor_p[k]+neighbor[k])*2.0f + diagonal[k])/(float(ivalence)+5.0f);
-
-                opos[vofs+k] += fp[k];
-                rp[i*length+k] =(neighbor_p[k]-neighbor_m[k])/3.0f + (diagonal[k]-diagonal_m[k])/6.0f;
-            }
-        }
-
-        for (int k=0; k<length; ++k) {
-            opos[vofs+k] /= ivalence;
-        }
-
-        zerothNeighbors[vid] = zerothNeighbor;
-
-        if (currNeighbor == 1) {
-            boundaryEdgeNeighbors[1] = boundaryEdgeNeighbors[0];
-        }
-
-        for (int i=0; i<ivalence; ++i) {
-            Far::Index im = (i+ivalence-1)%ivalence;
-            for (int k=0; k<length; ++k) {
-                float e = 0.5f*(f[i*length+k]+f[im*length+k]);
-                e0[vofs+k] += csf(ivalence-3, 2*i  ) * e;
-                e1[vofs+k] += csf(ivalence-3, 2*i+1) * e;
-            }
-        }
-
-        for (int k=0; k<length; ++k) {
-            e0[vofs+k] *= ef[ivalence-3];
-            e1[vofs+k] *= ef[ivalence-3];
-        }
-
-        if (valence<0) {
-            if (ivalence>2) {
-                for (int k=0; k<length; ++k) {
-                    opos[vofs+k] = (inOffset[boundaryEdgeNeighbors[0]*inDesc.stride+k] +
-                                    inOffset[boundaryEdgeNeighbors[1]*inDesc.stride+k] + 4.0f*pos[k])/6.0f;
-                }
-            } else {
-                memcpy(opos+vofs, pos, length*sizeof(float));
-            }
-
-            float k = float(float(ivalence) - 1.0f);    //k is the number of faces
-            float c = cosf(float(M_PI)/k);
-            float s = sinf(float(M_PI)/k);
-            float gamma = -(4.0f*s)/(3.0f*k+c);
-            float alpha_0k = -((1.0f+2.0f*c)*sqrtf(1.0f+c))/((3.0f*k+c)*sqrtf(1.0f-c));
-            float beta_0 = s/(3.0f*k + c);
-
-            int idx_diagonal = valenceTable[2*zerothNeighbor + 1 + 1];
-            assert(idx_diagonal>0);
-            float const * diagonal = inOffset + idx_diagonal * inDesc.stride;
-
-            for (int j=0; j<length; ++j) {
-                e0[vofs+j] = (inOffset[boundaryEdgeNeighbors[0]*inDesc.stride+j] -
-                              inOffset[boundaryEdgeNeighbors[1]*inDesc.stride+j])/6.0f;
-
-                e1[vofs+j] = gamma * pos[j] + beta_0 * diagonal[j] +
-                            (inOffset[boundaryEdgeNeighbors[0]*inDesc.stride+j] +
-                             inOffset[boundaryEdgeNeighbors[1]*inDesc.stride+j]) * alpha_0k;
-
-            }
-
-            for (int x=1; x<ivalence-1; ++x) {
-                Far::Index curri = ((x + zerothNeighbor)%ivalence);
-                float alpha = (4.0f*sinf((float(M_PI) * float(x))/k))/(3.0f*k+c);
-                float beta = (sinf((float(M_PI) * float(x))/k) + sinf((float(M_PI) * float(x+1))/k))/(3.0f*k+c);
-
-                int idx_neighbor = valenceTable[2*curri + 0 + 1];
-                    idx_diagonal = valenceTable[2*curri + 1 + 1];
-                assert( idx_neighbor>0 and idx_diagonal>0 );
-
-                float const * neighbor = inOffset + idx_neighbor * inDesc.stride;
-                              diagonal = inOffset + idx_diagonal * inDesc.stride;
-
-                for (int j=0; j<length; ++j) {
-                    e1[vofs+j] += alpha*neighbor[j] + beta*diagonal[j];
-                }
-            }
-
-            for (int j=0; j<length; ++j) {
-                e1[vofs+j] /= 3.0f;
-            }
-        }
-    }
-
-    // tess control
-
-    // Control Vertices based on :
-    // "Approximating Subdivision Surfaces with Gregory Patches for Hardware Tessellation"
-    // Loop, Schaefer, Ni, Castafio (ACM ToG Siggraph Asia 2009)
-    //
-    //  P3         e3-      e2+         E2
-    //     O--------O--------O--------O
-    //     |        |        |        |
-    //     |        |        |        |
-    //     |        | f3-    | f2+    |
-    //     |        O        O        |
-    // e3+ O------O            O------O e2-
-    //     |     f3+          f2-     |
-    //     |                          |
-    //     |                          |
-    //     |      f0-         f1+     |
-    // e0- O------O            O------O e1+
-    //     |        O        O        |
-    //     |        | f0+    | f1-    |
-    //     |        |        |        |
-    //     |        |        |        |
-    //     O--------O--------O--------O
-    //  P0         e0+      e1-         E1
-    //
-
-    float *Ep=(float*)alloca(length*4*sizeof(float)),
-          *Em=(float*)alloca(length*4*sizeof(float)),
-          *Fp=(float*)alloca(length*4*sizeof(float)),
-          *Fm=(float*)alloca(length*4*sizeof(float));
-
-    for (int vid=0; vid<4; ++vid) {
-
-        Far::Index ip = (vid+1)%4,
-                   im = (vid+3)%4,
-                   n = abs(valences[vid]),
-                   ivalence = n;
-
-        unsigned int const *quadOffsets = quadOffsetBuffer;
-
-        int vofs = vid * length;
-
-        Far::Index   start =  quadOffsets[vid] & 0x00ff,
-                      prev = (quadOffsets[vid] & 0xff00) / 256,
-                        np = abs(valences[ip]),
-                        nm = abs(valences[im]),
-                   start_m =  quadOffsets[im] & 0x00ff,
-                    prev_p = (quadOffsets[ip] & 0xff00) / 256;
-
-        float *Em_ip=(float*)alloca(length*sizeof(float)),
-              *Ep_im=(float*)alloca(length*sizeof(float));
-
-        if (valences[ip]<-2) {
-            Far::Index j = (np + prev_p - zerothNeighbors[ip]) % np;
-            for (int k=0, ipofs=ip*length; k<length; ++k, ++ipofs) {
-                Em_ip[k] = opos[ipofs] + cosf((float(M_PI)*j)/float(np-1))*e0[ipofs] + sinf((float(M_PI)*j)/float(np-1))*e1[ipofs];
-            }
-        } else {
-            for (int k=0, ipofs=ip*length; k<length; ++k, ++ipofs) {
-                Em_ip[k] = opos[ipofs] + e0[ipofs]*csf(np-3,2*prev_p)  + e1[ipofs]*csf(np-3,2*prev_p+1);
-            }
-        }
-
-        if (valences[im]<-2) {
-            Far::Index j = (nm + start_m - zerothNeighbors[im]) % nm;
-            for (int k=0, imofs=im*length; k<length; ++k, ++imofs) {
-                Ep_im[k] = opos[imofs] + cosf((float(M_PI)*j)/float(nm-1))*e0[imofs] + sinf((float(M_PI)*j)/float(nm-1))*e1[imofs];
-            }
-        } else {
-            for (int k=0, imofs=im*length; k<length; ++k, ++imofs) {
-                Ep_im[k] = opos[imofs] + e0[imofs]*csf(nm-3,2*start_m) + e1[imofs]*csf(nm-3,2*start_m+1);
-            }
-        }
-
-        if (valences[vid] < 0) {
-            n = (n-1)*2;
-        }
-        if (valences[im] < 0) {
-            nm = (nm-1)*2;
-        }
-        if (valences[ip] < 0) {
-            np = (np-1)*2;
-        }
-
-        rp=r+vid*maxValence*length;
-
-        if (valences[vid] > 2) {
-           float s1 = 3.0f - 2.0f*csf(n-3,2)-csf(np-3,2),
-                 s2 = 2.0f*csf(n-3,2),
-                 s3 = 3.0f -2.0f*cosf(2.0f*float(M_PI)/float(n)) - cosf(2.0f*float(M_PI)/float(nm));
-
-            for (int k=0, ofs=vofs; k<length; ++k, ++ofs) {
-                Ep[ofs] = opos[ofs] + e0[ofs] * csf(n-3, 2*start) + e1[ofs]*csf(n-3, 2*start +1);
-                Em[ofs] = opos[ofs] + e0[ofs] * csf(n-3, 2*prev ) + e1[ofs]*csf(n-3, 2*prev + 1);
-                Fp[ofs] = (csf(np-3,2)*opos[ofs] + s1*Ep[ofs] + s2*Em_ip[k] + rp[start*length+k])/3.0f;
-                Fm[ofs] = (csf(nm-3,2)*opos[ofs] + s3*Em[ofs] + s2*Ep_im[k] - rp[prev*length+k])/3.0f;
-            }
-        } else if (valences[vid] < -2) {
-            Far::Index jp = (ivalence + start - zerothNeighbors[vid]) % ivalence,
-                       jm = (ivalence + prev  - zerothNeighbors[vid]) % ivalence;
-
-            float s1 = 3-2*csf(n-3,2)-csf(np-3,2),
-                  s2 = 2*csf(n-3,2),
-                  s3 = 3.0f-2.0f*cosf(2.0f*float(M_PI)/n)-cosf(2.0f*float(M_PI)/nm);
-
-            for (int k=0, ofs=vofs; k<length; ++k, ++ofs) {
-                Ep[ofs] = opos[ofs] + cosf((float(M_PI)*jp)/float(ivalence-1))*e0[ofs] + sinf((float(M_PI)*jp)/float(ivalence-1))*e1[ofs];
-                Em[ofs] = opos[ofs] + cosf((float(M_PI)*jm)/float(ivalence-1))*e0[ofs] + sinf((float(M_PI)*jm)/float(ivalence-1))*e1[ofs];
-                Fp[ofs] = (csf(np-3,2)*opos[ofs] + s1*Ep[ofs] + s2*Em_ip[k] + rp[start*length+k])/3.0f;
-                Fm[ofs] = (csf(nm-3,2)*opos[ofs] + s3*Em[ofs] + s2*Ep_im[k] - rp[prev*length+k])/3.0f;
-            }
-
-            if (valences[im]<0) {
-                s1=3-2*csf(n-3,2)-csf(np-3,2);
-                for (int k=0, ofs=vofs; k<length; ++k, ++ofs) {
-                    Fp[ofs] = Fm[ofs] = (csf(np-3,2)*opos[ofs] + s1*Ep[ofs] + s2*Em_ip[k] + rp[start*length+k])/3.0f;
-                }
-            } else if (valences[ip]<0) {
-                s1 = 3.0f-2.0f*cosf(2.0f*float(M_PI)/n)-cosf(2.0f*float(M_PI)/nm);
-                for (int k=0, ofs=vofs; k<length; ++k, ++ofs) {
-                    Fm[ofs] = Fp[ofs] = (csf(nm-3,2)*opos[ofs] + s1*Em[ofs] + s2*Ep_im[k] - rp[prev*length+k])/3.0f;
-                }
-            }
-        } else if (valences[vid]==-2) {
-            for (int k=0, ofs=vofs, ipofs=ip*length, imofs=im*length; k<length; ++k, ++ofs, ++ipofs, ++imofs) {
-                Ep[ofs] = (2.0f * org[ofs] + org[ipofs])/3.0f;
-                Em[ofs] = (2.0f * org[ofs] + org[imofs])/3.0f;
-                Fp[ofs] = Fm[ofs] = (4.0f * org[ofs] + org[((vid+2)%n)*inDesc.stride+k] + 2.0f * org[ipofs] + 2.0f * org[imofs])/9.0f;
-            }
-        }
-    }
+    // gather the 20 control points of the patch
+    float * points = (float*)alloca(20*length*sizeof(float));
+    Far::PatchTables::ComputeGregoryPoints(Far::PatchDescriptor::GREGORY_BOUNDARY,
+        vertexIndices, vertexValenceBuffer, quadOffsetBuffer, maxValence,
+        inQ + inDesc.offset, inDesc.stride, length, points);
 
     float * p[20];
-    for (int vid=0, ofs=0; vid<4; ++vid, ofs+=length) {
-        p[vid*5+0] = opos + ofs;
-        p[vid*5+1] =   Ep + ofs;
-        p[vid*5+2] =   Em + ofs;
-        p[vid*5+3] =   Fp + ofs;
-        p[vid*5+4] =   Fm + ofs;
+    for (int i=0; i<20; ++i) {
+        p[i] = points + i*length;
     }
 
     float U = 1-u, V=1-v;
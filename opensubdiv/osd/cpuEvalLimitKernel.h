@@ -49,6 +49,15 @@ evalBilinear(float u, float v,
              VertexBufferDescriptor const & outDesc,
              float * outQ);
 
+void
+evalLinear(Far::PatchParam::BitField bits,
+           float u, float v,
+           Far::Index const * vertexIndices,
+           VertexBufferDescriptor const & inDesc,
+           float const * inQ,
+           VertexBufferDescriptor const & outDesc,
+           float * outQ);
+
 void
 evalBSpline(Far::PatchParam::BitField bits,
             float u, float v,
@@ -82,6 +91,16 @@ evalCorner(Far::PatchParam::BitField bits,
            float * outDQU,
            float * outDQV );
 
+void
+evalBezier(Far::PatchParam::BitField bits,
+           float u, float v,
+           VertexBufferDescriptor const & inDesc,
+           float const * inQ,
+           VertexBufferDescriptor const & outDesc,
+           float * outQ,
+           float * outDQU,
+           float * outDQV );
+
 void
 evalGregoryBasis(Far::PatchParam::BitField bits, float u, float v,
                  Far::StencilTables const & basisStencils,
@@ -93,6 +112,28 @@ evalGregoryBasis(Far::PatchParam::BitField bits, float u, float v,
                  float * outDQU,
                  float * outDQV );
 
+void
+evalLoop(Far::PatchParam::BitField bits,
+         float u, float v,
+         Far::Index const * vertexIndices,
+         VertexBufferDescriptor const & inDesc,
+         float const * inQ,
+         VertexBufferDescriptor const & outDesc,
+         float * outQ,
+         float * outDQU,
+         float * outDQV );
+
+void
+evalLoopBasis(Far::PatchParam::BitField bits, float u, float v,
+              Far::StencilTables const & basisStencils,
+              int stencilIndex,
+              VertexBufferDescriptor const & inDesc,
+              float const * inQ,
+              VertexBufferDescriptor const & outDesc,
+              float * outQ,
+              float * outDQU,
+              float * outDQV );
+
 void
 evalGregory(Far::PatchParam::BitField bits, float u, float v,
             Far::Index const * vertexIndices,
@@ -26,14 +26,13 @@
 #define OSD_TBB_KERNEL_H
 
 #include "../version.h"
+#include "../osd/vertexDescriptor.h"
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
 namespace Osd {
 
-struct VertexBufferDescriptor;
-
 void
 TbbComputeStencils(VertexBufferDescriptor const &vertexDesc,
                    float const * vertexSrc,
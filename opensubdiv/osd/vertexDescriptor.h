@@ -26,6 +26,7 @@
 #define OSD_CPU_VERTEX_DESCRIPTOR_H
 
 #include "../version.h"
+#include "../far/vertexBufferDescriptor.h"
 #include <string.h>
 
 namespace OpenSubdiv {
@@ -33,44 +34,9 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Osd {
 
-/// \brief Describes vertex elements in interleaved data buffers
-struct VertexBufferDescriptor {
-
-    /// Default Constructor
-    VertexBufferDescriptor() : offset(0), length(0), stride(0) { }
-
-    /// Constructor
-    VertexBufferDescriptor(int o, int l, int s) : offset(o), length(l), stride(s) { }
-
-    /// True if the descriptor values are internally consistent
-    bool IsValid() const {
-        return ((length>0) and (offset<stride) and (length<=stride-offset));
-    }
-
-    /// True if the 'other' descriptor can be used as a destination for
-    /// data evaluations.
-    bool CanEval( VertexBufferDescriptor const & other ) const {
-        return (IsValid() and
-                other.IsValid() and
-                (length==other.length));
-    }
-
-    /// Resets the descriptor to default
-    void Reset() {
-        offset = length = stride = 0;
-    }
-
-    /// True if the descriptors are identical
-    bool operator == ( VertexBufferDescriptor const other ) const {
-        return (offset == other.offset and
-                length == other.length and
-                stride == other.stride);
-    }
-
-    int offset;  // offset to desired element data
-    int length;  // number or length of the data
-    int stride;  // stride to the next element
-};
+/// \brief Describes vertex elements in interleaved data buffers (shared with
+///        the buffer variants of Far::TopologyRefiner::Interpolate())
+typedef Far::VertexBufferDescriptor VertexBufferDescriptor;
 
 } // end namespace Osd
 
@@ -76,8 +76,9 @@ Scheme<SCHEME_BILINEAR>::ComputeVertexVertexMask(VERTEX const& vertex, MASK& mas
 
 
 //
-//  Limit masks for any bilinear vertex are the vertex itself, with all tangents being
-//  zero for now as tangents are not unique (what did Hbr do?):
+//  Limit masks for any bilinear vertex are the vertex itself.  Tangents are not unique,
+//  so those of the first incident face are used -- the derivatives of its bilinear
+//  patch along the leading edge and the next edge:
 //
 template <>
 template <typename VERTEX, typename MASK>
@@ -103,21 +104,30 @@ Scheme<SCHEME_BILINEAR>::assignBoundaryLimitMask(VERTEX const& vertex, MASK& pos
 template <>
 template <typename VERTEX, typename MASK>
 inline void
-Scheme<SCHEME_BILINEAR>::assignInteriorLimitTangentMasks(VERTEX const& /* vertex */,
+Scheme<SCHEME_BILINEAR>::assignInteriorLimitTangentMasks(VERTEX const& vertex,
         MASK& tan1Mask, MASK& tan2Mask) const {
 
+    int numEdges = vertex.GetNumEdges();
+
     tan1Mask.SetNumVertexWeights(1);
-    tan1Mask.SetNumEdgeWeights(0);
+    tan1Mask.SetNumEdgeWeights(numEdges);
     tan1Mask.SetNumFaceWeights(0);
     tan1Mask.SetFaceWeightsForFaceCenters(false);
 
     tan2Mask.SetNumVertexWeights(1);
-    tan2Mask.SetNumEdgeWeights(0);
+    tan2Mask.SetNumEdgeWeights(numEdges);
     tan2Mask.SetNumFaceWeights(0);
     tan2Mask.SetFaceWeightsForFaceCenters(false);
 
-    tan1Mask.VertexWeight(0) = 0.0f;
-    tan2Mask.VertexWeight(0) = 0.0f;
+    for (int i = 0; i < numEdges; ++i) {
+        tan1Mask.EdgeWeight(i) = 0.0f;
+        tan2Mask.EdgeWeight(i) = 0.0f;
+    }
+    tan1Mask.VertexWeight(0) = -1.0f;
+    tan1Mask.EdgeWeight(0) = 1.0f;
+
+    tan2Mask.VertexWeight(0) = -1.0f;
+    tan2Mask.EdgeWeight(1) = 1.0f;
 }
 
 template <>
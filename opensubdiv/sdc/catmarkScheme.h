@@ -276,26 +276,98 @@ Scheme<SCHEME_CATMARK>::assignInteriorLimitMask(VERTEX const& vertex, MASK& posM
 }
 
 //
-//  Limit masks for tangents -- these are stubs for now, or have a temporary
-//  implementation
+//  Limit masks for tangents:
+//
+//  Tangents are scaled to be the derivatives of the limit surface with respect
+//  to a parameterization in which the incident edges are of unit length, i.e.
+//  in the regular case they match the derivatives of the bicubic patch whose
+//  corner is the vertex, with 'tan1' along the leading edge and 'tan2' along
+//  the next edge (counter-clockwise).
+//
+//  At boundaries, 'tan1' is the derivative of the cubic B-spline boundary
+//  curve and 'tan2' points across the boundary into the interior.  The latter
+//  is exact for the regular case and only defines the tangent plane for other
+//  valences.
 //
 template <>
 template <typename VERTEX, typename MASK>
 inline void
-Scheme<SCHEME_CATMARK>::assignBoundaryLimitTangentMasks(VERTEX const& /* vertex */,
+Scheme<SCHEME_CATMARK>::assignBoundaryLimitTangentMasks(VERTEX const& vertex,
         MASK& tan1Mask, MASK& tan2Mask) const {
 
+    typedef typename MASK::Weight Weight;
+
+    int numFaces = vertex.GetNumFaces();
+    int numEdges = vertex.GetNumEdges();
+
     tan1Mask.SetNumVertexWeights(1);
-    tan1Mask.SetNumEdgeWeights(0);
+    tan1Mask.SetNumEdgeWeights(numEdges);
     tan1Mask.SetNumFaceWeights(0);
     tan1Mask.SetFaceWeightsForFaceCenters(false);
-    tan1Mask.VertexWeight(0) = 0.0f;
 
     tan2Mask.SetNumVertexWeights(1);
-    tan2Mask.SetNumEdgeWeights(0);
-    tan2Mask.SetNumFaceWeights(0);
+    tan2Mask.SetNumEdgeWeights(numEdges);
+    tan2Mask.SetNumFaceWeights(numFaces);
     tan2Mask.SetFaceWeightsForFaceCenters(false);
-    tan2Mask.VertexWeight(0) = 0.0f;
+
+    //  The tangent along the boundary (leading edge minus trailing edge):
+    tan1Mask.VertexWeight(0) = 0.0f;
+    for (int i = 0; i < numEdges; ++i) {
+        tan1Mask.EdgeWeight(i) = 0.0f;
+    }
+    tan1Mask.EdgeWeight(0) = 0.5f;
+    tan1Mask.EdgeWeight(numEdges - 1) = -0.5f;
+
+    //  The tangent across the boundary -- the left eigenvector of the subdivision
+    //  matrix of the boundary 1-ring for its largest symmetric sub-dominant
+    //  eigenvalue 'lambda' (the first two cases are trivial and the second regular):
+    for (int i = 0; i < numFaces; ++i) {
+        tan2Mask.FaceWeight(i) = 0.0f;
+    }
+    if (numFaces == 1) {
+        tan2Mask.VertexWeight(0) = -1.0f;
+        tan2Mask.EdgeWeight(0) = 0.5f;
+        tan2Mask.EdgeWeight(1) = 0.5f;
+    } else if (numFaces == 2) {
+        tan2Mask.VertexWeight(0) = -4.0f / 6.0f;
+        tan2Mask.EdgeWeight(0) = -1.0f / 6.0f;
+        tan2Mask.EdgeWeight(1) =  4.0f / 6.0f;
+        tan2Mask.EdgeWeight(2) = -1.0f / 6.0f;
+        tan2Mask.FaceWeight(0) =  1.0f / 6.0f;
+        tan2Mask.FaceWeight(1) =  1.0f / 6.0f;
+    } else {
+        //  Interior edge and face weights are proportional to sin(i*theta) and
+        //  sin(i*theta) + sin((i+1)*theta) respectively, which leaves the vertex
+        //  and boundary edge weights to be solved for:
+        double theta    = M_PI / numFaces;
+        double cosTheta = std::cos(theta);
+        double sinTheta = std::sin(theta);
+        double sumSin   = (1.0 + cosTheta) / sinTheta;
+
+        double mu     = ((1.0 + cosTheta) +
+                         std::sqrt((1.0 + cosTheta) * (9.0 + cosTheta))) / 16.0;
+        double lambda = 0.25 + mu;
+        double fScale = 1.0 / (16.0 * mu);
+
+        double vWeight = (sinTheta * (1.0 / 16.0 + 0.25 * fScale) +
+                          (lambda - 0.5) * sumSin * (0.375 + 0.5 * fScale)) /
+                         ((lambda - 0.5) * (lambda - 0.75) - 0.125);
+        double cWeight = vWeight * (lambda - 0.75) - sumSin * (0.375 + 0.5 * fScale);
+
+        //  Scaled consistently with the regular case (2/3 of its eigenvector)
+        double scale = 2.0 / 3.0;
+
+        tan2Mask.VertexWeight(0) = (Weight) (scale * vWeight);
+        tan2Mask.EdgeWeight(0) = (Weight) (scale * cWeight);
+        tan2Mask.EdgeWeight(numEdges - 1) = (Weight) (scale * cWeight);
+        for (int i = 1; i < numEdges - 1; ++i) {
+            tan2Mask.EdgeWeight(i) = (Weight) (scale * std::sin(theta * i));
+        }
+        for (int i = 0; i < numFaces; ++i) {
+            tan2Mask.FaceWeight(i) = (Weight) (scale * fScale *
+                (std::sin(theta * i) + std::sin(theta * (i + 1))));
+        }
+    }
 }
 
 template <>
@@ -309,25 +381,38 @@ Scheme<SCHEME_CATMARK>::assignInteriorLimitTangentMasks(VERTEX const& vertex,
     int valence = vertex.GetNumFaces();
     assert(valence != 2);
 
-    //  Using the Loop tangent masks for now...
     tan1Mask.SetNumVertexWeights(1);
     tan1Mask.SetNumEdgeWeights(valence);
-    tan1Mask.SetNumFaceWeights(0);
+    tan1Mask.SetNumFaceWeights(valence);
     tan1Mask.SetFaceWeightsForFaceCenters(false);
 
     tan2Mask.SetNumVertexWeights(1);
     tan2Mask.SetNumEdgeWeights(valence);
-    tan2Mask.SetNumFaceWeights(0);
+    tan2Mask.SetNumFaceWeights(valence);
     tan2Mask.SetFaceWeightsForFaceCenters(false);
 
     tan1Mask.VertexWeight(0) = 0.0f;
     tan2Mask.VertexWeight(0) = 0.0f;
 
-    Weight alpha = (Weight) (2.0f * M_PI / valence);
+    //  The eigenvector weights of Halstead et al. -- the face i lies between
+    //  edges i and i+1 -- scaled to match the derivative in the regular case:
+    double alpha    = 2.0 * M_PI / valence;
+    double cosAlpha = std::cos(alpha);
+    double edgeScale = 1.0 + cosAlpha +
+                       std::cos(0.5 * alpha) * std::sqrt(2.0 * (9.0 + cosAlpha));
+    double scale = 1.0 / (3.0 * valence);
+
     for (int i = 0; i < valence; ++i) {
-        double alphaI = alpha * i;
-        tan1Mask.EdgeWeight(i) = cos(alphaI);
-        tan2Mask.EdgeWeight(i) = sin(alphaI);
+        double cosI  = std::cos(alpha * i),
+               sinI  = std::sin(alpha * i),
+               cosI1 = std::cos(alpha * (i + 1)),
+               sinI1 = std::sin(alpha * (i + 1));
+
+        tan1Mask.EdgeWeight(i) = (Weight) (scale * edgeScale * cosI);
+        tan1Mask.FaceWeight(i) = (Weight) (scale * (cosI + cosI1));
+
+        tan2Mask.EdgeWeight(i) = (Weight) (scale * edgeScale * sinI);
+        tan2Mask.FaceWeight(i) = (Weight) (scale * (sinI + sinI1));
     }
 }
 
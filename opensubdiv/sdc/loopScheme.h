@@ -29,6 +29,7 @@
 #include "../sdc/scheme.h"
 
 #include <cassert>
+#include <cmath>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -275,25 +276,70 @@ Scheme<SCHEME_LOOP>::assignInteriorLimitMask(VERTEX const& vertex, MASK& posMask
 //
 //  Limit masks for tangents:
 //
+//  Tangents are scaled to be the derivatives of the limit surface with respect
+//  to a parameterization in which the incident edges are of unit length:  in
+//  the regular case, 'tan1' is the derivative along the leading edge and 'tan2'
+//  the derivative in the orthogonal direction (counter-clockwise) of an
+//  equilateral embedding of the triangles.
+//
+//  At boundaries, 'tan1' is the derivative of the cubic B-spline boundary
+//  curve and 'tan2' points across the boundary into the interior.  The latter
+//  is exact for the regular case and only defines the tangent plane for other
+//  valences.
+//
 template <>
 template <typename VERTEX, typename MASK>
 inline void
-Scheme<SCHEME_LOOP>::assignBoundaryLimitTangentMasks(VERTEX const& /* vertex */,
+Scheme<SCHEME_LOOP>::assignBoundaryLimitTangentMasks(VERTEX const& vertex,
         MASK& tan1Mask, MASK& tan2Mask) const {
 
-    //  Need to dig up formulae for this case...
+    typedef typename MASK::Weight Weight;
+
+    int numFaces = vertex.GetNumFaces();
+    int numEdges = vertex.GetNumEdges();
 
     tan1Mask.SetNumVertexWeights(1);
-    tan1Mask.SetNumEdgeWeights(0);
+    tan1Mask.SetNumEdgeWeights(numEdges);
     tan1Mask.SetNumFaceWeights(0);
     tan1Mask.SetFaceWeightsForFaceCenters(false);
-    tan1Mask.VertexWeight(0) = 0.0f;
 
     tan2Mask.SetNumVertexWeights(1);
-    tan2Mask.SetNumEdgeWeights(0);
+    tan2Mask.SetNumEdgeWeights(numEdges);
     tan2Mask.SetNumFaceWeights(0);
     tan2Mask.SetFaceWeightsForFaceCenters(false);
-    tan2Mask.VertexWeight(0) = 0.0f;
+
+    //  The tangent along the boundary (leading edge minus trailing edge):
+    tan1Mask.VertexWeight(0) = 0.0f;
+    for (int i = 0; i < numEdges; ++i) {
+        tan1Mask.EdgeWeight(i) = 0.0f;
+    }
+    tan1Mask.EdgeWeight(0) = 0.5f;
+    tan1Mask.EdgeWeight(numEdges - 1) = -0.5f;
+
+    //  The tangent across the boundary -- the left eigenvector of the subdivision
+    //  matrix of the boundary 1-ring for its largest symmetric sub-dominant
+    //  eigenvalue, i.e. the vertex and boundary edges weighted by -1 and -cos(theta)
+    //  and the interior edges proportional to sin(i*theta):
+    if (numFaces == 1) {
+        tan2Mask.VertexWeight(0) = -1.0f;
+        tan2Mask.EdgeWeight(0) = 0.5f;
+        tan2Mask.EdgeWeight(1) = 0.5f;
+    } else {
+        double theta    = M_PI / numFaces;
+        double cosTheta = std::cos(theta);
+        double sinTheta = std::sin(theta);
+        double eScale   = (1.0 + 2.0 * cosTheta) * (1.0 - cosTheta) / sinTheta;
+
+        //  Scaled by 1/sqrt(3) to match the derivative of the regular case
+        double scale = 1.0 / std::sqrt(3.0);
+
+        tan2Mask.VertexWeight(0) = (Weight) -scale;
+        tan2Mask.EdgeWeight(0) = (Weight) (-scale * cosTheta);
+        tan2Mask.EdgeWeight(numEdges - 1) = (Weight) (-scale * cosTheta);
+        for (int i = 1; i < numEdges - 1; ++i) {
+            tan2Mask.EdgeWeight(i) = (Weight) (scale * eScale * std::sin(theta * i));
+        }
+    }
 }
 
 template <>
@@ -320,11 +366,13 @@ Scheme<SCHEME_LOOP>::assignInteriorLimitTangentMasks(VERTEX const& vertex,
     tan1Mask.VertexWeight(0) = 0.0f;
     tan2Mask.VertexWeight(0) = 0.0f;
 
+    //  Scaled by 2/valence to match the derivative in the regular case:
     Weight alpha = (Weight) (2.0f * M_PI / valence);
+    Weight scale = 2.0f / (Weight) valence;
     for (int i = 0; i < valence; ++i) {
         double alphaI = alpha * i;
-        tan1Mask.EdgeWeight(i) = cos(alphaI);
-        tan2Mask.EdgeWeight(i) = sin(alphaI);
+        tan1Mask.EdgeWeight(i) = scale * (Weight) cos(alphaI);
+        tan2Mask.EdgeWeight(i) = scale * (Weight) sin(alphaI);
     }
 }
 
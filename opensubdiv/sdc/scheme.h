@@ -115,13 +115,15 @@ public:
                                     Crease::Rule childRule = Crease::RULE_UNKNOWN) const;
 
     ///
-    ///  \brief IN PROGRESS -- NOT YET FULLY FUNCTIONAL...
+    ///  \brief Masks for limit points and tangents
     ///
-    ///  Masks for limit points and tangents -- note that these require the vertex be
-    ///  suitably isolated such that its limit is well-defined.
+    ///  Note that these require the vertex be suitably isolated such that its limit is
+    ///  well-defined, i.e. its incident faces are regular and it is either smooth or on a
+    ///  boundary (semi-sharp and infinitely sharp features are not yet supported).
     ///
-    ///  These are stubs that are still being completed.  The position masks are now
-    ///  supported but tangent masks need work.
+    ///  Tangents are derivatives with respect to unit length incident edges, the first
+    ///  along the leading edge and the second towards the next edge (counter-clockwise).
+    ///  They are exact in the regular case, but only define the tangent plane elsewhere.
     ///
     template <typename VERTEX, typename MASK>
     void ComputeVertexLimitMask(VERTEX const& vertexNeighborhood, MASK& positionMask) const;
@@ -171,6 +173,8 @@ protected:
     void assignBoundaryLimitTangentMasks(VERTEX const& vertex, MASK& tan1, MASK& tan2) const;
     template <typename VERTEX, typename MASK>
     void assignInteriorLimitTangentMasks(VERTEX const& vertex, MASK& tan1, MASK& tan2) const;
+    template <typename VERTEX, typename MASK>
+    void assignCornerLimitTangentMasks(VERTEX const& vertex, MASK& tan1, MASK& tan2) const;
 
 private:
     Options _options;
@@ -318,6 +322,40 @@ Scheme<SCHEME>::assignCornerMaskForVertex(VERTEX const&, MASK& mask) const {
     mask.VertexWeight(0) = 1.0f;
 }
 
+//
+//  Tangents at a corner are those of the two boundary curves, each a cubic B-spline
+//  interpolating its end point, i.e. the difference of the vertex with the end points
+//  of the leading and trailing edges:
+//
+template <SchemeType SCHEME>
+template <typename VERTEX, typename MASK>
+inline void
+Scheme<SCHEME>::assignCornerLimitTangentMasks(VERTEX const& vertex,
+        MASK& tan1Mask, MASK& tan2Mask) const {
+
+    int numEdges = vertex.GetNumEdges();
+
+    tan1Mask.SetNumVertexWeights(1);
+    tan1Mask.SetNumEdgeWeights(numEdges);
+    tan1Mask.SetNumFaceWeights(0);
+    tan1Mask.SetFaceWeightsForFaceCenters(false);
+
+    tan2Mask.SetNumVertexWeights(1);
+    tan2Mask.SetNumEdgeWeights(numEdges);
+    tan2Mask.SetNumFaceWeights(0);
+    tan2Mask.SetFaceWeightsForFaceCenters(false);
+
+    for (int i = 0; i < numEdges; ++i) {
+        tan1Mask.EdgeWeight(i) = 0.0f;
+        tan2Mask.EdgeWeight(i) = 0.0f;
+    }
+    tan1Mask.VertexWeight(0) = -1.0f;
+    tan1Mask.EdgeWeight(0) = 1.0f;
+
+    tan2Mask.VertexWeight(0) = -1.0f;
+    tan2Mask.EdgeWeight(numEdges - 1) = 1.0f;
+}
+
 
 //
 //  The computation of a face-vertex mask is trivial and consistent for all schemes:
@@ -603,6 +641,10 @@ Scheme<SCHEME>::ComputeVertexLimitMask(VERTEX const& vertex,
     if (vertex.GetNumFaces() == vertex.GetNumEdges()) {
         assignInteriorLimitMask(vertex, posMask);
         assignInteriorLimitTangentMasks(vertex, tan1Mask, tan2Mask);
+    } else if ((vertex.GetNumFaces() == 1) &&
+               (_options.GetVtxBoundaryInterpolation() == Sdc::Options::VTX_BOUNDARY_EDGE_AND_CORNER)) {
+        assignCornerMaskForVertex(vertex, posMask);
+        assignCornerLimitTangentMasks(vertex, tan1Mask, tan2Mask);
     } else {
         assignBoundaryLimitMask(vertex, posMask);
         assignBoundaryLimitTangentMasks(vertex, tan1Mask, tan2Mask);
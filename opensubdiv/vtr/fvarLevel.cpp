@@ -59,6 +59,19 @@ FVarLevel::FVarLevel(Level const& level) :
 FVarLevel::~FVarLevel() {
 }
 
+size_t
+FVarLevel::getMemoryUsage() const {
+
+    return VectorMemoryUsage(_faceVertValues)
+         + VectorMemoryUsage(_edgeTags)
+         + VectorMemoryUsage(_vertSiblingCounts)
+         + VectorMemoryUsage(_vertSiblingOffsets)
+         + VectorMemoryUsage(_vertFaceSiblings)
+         + VectorMemoryUsage(_vertValueIndices)
+         + VectorMemoryUsage(_vertValueTags)
+         + VectorMemoryUsage(_vertValueCreaseEnds);
+}
+
 //
 //  Initialization and sizing methods to allocate space:
 //
@@ -471,6 +484,59 @@ FVarLevel::getVertexCreaseEndValues(Index vIndex, Sibling vSibling, Index endVal
     endValues[1] = face1Values[endInFace1];
 }
 
+//
+//  Identifies the values associated with the vertices of a regular patch around the given
+//  face, i.e. the values to be used for bicubic interpolation of the face.
+//
+//  The limit surface over the face only depends on the rules applied to its corner vertices
+//  and incident edges, so the face-varying topology must only match the vertex topology at
+//  the corners -- any discts edge incident a corner also tags that corner as mismatched.  The
+//  values of the remaining patch vertices are then retrieved from the faces incident the
+//  corners (which cover the extent of the patch), and the gather fails if these faces do not
+//  agree on a single value for a vertex or if a patch vertex is not found among them.
+//
+bool
+FVarLevel::gatherPatchValues(Index fIndex, Index const patchVerts[], int numPatchVerts,
+                             Index patchValues[]) const {
+
+    if (_isLinear) {
+        return false;
+    }
+
+    ConstIndexArray fVerts = _level.getFaceVertices(fIndex);
+    for (int i = 0; i < fVerts.size(); ++i) {
+        if (!valueTopologyMatches(getVertexValueOffset(fVerts[i]))) {
+            return false;
+        }
+    }
+
+    std::fill(patchValues, patchValues + numPatchVerts, (Index) INDEX_INVALID);
+
+    for (int i = 0; i < fVerts.size(); ++i) {
+        ConstIndexArray vFaces = _level.getVertexFaces(fVerts[i]);
+
+        for (int j = 0; j < vFaces.size(); ++j) {
+            ConstIndexArray faceVerts  = _level.getFaceVertices(vFaces[j]);
+            ConstIndexArray faceValues = getFaceValues(vFaces[j]);
+
+            for (int k = 0; k < faceVerts.size(); ++k) {
+                Index const * patchVert = std::find(patchVerts, patchVerts + numPatchVerts, faceVerts[k]);
+                if (patchVert == (patchVerts + numPatchVerts)) {
+                    continue;
+                }
+                Index & value = patchValues[patchVert - patchVerts];
+                if (value == INDEX_INVALID) {
+                    value = faceValues[k];
+                } else if (value != faceValues[k]) {
+                    return false;
+                }
+            }
+        }
+    }
+    return std::find(patchValues, patchValues + numPatchVerts, (Index) INDEX_INVALID) ==
+           (patchValues + numPatchVerts);
+}
+
 //
 //  Debugging aids...
 //
@@ -43,6 +43,7 @@ namespace OPENSUBDIV_VERSION {
 //  Forward declaration of friend classes:
 namespace Far {
     class TopologyRefiner;
+    class TopologyRefinerCache;
 }
 namespace Vtr {
     class Refinement;
@@ -89,6 +90,7 @@ protected:
     friend class Refinement;
     friend class FVarRefinement;
     friend class Far::TopologyRefiner;
+    friend class Far::TopologyRefinerCache;
 
 protected:
     //
@@ -204,6 +206,8 @@ protected:
     void getVertexEdgeValues(Index vIndex, Index valuesPerEdge[]) const;
     void getVertexCreaseEndValues(Index vIndex, Sibling sibling, Index endValues[2]) const;
 
+    bool gatherPatchValues(Index fIndex, Index const patchVerts[], int numPatchVerts, Index patchValues[]) const;
+
     //  Initialization and allocation helpers:
     void setOptions(Sdc::Options const& options);
     void resizeVertexValues(int numVertexValues);
@@ -224,6 +228,9 @@ protected:
     };
     void gatherValueSpans(Index vIndex, ValueSpan * vValueSpans) const;
 
+    //  Memory allocated for the channel (in bytes):
+    size_t getMemoryUsage() const;
+
     //  Debugging methods:
     bool validate() const;
     void print() const;
@@ -274,30 +281,30 @@ protected:
 inline ConstIndexArray
 FVarLevel::getFaceValues(Index fIndex) const {
 
-    int vCount  = _level._faceVertCountsAndOffsets[fIndex*2];
-    int vOffset = _level._faceVertCountsAndOffsets[fIndex*2+1];
+    int vCount  = _level.getNumFaceVertices(fIndex);
+    int vOffset = _level.getOffsetOfFaceVertices(fIndex);
     return ConstIndexArray(&_faceVertValues[vOffset], vCount);
 }
 inline IndexArray
 FVarLevel::getFaceValues(Index fIndex) {
 
-    int vCount  = _level._faceVertCountsAndOffsets[fIndex*2];
-    int vOffset = _level._faceVertCountsAndOffsets[fIndex*2+1];
+    int vCount  = _level.getNumFaceVertices(fIndex);
+    int vOffset = _level.getOffsetOfFaceVertices(fIndex);
     return IndexArray(&_faceVertValues[vOffset], vCount);
 }
 
 inline FVarLevel::ConstSiblingArray
 FVarLevel::getVertexFaceSiblings(Index vIndex) const {
 
-    int vCount  = _level._vertFaceCountsAndOffsets[vIndex*2];
-    int vOffset = _level._vertFaceCountsAndOffsets[vIndex*2+1];
+    int vCount  = _level.getNumVertexFaces(vIndex);
+    int vOffset = _level.getOffsetOfVertexFaces(vIndex);
     return ConstSiblingArray(&_vertFaceSiblings[vOffset], vCount);
 }
 inline FVarLevel::SiblingArray
 FVarLevel::getVertexFaceSiblings(Index vIndex) {
 
-    int vCount  = _level._vertFaceCountsAndOffsets[vIndex*2];
-    int vOffset = _level._vertFaceCountsAndOffsets[vIndex*2+1];
+    int vCount  = _level.getNumVertexFaces(vIndex);
+    int vOffset = _level.getOffsetOfVertexFaces(vIndex);
     return SiblingArray(&_vertFaceSiblings[vOffset], vCount);
 }
 
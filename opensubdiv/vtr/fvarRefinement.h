@@ -45,6 +45,7 @@ namespace OPENSUBDIV_VERSION {
 //
 namespace Far {
     class TopologyRefiner;
+    class TopologyRefinerCache;
 }
 
 //
@@ -66,6 +67,7 @@ class FVarRefinement {
 protected:
     friend class Refinement;
     friend class Far::TopologyRefiner;
+    friend class Far::TopologyRefinerCache;
 
 protected:
     FVarRefinement(Refinement const& refinement, FVarLevel& parent, FVarLevel& child);
@@ -33,7 +33,6 @@
 #include <cstring>
 #include <algorithm>
 #include <vector>
-#include <map>
 
 #ifdef _MSC_VER
     #define snprintf _snprintf
@@ -62,7 +61,8 @@ Level::Level() :
     _vertCount(0),
     _depth(0),
     _maxEdgeFaces(0),
-    _maxValence(0) {
+    _maxValence(0),
+    _uniformFaceSize(0) {
 }
 
 Level::~Level() {
@@ -71,6 +71,54 @@ Level::~Level() {
     }
 }
 
+//
+//  Memory accounting -- the capacity of the vectors is reported rather than their size
+//  as that is what has been allocated:
+//
+size_t
+Level::getRelationMemoryUsage(Relation relation) const {
+
+    switch (relation) {
+        case RELATION_FACE_VERTICES :
+            return VectorMemoryUsage(_faceVertOffsets) + VectorMemoryUsage(_faceVertIndices);
+        case RELATION_FACE_EDGES :
+            return VectorMemoryUsage(_faceEdgeIndices);
+        case RELATION_EDGE_VERTICES :
+            return VectorMemoryUsage(_edgeVertIndices);
+        case RELATION_EDGE_FACES :
+            return VectorMemoryUsage(_edgeFaceOffsets) + VectorMemoryUsage(_edgeFaceIndices);
+        case RELATION_VERTEX_FACES :
+            return VectorMemoryUsage(_vertFaceOffsets) + VectorMemoryUsage(_vertFaceIndices)
+                 + VectorMemoryUsage(_vertFaceLocalIndices);
+        case RELATION_VERTEX_EDGES :
+            return VectorMemoryUsage(_vertEdgeOffsets) + VectorMemoryUsage(_vertEdgeIndices)
+                 + VectorMemoryUsage(_vertEdgeLocalIndices);
+        default :
+            assert("Unknown relation" == 0);
+    }
+    return 0;
+}
+
+size_t
+Level::getTagMemoryUsage() const {
+    return VectorMemoryUsage(_faceTags) + VectorMemoryUsage(_edgeTags) + VectorMemoryUsage(_vertTags);
+}
+
+size_t
+Level::getSharpnessMemoryUsage() const {
+    return VectorMemoryUsage(_edgeSharpness) + VectorMemoryUsage(_vertSharpness);
+}
+
+size_t
+Level::getFVarMemoryUsage() const {
+
+    size_t bytes = 0;
+    for (int i = 0; i < (int)_fvarChannels.size(); ++i) {
+        bytes += _fvarChannels[i]->getMemoryUsage();
+    }
+    return bytes;
+}
+
 
 char const *
 Level::getTopologyErrorString(TopologyError errCode) {
@@ -411,7 +459,10 @@ Level::print(const Refinement* pRefinement) const {
     printf("  Topology relation sizes:\n");
 
     printf("    Face relations:\n");
-    printf("      face-vert counts/offset = %lu\n", (unsigned long)_faceVertCountsAndOffsets.size());
+    printf("      face-vert offsets = %lu\n", (unsigned long)_faceVertOffsets.size());
+    if (_uniformFaceSize) {
+        printf("      face-vert uniform size = %d\n", _uniformFaceSize);
+    }
     printf("      face-vert indices = %lu\n", (unsigned long)_faceVertIndices.size());
     if (_faceVertIndices.size()) {
         for (int i = 0; printFaceVerts && i < getNumFaces(); ++i) {
@@ -448,7 +499,7 @@ Level::print(const Refinement* pRefinement) const {
             printIndexArray(getEdgeVertices(i));
         }
     }
-    printf("      edge-face counts/offset = %lu\n", (unsigned long)_edgeFaceCountsAndOffsets.size());
+    printf("      edge-face offsets = %lu\n", (unsigned long)_edgeFaceOffsets.size());
     printf("      edge-face indices = %lu\n", (unsigned long)_edgeFaceIndices.size());
     if (_edgeFaceIndices.size()) {
         for (int i = 0; printEdgeFaces && i < getNumEdges(); ++i) {
@@ -477,7 +528,7 @@ Level::print(const Refinement* pRefinement) const {
     }
 
     printf("    Vert relations:\n");
-    printf("      vert-face counts/offset = %lu\n", (unsigned long)_vertFaceCountsAndOffsets.size());
+    printf("      vert-face offsets  = %lu\n", (unsigned long)_vertFaceOffsets.size());
     printf("      vert-face indices  = %lu\n", (unsigned long)_vertFaceIndices.size());
     printf("      vert-face children = %lu\n", (unsigned long)_vertFaceLocalIndices.size());
     if (_vertFaceIndices.size()) {
@@ -489,7 +540,7 @@ Level::print(const Refinement* pRefinement) const {
             printIndexArray(getVertexFaceLocalIndices(i));
         }
     }
-    printf("      vert-edge counts/offset = %lu\n", (unsigned long)_vertEdgeCountsAndOffsets.size());
+    printf("      vert-edge offsets  = %lu\n", (unsigned long)_vertEdgeOffsets.size());
     printf("      vert-edge indices  = %lu\n", (unsigned long)_vertEdgeIndices.size());
     printf("      vert-edge children = %lu\n", (unsigned long)_vertEdgeLocalIndices.size());
     if (_vertEdgeIndices.size()) {
@@ -1242,172 +1293,145 @@ Level::isSingleCreasePatch(Index face, float *sharpnessOut, int *rotationOut) co
 }
 
 //
-//  What follows is an internal/anonymous class and protected methods to complete all
-//  topological relations when only the face-vertex relations is defined.
+//  Gathering the 12 vertices of a tri-regular patch -- interior or with boundaries:
+//      - the face and its neighborhood are assumed to be tri-regular (see isTriRegularPatch())
+//      - the vertices follow the ordering of gatherTriRegularInteriorPatchVertices()
+//      - vertices missing on a boundary are assigned INDEX_INVALID
 //
-//  In keeping with the original idea that Level is just data and relies on other
-//  classes to construct it, this functionality may be warranted elsewhere, but we are
-//  collectively unclear as to where that should be at present.  In the meantime, the
-//  implementation is provided here so that we can test and make use of it.
+//  Each vertex of the face contributes the vertices of its incident edges, which are
+//  located relative to the edge of the face leading from it -- their position in the
+//  patch is given by the direction of the edge in the triangular lattice of the patch:
 //
-namespace {
-    //
-    //  This is an internal helper class to manage the assembly of the tological relations
-    //  that do not have a predictable size, i.e. faces-per-edge, faces-per-vertex and
-    //  edges-per-vertex.  Level manages these with two vectors:
-    //
-    //      - a vector of integer pairs for the "counts" and "offsets"
-    //      - a vector of incident members accessed by the "offset" of each
-    //
-    //  The "dynamic relation" allocates the latter vector of members based on a typical
-    //  number of members per component, e.g. we expect valence 4 vertices in a typical
-    //  quad-mesh, and so an "expected" number might be 6 to accomodate a few x-ordinary
-    //  vertices.  The member vector is allocated with this number per component and the
-    //  counts and offsets initialized to refer to them -- but with the counts set to 0.
-    //  The count will be incremented as members are identified and entered, and if any
-    //  component "overflows" the expected number of members, the members are moved to a
-    //  separate vector in an std::map for the component.
-    //
-    //  Once all incident members have been added, the main vector is compressed and may
-    //  need to merge entries from the map in the process.
-    //
-    typedef std::map<Index, IndexVector> IrregIndexMap;
-
-    class DynamicRelation {
-    public:
-        DynamicRelation(IndexVector& countAndOffsets, IndexVector& indices, int membersPerComp);
-        ~DynamicRelation() { }
-
-    public:
-        //  Methods dealing with the members for each component:
-        IndexArray getCompMembers(Index index);
-        void          appendCompMember(Index index, Index member);
-
-        //  Methods dealing with the components:
-        void appendComponent();
-        void compressMemberIndices();
+/*                  9           8
+//                  X - - - - - X
+//                /   \       /   \
+//              /       \   /       \
+//        10  X - - - - - X - - - - - X  7
+//          /   \       / 2 \       /   \
+//        /       \   /       \   /       \
+//  11  X - - - - - X - - - - - X - - - - - X  6
+//        \       / 0 \       / 1 \       /
+//          \   /       \   /       \   /
+//            X - - - - - X - - - - - X
+//            3           4           5
+*/
+//  The edges leaving vertex 0 are ordered CCW to vertices 1, 2, 10, 11, 3 and 4.
+//
+int
+Level::gatherTriRegularPatchVertices(Index fIndex, Index points[12]) const
+{
+    //  Patch position of the vertex at the end of each of the 6 CCW lattice directions
+    //  from each vertex of the face -- direction 0 pointing along edge 0 from vertex 0:
+    static int const latticePoints[3][6] = { {  1,  2, 10, 11,  3,  4 },
+                                             {  6,  7,  2,  0,  4,  5 },
+                                             {  7,  8,  9, 10,  0,  1 } };
 
-    public:
-        int _compCount;
-        int _memberCountPerComp;
+    ConstIndexArray fVerts = getFaceVertices(fIndex);
+    ConstIndexArray fEdges = getFaceEdges(fIndex);
 
-        IndexVector & _countsAndOffsets;
-        IndexVector & _regIndices;
+    for (int i = 3; i < 12; ++i) {
+        points[i] = INDEX_INVALID;
+    }
+    for (int i = 0; i < 3; ++i) {
+        points[i] = fVerts[i];
+    }
 
-        IrregIndexMap _irregIndices;
-    };
+    for (int i = 0; i < 3; ++i) {
+        ConstIndexArray vEdges = getVertexEdges(fVerts[i]);
 
-    inline
-    DynamicRelation::DynamicRelation(IndexVector& countAndOffsets, IndexVector& indices, int membersPerComp) :
-            _compCount(0),
-            _memberCountPerComp(membersPerComp),
-            _countsAndOffsets(countAndOffsets),
-            _regIndices(indices) {
+        //  Edge i leaves vertex i in lattice direction 2*i:
+        int eInVEdges = vEdges.FindIndex(fEdges[i]);
+        assert(eInVEdges >= 0);
 
-        _compCount = (int) _countsAndOffsets.size() / 2;
+        for (int j = 0; j < vEdges.size(); ++j) {
+            int direction = (2*i + 6 + j - eInVEdges) % 6;
 
-        for (int i = 0; i < _compCount; ++i) {
-            _countsAndOffsets[2*i]   = 0;
-            _countsAndOffsets[2*i+1] = i * _memberCountPerComp;
+            points[latticePoints[i][direction]] = otherOfTwo(getEdgeVertices(vEdges[j]), fVerts[i]);
         }
-        _regIndices.resize(_compCount * _memberCountPerComp);
     }
+    return 12;
+}
 
-    inline IndexArray
-    DynamicRelation::getCompMembers(Index compIndex) {
+//
+//  Tests if a triangle can be represented by a regular Loop (box-spline) patch:  all of
+//  its vertices must be regular and smooth, or regular boundary (crease) and corner
+//  vertices.  The patch supports the boundary configurations of a single boundary edge,
+//  two boundary edges meeting at a corner, or a single boundary vertex whose boundary
+//  edges are not edges of the face.
+//
+//  When a patch is supported, the optional mask returned identifies either the boundary
+//  edges of the face or, when it has no boundary edges, its boundary vertex.
+//
+bool
+Level::isTriRegularPatch(Index face, int* boundaryMaskOut, bool* vertexMaskOut) const {
 
-        int count = _countsAndOffsets[2*compIndex];
-        if (count > _memberCountPerComp) {
-            IndexVector & irregMembers = _irregIndices[compIndex];
-            return IndexArray(&irregMembers[0], (int)irregMembers.size());
-        } else {
-            int offset = _countsAndOffsets[2*compIndex+1];
-            return IndexArray(&_regIndices[offset], count);
-        }
-    }
-    inline void
-    DynamicRelation::appendCompMember(Index compIndex, Index memberValue) {
+    ConstIndexArray fVerts = getFaceVertices(face);
+    if (fVerts.size() != 3) return false;
 
-        int count  = _countsAndOffsets[2*compIndex];
-        int offset = _countsAndOffsets[2*compIndex+1];
+    ConstIndexArray fEdges = getFaceEdges(face);
 
-        if (count < _memberCountPerComp) {
-            _regIndices[offset + count] = memberValue;
-        } else {
-            IndexVector& irregMembers = _irregIndices[compIndex];
+    int vertMask = 0;
+    int edgeMask = 0;
+    for (int i = 0; i < 3; ++i) {
+        VTag vTag = getVertexTag(fVerts[i]);
+
+        if (vTag._nonManifold || vTag._xordinary || vTag._semiSharp) return false;
 
-            if (count > _memberCountPerComp) {
-                irregMembers.push_back(memberValue);
+        if (!vTag._boundary) {
+            if (vTag._rule != Sdc::Crease::RULE_SMOOTH) return false;
+        } else {
+            //  Regular boundary vertices have 4 edges, regular corners 2:
+            int nEdges = getVertexEdges(fVerts[i]).size();
+            if (nEdges == 4) {
+                if (vTag._rule != Sdc::Crease::RULE_CREASE) return false;
+            } else if (nEdges == 2) {
+                if (vTag._rule != Sdc::Crease::RULE_CORNER) return false;
             } else {
-                irregMembers.resize(_memberCountPerComp + 1);
-                std::memcpy(&irregMembers[0], &_regIndices[offset], sizeof(Index) * _memberCountPerComp);
-                irregMembers[_memberCountPerComp] = memberValue;
+                return false;
             }
+            vertMask |= 1 << i;
+        }
+        if (getEdgeTag(fEdges[i])._boundary) {
+            edgeMask |= 1 << i;
         }
-        _countsAndOffsets[2*compIndex] ++;
     }
-    inline void
-    DynamicRelation::appendComponent() {
-
-        _countsAndOffsets.push_back(0);
-        _countsAndOffsets.push_back(_compCount * _memberCountPerComp);
 
-        ++ _compCount;
-        _regIndices.resize(_compCount * _memberCountPerComp);
+    bool isVertexMask = false;
+    switch (edgeMask) {
+        case 0x0:
+            //  No boundary edge -- a single boundary vertex at most:
+            if (vertMask & (vertMask - 1)) return false;
+            isVertexMask = (vertMask != 0);
+            break;
+        case 0x1:
+        case 0x2:
+        case 0x4:
+            //  A single boundary edge -- the opposite vertex must be interior:
+            if (vertMask != (edgeMask | ((edgeMask << 1) & 0x7) | (edgeMask >> 2))) return false;
+            break;
+        case 0x3:
+        case 0x5:
+        case 0x6:
+            //  Two boundary edges meeting at a corner
+            break;
+        default:
+            return false;
     }
-    void
-    DynamicRelation::compressMemberIndices() {
-
-        if (_irregIndices.size() == 0) {
-            int memberCount = _countsAndOffsets[0];
-            for (int i = 1; i < _compCount; ++i) {
-                int count  = _countsAndOffsets[2*i];
-                int offset = _countsAndOffsets[2*i + 1];
-
-                memmove(&_regIndices[memberCount], &_regIndices[offset], count * sizeof(Index));
 
-                _countsAndOffsets[2*i + 1] = memberCount;
-                memberCount += count;
-            }
-            _regIndices.resize(memberCount);
-        } else {
-            //  Assign new offsets-per-component while determining if we can trivially compressed in place:
-            bool cannotBeCompressedInPlace = false;
-
-            int memberCount = _countsAndOffsets[0];
-            for (int i = 1; i < _compCount; ++i) {
-                _countsAndOffsets[2*i + 1] = memberCount;
-
-                cannotBeCompressedInPlace |= (memberCount > (_memberCountPerComp * i));
-
-                memberCount += _countsAndOffsets[2*i];
-            }
-            cannotBeCompressedInPlace |= (memberCount > (_memberCountPerComp * _compCount));
-
-            //  Copy members into the original or temporary vector accordingly:
-            IndexVector  tmpIndices;
-            if (cannotBeCompressedInPlace) {
-                tmpIndices.resize(memberCount);
-            }
-            IndexVector& dstIndices = cannotBeCompressedInPlace ? tmpIndices : _regIndices;
-            for (int i = 0; i < _compCount; ++i) {
-                int count = _countsAndOffsets[2*i];
-
-                Index *dstMembers = &dstIndices[_countsAndOffsets[2*i + 1]];
-                Index *srcMembers = (count <= _memberCountPerComp)
-                                     ? &_regIndices[i * _memberCountPerComp]
-                                     : &_irregIndices[i][0];
-                memmove(dstMembers, srcMembers, count * sizeof(Index));
-            }
-            if (cannotBeCompressedInPlace) {
-                _regIndices.swap(tmpIndices);
-            } else {
-                _regIndices.resize(memberCount);
-            }
-        }
-    }
+    if (boundaryMaskOut) *boundaryMaskOut = isVertexMask ? vertMask : edgeMask;
+    if (vertexMaskOut) *vertexMaskOut = isVertexMask;
+    return true;
 }
 
+//
+//  What follows are protected methods to complete all topological relations when only
+//  the face-vertex relations is defined.
+//
+//  In keeping with the original idea that Level is just data and relies on other
+//  classes to construct it, this functionality may be warranted elsewhere, but we are
+//  collectively unclear as to where that should be at present.  In the meantime, the
+//  implementation is provided here so that we can test and make use of it.
+//
 
 //
 //  Methods to populate the missing topology relations of the Level:
@@ -1438,8 +1462,23 @@ Level::findEdge(Index v0Index, Index v1Index) const {
     return this->findEdge(v0Index, v1Index, this->getVertexEdges(v0Index));
 }
 
+namespace {
+    //
+    //  Ordering of the face-edge "slots" of a bucket by the greater of their two vertices
+    //  (and by slot to be deterministic):
+    //
+    struct SlotLess {
+        SlotLess(Index const * maxVerts) : _maxVerts(maxVerts) { }
+
+        bool operator()(Index a, Index b) const {
+            return (_maxVerts[a] < _maxVerts[b]) || ((_maxVerts[a] == _maxVerts[b]) && (a < b));
+        }
+        Index const * _maxVerts;
+    };
+}
+
 void
-Level::completeTopologyFromFaceVertices() {
+Level::completeTopologyFromFaceVertices(bool parallel) {
 
     //
     //  Its assumed (a pre-condition) that face-vertices have been fully specified and that we
@@ -1460,65 +1499,182 @@ Level::completeTopologyFromFaceVertices() {
     this->resizeFaces(fCount);
     this->resizeEdges(0);
 
+    //  Silence unused parameter warnings when OpenMP is not available:
+    (void) parallel;
+
+    //
+    //  Rather than searching the edges incident each vertex as faces are traversed, the
+    //  edges are identified by sorting the vertex pairs of all face-edges -- one for each
+    //  face-vertex, referred to as a "slot" here.  The pairs are bucketed by their lesser
+    //  vertex (a counting sort) and each bucket, typically no larger than the valence of
+    //  the vertex, is then sorted by the greater vertex.  Each run of matching pairs in a
+    //  bucket is an edge (possibly non-manifold), which is numbered in the order of its
+    //  leading slot -- the order in which edges are first encountered when traversing the
+    //  faces, so the resulting relations are identical to those of an incremental search.
     //
-    //  Resize face-edges to match face-verts and reserve for edges based on an estimate:
+    //  The slots of each face, the sorting of each bucket and the population of edges from
+    //  the runs are independent and so populated concurrently when requested -- only a few
+    //  linear counting passes (and prefix sums) remain serial:
     //
-    this->_faceEdgeIndices.resize(this->getNumFaceVerticesTotal());
+    int sCount = this->getNumFaceVerticesTotal();
 
-    int eCountEstimate = (vCount << 1);
+    this->_faceEdgeIndices.resize(sCount);
 
-    this->_edgeVertIndices.reserve(eCountEstimate * 2);
-    this->_edgeFaceIndices.reserve(eCountEstimate * 2);
+    IndexVector slotFaces(sCount);
+    IndexVector slotMinVerts(sCount);
+    IndexVector slotMaxVerts(sCount);
 
-    this->_edgeFaceCountsAndOffsets.reserve(eCountEstimate * 2);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (parallel)
+#endif
+    for (Index fIndex = 0; fIndex < fCount; ++fIndex) {
+        ConstIndexArray fVerts  = this->getFaceVertices(fIndex);
+        Index           fOffset = this->getOffsetOfFaceVertices(fIndex);
+
+        for (int i = 0; i < fVerts.size(); ++i) {
+            Index v0Index = fVerts[i];
+            Index v1Index = fVerts[(i+1) % fVerts.size()];
+
+            slotFaces[fOffset + i]    = fIndex;
+            slotMinVerts[fOffset + i] = std::min(v0Index, v1Index);
+            slotMaxVerts[fOffset + i] = std::max(v0Index, v1Index);
+        }
+    }
+    for (Index fIndex = 0; fIndex < fCount; ++fIndex) {
+        _maxValence = std::max(_maxValence, this->getNumFaceVertices(fIndex));
+    }
 
     //
-    //  Create the dynamic relations to be populated (edge-faces will remain empty as reserved
-    //  above since there are currently no edges) and iterate through the faces to do so:
+    //  Bucket the slots by their lesser vertex (in order of the slots within each bucket):
     //
-    const int avgSize = 6;
+    IndexVector bucketOffsets(vCount + 1, 0);
+    IndexVector bucketSlots(sCount);
 
-    DynamicRelation dynEdgeFaces(this->_edgeFaceCountsAndOffsets, this->_edgeFaceIndices, 2);
-    DynamicRelation dynVertFaces(this->_vertFaceCountsAndOffsets, this->_vertFaceIndices, avgSize);
-    DynamicRelation dynVertEdges(this->_vertEdgeCountsAndOffsets, this->_vertEdgeIndices, avgSize);
+    for (Index sIndex = 0; sIndex < sCount; ++sIndex) {
+        ++ bucketOffsets[slotMinVerts[sIndex] + 1];
+    }
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        bucketOffsets[vIndex + 1] += bucketOffsets[vIndex];
+    }
+    {
+        IndexVector bucketSizes(vCount, 0);
+        for (Index sIndex = 0; sIndex < sCount; ++sIndex) {
+            Index vIndex = slotMinVerts[sIndex];
+            bucketSlots[bucketOffsets[vIndex] + bucketSizes[vIndex]++] = sIndex;
+        }
+    }
 
-    for (Index fIndex = 0; fIndex < fCount; ++fIndex) {
-        IndexArray fVerts = this->getFaceVertices(fIndex);
-        IndexArray fEdges = this->getFaceEdges(fIndex);
+    //
+    //  Sort each bucket by the greater vertex and assign the leading slot of each run to
+    //  all slots of the run (reusing the lesser vertices of the slots, no longer needed):
+    //
+    IndexVector & slotLeads = slotMinVerts;
 
-        for (int i = 0; i < fVerts.size(); ++i) {
-            Index v0Index = fVerts[i];
-            Index v1Index = fVerts[(i+1) % fVerts.size()];
+    SlotLess slotLess(slotMaxVerts.empty() ? 0 : &slotMaxVerts[0]);
 
-            //  Look for the edge in v0's incident edge members:
-            IndexArray v0Edges = dynVertEdges.getCompMembers(v0Index);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (parallel)
+#endif
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        Index * bSlots = &bucketSlots[0] + bucketOffsets[vIndex];
+        int     bCount = bucketOffsets[vIndex + 1] - bucketOffsets[vIndex];
 
-            Index eIndex = this->findEdge(v0Index, v1Index, v0Edges);
+        std::sort(bSlots, bSlots + bCount, slotLess);
 
-            //  If no edge found, create/append a new one:
-            if (!IndexIsValid(eIndex)) {
-                eIndex = (Index) this->_edgeCount;
+        for (int i = 0; i < bCount; ++i) {
+            bool leading = (i == 0) || (slotMaxVerts[bSlots[i]] != slotMaxVerts[bSlots[i-1]]);
 
-                this->_edgeCount ++;
-                this->_edgeVertIndices.push_back(v0Index);
-                this->_edgeVertIndices.push_back(v1Index);
+            slotLeads[bSlots[i]] = leading ? bSlots[i] : slotLeads[bSlots[i-1]];
+        }
+    }
 
-                dynEdgeFaces.appendComponent();
+    //
+    //  Number the edges in the order of their leading slots, assigning their vertices as
+    //  they first occur, then assign the edges of all other slots from their leading slot:
+    //
+    IndexVector edgeLeadingSlots;
+    edgeLeadingSlots.reserve(vCount << 1);
+    for (Index sIndex = 0; sIndex < sCount; ++sIndex) {
+        if (slotLeads[sIndex] == sIndex) {
+            edgeLeadingSlots.push_back(sIndex);
+        }
+    }
+    eCount = (int) edgeLeadingSlots.size();
 
-                dynVertEdges.appendCompMember(v0Index, eIndex);
-                dynVertEdges.appendCompMember(v1Index, eIndex);
-            }
-            dynEdgeFaces.appendCompMember(eIndex,  fIndex);
-            dynVertFaces.appendCompMember(v0Index, fIndex);
+    this->_edgeCount = eCount;
+    this->_edgeVertIndices.resize(2 * eCount);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (parallel)
+#endif
+    for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
+        Index sIndex = edgeLeadingSlots[eIndex];
+
+        ConstIndexArray fVerts = this->getFaceVertices(slotFaces[sIndex]);
+        int             vInFace = sIndex - this->getOffsetOfFaceVertices(slotFaces[sIndex]);
 
-            fEdges[i] = eIndex;
+        this->_edgeVertIndices[2*eIndex]     = fVerts[vInFace];
+        this->_edgeVertIndices[2*eIndex + 1] = fVerts[(vInFace + 1) % fVerts.size()];
+
+        this->_faceEdgeIndices[sIndex] = eIndex;
+    }
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (parallel)
+#endif
+    for (Index sIndex = 0; sIndex < sCount; ++sIndex) {
+        if (slotLeads[sIndex] != sIndex) {
+            this->_faceEdgeIndices[sIndex] = this->_faceEdgeIndices[slotLeads[sIndex]];
         }
-        _maxValence = std::max(_maxValence, fVerts.size());
     }
 
-    dynEdgeFaces.compressMemberIndices();
-    dynVertFaces.compressMemberIndices();
-    dynVertEdges.compressMemberIndices();
+    //
+    //  Edge-faces and vertex-faces in the order of the slots, and vertex-edges in the order
+    //  of the edges (as they would have been appended incrementally):
+    //
+    this->_edgeFaceOffsets.assign(eCount + 1, 0);
+    this->_vertFaceOffsets.assign(vCount + 1, 0);
+    this->_vertEdgeOffsets.assign(vCount + 1, 0);
+
+    for (Index sIndex = 0; sIndex < sCount; ++sIndex) {
+        ++ this->_edgeFaceOffsets[this->_faceEdgeIndices[sIndex] + 1];
+        ++ this->_vertFaceOffsets[this->_faceVertIndices[sIndex] + 1];
+    }
+    for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
+        ++ this->_vertEdgeOffsets[this->_edgeVertIndices[2*eIndex] + 1];
+        ++ this->_vertEdgeOffsets[this->_edgeVertIndices[2*eIndex + 1] + 1];
+    }
+    for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
+        this->_edgeFaceOffsets[eIndex + 1] += this->_edgeFaceOffsets[eIndex];
+    }
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        this->_vertFaceOffsets[vIndex + 1] += this->_vertFaceOffsets[vIndex];
+        this->_vertEdgeOffsets[vIndex + 1] += this->_vertEdgeOffsets[vIndex];
+    }
+
+    this->_edgeFaceIndices.resize(sCount);
+    this->_vertFaceIndices.resize(sCount);
+    this->_vertEdgeIndices.resize(2 * eCount);
+    {
+        IndexVector edgeFaceCounts(eCount, 0);
+        IndexVector vertFaceCounts(vCount, 0);
+        IndexVector vertEdgeCounts(vCount, 0);
+
+        for (Index sIndex = 0; sIndex < sCount; ++sIndex) {
+            Index eIndex = this->_faceEdgeIndices[sIndex];
+            Index vIndex = this->_faceVertIndices[sIndex];
+
+            this->_edgeFaceIndices[this->_edgeFaceOffsets[eIndex] + edgeFaceCounts[eIndex]++] = slotFaces[sIndex];
+            this->_vertFaceIndices[this->_vertFaceOffsets[vIndex] + vertFaceCounts[vIndex]++] = slotFaces[sIndex];
+        }
+        for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
+            Index v0Index = this->_edgeVertIndices[2*eIndex];
+            Index v1Index = this->_edgeVertIndices[2*eIndex + 1];
+
+            this->_vertEdgeIndices[this->_vertEdgeOffsets[v0Index] + vertEdgeCounts[v0Index]++] = eIndex;
+            this->_vertEdgeIndices[this->_vertEdgeOffsets[v1Index] + vertEdgeCounts[v1Index]++] = eIndex;
+        }
+    }
 
     //
     //  At this point all incident members are associated with each component.  We now need
@@ -1766,6 +1922,46 @@ Level::destroyFVarChannel(int channel) {
     _fvarChannels.erase(_fvarChannels.begin() + channel);
 }
 
+//
+//  Releasing the topology of a Level -- only the component counts remain:
+//
+namespace {
+    template <typename T>
+    inline void
+    releaseVector(std::vector<T> & v) {
+        std::vector<T>().swap(v);
+    }
+}
+
+void
+Level::releaseTopology() {
+
+    releaseVector(_faceVertOffsets);
+    releaseVector(_faceVertIndices);
+    releaseVector(_faceEdgeIndices);
+    releaseVector(_faceTags);
+
+    releaseVector(_edgeVertIndices);
+    releaseVector(_edgeFaceOffsets);
+    releaseVector(_edgeFaceIndices);
+    releaseVector(_edgeSharpness);
+    releaseVector(_edgeTags);
+
+    releaseVector(_vertFaceOffsets);
+    releaseVector(_vertFaceIndices);
+    releaseVector(_vertFaceLocalIndices);
+    releaseVector(_vertEdgeOffsets);
+    releaseVector(_vertEdgeIndices);
+    releaseVector(_vertEdgeLocalIndices);
+    releaseVector(_vertSharpness);
+    releaseVector(_vertTags);
+
+    for (int i = 0; i < (int)_fvarChannels.size(); ++i) {
+        delete _fvarChannels[i];
+    }
+    releaseVector(_fvarChannels);
+}
+
 int
 Level::getNumFVarValues(int channel) const {
     return _fvarChannels[channel]->getNumValues();
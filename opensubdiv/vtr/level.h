@@ -46,6 +46,7 @@ namespace Far {
     class TopologyRefinerFactoryBase;
     class TopologyRefiner;
     class PatchTablesFactory;
+    class TopologyRefinerCache;
 }
 
 namespace Vtr {
@@ -177,6 +178,9 @@ public:
 
     ETag getFaceCompositeETag(ConstIndexArray & faceEdges) const;
 
+    VTag getVertexTag(Index vertIndex) const { return _vertTags[vertIndex]; }
+    ETag getEdgeTag(Index edgeIndex) const   { return _edgeTags[edgeIndex]; }
+
 public:
     Level();
     ~Level();
@@ -199,6 +203,23 @@ public:
     int getMaxValence() const { return _maxValence; }
     int getMaxEdgeFaces() const { return _maxEdgeFaces; }
 
+    //  Memory allocated for each of the six topological relations (including offsets and
+    //  local indices) and for the remaining per-component data, in bytes -- intended for
+    //  instrumentation of the construction and refinement of levels:
+    enum Relation {
+        RELATION_FACE_VERTICES,
+        RELATION_FACE_EDGES,
+        RELATION_EDGE_VERTICES,
+        RELATION_EDGE_FACES,
+        RELATION_VERTEX_FACES,
+        RELATION_VERTEX_EDGES,
+        NUM_RELATIONS
+    };
+    size_t getRelationMemoryUsage(Relation relation) const;
+    size_t getTagMemoryUsage() const;
+    size_t getSharpnessMemoryUsage() const;
+    size_t getFVarMemoryUsage() const;
+
     //  Methods to access the relation tables/indices -- note that for some relations
     //  we store an additional "local index", e.g. for the case of vert-faces if one
     //  of the faces F[i] is incident a vertex V, then L[i] is the "local index" in
@@ -285,8 +306,10 @@ public:
     int gatherTriRegularBoundaryEdgePatchVertices(  Index fIndex, Index patchVerts[], int boundaryEdgeInFace) const;
     int gatherTriRegularCornerVertexPatchVertices(  Index fIndex, Index patchVerts[], int cornerVertInFace) const;
     int gatherTriRegularCornerEdgePatchVertices(    Index fIndex, Index patchVerts[], int cornerEdgeInFace) const;
+    int gatherTriRegularPatchVertices(              Index fIndex, Index patchVerts[]) const;
 
     bool isSingleCreasePatch(Index face, float* sharpnessOut=NULL, int* rotationOut=NULL) const;
+    bool isTriRegularPatch(Index face, int* boundaryMaskOut=NULL, bool* vertexMaskOut=NULL) const;
 
 protected:
 
@@ -300,6 +323,7 @@ protected:
     friend class Far::TopologyRefinerFactoryBase;
     friend class Far::TopologyRefiner;
     friend class Far::PatchTablesFactory;
+    friend class Far::TopologyRefinerCache;
 
     //  Sizing methods used to construct a level to populate:
     void resizeFaces(       int numFaces);
@@ -314,6 +338,10 @@ protected:
     void resizeVertexFaces(int numVertexFacesTotal);
     void resizeVertexEdges(int numVertexEdgesTotal);
 
+    //  Release the memory of all relations, tags and face-varying channels while
+    //  retaining the component counts -- for levels no longer needed once refined:
+    void releaseTopology();
+
     //  Modifiers to populate the relations for each component:
     IndexArray      getFaceVertices(Index faceIndex);
     IndexArray      getFaceEdges(Index faceIndex);
@@ -342,8 +370,9 @@ protected:
 
     //  Counts and offsets for all relation types:
     //      - these may be unwarranted if we let Refinement access members directly...
-    int getNumFaceVertices(     Index faceIndex) const { return _faceVertCountsAndOffsets[2*faceIndex]; }
-    int getOffsetOfFaceVertices(Index faceIndex) const { return _faceVertCountsAndOffsets[2*faceIndex + 1]; }
+    //      - counts are implied by consecutive offsets (see the member vectors below)
+    int getNumFaceVertices(     Index faceIndex) const;
+    int getOffsetOfFaceVertices(Index faceIndex) const;
 
     int getNumFaceEdges(     Index faceIndex) const { return getNumFaceVertices(faceIndex); }
     int getOffsetOfFaceEdges(Index faceIndex) const { return getOffsetOfFaceVertices(faceIndex); }
@@ -351,14 +380,18 @@ protected:
     int getNumEdgeVertices(     Index )          const { return 2; }
     int getOffsetOfEdgeVertices(Index edgeIndex) const { return 2 * edgeIndex; }
 
-    int getNumEdgeFaces(     Index edgeIndex) const { return _edgeFaceCountsAndOffsets[2*edgeIndex]; }
-    int getOffsetOfEdgeFaces(Index edgeIndex) const { return _edgeFaceCountsAndOffsets[2*edgeIndex + 1]; }
+    int getNumEdgeFaces(     Index edgeIndex) const { return _edgeFaceOffsets[edgeIndex+1] - _edgeFaceOffsets[edgeIndex]; }
+    int getOffsetOfEdgeFaces(Index edgeIndex) const { return _edgeFaceOffsets[edgeIndex]; }
 
-    int getNumVertexFaces(     Index vertIndex) const { return _vertFaceCountsAndOffsets[2*vertIndex]; }
-    int getOffsetOfVertexFaces(Index vertIndex) const { return _vertFaceCountsAndOffsets[2*vertIndex + 1]; }
+    int getNumVertexFaces(     Index vertIndex) const { return _vertFaceOffsets[vertIndex+1] - _vertFaceOffsets[vertIndex]; }
+    int getOffsetOfVertexFaces(Index vertIndex) const { return _vertFaceOffsets[vertIndex]; }
 
-    int getNumVertexEdges(     Index vertIndex) const { return _vertEdgeCountsAndOffsets[2*vertIndex]; }
-    int getOffsetOfVertexEdges(Index vertIndex) const { return _vertEdgeCountsAndOffsets[2*vertIndex + 1]; }
+    int getNumVertexEdges(     Index vertIndex) const { return _vertEdgeOffsets[vertIndex+1] - _vertEdgeOffsets[vertIndex]; }
+    int getOffsetOfVertexEdges(Index vertIndex) const { return _vertEdgeOffsets[vertIndex]; }
+
+    //  Faces of a uniform size (all refined levels) have implicit counts and offsets:
+    bool hasUniformFaceSize() const { return _uniformFaceSize != 0; }
+    void setUniformFaceSize(int faceSize);
 
 
     //
@@ -368,7 +401,8 @@ protected:
     //  of incident components.  Assuming adequate memory has been allocated, the
     //  "resize" methods here initialize the set of incident components by setting
     //  both the size and the appropriate offset, while "trim" is use to quickly lower
-    //  the size from an upper bound and nothing else.
+    //  the size from an upper bound and nothing else.  Since the offset of each is
+    //  that following the previous component, both must be applied in order.
     //
     void resizeFaceVertices(Index FaceIndex, int count);
 
@@ -389,7 +423,7 @@ protected:
     //  externally (either a Factory outside Vtr or another Vtr construction helper), but
     //  until we decide where, the required implementation is defined here.
     //
-    void completeTopologyFromFaceVertices();
+    void completeTopologyFromFaceVertices(bool parallel = false);
     Index findEdge(Index v0, Index v1, ConstIndexArray v0Edges) const;
 
     //  Methods supporting the above:
@@ -398,7 +432,7 @@ protected:
     bool orderVertexFacesAndEdges(Index vIndex);
     void populateLocalIndices();
 
-    IndexArray shareFaceVertCountsAndOffsets() const;
+    IndexArray shareFaceVertOffsets() const;
 
 protected:
     //
@@ -419,6 +453,7 @@ protected:
     int _depth;
     int _maxEdgeFaces;
     int _maxValence;
+    int _uniformFaceSize;  // non-zero when all faces are of this size
 
     //
     //  Topology vectors:
@@ -438,26 +473,41 @@ protected:
     //      and child components, and so has been named to reflect that more clearly.
     //
 
+    //  The incident components of variable size are located by a vector of offsets --
+    //  one per component plus a final one for the total -- where the count for each
+    //  component is the difference between its offset and the next.  The face-vert
+    //  offsets are not needed (and left empty) when all faces are the same size, as
+    //  is the case for all refined levels.
+    //
+    //  Since the resize and trim methods write the offset following the component
+    //  (i.e. the offset of the next), components sized that way must be sized in
+    //  increasing order from zero-initialized offsets, and any trim of a component
+    //  must be applied before the next component is sized -- trimming afterward
+    //  would shift the start of the next component and corrupt its relations.  The
+    //  trim methods assert this.  Offsets assigned all at once (e.g. accumulated
+    //  from known counts for parallel refinement) must not be trimmed at all.
+    //
+
     //  Per-face:
-    std::vector<Index> _faceVertCountsAndOffsets;  // 2 per face, redundant after level 0
+    std::vector<Index> _faceVertOffsets;           // 1 per face + 1, empty when uniform
     std::vector<Index> _faceVertIndices;           // 3 or 4 per face, variable at level 0
     std::vector<Index> _faceEdgeIndices;           // matches face-vert indices
     std::vector<FTag>  _faceTags;                  // 1 per face:  includes "hole" tag
 
     //  Per-edge:
     std::vector<Index> _edgeVertIndices;           // 2 per edge
-    std::vector<Index> _edgeFaceCountsAndOffsets;  // 2 per edge
+    std::vector<Index> _edgeFaceOffsets;           // 1 per edge + 1
     std::vector<Index> _edgeFaceIndices;           // varies with faces per edge
 
     std::vector<float> _edgeSharpness;             // 1 per edge
     std::vector<ETag>  _edgeTags;                  // 1 per edge:  manifold, boundary, etc.
 
     //  Per-vertex:
-    std::vector<Index>      _vertFaceCountsAndOffsets;  // 2 per vertex
+    std::vector<Index>      _vertFaceOffsets;           // 1 per vertex + 1
     std::vector<Index>      _vertFaceIndices;           // varies with valence
     std::vector<LocalIndex> _vertFaceLocalIndices;      // varies with valence, 8-bit for now
 
-    std::vector<Index>      _vertEdgeCountsAndOffsets;  // 2 per vertex
+    std::vector<Index>      _vertEdgeOffsets;           // 1 per vertex + 1
     std::vector<Index>      _vertEdgeIndices;           // varies with valence
     std::vector<LocalIndex> _vertEdgeLocalIndices;      // varies with valence, 8-bit for now
 
@@ -468,28 +518,48 @@ protected:
     std::vector<FVarLevel*> _fvarChannels;
 };
 
+//
+//  Counts and offsets of the vertices (and edges) of a face -- implicit if uniform:
+//
+inline int
+Level::getNumFaceVertices(Index faceIndex) const {
+    return _uniformFaceSize ? _uniformFaceSize
+                            : (_faceVertOffsets[faceIndex+1] - _faceVertOffsets[faceIndex]);
+}
+inline int
+Level::getOffsetOfFaceVertices(Index faceIndex) const {
+    return _uniformFaceSize ? (faceIndex * _uniformFaceSize) : _faceVertOffsets[faceIndex];
+}
+
+inline void
+Level::setUniformFaceSize(int faceSize) {
+    _uniformFaceSize = faceSize;
+
+    std::vector<Index>().swap(_faceVertOffsets);
+
+    _maxValence = std::max(_maxValence, faceSize);
+}
+
 //
 //  Access/modify the vertices indicent a given face:
 //
 inline ConstIndexArray
 Level::getFaceVertices(Index faceIndex) const {
-    return ConstIndexArray(&_faceVertIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return ConstIndexArray(&_faceVertIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 inline IndexArray
 Level::getFaceVertices(Index faceIndex) {
-    return IndexArray(&_faceVertIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return IndexArray(&_faceVertIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 
 inline void
 Level::resizeFaceVertices(Index faceIndex, int count) {
     assert(count < 256);
+    assert(!_uniformFaceSize);
 
-    int* countOffsetPair = &_faceVertCountsAndOffsets[faceIndex*2];
-
-    countOffsetPair[0] = count;
-    countOffsetPair[1] = (faceIndex == 0) ? 0 : (countOffsetPair[-2] + countOffsetPair[-1]);
+    _faceVertOffsets[faceIndex+1] = _faceVertOffsets[faceIndex] + count;
 
     _maxValence = std::max(_maxValence, count);
 }
@@ -499,13 +569,13 @@ Level::resizeFaceVertices(Index faceIndex, int count) {
 //
 inline ConstIndexArray
 Level::getFaceEdges(Index faceIndex) const {
-    return ConstIndexArray(&_faceEdgeIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return ConstIndexArray(&_faceEdgeIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 inline IndexArray
 Level::getFaceEdges(Index faceIndex) {
-    return IndexArray(&_faceEdgeIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return IndexArray(&_faceEdgeIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 
 //
@@ -513,36 +583,37 @@ Level::getFaceEdges(Index faceIndex) {
 //
 inline ConstIndexArray
 Level::getVertexFaces(Index vertIndex) const {
-    return ConstIndexArray(&_vertFaceIndices[_vertFaceCountsAndOffsets[vertIndex*2+1]],
-                          _vertFaceCountsAndOffsets[vertIndex*2]);
+    return ConstIndexArray(&_vertFaceIndices[getOffsetOfVertexFaces(vertIndex)],
+                          getNumVertexFaces(vertIndex));
 }
 inline IndexArray
 Level::getVertexFaces(Index vertIndex) {
-    return IndexArray(&_vertFaceIndices[_vertFaceCountsAndOffsets[vertIndex*2+1]],
-                          _vertFaceCountsAndOffsets[vertIndex*2]);
+    return IndexArray(&_vertFaceIndices[getOffsetOfVertexFaces(vertIndex)],
+                          getNumVertexFaces(vertIndex));
 }
 
 inline ConstLocalIndexArray
 Level::getVertexFaceLocalIndices(Index vertIndex) const {
-    return ConstLocalIndexArray(&_vertFaceLocalIndices[_vertFaceCountsAndOffsets[vertIndex*2+1]],
-                               _vertFaceCountsAndOffsets[vertIndex*2]);
+    return ConstLocalIndexArray(&_vertFaceLocalIndices[getOffsetOfVertexFaces(vertIndex)],
+                               getNumVertexFaces(vertIndex));
 }
 inline LocalIndexArray
 Level::getVertexFaceLocalIndices(Index vertIndex) {
-    return LocalIndexArray(&_vertFaceLocalIndices[_vertFaceCountsAndOffsets[vertIndex*2+1]],
-                               _vertFaceCountsAndOffsets[vertIndex*2]);
+    return LocalIndexArray(&_vertFaceLocalIndices[getOffsetOfVertexFaces(vertIndex)],
+                               getNumVertexFaces(vertIndex));
 }
 
 inline void
 Level::resizeVertexFaces(Index vertIndex, int count) {
-    int* countOffsetPair = &_vertFaceCountsAndOffsets[vertIndex*2];
-
-    countOffsetPair[0] = count;
-    countOffsetPair[1] = (vertIndex == 0) ? 0 : (countOffsetPair[-2] + countOffsetPair[-1]);
+    _vertFaceOffsets[vertIndex+1] = _vertFaceOffsets[vertIndex] + count;
 }
 inline void
 Level::trimVertexFaces(Index vertIndex, int count) {
-    _vertFaceCountsAndOffsets[vertIndex*2] = count;
+    //  Only lowers the size and must precede the sizing of the next component:
+    assert(count <= (_vertFaceOffsets[vertIndex+1] - _vertFaceOffsets[vertIndex]));
+    assert(((vertIndex+2) >= (Index)_vertFaceOffsets.size()) || (_vertFaceOffsets[vertIndex+2] == 0));
+
+    _vertFaceOffsets[vertIndex+1] = _vertFaceOffsets[vertIndex] + count;
 }
 
 //
@@ -550,38 +621,39 @@ Level::trimVertexFaces(Index vertIndex, int count) {
 //
 inline ConstIndexArray
 Level::getVertexEdges(Index vertIndex) const {
-    return ConstIndexArray(&_vertEdgeIndices[_vertEdgeCountsAndOffsets[vertIndex*2+1]],
-                          _vertEdgeCountsAndOffsets[vertIndex*2]);
+    return ConstIndexArray(&_vertEdgeIndices[getOffsetOfVertexEdges(vertIndex)],
+                          getNumVertexEdges(vertIndex));
 }
 inline IndexArray
 Level::getVertexEdges(Index vertIndex) {
-    return IndexArray(&_vertEdgeIndices[_vertEdgeCountsAndOffsets[vertIndex*2+1]],
-                          _vertEdgeCountsAndOffsets[vertIndex*2]);
+    return IndexArray(&_vertEdgeIndices[getOffsetOfVertexEdges(vertIndex)],
+                          getNumVertexEdges(vertIndex));
 }
 
 inline ConstLocalIndexArray
 Level::getVertexEdgeLocalIndices(Index vertIndex) const {
-    return ConstLocalIndexArray(&_vertEdgeLocalIndices[_vertEdgeCountsAndOffsets[vertIndex*2+1]],
-                               _vertEdgeCountsAndOffsets[vertIndex*2]);
+    return ConstLocalIndexArray(&_vertEdgeLocalIndices[getOffsetOfVertexEdges(vertIndex)],
+                               getNumVertexEdges(vertIndex));
 }
 inline LocalIndexArray
 Level::getVertexEdgeLocalIndices(Index vertIndex) {
-    return LocalIndexArray(&_vertEdgeLocalIndices[_vertEdgeCountsAndOffsets[vertIndex*2+1]],
-                               _vertEdgeCountsAndOffsets[vertIndex*2]);
+    return LocalIndexArray(&_vertEdgeLocalIndices[getOffsetOfVertexEdges(vertIndex)],
+                               getNumVertexEdges(vertIndex));
 }
 
 inline void
 Level::resizeVertexEdges(Index vertIndex, int count) {
-    int* countOffsetPair = &_vertEdgeCountsAndOffsets[vertIndex*2];
-
-    countOffsetPair[0] = count;
-    countOffsetPair[1] = (vertIndex == 0) ? 0 : (countOffsetPair[-2] + countOffsetPair[-1]);
+    _vertEdgeOffsets[vertIndex+1] = _vertEdgeOffsets[vertIndex] + count;
 
     _maxValence = std::max(_maxValence, count);
 }
 inline void
 Level::trimVertexEdges(Index vertIndex, int count) {
-    _vertEdgeCountsAndOffsets[vertIndex*2] = count;
+    //  Only lowers the size and must precede the sizing of the next component:
+    assert(count <= (_vertEdgeOffsets[vertIndex+1] - _vertEdgeOffsets[vertIndex]));
+    assert(((vertIndex+2) >= (Index)_vertEdgeOffsets.size()) || (_vertEdgeOffsets[vertIndex+2] == 0));
+
+    _vertEdgeOffsets[vertIndex+1] = _vertEdgeOffsets[vertIndex] + count;
 }
 
 //
@@ -601,27 +673,28 @@ Level::getEdgeVertices(Index edgeIndex) {
 //
 inline ConstIndexArray
 Level::getEdgeFaces(Index edgeIndex) const {
-    return ConstIndexArray(&_edgeFaceIndices[_edgeFaceCountsAndOffsets[edgeIndex*2+1]],
-                          _edgeFaceCountsAndOffsets[edgeIndex*2]);
+    return ConstIndexArray(&_edgeFaceIndices[getOffsetOfEdgeFaces(edgeIndex)],
+                          getNumEdgeFaces(edgeIndex));
 }
 inline IndexArray
 Level::getEdgeFaces(Index edgeIndex) {
-    return IndexArray(&_edgeFaceIndices[_edgeFaceCountsAndOffsets[edgeIndex*2+1]],
-                          _edgeFaceCountsAndOffsets[edgeIndex*2]);
+    return IndexArray(&_edgeFaceIndices[getOffsetOfEdgeFaces(edgeIndex)],
+                          getNumEdgeFaces(edgeIndex));
 }
 
 inline void
 Level::resizeEdgeFaces(Index edgeIndex, int count) {
-    int* countOffsetPair = &_edgeFaceCountsAndOffsets[edgeIndex*2];
-
-    countOffsetPair[0] = count;
-    countOffsetPair[1] = (edgeIndex == 0) ? 0 : (countOffsetPair[-2] + countOffsetPair[-1]);
+    _edgeFaceOffsets[edgeIndex+1] = _edgeFaceOffsets[edgeIndex] + count;
 
     _maxEdgeFaces = std::max(_maxEdgeFaces, count);
 }
 inline void
 Level::trimEdgeFaces(Index edgeIndex, int count) {
-    _edgeFaceCountsAndOffsets[edgeIndex*2] = count;
+    //  Only lowers the size and must precede the sizing of the next component:
+    assert(count <= (_edgeFaceOffsets[edgeIndex+1] - _edgeFaceOffsets[edgeIndex]));
+    assert(((edgeIndex+2) >= (Index)_edgeFaceOffsets.size()) || (_edgeFaceOffsets[edgeIndex+2] == 0));
+
+    _edgeFaceOffsets[edgeIndex+1] = _edgeFaceOffsets[edgeIndex] + count;
 }
 
 //
@@ -689,7 +762,9 @@ Level::isVertexNonManifold(Index vertIndex) const {
 inline void
 Level::resizeFaces(int faceCount) {
     _faceCount = faceCount;
-    _faceVertCountsAndOffsets.resize(2 * faceCount);
+    if (!_uniformFaceSize) {
+        _faceVertOffsets.resize(faceCount + 1, 0);
+    }
 
     _faceTags.resize(faceCount);
     std::memset(&_faceTags[0], 0, _faceCount * sizeof(FTag));
@@ -707,7 +782,7 @@ inline void
 Level::resizeEdges(int edgeCount) {
 
     _edgeCount = edgeCount;
-    _edgeFaceCountsAndOffsets.resize(2 * edgeCount);
+    _edgeFaceOffsets.resize(edgeCount + 1, 0);
 
     _edgeSharpness.resize(edgeCount);
     _edgeTags.resize(edgeCount);
@@ -731,8 +806,8 @@ inline void
 Level::resizeVertices(int vertCount) {
 
     _vertCount = vertCount;
-    _vertFaceCountsAndOffsets.resize(2 * vertCount);
-    _vertEdgeCountsAndOffsets.resize(2 * vertCount);
+    _vertFaceOffsets.resize(vertCount + 1, 0);
+    _vertEdgeOffsets.resize(vertCount + 1, 0);
 
     _vertSharpness.resize(vertCount);
     _vertTags.resize(vertCount);
@@ -752,11 +827,12 @@ Level::resizeVertexEdges(int totalVertEdgeCount) {
 }
 
 inline IndexArray
-Level::shareFaceVertCountsAndOffsets() const {
+Level::shareFaceVertOffsets() const {
+    assert(!_uniformFaceSize);
     // XXXX manuelk we have to force const casting here (classes don't 'share'
     // members usually...)
-    return IndexArray(const_cast<Index *>(&_faceVertCountsAndOffsets[0]),
-        (int)_faceVertCountsAndOffsets.size());
+    return IndexArray(const_cast<Index *>(&_faceVertOffsets[0]),
+        (int)_faceVertOffsets.size());
 }
 
 } // end namespace Vtr
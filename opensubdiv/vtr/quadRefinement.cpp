@@ -29,6 +29,11 @@
 #include <cassert>
 #include <cstdio>
 #include <utility>
+#include <algorithm>
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
 
 
 namespace OpenSubdiv {
@@ -69,17 +74,23 @@ QuadRefinement::allocateParentChildIndices() {
     int vertChildVertCount = _parent->getNumVertices();
 
     //
-    //  First reference the parent Level's face-vertex counts/offsets -- they can be used
-    //  here for both the face-child-faces and face-child-edges as they both have one per
-    //  face-vertex.
+    //  First reference the parent Level's face-vertex offsets -- they can be used here
+    //  for both the face-child-faces and face-child-edges as they both have one per
+    //  face-vertex.  If the parent's faces are all the same size, the offsets are
+    //  implicit and the face size serves as the stride for both.
     //
     //  Given we will be ignoring initial values with uniform refinement and assigning all
     //  directly, initializing here is a waste...
     //
     Index initValue = 0;
 
-    _faceChildFaceCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
-    _faceChildEdgeCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
+    if (_parent->hasUniformFaceSize()) {
+        _faceChildFaceStride = _parent->_uniformFaceSize;
+        _faceChildEdgeStride = _parent->_uniformFaceSize;
+    } else {
+        _faceChildFaceOffsets = _parent->shareFaceVertOffsets();
+        _faceChildEdgeOffsets = _parent->shareFaceVertOffsets();
+    }
 
     _faceChildFaceIndices.resize(faceChildFaceCount, initValue);
     _faceChildEdgeIndices.resize(faceChildEdgeCount, initValue);
@@ -91,6 +102,59 @@ QuadRefinement::allocateParentChildIndices() {
 }
 
 
+namespace {
+    //
+    //  Convert a vector of offsets, whose entries following the first have been assigned
+    //  the counts of the preceding component, into offsets, i.e. an inclusive prefix sum
+    //  of the counts.  The counts are divided into blocks whose sums can be computed and
+    //  applied concurrently:
+    //
+    void
+    accumulateOffsetsFromCounts(std::vector<Index> & offsets) {
+
+        int numCounts = (int)offsets.size() - 1;
+
+        int numBlocks = 1;
+#ifdef OPENSUBDIV_HAS_OPENMP
+        numBlocks = std::max(1, std::min(omp_get_max_threads(), numCounts / 4096));
+#endif
+        int blockSize = (numCounts + numBlocks - 1) / numBlocks;
+
+        std::vector<Index> blockOffsets(numBlocks + 1, 0);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for
+#endif
+        for (int block = 0; block < numBlocks; ++block) {
+            int countBegin = 1 + block * blockSize;
+            int countEnd   = 1 + std::min(block * blockSize + blockSize, numCounts);
+
+            Index blockSum = 0;
+            for (int i = countBegin; i < countEnd; ++i) {
+                blockSum += offsets[i];
+            }
+            blockOffsets[block + 1] = blockSum;
+        }
+        for (int block = 0; block < numBlocks; ++block) {
+            blockOffsets[block + 1] += blockOffsets[block];
+        }
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for
+#endif
+        for (int block = 0; block < numBlocks; ++block) {
+            int countBegin = 1 + block * blockSize;
+            int countEnd   = 1 + std::min(block * blockSize + blockSize, numCounts);
+
+            Index offset = offsets[0] + blockOffsets[block];
+            for (int i = countBegin; i < countEnd; ++i) {
+                offset += offsets[i];
+                offsets[i] = offset;
+            }
+        }
+    }
+}
+
 //
 //  Methods to populate the face-vertex relation of the child Level:
 //      - child faces only originate from parent faces
@@ -99,9 +163,10 @@ void
 QuadRefinement::populateFaceVertexRelation() {
 
     //  Both face-vertex and face-edge share the face-vertex counts/offsets within a
-    //  Level, so be sure not to re-initialize it if already done:
+    //  Level (implicit for the uniformly sized child faces), so be sure not to
+    //  re-initialize them if already done:
     //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
+    if (!_child->hasUniformFaceSize()) {
         populateFaceVertexCountsAndOffsets();
     }
     _child->_faceVertIndices.resize(_child->getNumFaces() * 4);
@@ -112,12 +177,8 @@ QuadRefinement::populateFaceVertexRelation() {
 void
 QuadRefinement::populateFaceVertexCountsAndOffsets() {
 
-    _child->_faceVertCountsAndOffsets.resize(_child->getNumFaces() * 2);
-
-    for (int i = 0; i < _child->getNumFaces(); ++i) {
-        _child->_faceVertCountsAndOffsets[i*2 + 0] = 4;
-        _child->_faceVertCountsAndOffsets[i*2 + 1] = i << 2;
-    }
+    //  All child faces are quads, so their counts and offsets are implicit:
+    _child->setUniformFaceSize(4);
 }
 
 void
@@ -129,6 +190,9 @@ QuadRefinement::populateFaceVerticesFromParentFaces() {
     //    - use parent components incident the parent face:
     //        - use the interior face-vert, corner vert-vert and two edge-verts
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
@@ -178,7 +242,7 @@ QuadRefinement::populateFaceEdgeRelation() {
     //  Both face-vertex and face-edge share the face-vertex counts/offsets, so be sure
     //  not to re-initialize it if already done:
     //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
+    if (!_child->hasUniformFaceSize()) {
         populateFaceVertexCountsAndOffsets();
     }
     _child->_faceEdgeIndices.resize(_child->getNumFaces() * 4);
@@ -195,6 +259,9 @@ QuadRefinement::populateFaceEdgesFromParentFaces() {
     //    - use parent components incident the parent face:
     //        - use the two interior face-edges and the two boundary edge-edges
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
@@ -281,6 +348,9 @@ QuadRefinement::populateEdgeVerticesFromParentFaces() {
     //    - identify parent edge perpendicular to face's child edge:
     //        - identify parent edge's vert-child
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceEdges      = _parent->getFaceEdges(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
@@ -306,6 +376,9 @@ QuadRefinement::populateEdgeVerticesFromParentEdges() {
     //    - identify parent vert at end of child edge:
     //        - identify parent vert's vert-child
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         ConstIndexArray pEdgeVerts = _parent->getEdgeVertices(pEdge),
                         pEdgeChildren = getEdgeChildEdges(pEdge);
@@ -358,9 +431,12 @@ QuadRefinement::populateEdgeFaceRelation() {
     int childEdgeFaceIndexSizeEstimate = (int)parent._faceVertIndices.size() * 2 +
                                          (int)parent._edgeFaceIndices.size() * 2;
 
-    child._edgeFaceCountsAndOffsets.resize(child.getNumEdges() * 2);
+    child._edgeFaceOffsets.resize(child.getNumEdges() + 1, 0);
     child._edgeFaceIndices.resize(childEdgeFaceIndexSizeEstimate);
 
+    if (_parallel) {
+        populateEdgeFaceCountsAndOffsets();
+    }
     populateEdgeFacesFromParentFaces();
     populateEdgeFacesFromParentEdges();
 
@@ -370,17 +446,61 @@ QuadRefinement::populateEdgeFaceRelation() {
                                      child.getOffsetOfEdgeFaces(child.getNumEdges()-1);
     child._edgeFaceIndices.resize(childEdgeFaceIndexSizeEstimate);
 
-    child._maxEdgeFaces = parent._maxEdgeFaces;
+    //  Child edges interior to parent faces are incident two faces:
+    child._maxEdgeFaces = std::max(parent._maxEdgeFaces, 2);
+}
+
+//
+//  With uniform refinement all child components are present, so the number of faces
+//  incident each child edge is known from its parent -- two for those interior to a
+//  parent face, and the number incident the parent edge otherwise.  Assigning these
+//  counts and accumulating their offsets up front leaves each child edge to be
+//  populated independently of the others:
+//
+void
+QuadRefinement::populateEdgeFaceCountsAndOffsets() {
+
+    assert(_uniform);
+
+    std::vector<Index> & offsets = _child->_edgeFaceOffsets;
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+        ConstIndexArray pFaceChildEdges = getFaceChildEdges(pFace);
+
+        for (int j = 0; j < pFaceChildEdges.size(); ++j) {
+            offsets[pFaceChildEdges[j] + 1] = 2;
+        }
+    }
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+        ConstIndexArray pEdgeChildEdges = getEdgeChildEdges(pEdge);
+
+        int pEdgeFaceCount = _parent->getNumEdgeFaces(pEdge);
+
+        offsets[pEdgeChildEdges[0] + 1] = pEdgeFaceCount;
+        offsets[pEdgeChildEdges[1] + 1] = pEdgeFaceCount;
+    }
+
+    accumulateOffsetsFromCounts(offsets);
 }
 
 void
 QuadRefinement::populateEdgeFacesFromParentFaces() {
 
     //
-    //  Note -- the edge-face counts/offsets vector is not known
-    //  ahead of time and is populated incrementally, so we cannot
-    //  thread this yet...
+    //  Note -- unless assigned up front (uniform refinement only), the edge-face
+    //  counts/offsets vector is populated incrementally and so must be populated
+    //  in order:
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceChildFaces = getFaceChildFaces(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
@@ -391,9 +511,11 @@ QuadRefinement::populateEdgeFacesFromParentFaces() {
             Index cEdge = pFaceChildEdges[j];
             if (IndexIsValid(cEdge)) {
                 //
-                //  Reserve enough edge-faces, populate and trim as needed:
+                //  Reserve enough edge-faces (if not already), populate and trim as needed:
                 //
-                _child->resizeEdgeFaces(cEdge, 2);
+                if (!_parallel) {
+                    _child->resizeEdgeFaces(cEdge, 2);
+                }
 
                 IndexArray cEdgeFaces = _child->getEdgeFaces(cEdge);
 
@@ -407,7 +529,9 @@ QuadRefinement::populateEdgeFacesFromParentFaces() {
                 if (IndexIsValid(pFaceChildFaces[jNext])) {
                     cEdgeFaces[cEdgeFaceCount++] = pFaceChildFaces[jNext];
                 }
-                _child->trimEdgeFaces(cEdge, cEdgeFaceCount);
+                if (!_parallel) {
+                    _child->trimEdgeFaces(cEdge, cEdgeFaceCount);
+                }
             }
         }
     }
@@ -417,10 +541,13 @@ void
 QuadRefinement::populateEdgeFacesFromParentEdges() {
 
     //
-    //  Note -- the edge-face counts/offsets vector is not known
-    //  ahead of time and is populated incrementally, so we cannot
-    //  thread this yet...
+    //  Note -- unless assigned up front (uniform refinement only), the edge-face
+    //  counts/offsets vector is populated incrementally and so must be populated
+    //  in order:
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         ConstIndexArray pEdgeVerts = _parent->getEdgeVertices(pEdge),
                         pEdgeFaces = _parent->getEdgeFaces(pEdge),
@@ -431,9 +558,11 @@ QuadRefinement::populateEdgeFacesFromParentEdges() {
             if (!IndexIsValid(cEdge)) continue;
 
             //
-            //  Reserve enough edge-faces, populate and trim as needed:
+            //  Reserve enough edge-faces (if not already), populate and trim as needed:
             //
-            _child->resizeEdgeFaces(cEdge, pEdgeFaces.size());
+            if (!_parallel) {
+                _child->resizeEdgeFaces(cEdge, pEdgeFaces.size());
+            }
 
             IndexArray cEdgeFaces = _child->getEdgeFaces(cEdge);
 
@@ -485,7 +614,9 @@ QuadRefinement::populateEdgeFacesFromParentEdges() {
                     cEdgeFaces[cEdgeFaceCount++] = pFaceChildren[childInFace];
                 }
             }
-            _child->trimEdgeFaces(cEdge, cEdgeFaceCount);
+            if (!_parallel) {
+                _child->trimEdgeFaces(cEdge, cEdgeFaceCount);
+            }
         }
     }
 }
@@ -496,7 +627,8 @@ QuadRefinement::populateEdgeFacesFromParentEdges() {
 //      - child vertices originate from parent faces, edges and vertices
 //      - sparse refinement poses challenges with allocation here:
 //          - we need to update the counts/offsets as we populate
-//          - note this imposes ordering constraints and inhibits concurrency
+//          - note this imposes ordering constraints and inhibits concurrency, so
+//            counts/offsets are assigned up front when refining in parallel
 //
 void
 QuadRefinement::populateVertexFaceRelation() {
@@ -526,10 +658,13 @@ QuadRefinement::populateVertexFaceRelation() {
                                        + (int)parent._edgeFaceIndices.size() * 2
                                        + (int)parent._vertFaceIndices.size();
 
-    child._vertFaceCountsAndOffsets.resize(child.getNumVertices() * 2);
+    child._vertFaceOffsets.resize(child.getNumVertices() + 1, 0);
     child._vertFaceIndices.resize(         childVertFaceIndexSizeEstimate);
     child._vertFaceLocalIndices.resize(    childVertFaceIndexSizeEstimate);
 
+    if (_parallel) {
+        populateVertexFaceCountsAndOffsets();
+    }
     if (getFirstChildVertexFromVertices() == 0) {
         populateVertexFacesFromParentVertices();
         populateVertexFacesFromParentFaces();
@@ -548,12 +683,51 @@ QuadRefinement::populateVertexFaceRelation() {
     child._vertFaceLocalIndices.resize(childVertFaceIndexSizeEstimate);
 }
 
+//
+//  As with the edge-faces, the number of faces incident each child vertex is known
+//  from its parent with uniform refinement, so all counts and offsets are assigned
+//  before populating each child vertex independently:
+//
+void
+QuadRefinement::populateVertexFaceCountsAndOffsets() {
+
+    assert(_uniform);
+
+    std::vector<Index> & offsets = _child->_vertFaceOffsets;
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+        offsets[_faceChildVertIndex[pFace] + 1] = _parent->getNumFaceVertices(pFace);
+    }
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+        offsets[_edgeChildVertIndex[pEdge] + 1] = 2 * _parent->getNumEdgeFaces(pEdge);
+    }
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
+        offsets[_vertChildVertIndex[pVert] + 1] = _parent->getNumVertexFaces(pVert);
+    }
+
+    accumulateOffsetsFromCounts(offsets);
+}
+
 void
 QuadRefinement::populateVertexFacesFromParentFaces() {
 
     const Level& parent = *this->_parent;
           Level& child  = *this->_child;
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int fIndex = 0; fIndex < parent.getNumFaces(); ++fIndex) {
         int cVertIndex = this->_faceChildVertIndex[fIndex];
         if (!IndexIsValid(cVertIndex)) continue;
@@ -566,9 +740,11 @@ QuadRefinement::populateVertexFacesFromParentFaces() {
         ConstIndexArray pFaceChildren = this->getFaceChildFaces(fIndex);
 
         //
-        //  Reserve enough vert-faces, populate and trim to the actual size:
+        //  Reserve enough vert-faces (if not already), populate and trim to the actual size:
         //
-        child.resizeVertexFaces(cVertIndex, pFaceVertCount);
+        if (!_parallel) {
+            child.resizeVertexFaces(cVertIndex, pFaceVertCount);
+        }
 
         IndexArray      cVertFaces  = child.getVertexFaces(cVertIndex);
         LocalIndexArray cVertInFace = child.getVertexFaceLocalIndices(cVertIndex);
@@ -585,7 +761,9 @@ QuadRefinement::populateVertexFacesFromParentFaces() {
                 cVertFaceCount++;
             }
         }
-        child.trimVertexFaces(cVertIndex, cVertFaceCount);
+        if (!_parallel) {
+            child.trimVertexFaces(cVertIndex, cVertFaceCount);
+        }
     }
 }
 
@@ -595,6 +773,9 @@ QuadRefinement::populateVertexFacesFromParentEdges() {
     const Level& parent = *this->_parent;
           Level& child  = *this->_child;
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int pEdgeIndex = 0; pEdgeIndex < parent.getNumEdges(); ++pEdgeIndex) {
         int cVertIndex = this->_edgeChildVertIndex[pEdgeIndex];
         if (!IndexIsValid(cVertIndex)) continue;
@@ -605,9 +786,11 @@ QuadRefinement::populateVertexFacesFromParentEdges() {
         ConstIndexArray pEdgeFaces = parent.getEdgeFaces(pEdgeIndex);
 
         //
-        //  Reserve enough vert-faces, populate and trim to the actual size:
+        //  Reserve enough vert-faces (if not already), populate and trim to the actual size:
         //
-        child.resizeVertexFaces(cVertIndex, 2 * pEdgeFaces.size());
+        if (!_parallel) {
+            child.resizeVertexFaces(cVertIndex, 2 * pEdgeFaces.size());
+        }
 
         IndexArray      cVertFaces  = child.getVertexFaces(cVertIndex);
         LocalIndexArray cVertInFace = child.getVertexFaceLocalIndices(cVertIndex);
@@ -650,7 +833,9 @@ QuadRefinement::populateVertexFacesFromParentEdges() {
                 cVertFaceCount++;
             }
         }
-        child.trimVertexFaces(cVertIndex, cVertFaceCount);
+        if (!_parallel) {
+            child.trimVertexFaces(cVertIndex, cVertFaceCount);
+        }
     }
 }
 
@@ -660,6 +845,9 @@ QuadRefinement::populateVertexFacesFromParentVertices() {
     const Level& parent = *this->_parent;
           Level& child  = *this->_child;
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int vIndex = 0; vIndex < parent.getNumVertices(); ++vIndex) {
         int cVertIndex = this->_vertChildVertIndex[vIndex];
         if (!IndexIsValid(cVertIndex)) continue;
@@ -671,9 +859,11 @@ QuadRefinement::populateVertexFacesFromParentVertices() {
         ConstLocalIndexArray pVertInFace = parent.getVertexFaceLocalIndices(vIndex);
 
         //
-        //  Reserve enough vert-faces, populate and trim to the actual size:
+        //  Reserve enough vert-faces (if not already), populate and trim to the actual size:
         //
-        child.resizeVertexFaces(cVertIndex, pVertFaces.size());
+        if (!_parallel) {
+            child.resizeVertexFaces(cVertIndex, pVertFaces.size());
+        }
 
         IndexArray      cVertFaces  = child.getVertexFaces(cVertIndex);
         LocalIndexArray cVertInFace = child.getVertexFaceLocalIndices(cVertIndex);
@@ -693,7 +883,9 @@ QuadRefinement::populateVertexFacesFromParentVertices() {
                 cVertFaceCount++;
             }
         }
-        child.trimVertexFaces(cVertIndex, cVertFaceCount);
+        if (!_parallel) {
+            child.trimVertexFaces(cVertIndex, cVertFaceCount);
+        }
     }
 }
 
@@ -702,7 +894,8 @@ QuadRefinement::populateVertexFacesFromParentVertices() {
 //      - child vertices originate from parent faces, edges and vertices
 //      - sparse refinement poses challenges with allocation here:
 //          - we need to update the counts/offsets as we populate
-//          - note this imposes ordering constraints and inhibits concurrency
+//          - note this imposes ordering constraints and inhibits concurrency, so
+//            counts/offsets are assigned up front when refining in parallel
 //
 void
 QuadRefinement::populateVertexEdgeRelation() {
@@ -736,10 +929,13 @@ QuadRefinement::populateVertexEdgeRelation() {
                                        + (int)parent._edgeFaceIndices.size() + parent.getNumEdges() * 2
                                        + (int)parent._vertEdgeIndices.size();
 
-    child._vertEdgeCountsAndOffsets.resize(child.getNumVertices() * 2);
+    child._vertEdgeOffsets.resize(child.getNumVertices() + 1, 0);
     child._vertEdgeIndices.resize(         childVertEdgeIndexSizeEstimate);
     child._vertEdgeLocalIndices.resize(    childVertEdgeIndexSizeEstimate);
 
+    if (_parallel) {
+        populateVertexEdgeCountsAndOffsets();
+    }
     if (getFirstChildVertexFromVertices() == 0) {
         populateVertexEdgesFromParentVertices();
         populateVertexEdgesFromParentFaces();
@@ -758,12 +954,51 @@ QuadRefinement::populateVertexEdgeRelation() {
     child._vertEdgeLocalIndices.resize(childVertEdgeIndexSizeEstimate);
 }
 
+//
+//  As with the vertex-faces, the number of edges incident each child vertex is known
+//  from its parent with uniform refinement, so all counts and offsets are assigned
+//  before populating each child vertex independently:
+//
+void
+QuadRefinement::populateVertexEdgeCountsAndOffsets() {
+
+    assert(_uniform);
+
+    std::vector<Index> & offsets = _child->_vertEdgeOffsets;
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+        offsets[_faceChildVertIndex[pFace] + 1] = _parent->getNumFaceVertices(pFace);
+    }
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+        offsets[_edgeChildVertIndex[pEdge] + 1] = _parent->getNumEdgeFaces(pEdge) + 2;
+    }
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
+        offsets[_vertChildVertIndex[pVert] + 1] = _parent->getNumVertexEdges(pVert);
+    }
+
+    accumulateOffsetsFromCounts(offsets);
+}
+
 void
 QuadRefinement::populateVertexEdgesFromParentFaces() {
 
     const Level& parent = *this->_parent;
           Level& child  = *this->_child;
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int fIndex = 0; fIndex < parent.getNumFaces(); ++fIndex) {
         int cVertIndex = this->_faceChildVertIndex[fIndex];
         if (!IndexIsValid(cVertIndex)) continue;
@@ -775,9 +1010,11 @@ QuadRefinement::populateVertexEdgesFromParentFaces() {
                         pFaceChildEdges = this->getFaceChildEdges(fIndex);
 
         //
-        //  Reserve enough vert-edges, populate and trim to the actual size:
+        //  Reserve enough vert-edges (if not already), populate and trim to the actual size:
         //
-        child.resizeVertexEdges(cVertIndex, pFaceVerts.size());
+        if (!_parallel) {
+            child.resizeVertexEdges(cVertIndex, pFaceVerts.size());
+        }
 
         IndexArray      cVertEdges  = child.getVertexEdges(cVertIndex);
         LocalIndexArray cVertInEdge = child.getVertexEdgeLocalIndices(cVertIndex);
@@ -796,7 +1033,9 @@ QuadRefinement::populateVertexEdgesFromParentFaces() {
                 cVertEdgeCount++;
             }
         }
-        child.trimVertexEdges(cVertIndex, cVertEdgeCount);
+        if (!_parallel) {
+            child.trimVertexEdges(cVertIndex, cVertEdgeCount);
+        }
     }
 }
 void
@@ -805,6 +1044,9 @@ QuadRefinement::populateVertexEdgesFromParentEdges() {
     const Level& parent = *this->_parent;
           Level& child  = *this->_child;
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int eIndex = 0; eIndex < parent.getNumEdges(); ++eIndex) {
         int cVertIndex = this->_edgeChildVertIndex[eIndex];
         if (!IndexIsValid(cVertIndex)) continue;
@@ -816,9 +1058,11 @@ QuadRefinement::populateVertexEdgesFromParentEdges() {
                         pEdgeChildEdges = this->getEdgeChildEdges(eIndex);
 
         //
-        //  Reserve enough vert-edges, populate and trim to the actual size:
+        //  Reserve enough vert-edges (if not already), populate and trim to the actual size:
         //
-        child.resizeVertexEdges(cVertIndex, pEdgeFaces.size() + 2);
+        if (!_parallel) {
+            child.resizeVertexEdges(cVertIndex, pEdgeFaces.size() + 2);
+        }
 
         IndexArray      cVertEdges  = child.getVertexEdges(cVertIndex);
         LocalIndexArray cVertInEdge = child.getVertexEdgeLocalIndices(cVertIndex);
@@ -892,7 +1136,9 @@ QuadRefinement::populateVertexEdgesFromParentEdges() {
             std::swap(cVertInEdge[1], cVertInEdge[2]);
         }
 
-        child.trimVertexEdges(cVertIndex, cVertEdgeCount);
+        if (!_parallel) {
+            child.trimVertexEdges(cVertIndex, cVertEdgeCount);
+        }
     }
 }
 void
@@ -901,6 +1147,9 @@ QuadRefinement::populateVertexEdgesFromParentVertices() {
     const Level& parent = *this->_parent;
           Level& child  = *this->_child;
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int vIndex = 0; vIndex < parent.getNumVertices(); ++vIndex) {
         int cVertIndex = this->_vertChildVertIndex[vIndex];
         if (!IndexIsValid(cVertIndex)) continue;
@@ -912,9 +1161,11 @@ QuadRefinement::populateVertexEdgesFromParentVertices() {
         ConstLocalIndexArray pVertInEdge = parent.getVertexEdgeLocalIndices(vIndex);
 
         //
-        //  Reserve enough vert-edges, populate and trim to the actual size:
+        //  Reserve enough vert-edges (if not already), populate and trim to the actual size:
         //
-        child.resizeVertexEdges(cVertIndex, pVertEdges.size());
+        if (!_parallel) {
+            child.resizeVertexEdges(cVertIndex, pVertEdges.size());
+        }
 
         IndexArray      cVertEdges  = child.getVertexEdges(cVertIndex);
         LocalIndexArray cVertInEdge = child.getVertexEdgeLocalIndices(cVertIndex);
@@ -931,7 +1182,9 @@ QuadRefinement::populateVertexEdgesFromParentVertices() {
                 cVertEdgeCount++;
             }
         }
-        child.trimVertexEdges(cVertIndex, cVertEdgeCount);
+        if (!_parallel) {
+            child.trimVertexEdges(cVertIndex, cVertEdgeCount);
+        }
     }
 }
 
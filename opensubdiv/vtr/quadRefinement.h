@@ -75,13 +75,16 @@ protected:
     void populateEdgeVerticesFromParentFaces();
     void populateEdgeVerticesFromParentEdges();
 
+    void populateEdgeFaceCountsAndOffsets();
     void populateEdgeFacesFromParentFaces();
     void populateEdgeFacesFromParentEdges();
 
+    void populateVertexFaceCountsAndOffsets();
     void populateVertexFacesFromParentFaces();
     void populateVertexFacesFromParentEdges();
     void populateVertexFacesFromParentVertices();
 
+    void populateVertexEdgeCountsAndOffsets();
     void populateVertexEdgesFromParentFaces();
     void populateVertexEdgesFromParentEdges();
     void populateVertexEdgesFromParentVertices();
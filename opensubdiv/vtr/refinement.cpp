@@ -30,6 +30,7 @@
 #include "../vtr/fvarLevel.h"
 #include "../vtr/fvarRefinement.h"
 #include "../vtr/maskInterfaces.h"
+#include "../vtr/stopwatch.h"
 
 #include <cassert>
 #include <cstdio>
@@ -60,10 +61,16 @@ Refinement::Refinement(Level const & parent, Level & child, Sdc::Options const&
     _firstChildEdgeFromEdge(0),
     _firstChildVertFromFace(0),
     _firstChildVertFromEdge(0),
-    _firstChildVertFromVert(0) {
+    _firstChildVertFromVert(0),
+    _faceChildFaceStride(0),
+    _faceChildEdgeStride(0) {
 
     assert((child.getDepth() == 0) && (child.getNumVertices() == 0));
     child._depth = 1 + parent.getDepth();
+
+    for (int i = 0; i < NUM_STAGES; ++i) {
+        _stageTimes[i] = 0.0;
+    }
 }
 
 Refinement::~Refinement() {
@@ -118,17 +125,27 @@ Refinement::refine(Options refineOptions) {
 
     _uniform = !refineOptions._sparse;
 
+    //  Concurrent population of the child is only supported for uniform refinement:
+    _parallel = _uniform && refineOptions._parallel;
+
+    //  Optional timing of each stage -- the timer is only read when requested:
+    bool      timeStages = refineOptions._timeStages;
+    Stopwatch stageTimer;
+
     //
     //  Initialize the parent-to-child and reverse child-to-parent mappings and propagate
     //  component tags to the new child components:
     //
     populateParentToChildMapping();
+    if (timeStages) _stageTimes[STAGE_PARENT_TO_CHILD_MAPPING] = stageTimer.lap();
 
     initializeChildComponentCounts();
 
     populateChildToParentMapping();
+    if (timeStages) _stageTimes[STAGE_CHILD_TO_PARENT_MAPPING] = stageTimer.lap();
 
     propagateComponentTags();
+    if (timeStages) _stageTimes[STAGE_COMPONENT_TAGS] = stageTimer.lap();
 
     //
     //  Subdivide the topology -- populating only those of the 6 relations specified:
@@ -141,18 +158,21 @@ Refinement::refine(Options refineOptions) {
         relationsToPopulate.setAll(true);
     }
     subdivideTopology(relationsToPopulate);
+    if (timeStages) _stageTimes[STAGE_TOPOLOGY] = stageTimer.lap();
 
     //
     //  Subdivide the sharpness values and face-varying channels:
     //    - note there is some dependency of the vertex tag/Rule for semi-sharp vertices
     //
     subdivideSharpnessValues();
+    if (timeStages) _stageTimes[STAGE_SHARPNESS] = stageTimer.lap();
 
     //  We may have an option here to suppress face-varying channels...
     bool refineOptions_faceVaryingChannels = true;
     if (refineOptions_faceVaryingChannels) {
         subdivideFVarChannels();
     }
+    if (timeStages) _stageTimes[STAGE_FVAR_CHANNELS] = stageTimer.lap();
 
     //  Various debugging support:
     //
@@ -163,6 +183,53 @@ Refinement::refine(Options refineOptions) {
     //assert(_child->validateTopology());
 }
 
+//
+//  Update of the child following changes to the sharpness of the parent -- the tags of
+//  all child components are propagated again from their parents (topological tags are
+//  unchanged while those for sharpness and the Rule are reassigned) before the sharpness
+//  values are subdivided, just as in the original refinement.  The parent-child mappings
+//  and all topological relations of the child are reused without modification:
+//
+void
+Refinement::updateSharpness() {
+
+    assert(_parent && _child);
+    assert((int)_child->_vertTags.size() == _child->getNumVertices());
+
+    propagateComponentTags();
+
+    subdivideSharpnessValues();
+}
+
+//
+//  Memory allocated for the mappings and tags -- the offsets of child faces and edges
+//  are either shared with the parent Level or local vectors included in the indices:
+//
+size_t
+Refinement::getMemoryUsage() const {
+
+    size_t bytes = VectorMemoryUsage(_faceChildFaceIndices)
+                 + VectorMemoryUsage(_faceChildEdgeIndices)
+                 + VectorMemoryUsage(_faceChildVertIndex)
+                 + VectorMemoryUsage(_edgeChildEdgeIndices)
+                 + VectorMemoryUsage(_edgeChildVertIndex)
+                 + VectorMemoryUsage(_vertChildVertIndex)
+                 + VectorMemoryUsage(_childFaceParentIndex)
+                 + VectorMemoryUsage(_childEdgeParentIndex)
+                 + VectorMemoryUsage(_childVertexParentIndex)
+                 + VectorMemoryUsage(_childFaceTag)
+                 + VectorMemoryUsage(_childEdgeTag)
+                 + VectorMemoryUsage(_childVertexTag)
+                 + VectorMemoryUsage(_parentFaceTag)
+                 + VectorMemoryUsage(_parentEdgeTag)
+                 + VectorMemoryUsage(_parentVertexTag);
+
+    for (int i = 0; i < (int)_fvarChannels.size(); ++i) {
+        bytes += VectorMemoryUsage(_fvarChannels[i]->_childValueParentSource);
+    }
+    return bytes;
+}
+
 
 //
 //  Methods for construct the parent-to-child mapping
@@ -538,11 +605,14 @@ Refinement::populateVertexParentFromParentFaces(ChildTag const initialChildTags[
     if (getNumChildVerticesFromFaces() == 0) return;
 
     if (_uniform) {
-        Index cVert = getFirstChildVertexFromFaces();
-        for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace, ++cVert) {
+        Index cVertBegin = getFirstChildVertexFromFaces();
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_parallel)
+#endif
+        for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
             //  Child tag was initialized as the complete and only child when allocated
 
-            _childVertexParentIndex[cVert] = pFace;
+            _childVertexParentIndex[cVertBegin + pFace] = pFace;
         }
     } else {
         ChildTag const & completeChildTag = initialChildTags[0][0];
@@ -563,11 +633,14 @@ void
 Refinement::populateVertexParentFromParentEdges(ChildTag const initialChildTags[2][4]) {
 
     if (_uniform) {
-        Index cVert = getFirstChildVertexFromEdges();
-        for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge, ++cVert) {
+        Index cVertBegin = getFirstChildVertexFromEdges();
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_parallel)
+#endif
+        for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
             //  Child tag was initialized as the complete and only child when allocated
 
-            _childVertexParentIndex[cVert] = pEdge;
+            _childVertexParentIndex[cVertBegin + pEdge] = pEdge;
         }
     } else {
         ChildTag const & completeChildTag = initialChildTags[0][0];
@@ -588,11 +661,14 @@ void
 Refinement::populateVertexParentFromParentVertices(ChildTag const initialChildTags[2][4]) {
 
     if (_uniform) {
-        Index cVert = getFirstChildVertexFromVertices();
-        for (Index pVert = 0; pVert < _parent->getNumVertices(); ++pVert, ++cVert) {
+        Index cVertBegin = getFirstChildVertexFromVertices();
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_parallel)
+#endif
+        for (Index pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
             //  Child tag was initialized as the complete and only child when allocated
 
-            _childVertexParentIndex[cVert] = pVert;
+            _childVertexParentIndex[cVertBegin + pVert] = pVert;
         }
     } else {
         ChildTag const & completeChildTag = initialChildTags[0][0];
@@ -635,9 +711,12 @@ Refinement::populateFaceTagsFromParentFaces() {
     //
     //  Tags for faces originating from faces are inherited from the parent face:
     //
-    Index cFace    = getFirstChildFaceFromFaces();
-    Index cFaceEnd = cFace + getNumChildFacesFromFaces();
-    for ( ; cFace < cFaceEnd; ++cFace) {
+    Index cFaceBegin = getFirstChildFaceFromFaces();
+    Index cFaceEnd   = cFaceBegin + getNumChildFacesFromFaces();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cFace = cFaceBegin; cFace < cFaceEnd; ++cFace) {
         _child->_faceTags[cFace] = _parent->_faceTags[_childFaceParentIndex[cFace]];
     }
 }
@@ -662,9 +741,12 @@ Refinement::populateEdgeTagsFromParentFaces() {
     eTag._infSharp    = 0;
     eTag._semiSharp   = 0;
 
-    Index cEdge    = getFirstChildEdgeFromFaces();
-    Index cEdgeEnd = cEdge + getNumChildEdgesFromFaces();
-    for ( ; cEdge < cEdgeEnd; ++cEdge) {
+    Index cEdgeBegin = getFirstChildEdgeFromFaces();
+    Index cEdgeEnd   = cEdgeBegin + getNumChildEdgesFromFaces();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cEdge = cEdgeBegin; cEdge < cEdgeEnd; ++cEdge) {
         _child->_edgeTags[cEdge] = eTag;
     }
 }
@@ -674,9 +756,12 @@ Refinement::populateEdgeTagsFromParentEdges() {
     //
     //  Tags for edges originating from edges are inherited from the parent edge:
     //
-    Index cEdge    = getFirstChildEdgeFromEdges();
-    Index cEdgeEnd = cEdge + getNumChildEdgesFromEdges();
-    for ( ; cEdge < cEdgeEnd; ++cEdge) {
+    Index cEdgeBegin = getFirstChildEdgeFromEdges();
+    Index cEdgeEnd   = cEdgeBegin + getNumChildEdgesFromEdges();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cEdge = cEdgeBegin; cEdge < cEdgeEnd; ++cEdge) {
         _child->_edgeTags[cEdge] = _parent->_edgeTags[_childEdgeParentIndex[cEdge]];
     }
 }
@@ -741,6 +826,9 @@ Refinement::populateVertexTagsFromParentEdges() {
     //  Tags for vertices originating from edges are initialized according to the tags
     //  of the parent edge:
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         Index cVert = _edgeChildVertIndex[pEdge];
         if (!IndexIsValid(cVert)) continue;
@@ -765,9 +853,12 @@ Refinement::populateVertexTagsFromParentVertices() {
     //
     //  Tags for vertices originating from vertices are inherited from the parent vertex:
     //
-    Index cVert    = getFirstChildVertexFromVertices();
-    Index cVertEnd = cVert + getNumChildVerticesFromVertices();
-    for ( ; cVert < cVertEnd; ++cVert) {
+    Index cVertBegin = getFirstChildVertexFromVertices();
+    Index cVertEnd   = cVertBegin + getNumChildVerticesFromVertices();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
         _child->_vertTags[cVert] = _parent->_vertTags[_childVertexParentIndex[cVert]];
     }
 }
@@ -42,6 +42,7 @@ namespace OPENSUBDIV_VERSION {
 namespace Far {
     class TopologyRefiner;
     class PatchTablesFactory;
+    class TopologyRefinerCache;
 }
 
 namespace Vtr {
@@ -95,6 +96,16 @@ public:
     //          This is only one of the six possible topological relations that
     //          can be generated -- we may eventually want a flag for each.
     //
+    //      "parallel": populate the child level concurrently (when OpenMP is
+    //          available).  This is currently limited to uniform refinement, where
+    //          the size of every relation of a child component is known from its
+    //          parent, so that count/offset vectors can be assigned up front by a
+    //          prefix sum and each component then filled independently.  The
+    //          resulting child Level is identical to that of serial refinement.
+    //
+    //      "time stages": record the time spent in each stage of the refinement
+    //          (retrievable with getStageTime()) -- intended for instrumentation.
+    //
     //      "compute masks": this is intended to be temporary, along with the data
     //          members associated with it -- it will trigger the computation and
     //          storage of mask weights for all child vertices.  This is naively
@@ -106,11 +117,15 @@ public:
     //
     struct Options {
         Options() : _sparse(0),
-                    _faceTopologyOnly(0)
+                    _faceTopologyOnly(0),
+                    _parallel(0),
+                    _timeStages(0)
                     { }
 
         unsigned int _sparse           : 1;
         unsigned int _faceTopologyOnly : 1;
+        unsigned int _parallel         : 1;
+        unsigned int _timeStages       : 1;
 
         //  Currently under consideration:
         //unsigned int _childToParentMap    : 1;
@@ -120,6 +135,32 @@ public:
 
     void refine(Options options = Options());
 
+    //  Re-derive the tags and sharpness values of the child following changes to the
+    //  sharpness of the parent -- the topology of the child is retained as is:
+    void updateSharpness();
+
+    //
+    //  Stages of the refinement timed when requested by the options (times are in
+    //  seconds and zero when not recorded).  The selection of components for sparse
+    //  refinement precedes refine() and is recorded by the client of SparseSelector:
+    //
+    enum Stage {
+        STAGE_SPARSE_SELECTION,
+        STAGE_PARENT_TO_CHILD_MAPPING,
+        STAGE_CHILD_TO_PARENT_MAPPING,
+        STAGE_COMPONENT_TAGS,
+        STAGE_TOPOLOGY,
+        STAGE_SHARPNESS,
+        STAGE_FVAR_CHANNELS,
+        NUM_STAGES
+    };
+
+    double getStageTime(Stage stage) const { return _stageTimes[stage]; }
+    void   setStageTime(Stage stage, double seconds) { _stageTimes[stage] = seconds; }
+
+    //  Memory allocated for the parent-child mappings and tags (in bytes):
+    size_t getMemoryUsage() const;
+
 public:
     //
     //  Access to members -- some testing classes (involving vertex interpolation)
@@ -166,6 +207,7 @@ protected:
 
     friend class Far::TopologyRefiner;
     friend class Far::PatchTablesFactory;
+    friend class Far::TopologyRefinerCache;
 
 
     IndexArray getFaceChildFaces(Index parentFace);
@@ -326,6 +368,9 @@ protected:
 
     //  Determined by the refinement options:
     bool _uniform;
+    bool _parallel;
+
+    double _stageTimes[NUM_STAGES];
 
     //
     //  Inventory and ordering of the types of child components:
@@ -357,8 +402,15 @@ protected:
     //  the subclass just initializes the Array members after allocating its own local
     //  vector members.
     //
-    IndexArray _faceChildFaceCountsAndOffsets;
-    IndexArray _faceChildEdgeCountsAndOffsets;
+    //  The child faces and edges of each parent face are located by offsets (as with
+    //  the relations of the Level), unless there are a fixed number of each for every
+    //  face, in which case the offsets are left empty and the fixed "stride" is used.
+    //
+    IndexArray _faceChildFaceOffsets;
+    IndexArray _faceChildEdgeOffsets;
+
+    int _faceChildFaceStride;
+    int _faceChildEdgeStride;
 
     IndexVector _faceChildFaceIndices;  // *cannot* always use face-vert counts/offsets
     IndexVector _faceChildEdgeIndices;  // can use face-vert counts/offsets
@@ -396,28 +448,40 @@ protected:
 inline ConstIndexArray
 Refinement::getFaceChildFaces(Index parentFace) const {
 
-    return ConstIndexArray(&_faceChildFaceIndices[_faceChildFaceCountsAndOffsets[2*parentFace+1]],
-                                             _faceChildFaceCountsAndOffsets[2*parentFace]);
+    if (_faceChildFaceStride) {
+        return ConstIndexArray(&_faceChildFaceIndices[parentFace * _faceChildFaceStride], _faceChildFaceStride);
+    }
+    return ConstIndexArray(&_faceChildFaceIndices[_faceChildFaceOffsets[parentFace]],
+                      _faceChildFaceOffsets[parentFace+1] - _faceChildFaceOffsets[parentFace]);
 }
 
 inline IndexArray
 Refinement::getFaceChildFaces(Index parentFace) {
 
-    return IndexArray(&_faceChildFaceIndices[_faceChildFaceCountsAndOffsets[2*parentFace+1]],
-                                             _faceChildFaceCountsAndOffsets[2*parentFace]);
+    if (_faceChildFaceStride) {
+        return IndexArray(&_faceChildFaceIndices[parentFace * _faceChildFaceStride], _faceChildFaceStride);
+    }
+    return IndexArray(&_faceChildFaceIndices[_faceChildFaceOffsets[parentFace]],
+                      _faceChildFaceOffsets[parentFace+1] - _faceChildFaceOffsets[parentFace]);
 }
 
 inline ConstIndexArray
 Refinement::getFaceChildEdges(Index parentFace) const {
 
-    return ConstIndexArray(&_faceChildEdgeIndices[_faceChildEdgeCountsAndOffsets[2*parentFace+1]],
-                                             _faceChildEdgeCountsAndOffsets[2*parentFace]);
+    if (_faceChildEdgeStride) {
+        return ConstIndexArray(&_faceChildEdgeIndices[parentFace * _faceChildEdgeStride], _faceChildEdgeStride);
+    }
+    return ConstIndexArray(&_faceChildEdgeIndices[_faceChildEdgeOffsets[parentFace]],
+                      _faceChildEdgeOffsets[parentFace+1] - _faceChildEdgeOffsets[parentFace]);
 }
 inline IndexArray
 Refinement::getFaceChildEdges(Index parentFace) {
 
-    return IndexArray(&_faceChildEdgeIndices[_faceChildEdgeCountsAndOffsets[2*parentFace+1]],
-                                             _faceChildEdgeCountsAndOffsets[2*parentFace]);
+    if (_faceChildEdgeStride) {
+        return IndexArray(&_faceChildEdgeIndices[parentFace * _faceChildEdgeStride], _faceChildEdgeStride);
+    }
+    return IndexArray(&_faceChildEdgeIndices[_faceChildEdgeOffsets[parentFace]],
+                      _faceChildEdgeOffsets[parentFace+1] - _faceChildEdgeOffsets[parentFace]);
 }
 
 inline ConstIndexArray
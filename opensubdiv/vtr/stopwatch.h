@@ -0,0 +1,67 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef VTR_STOPWATCH_H
+#define VTR_STOPWATCH_H
+
+#include "../version.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Vtr {
+
+//
+//  Stopwatch:
+//      A minimal wall-clock timer for the optional instrumentation of refinement (and
+//  of the construction of the base level by Far).  Each call to lap() returns the time
+//  in seconds since construction or the previous lap, so that a sequence of stages can
+//  be timed with a single instance.  The platform-specific clock is kept out of the
+//  header, which is also included by the TopologyRefinerFactory template.
+//
+class Stopwatch {
+
+public:
+    Stopwatch() { _last = now(); }
+
+    double lap() {
+        double t = now(),
+               elapsed = t - _last;
+        _last = t;
+        return elapsed;
+    }
+
+private:
+    static double now();
+
+    double _last;
+};
+
+} // end namespace Vtr
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* VTR_STOPWATCH_H */
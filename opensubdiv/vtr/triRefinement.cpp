@@ -29,6 +29,7 @@
 #include <cassert>
 #include <cstdio>
 #include <utility>
+#include <algorithm>
 
 
 namespace OpenSubdiv {
@@ -77,21 +78,19 @@ TriRefinement::allocateParentChildIndices() {
     int vertChildVertCount = _parent->getNumVertices();
 
     //
-    //  First initialize the count/offset vectors for the child-faces and child-edges of
-    //  parent faces.  For now we can use the parent's face-vert counts for the child-edges
-    //  of faces, but we must use a local vector for the child-faces.
+    //  First initialize the offsets for the child-faces and child-edges of parent faces.
+    //  Every parent face has four child faces, so a fixed stride is used for those, while
+    //  the parent's face-vert offsets (or its uniform face size) serve the child-edges.
     //
-    //  This will be more necessary (and need adjustment) when N-sided faces are supported.
+    //  This will need adjustment when N-sided faces are supported.
     //
-    _localFaceChildFaceCountsAndOffsets.resize(_parent->getNumFaces() * 2, 4);
-    for (int i = 0; i < _parent->getNumFaces(); ++i) {
-        _localFaceChildFaceCountsAndOffsets[i*2 + 1] = 4 * i;
+    _faceChildFaceStride = 4;
+    if (_parent->hasUniformFaceSize()) {
+        _faceChildEdgeStride = _parent->_uniformFaceSize;
+    } else {
+        _faceChildEdgeOffsets = _parent->shareFaceVertOffsets();
     }
 
-    _faceChildFaceCountsAndOffsets = IndexArray(&_localFaceChildFaceCountsAndOffsets[0],
-                                                (int)_localFaceChildFaceCountsAndOffsets.size());
-    _faceChildEdgeCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
-
     //
     //  Given we will be ignoring initial values with uniform refinement and assigning all
     //  directly, initializing here is a waste...
@@ -118,8 +117,8 @@ TriRefinement::populateFaceVertexRelation() {
     //  Both face-vertex and face-edge share the face-vertex counts/offsets within a
     //  Level, so be sure not to re-initialize it if already done:
     //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
-    populateFaceVertexCountsAndOffsets();
+    if (!_child->hasUniformFaceSize()) {
+        populateFaceVertexCountsAndOffsets();
     }
     _child->_faceVertIndices.resize(_child->getNumFaces() * 3);
 
@@ -129,11 +128,8 @@ TriRefinement::populateFaceVertexRelation() {
 void
 TriRefinement::populateFaceVertexCountsAndOffsets() {
 
-    _child->_faceVertCountsAndOffsets.resize(_child->getNumFaces() * 2, 3);
-
-    for (int i = 0; i < _child->getNumFaces(); ++i) {
-        _child->_faceVertCountsAndOffsets[i*2 + 1] = i * 3;
-    }
+    //  All child faces are triangles, so their counts and offsets are implicit:
+    _child->setUniformFaceSize(3);
 }
 
 void
@@ -206,7 +202,7 @@ TriRefinement::populateFaceEdgeRelation() {
     //  Both face-vertex and face-edge share the face-vertex counts/offsets, so be sure
     //  not to re-initialize it if already done:
     //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
+    if (!_child->hasUniformFaceSize()) {
         populateFaceVertexCountsAndOffsets();
     }
     _child->_faceEdgeIndices.resize(_child->getNumFaces() * 3);
@@ -360,7 +356,7 @@ TriRefinement::populateEdgeFaceRelation() {
     int childEdgeFaceIndexSizeEstimate = (int)_faceChildEdgeIndices.size() * 2 +
                                          (int)_parent->_edgeFaceIndices.size() * 2;
 
-    _child->_edgeFaceCountsAndOffsets.resize(_child->getNumEdges() * 2);
+    _child->_edgeFaceOffsets.resize(_child->getNumEdges() + 1, 0);
     _child->_edgeFaceIndices.resize(childEdgeFaceIndexSizeEstimate);
 
     populateEdgeFacesFromParentFaces();
@@ -372,7 +368,8 @@ TriRefinement::populateEdgeFaceRelation() {
                                      _child->getOffsetOfEdgeFaces(_child->getNumEdges()-1);
     _child->_edgeFaceIndices.resize(childEdgeFaceIndexSizeEstimate);
 
-    _child->_maxEdgeFaces = _parent->_maxEdgeFaces;
+    //  Child edges interior to parent faces are incident two faces:
+    _child->_maxEdgeFaces = std::max(_parent->_maxEdgeFaces, 2);
 }
 
 void
@@ -500,7 +497,7 @@ TriRefinement::populateVertexFaceRelation() {
     int childVertFaceIndexSizeEstimate = (int)_parent->_edgeFaceIndices.size() * 3
                                        + (int)_parent->_vertFaceIndices.size();
 
-    _child->_vertFaceCountsAndOffsets.resize(_child->getNumVertices() * 2);
+    _child->_vertFaceOffsets.resize(_child->getNumVertices() + 1, 0);
     _child->_vertFaceIndices.resize(         childVertFaceIndexSizeEstimate);
     _child->_vertFaceLocalIndices.resize(    childVertFaceIndexSizeEstimate);
 
@@ -533,7 +530,7 @@ TriRefinement::populateVertexFacesFromParentEdges() {
         //
         //  Reserve enough vert-faces, populate and trim to the actual size:
         //
-        _child->resizeVertexFaces(cVert, 2 * pEdgeFaces.size());
+        _child->resizeVertexFaces(cVert, 3 * pEdgeFaces.size());
 
         IndexArray      cVertFaces  = _child->getVertexFaces(cVert);
         LocalIndexArray cVertInFace = _child->getVertexFaceLocalIndices(cVert);
@@ -668,7 +665,7 @@ TriRefinement::populateVertexEdgeRelation() {
     int childVertEdgeIndexSizeEstimate = (int)_parent->_edgeFaceIndices.size() * 2 + _parent->getNumEdges() * 2
                                        + (int)_parent->_vertEdgeIndices.size();
 
-    _child->_vertEdgeCountsAndOffsets.resize(_child->getNumVertices() * 2);
+    _child->_vertEdgeOffsets.resize(_child->getNumVertices() + 1, 0);
     _child->_vertEdgeIndices.resize(         childVertEdgeIndexSizeEstimate);
     _child->_vertEdgeLocalIndices.resize(    childVertEdgeIndexSizeEstimate);
 
@@ -705,7 +702,7 @@ TriRefinement::populateVertexEdgesFromParentEdges() {
         //
         //  Reserve enough vert-edges, populate and trim to the actual size:
         //
-        _child->resizeVertexEdges(cVertIndex, pEdgeFaces.size() + 2);
+        _child->resizeVertexEdges(cVertIndex, 2 * pEdgeFaces.size() + 2);
 
         IndexArray      cVertEdges  = _child->getVertexEdges(cVertIndex);
         LocalIndexArray cVertInEdge = _child->getVertexEdgeLocalIndices(cVertIndex);
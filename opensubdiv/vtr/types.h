@@ -28,6 +28,7 @@
 
 #include "../vtr/array.h"
 
+#include <cstddef>
 #include <vector>
 
 namespace OpenSubdiv {
@@ -57,6 +58,12 @@ static const Index  INDEX_INVALID = -1;
 
 inline bool IndexIsValid(Index index) { return (index != INDEX_INVALID); }
 
+//
+//  Memory allocated by a vector in bytes (for instrumentation of Level and Refinement):
+//
+template <typename T>
+inline size_t VectorMemoryUsage(std::vector<T> const & v) { return v.capacity() * sizeof(T); }
+
 //
 //  Note for aggregate types that the use of "vector" in the name indicates a class
 //  that wraps an std:;vector (typically a member variable) which is fully resizable
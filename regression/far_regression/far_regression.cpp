@@ -0,0 +1,850 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include <far/topologyRefinerFactory.h>
+#include <far/stencilTablesFactory.h>
+#include <far/patchTablesFactory.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "../../regression/common/vtr_utils.h"
+
+#include "init_shapes.h"
+
+//
+// Regression testing matching the alternate code paths of Far to their
+// reference implementation :
+//
+// - parallel uniform refinement            vs  serial refinement
+// - compacted topology relations           vs  their inverse relations
+// - sorted base edges                      vs  the face-vertices
+// - parallel base topology                 vs  serial base topology
+// - parallel, buffer and cached-mask
+//   interpolation                          vs  templated Interpolate()
+// - streaming and chunked StencilTables    vs  StencilTablesFactory::Create()
+// - compact and parallel PatchTables       vs  default PatchTables
+// - derivatives of the basis weights       vs  their central differences
+//
+// Notes:
+// - the alternate code paths produce the same results in the same order as
+//   their reference, so results are expected to be bitwise identical.
+// - the derivatives of the basis weights are only expected to match their
+//   central differences within a tolerance.
+//
+
+using namespace OpenSubdiv;
+
+typedef Far::TopologyRefiner               FarTopologyRefiner;
+typedef Far::TopologyRefinerFactory<Shape> FarTopologyRefinerFactory;
+typedef Far::StencilTables                 FarStencilTables;
+typedef Far::StencilTablesFactory          FarStencilTablesFactory;
+typedef Far::PatchTables                   FarPatchTables;
+typedef Far::PatchTablesFactory            FarPatchTablesFactory;
+typedef Far::VertexBufferDescriptor        FarVertexBufferDescriptor;
+typedef Far::Index                         FarIndex;
+typedef Far::ConstIndexArray               FarConstIndexArray;
+
+//------------------------------------------------------------------------------
+// Vertex class implementation -- vertex and varying data are accumulated
+// separately
+struct Vertex {
+
+    void Clear( void * =0 ) {
+        _pos[0]=_pos[1]=_pos[2]=0.0f;
+        _var[0]=_var[1]=_var[2]=0.0f;
+    }
+
+    void AddWithWeight(Vertex const & src, float weight) {
+        _pos[0]+=weight*src._pos[0];
+        _pos[1]+=weight*src._pos[1];
+        _pos[2]+=weight*src._pos[2];
+    }
+
+    void AddVaryingWithWeight(Vertex const & src, float weight) {
+        _var[0]+=weight*src._var[0];
+        _var[1]+=weight*src._var[1];
+        _var[2]+=weight*src._var[2];
+    }
+
+    float _pos[3],
+          _var[3];
+};
+
+//------------------------------------------------------------------------------
+static Shape *
+createShape(ShapeDesc const & desc) {
+
+    Shape * shape = Shape::parseObj(desc.data.c_str(), desc.scheme);
+
+    // the parser declares a face-varying channel even without uvs
+    if (not shape->HasUV()) {
+        shape->faceuvs.clear();
+    }
+    return shape;
+}
+
+static FarTopologyRefiner *
+createRefiner(Shape const & shape) {
+
+    FarTopologyRefiner * refiner =
+        FarTopologyRefinerFactory::Create(shape,
+            FarTopologyRefinerFactory::Options(GetSdcType(shape), GetSdcOptions(shape)));
+    assert(refiner);
+    return refiner;
+}
+
+static void
+initVertexData(Shape const & shape, FarTopologyRefiner const & refiner,
+    std::vector<Vertex> & data) {
+
+    data.resize(refiner.GetNumVerticesTotal());
+    memset(&data[0], 0, data.size()*sizeof(Vertex));
+
+    for (int i=0; i<refiner.GetNumVertices(0); ++i) {
+        for (int k=0; k<3; ++k) {
+            data[i]._pos[k] = shape.verts[i*3+k];
+            data[i]._var[k] = shape.verts[i*3+(k+1)%3];
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Comparison helpers -- each returns the number of differences
+template <class T> static int
+compareVectors(std::vector<T> const & a, std::vector<T> const & b) {
+
+    if (a.size()!=b.size()) {
+        return 1;
+    }
+    return (a.empty() or memcmp(&a[0], &b[0], a.size()*sizeof(T))==0) ? 0 : 1;
+}
+
+static int
+compareArrays(FarConstIndexArray a, FarConstIndexArray b) {
+
+    if (a.size()!=b.size()) {
+        return 1;
+    }
+    for (int i=0; i<a.size(); ++i) {
+        if (a[i]!=b[i]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int
+compareVertexData(std::vector<Vertex> const & a, std::vector<Vertex> const & b,
+    bool vertex, bool varying) {
+
+    assert(a.size()==b.size());
+
+    int count=0;
+    for (int i=0; i<(int)a.size(); ++i) {
+        if ((vertex and memcmp(a[i]._pos, b[i]._pos, sizeof(a[i]._pos))) or
+            (varying and memcmp(a[i]._var, b[i]._var, sizeof(a[i]._var)))) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static int
+compareTopology(FarTopologyRefiner const & a, FarTopologyRefiner const & b) {
+
+    if (a.GetMaxLevel()!=b.GetMaxLevel()) {
+        return 1;
+    }
+
+    int count=0;
+    for (int level=0; level<=a.GetMaxLevel(); ++level) {
+
+        if (a.GetNumFaces(level)!=b.GetNumFaces(level) or
+            a.GetNumEdges(level)!=b.GetNumEdges(level) or
+            a.GetNumVertices(level)!=b.GetNumVertices(level)) {
+            ++count;
+            continue;
+        }
+        for (int face=0; face<a.GetNumFaces(level); ++face) {
+            count += compareArrays(a.GetFaceVertices(level, face), b.GetFaceVertices(level, face));
+            count += compareArrays(a.GetFaceEdges(level, face), b.GetFaceEdges(level, face));
+            count += (a.IsHole(level, face)!=b.IsHole(level, face));
+        }
+        for (int edge=0; edge<a.GetNumEdges(level); ++edge) {
+            count += compareArrays(a.GetEdgeVertices(level, edge), b.GetEdgeVertices(level, edge));
+            count += compareArrays(a.GetEdgeFaces(level, edge), b.GetEdgeFaces(level, edge));
+            count += (a.GetEdgeSharpness(level, edge)!=b.GetEdgeSharpness(level, edge));
+        }
+        for (int vert=0; vert<a.GetNumVertices(level); ++vert) {
+            count += compareArrays(a.GetVertexFaces(level, vert), b.GetVertexFaces(level, vert));
+            count += compareArrays(a.GetVertexEdges(level, vert), b.GetVertexEdges(level, vert));
+            count += (a.GetVertexSharpness(level, vert)!=b.GetVertexSharpness(level, vert));
+            count += (a.GetVertexRule(level, vert)!=b.GetVertexRule(level, vert));
+        }
+    }
+    return count;
+}
+
+static int
+compareStencilTables(FarStencilTables const & a, FarStencilTables const & b) {
+
+    return (a.GetNumStencils()!=b.GetNumStencils()) +
+           (a.GetNumControlVertices()!=b.GetNumControlVertices()) +
+           compareVectors(a.GetSizes(), b.GetSizes()) +
+           compareVectors(a.GetOffsets(), b.GetOffsets()) +
+           compareVectors(a.GetControlIndices(), b.GetControlIndices()) +
+           compareVectors(a.GetWeights(), b.GetWeights());
+}
+
+//------------------------------------------------------------------------------
+// Parallel uniform refinement vs serial refinement
+static int
+checkParallelRefinement(ShapeDesc const & desc, int maxlevel) {
+
+    Shape * shape = createShape(desc);
+
+    FarTopologyRefiner * serial = createRefiner(*shape),
+                       * parallel = createRefiner(*shape);
+
+    FarTopologyRefiner::UniformOptions options(maxlevel);
+    options.fullTopologyInLastLevel=true;
+    serial->RefineUniform(options);
+
+    options.parallelRefinement=true;
+    parallel->RefineUniform(options);
+
+    int count = compareTopology(*serial, *parallel);
+
+    std::vector<Vertex> serialData, parallelData;
+    initVertexData(*shape, *serial, serialData);
+    initVertexData(*shape, *parallel, parallelData);
+
+    serial->Interpolate(&serialData[0], &serialData[serial->GetNumVertices(0)]);
+    parallel->Interpolate(&parallelData[0], &parallelData[parallel->GetNumVertices(0)]);
+
+    count += compareVertexData(serialData, parallelData, true, true);
+
+    if (count) {
+        printf("  parallel refinement : %d differences\n", count);
+    }
+
+    delete serial;
+    delete parallel;
+    delete shape;
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// Consistency of the compacted relations of each level
+static bool
+contains(FarConstIndexArray a, FarIndex index) {
+
+    for (int i=0; i<a.size(); ++i) {
+        if (a[i]==index) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int
+checkRelations(ShapeDesc const & desc, int maxlevel) {
+
+    Shape * shape = createShape(desc);
+
+    FarTopologyRefiner * refiner = createRefiner(*shape);
+
+    FarTopologyRefiner::UniformOptions options(maxlevel);
+    options.fullTopologyInLastLevel=true;
+    refiner->RefineUniform(options);
+
+    int count=0;
+    for (int level=0; level<=refiner->GetMaxLevel(); ++level) {
+
+        // every relation must be matched by its inverse
+        int numFaceVerts=0;
+        for (int face=0; face<refiner->GetNumFaces(level); ++face) {
+
+            FarConstIndexArray fVerts = refiner->GetFaceVertices(level, face),
+                               fEdges = refiner->GetFaceEdges(level, face);
+
+            count += (fVerts.size()!=fEdges.size());
+            for (int i=0; i<fVerts.size(); ++i) {
+                count += not contains(refiner->GetVertexFaces(level, fVerts[i]), face);
+            }
+            for (int i=0; i<fEdges.size(); ++i) {
+                count += not contains(refiner->GetEdgeFaces(level, fEdges[i]), face);
+            }
+            numFaceVerts += fVerts.size();
+        }
+        count += (numFaceVerts!=refiner->GetNumFaceVertices(level));
+
+        for (int edge=0; edge<refiner->GetNumEdges(level); ++edge) {
+
+            FarConstIndexArray eVerts = refiner->GetEdgeVertices(level, edge),
+                               eFaces = refiner->GetEdgeFaces(level, edge);
+
+            for (int i=0; i<eVerts.size(); ++i) {
+                count += not contains(refiner->GetVertexEdges(level, eVerts[i]), edge);
+            }
+            for (int i=0; i<eFaces.size(); ++i) {
+                count += not contains(refiner->GetFaceEdges(level, eFaces[i]), edge);
+            }
+        }
+
+        for (int vert=0; vert<refiner->GetNumVertices(level); ++vert) {
+
+            FarConstIndexArray vFaces = refiner->GetVertexFaces(level, vert),
+                               vEdges = refiner->GetVertexEdges(level, vert);
+
+            for (int i=0; i<vFaces.size(); ++i) {
+                count += not contains(refiner->GetFaceVertices(level, vFaces[i]), vert);
+            }
+            for (int i=0; i<vEdges.size(); ++i) {
+                count += not contains(refiner->GetEdgeVertices(level, vEdges[i]), vert);
+            }
+        }
+    }
+
+    if (count) {
+        printf("  topology relations : %d differences\n", count);
+    }
+
+    delete refiner;
+    delete shape;
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// Edges constructed from the face-vertices of the base level, serially and
+// in parallel
+static int
+checkBaseEdges(ShapeDesc const & desc) {
+
+    Shape * shape = createShape(desc);
+
+    FarTopologyRefiner * refiner = createRefiner(*shape);
+
+    int count=0;
+
+    // each face-edge joins two consecutive face-vertices
+    for (int face=0; face<refiner->GetNumFaces(0); ++face) {
+
+        FarConstIndexArray fVerts = refiner->GetFaceVertices(0, face),
+                           fEdges = refiner->GetFaceEdges(0, face);
+
+        for (int i=0; i<fEdges.size(); ++i) {
+
+            FarIndex v0 = fVerts[i],
+                     v1 = fVerts[(i+1)%fVerts.size()];
+
+            FarConstIndexArray eVerts = refiner->GetEdgeVertices(0, fEdges[i]);
+            count += not (((eVerts[0]==v0) and (eVerts[1]==v1)) or
+                          ((eVerts[0]==v1) and (eVerts[1]==v0)));
+            count += (refiner->FindEdge(0, v0, v1)!=fEdges[i]);
+        }
+    }
+
+    // and no two edges join the same pair of vertices
+    std::vector<std::pair<FarIndex, FarIndex> > pairs(refiner->GetNumEdges(0));
+    for (int edge=0; edge<refiner->GetNumEdges(0); ++edge) {
+
+        FarConstIndexArray eVerts = refiner->GetEdgeVertices(0, edge);
+        pairs[edge] = std::make_pair(std::min(eVerts[0], eVerts[1]),
+                                     std::max(eVerts[0], eVerts[1]));
+    }
+    std::sort(pairs.begin(), pairs.end());
+    count += (int)(pairs.end() - std::unique(pairs.begin(), pairs.end()));
+
+    // the topology completed in parallel must be identical
+    FarTopologyRefinerFactory::Options options(GetSdcType(*shape), GetSdcOptions(*shape));
+    options.parallelTopology=true;
+
+    FarTopologyRefiner * parallel = FarTopologyRefinerFactory::Create(*shape, options);
+    assert(parallel);
+
+    count += compareTopology(*refiner, *parallel);
+
+    if (count) {
+        printf("  base edges : %d differences\n", count);
+    }
+
+    delete parallel;
+    delete refiner;
+    delete shape;
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// Parallel, buffer and cached-mask interpolation vs templated Interpolate()
+static void
+interpolateBuffer(FarTopologyRefiner const & refiner, std::vector<Vertex> & data,
+    bool varying) {
+
+    // interleave the data of the 'Vertex' class in a buffer of floats, with
+    // the vertex (or varying) data at offset 1 of a stride of 5 floats
+    int nverts = refiner.GetNumVerticesTotal(),
+        ncoarse = refiner.GetNumVertices(0);
+
+    std::vector<float> buffer(nverts*5, 0.0f);
+    for (int i=0; i<ncoarse; ++i) {
+        memcpy(&buffer[i*5+1], varying ? data[i]._var : data[i]._pos, 3*sizeof(float));
+    }
+
+    FarVertexBufferDescriptor desc(1, 3, 5);
+    if (varying) {
+        refiner.InterpolateVarying(&buffer[0], desc, &buffer[ncoarse*5], desc);
+    } else {
+        refiner.Interpolate(&buffer[0], desc, &buffer[ncoarse*5], desc);
+    }
+
+    for (int i=ncoarse; i<nverts; ++i) {
+        memcpy(varying ? data[i]._var : data[i]._pos, &buffer[i*5+1], 3*sizeof(float));
+    }
+}
+
+static int
+checkInterpolation(ShapeDesc const & desc, int maxlevel, bool adaptive) {
+
+    Shape * shape = createShape(desc);
+
+    FarTopologyRefiner * refiner = createRefiner(*shape);
+
+    if (adaptive) {
+        refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(maxlevel));
+    } else {
+        FarTopologyRefiner::UniformOptions options(maxlevel);
+        options.fullTopologyInLastLevel=true;
+        refiner->RefineUniform(options);
+    }
+
+    int ncoarse = refiner->GetNumVertices(0);
+
+    std::vector<Vertex> reference, data;
+    initVertexData(*shape, *refiner, reference);
+    refiner->Interpolate(&reference[0], &reference[ncoarse]);
+
+    int counts[6] = { 0, 0, 0, 0, 0, 0 };
+
+    for (int cached=0; cached<2; ++cached) {
+
+        // templated, with cached masks
+        if (cached) {
+            refiner->CacheMasks();
+
+            initVertexData(*shape, *refiner, data);
+            refiner->Interpolate(&data[0], &data[ncoarse]);
+            counts[0] += compareVertexData(reference, data, true, true);
+        }
+
+        // parallel
+        initVertexData(*shape, *refiner, data);
+        refiner->ParallelInterpolate(&data[0], &data[ncoarse]);
+        counts[1] += compareVertexData(reference, data, true, true);
+
+        // varying only
+        initVertexData(*shape, *refiner, data);
+        refiner->InterpolateVarying(&data[0], &data[ncoarse]);
+        counts[2] += compareVertexData(reference, data, false, true);
+
+        initVertexData(*shape, *refiner, data);
+        refiner->ParallelInterpolateVarying(&data[0], &data[ncoarse]);
+        counts[3] += compareVertexData(reference, data, false, true);
+
+        // buffers of floats
+        initVertexData(*shape, *refiner, data);
+        interpolateBuffer(*refiner, data, false);
+        counts[4] += compareVertexData(reference, data, true, false);
+
+        interpolateBuffer(*refiner, data, true);
+        counts[5] += compareVertexData(reference, data, false, true);
+    }
+
+    static char const * names[6] = { "cached masks", "parallel", "varying",
+        "parallel varying", "buffer", "buffer varying" };
+
+    int count=0;
+    for (int i=0; i<6; ++i) {
+        if (counts[i]) {
+            printf("  %s interpolation (%s) : %d differences\n", names[i],
+                adaptive ? "adaptive" : "uniform", counts[i]);
+        }
+        count += counts[i];
+    }
+
+    delete refiner;
+    delete shape;
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// StencilTablesFactory::CreateStreaming() and CreateChunked() vs Create()
+struct StencilChunks {
+
+    int numStencils,
+        numChunks;
+
+    std::vector<unsigned char> sizes;
+    std::vector<FarIndex>      indices;
+    std::vector<float>         weights;
+};
+
+static void
+appendStencilChunk(FarStencilTables const & chunk, FarIndex firstStencil,
+    void * clientData) {
+
+    StencilChunks * chunks = static_cast<StencilChunks *>(clientData);
+
+    // chunks must be contiguous
+    if (firstStencil!=chunks->numStencils) {
+        chunks->numStencils = -1;
+        return;
+    }
+    chunks->numStencils += chunk.GetNumStencils();
+    ++chunks->numChunks;
+
+    chunks->sizes.insert(chunks->sizes.end(), chunk.GetSizes().begin(), chunk.GetSizes().end());
+    chunks->indices.insert(chunks->indices.end(), chunk.GetControlIndices().begin(), chunk.GetControlIndices().end());
+    chunks->weights.insert(chunks->weights.end(), chunk.GetWeights().begin(), chunk.GetWeights().end());
+}
+
+static int
+checkStencilTables(ShapeDesc const & desc, int maxlevel) {
+
+    Shape * shape = createShape(desc);
+
+    FarTopologyRefiner::UniformOptions refineOptions(maxlevel);
+    refineOptions.fullTopologyInLastLevel=true;
+
+    FarTopologyRefiner * refiner = createRefiner(*shape);
+    refiner->RefineUniform(refineOptions);
+
+    int countStreaming=0,
+        countChunked=0;
+
+    for (int i=0; i<16; ++i) {
+
+        FarStencilTablesFactory::Options options;
+        options.interpolationMode = (i&1) ?
+            FarStencilTablesFactory::INTERPOLATE_VARYING : FarStencilTablesFactory::INTERPOLATE_VERTEX;
+        options.generateOffsets = true;
+        options.generateControlVerts = (i>>1)&1;
+        options.generateIntermediateLevels = (i>>2)&1;
+        options.factorizeIntermediateLevels = (i>>3)&1;
+
+        FarStencilTables const * reference =
+            FarStencilTablesFactory::Create(*refiner, options);
+
+        // streaming -- refines its own refiner
+        FarTopologyRefiner * streamed = createRefiner(*shape);
+
+        FarStencilTables const * streaming =
+            FarStencilTablesFactory::CreateStreaming(*streamed, refineOptions, options);
+
+        countStreaming += compareStencilTables(*reference, *streaming);
+
+        delete streaming;
+        delete streamed;
+
+        // chunked -- with a budget of a few stencils per chunk
+        StencilChunks chunks;
+        chunks.numStencils = chunks.numChunks = 0;
+
+        FarStencilTablesFactory::CreateChunked(*refiner, appendStencilChunk, &chunks, 1024, options);
+
+        countChunked += (chunks.numStencils!=reference->GetNumStencils()) +
+                        compareVectors(chunks.sizes, reference->GetSizes()) +
+                        compareVectors(chunks.indices, reference->GetControlIndices()) +
+                        compareVectors(chunks.weights, reference->GetWeights());
+
+        delete reference;
+    }
+
+    if (countStreaming) {
+        printf("  streaming stencils : %d differences\n", countStreaming);
+    }
+    if (countChunked) {
+        printf("  chunked stencils : %d differences\n", countChunked);
+    }
+
+    delete refiner;
+    delete shape;
+    return countStreaming + countChunked;
+}
+
+//------------------------------------------------------------------------------
+// Compact and parallel PatchTables vs default PatchTables
+static int
+comparePatches(FarPatchTables const & a, FarPatchTables const & b) {
+
+    if (a.GetNumPatchArrays()!=b.GetNumPatchArrays()) {
+        return 1;
+    }
+
+    int count=0;
+    std::vector<FarIndex> aVerts, bVerts;
+    for (int array=0; array<a.GetNumPatchArrays(); ++array) {
+
+        if (not (a.GetPatchArrayDescriptor(array)==b.GetPatchArrayDescriptor(array)) or
+            a.GetNumPatches(array)!=b.GetNumPatches(array)) {
+            ++count;
+            continue;
+        }
+
+        int ncvs = a.GetPatchArrayDescriptor(array).GetNumControlVertices();
+
+        bool isSingleCrease = (a.GetPatchArrayDescriptor(array).GetType()==
+                               Far::PatchDescriptor::SINGLE_CREASE);
+        aVerts.resize(ncvs);
+        bVerts.resize(ncvs);
+
+        for (int patch=0; patch<a.GetNumPatches(array); ++patch) {
+
+            count += compareArrays(a.GetPatchVertices(array, patch, &aVerts[0]),
+                                   b.GetPatchVertices(array, patch, &bVerts[0]));
+
+            Far::PatchParam aParam = a.GetPatchParam(array, patch),
+                            bParam = b.GetPatchParam(array, patch);
+            count += (aParam.faceIndex!=bParam.faceIndex) or
+                     (aParam.bitField.field!=bParam.bitField.field);
+
+            if (isSingleCrease) {
+                count += (a.GetSingleCreasePatchSharpnessValue(array, patch)!=
+                          b.GetSingleCreasePatchSharpnessValue(array, patch));
+            }
+        }
+    }
+    count += (a.GetNumPtexFaces()!=b.GetNumPtexFaces());
+    count += (a.GetMaxValence()!=b.GetMaxValence());
+    count += compareVectors(a.GetVertexValenceTable(), b.GetVertexValenceTable());
+
+    if (a.GetEndCapStencilTables() and b.GetEndCapStencilTables()) {
+        count += compareStencilTables(*a.GetEndCapStencilTables(), *b.GetEndCapStencilTables());
+    } else {
+        count += (a.GetEndCapStencilTables()!=b.GetEndCapStencilTables());
+    }
+    return count;
+}
+
+// the raw tables -- only available if neither is compact
+static int
+compareTables(FarPatchTables const & a, FarPatchTables const & b) {
+
+    int count = compareVectors(a.GetPatchControlVerticesTable(), b.GetPatchControlVerticesTable()) +
+                compareVectors(a.GetPatchParamTable(), b.GetPatchParamTable()) +
+                compareVectors(a.GetSharpnessIndexTable(), b.GetSharpnessIndexTable()) +
+                compareVectors(a.GetSharpnessValues(), b.GetSharpnessValues()) +
+                compareVectors(a.GetQuadOffsetsTable(), b.GetQuadOffsetsTable());
+
+    FarPatchTables::FVarPatchTables const * aFVar = a.GetFVarPatchTables(),
+                                          * bFVar = b.GetFVarPatchTables();
+    if (aFVar and bFVar) {
+        count += (aFVar->GetNumChannels()!=bFVar->GetNumChannels());
+        for (int channel=0; channel<aFVar->GetNumChannels() and
+                            channel<bFVar->GetNumChannels(); ++channel) {
+            count += compareVectors(aFVar->GetPatchVertices(channel),
+                                    bFVar->GetPatchVertices(channel));
+        }
+    } else {
+        count += ((aFVar==0)!=(bFVar==0));
+    }
+    return count;
+}
+
+static int
+checkPatchTables(ShapeDesc const & desc, int maxlevel, bool adaptive) {
+
+    Shape * shape = createShape(desc);
+
+    FarTopologyRefiner * refiner = createRefiner(*shape);
+
+    FarStencilTables const * endcapStencils = 0;
+    if (adaptive) {
+        refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(maxlevel));
+
+        // stencils of the refined vertices for the Gregory basis end-caps
+        FarStencilTablesFactory::Options options;
+        options.generateOffsets=true;
+        options.generateIntermediateLevels=true;
+        endcapStencils = FarStencilTablesFactory::Create(*refiner, options);
+    } else {
+        FarTopologyRefiner::UniformOptions options(maxlevel);
+        options.fullTopologyInLastLevel=true;
+        refiner->RefineUniform(options);
+    }
+
+    FarPatchTablesFactory::Options options(maxlevel);
+    options.adaptiveStencilTables = endcapStencils;
+    options.generateFVarTables = shape->HasUV();
+
+    FarPatchTables const * reference = FarPatchTablesFactory::Create(*refiner, options);
+
+    options.parallelCreation=true;
+    FarPatchTables const * parallel = FarPatchTablesFactory::Create(*refiner, options);
+
+    options.compactStorage=true;
+    FarPatchTables const * parallelCompact = FarPatchTablesFactory::Create(*refiner, options);
+
+    options.parallelCreation=false;
+    FarPatchTables const * compact = FarPatchTablesFactory::Create(*refiner, options);
+
+    int countParallel = comparePatches(*reference, *parallel) +
+                        compareTables(*reference, *parallel),
+        countCompact = comparePatches(*reference, *compact) +
+                       comparePatches(*reference, *parallelCompact);
+
+    if (countParallel) {
+        printf("  parallel patch tables (%s) : %d differences\n",
+            adaptive ? "adaptive" : "uniform", countParallel);
+    }
+    if (countCompact) {
+        printf("  compact patch tables (%s) : %d differences\n",
+            adaptive ? "adaptive" : "uniform", countCompact);
+    }
+
+    delete reference;
+    delete parallel;
+    delete parallelCompact;
+    delete compact;
+    delete endcapStencils;
+    delete refiner;
+    delete shape;
+    return countParallel + countCompact;
+}
+
+//------------------------------------------------------------------------------
+// Derivative weights of PatchTables::GetBasisWeights() vs central differences
+// of the point weights
+static int
+checkBasisDerivatives() {
+
+    static FarPatchTables::TensorBasis const bases[2] =
+        { FarPatchTables::BASIS_BEZIER, FarPatchTables::BASIS_BSPLINE };
+    static char const * names[2] = { "Bezier", "B-spline" };
+
+    printf("- %-25s : \n", "basis derivatives");
+
+    Far::PatchParam::BitField bits;
+    bits.Set(0, 0, 0, 0, false);
+
+    float const h = 1.0e-2f,
+                tolerance = 1.0e-3f;
+
+    int total=0;
+    for (int basis=0; basis<2; ++basis) {
+
+        int count=0;
+        for (int i=1; i<8; ++i) {
+            for (int j=1; j<8; ++j) {
+
+                float s = (float)i/8.0f,
+                      t = (float)j/8.0f;
+
+                float point[16], dS[16], dT[16],
+                      sPlus[16], sMinus[16], tPlus[16], tMinus[16];
+
+                FarPatchTables::GetBasisWeights(bases[basis], bits, s, t, point, dS, dT);
+                FarPatchTables::GetBasisWeights(bases[basis], bits, s+h, t, sPlus, 0, 0);
+                FarPatchTables::GetBasisWeights(bases[basis], bits, s-h, t, sMinus, 0, 0);
+                FarPatchTables::GetBasisWeights(bases[basis], bits, s, t+h, tPlus, 0, 0);
+                FarPatchTables::GetBasisWeights(bases[basis], bits, s, t-h, tMinus, 0, 0);
+
+                for (int k=0; k<16; ++k) {
+                    count += (fabsf(dS[k] - (sPlus[k]-sMinus[k])/(2.0f*h)) > tolerance);
+                    count += (fabsf(dT[k] - (tPlus[k]-tMinus[k])/(2.0f*h)) > tolerance);
+                }
+            }
+        }
+        if (count) {
+            printf("  %s derivatives : %d differences\n", names[basis], count);
+        }
+        total += count;
+    }
+
+    if (total==0) {
+        printf("  success !\n");
+    }
+    return total;
+}
+
+//------------------------------------------------------------------------------
+static int
+checkMesh(ShapeDesc const & desc, int maxlevel) {
+
+    static char const * schemes[] = { "Bilinear", "Catmark", "Loop" };
+    printf("- %-25s ( %-8s ): \n", desc.name.c_str(), schemes[desc.scheme]);
+
+    int count=0;
+
+    count += checkParallelRefinement(desc, maxlevel);
+
+    count += checkRelations(desc, maxlevel);
+
+    count += checkBaseEdges(desc);
+
+    count += checkInterpolation(desc, maxlevel, false);
+
+    count += checkStencilTables(desc, maxlevel);
+
+    count += checkPatchTables(desc, maxlevel, false);
+
+    // feature adaptive refinement and patches are Catmark only
+    if (desc.scheme==kCatmark) {
+        count += checkInterpolation(desc, maxlevel, true);
+
+        count += checkPatchTables(desc, maxlevel, true);
+    }
+
+    if (count==0) {
+        printf("  success !\n");
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+int main(int /* argc */, char ** /* argv */) {
+
+    int levels=3, total=0;
+
+    initShapes();
+
+    total+=checkBasisDerivatives();
+
+    for (int i=0; i<(int)g_shapes.size(); ++i) {
+        total+=checkMesh(g_shapes[i], levels);
+    }
+
+    if (total==0)
+      printf("All tests passed.\n");
+    else
+      printf("Total failures : %d\n", total);
+
+    return total==0 ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------